@@ -0,0 +1,48 @@
+// Copyright (C) 2026 George Cave.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef FOE_PARALLEL_FOR_H
+#define FOE_PARALLEL_FOR_H
+
+#include <foe/export.h>
+#include <foe/result.h>
+#include <foe/split_thread_pool.h>
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Processes the items in the range [begin, end)
+typedef void (*PFN_foeParallelForTask)(void *pContext, size_t begin, size_t end);
+
+/** @brief Splits a range into chunks that are processed across the sync threads of a pool
+ * @param pool Thread pool to spread the work across
+ * @param begin Start of the range
+ * @param end One past the end of the range
+ * @param grainSize Minimum number of items processed in a single call, except for the last chunk
+ * @param task Function called for each chunk
+ * @param pContext Context passed to each call of the task
+ * @return FOE_SUCCESS once all chunks have been processed, an appropriate error code otherwise.
+ *
+ * Chunks are handed out from a shared cursor, starting large and shrinking as the remaining range
+ * drops, so that threads that finish early can pick up smaller pieces of what is left.
+ *
+ * The calling thread processes chunks as well, and does not return until all chunks have
+ * completed. As such it is safe to call from within a task running on the same pool.
+ */
+FOE_EXPORT
+foeResultSet foeParallelFor(foeSplitThreadPool pool,
+                            size_t begin,
+                            size_t end,
+                            size_t grainSize,
+                            PFN_foeParallelForTask task,
+                            void *pContext);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FOE_PARALLEL_FOR_H
@@ -1,4 +1,4 @@
-// Copyright (C) 2021-2023 George Cave.
+// Copyright (C) 2021-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
@@ -33,6 +33,7 @@ typedef enum foeResult {
     FOE_SUCCESS = 0,
     FOE_INCOMPLETE = 1000000001,
     FOE_AWAITING_INPUT = 1000000002,
+    FOE_TIMEOUT = 1000000003,
     FOE_ERROR_OUT_OF_MEMORY = -1000000001,
     FOE_ERROR_FAILED_TO_OPEN_FILE = -1000000002,
     FOE_ERROR_FAILED_TO_STAT_FILE = -1000000003,
@@ -50,6 +51,7 @@ typedef enum foeResult {
     FOE_ERROR_UTF_MALFORMED_DATA = -1000000015,
     FOE_ERROR_UTF_INVALID_STATE = -1000000016,
     FOE_ERROR_UTF_INVALID_CODEPOINT = -1000000017,
+    FOE_ERROR_TASK_GROUP_CLOSED = -1000000018,
 } foeResult;
 
 FOE_EXPORT
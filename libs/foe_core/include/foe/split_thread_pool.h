@@ -1,4 +1,4 @@
-// Copyright (C) 2021-2022 George Cave.
+// Copyright (C) 2021-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
@@ -59,6 +59,10 @@ foeResultSet foeScheduleSyncTask(foeSplitThreadPool pool, PFN_foeTask task, void
 FOE_EXPORT
 foeResultSet foeScheduleAsyncTask(foeSplitThreadPool pool, PFN_foeTask task, void *pTaskContext);
 
+/** @brief Blocks until all tasks of the given type(s) have completed
+ *
+ * The calling thread sleeps rather than spins while waiting.
+ */
 FOE_EXPORT
 foeResultSet foeWaitSyncThreads(foeSplitThreadPool pool);
 FOE_EXPORT
@@ -66,6 +70,17 @@ foeResultSet foeWaitAsyncThreads(foeSplitThreadPool pool);
 FOE_EXPORT
 foeResultSet foeWaitAllThreads(foeSplitThreadPool pool);
 
+/** @brief Blocks until all tasks of the given type(s) have completed or the timeout elapses
+ * @param timeoutNanoseconds Maximum time to wait. Zero just checks the current state.
+ * @return FOE_SUCCESS if all tasks completed, FOE_TIMEOUT if the timeout elapsed first.
+ */
+FOE_EXPORT
+foeResultSet foeTimedWaitSyncThreads(foeSplitThreadPool pool, uint64_t timeoutNanoseconds);
+FOE_EXPORT
+foeResultSet foeTimedWaitAsyncThreads(foeSplitThreadPool pool, uint64_t timeoutNanoseconds);
+FOE_EXPORT
+foeResultSet foeTimedWaitAllThreads(foeSplitThreadPool pool, uint64_t timeoutNanoseconds);
+
 #ifdef __cplusplus
 }
 #endif
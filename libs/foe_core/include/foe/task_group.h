@@ -0,0 +1,96 @@
+// Copyright (C) 2026 George Cave.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef FOE_TASK_GROUP_H
+#define FOE_TASK_GROUP_H
+
+#include <foe/export.h>
+#include <foe/handle.h>
+#include <foe/result.h>
+#include <foe/split_thread_pool.h>
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief A set of tasks on a split thread pool that can be waited on and depended upon together
+ *
+ * Tasks are scheduled into an open group, and run on the group's thread pool like any other task.
+ * Once all tasks have been scheduled the group is closed, after which it completes as soon as all
+ * of its tasks have finished.
+ *
+ * A group can depend on other groups, in which case none of its tasks start until all of the
+ * groups it depends on have completed, allowing a directed acyclic graph of work to be described.
+ *
+ * Continuations are tasks that are scheduled onto the thread pool when the group completes, but are
+ * not themselves part of the group.
+ */
+FOE_DEFINE_HANDLE(foeTaskGroup)
+
+FOE_EXPORT
+foeResultSet foeCreateTaskGroup(foeSplitThreadPool pool, foeTaskGroup *pTaskGroup);
+
+/** @brief Closes the group if still open, waits for it to complete, then frees it
+ * @note Must not be called from within one of the group's own tasks.
+ */
+FOE_EXPORT
+void foeDestroyTaskGroup(foeTaskGroup taskGroup);
+
+/** @brief Schedules a task as part of the group
+ * @return FOE_SUCCESS on success, FOE_ERROR_TASK_GROUP_CLOSED if the group was already closed.
+ */
+FOE_EXPORT
+foeResultSet foeTaskGroupScheduleSyncTask(foeTaskGroup taskGroup,
+                                          PFN_foeTask task,
+                                          void *pTaskContext);
+FOE_EXPORT
+foeResultSet foeTaskGroupScheduleAsyncTask(foeTaskGroup taskGroup,
+                                           PFN_foeTask task,
+                                           void *pTaskContext);
+
+/** @brief Adds a task to be scheduled onto the thread pool once the group completes
+ *
+ * If the group has already completed, the task is scheduled immediately.
+ */
+FOE_EXPORT
+foeResultSet foeTaskGroupAddSyncContinuation(foeTaskGroup taskGroup,
+                                             PFN_foeTask task,
+                                             void *pTaskContext);
+FOE_EXPORT
+foeResultSet foeTaskGroupAddAsyncContinuation(foeTaskGroup taskGroup,
+                                              PFN_foeTask task,
+                                              void *pTaskContext);
+
+/** @brief Prevents any tasks of the group from starting until the dependency group has completed
+ * @param taskGroup Group that is to wait on the other.
+ * @param dependency Group that must complete first.
+ * @return FOE_SUCCESS on success, FOE_ERROR_TASK_GROUP_CLOSED if taskGroup was already closed.
+ * @note Tasks of taskGroup that have already started are unaffected, so dependencies should be
+ * added before scheduling tasks. Dependency cycles will never complete.
+ */
+FOE_EXPORT
+foeResultSet foeTaskGroupAddDependency(foeTaskGroup taskGroup, foeTaskGroup dependency);
+
+/// Marks that no more tasks will be added, allowing the group to complete
+FOE_EXPORT
+void foeTaskGroupClose(foeTaskGroup taskGroup);
+
+/// Blocks until the group has been closed and all of its tasks have completed
+FOE_EXPORT
+foeResultSet foeWaitTaskGroup(foeTaskGroup taskGroup);
+
+/** @brief Blocks until the group has completed or the timeout elapses
+ * @param timeoutNanoseconds Maximum time to wait. Zero just checks the current state.
+ * @return FOE_SUCCESS if the group completed, FOE_TIMEOUT if the timeout elapsed first.
+ */
+FOE_EXPORT
+foeResultSet foeTimedWaitTaskGroup(foeTaskGroup taskGroup, uint64_t timeoutNanoseconds);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FOE_TASK_GROUP_H
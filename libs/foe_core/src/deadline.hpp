@@ -0,0 +1,19 @@
+// Copyright (C) 2026 George Cave.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DEADLINE_HPP
+#define DEADLINE_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+/// Returns the point in time that a wait with the given timeout should give up at
+inline std::chrono::steady_clock::time_point getDeadline(uint64_t timeoutNanoseconds) {
+    // Clamped so that very large timeouts don't overflow the clock
+    return std::chrono::steady_clock::now() +
+           std::chrono::nanoseconds{std::min<uint64_t>(timeoutNanoseconds, INT64_MAX / 2)};
+}
+
+#endif // DEADLINE_HPP
@@ -0,0 +1,126 @@
+// Copyright (C) 2026 George Cave.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <foe/parallel_for.h>
+
+#include "result.h"
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+
+namespace {
+
+struct ParallelForData {
+    /// Start of the next unclaimed chunk
+    std::atomic<size_t> next;
+    /// Number of items not yet processed, the caller is woken when this reaches zero
+    std::atomic<size_t> remaining;
+    /// Number of threads that may still access this data, the last one frees it
+    std::atomic_uint refCount;
+
+    size_t end;
+    size_t grainSize;
+    /// Number of threads expected to be processing chunks, used to size them
+    size_t numWorkers;
+
+    PFN_foeParallelForTask task;
+    void *pContext;
+};
+
+void releaseData(ParallelForData *pData) {
+    if (--pData->refCount == 0)
+        delete pData;
+}
+
+void processChunks(ParallelForData *pData) {
+    size_t next = pData->next.load(std::memory_order_relaxed);
+
+    while (next < pData->end) {
+        // Guided chunking, large chunks at first that shrink towards the grain size as the
+        // remaining range drops
+        size_t const unclaimed = pData->end - next;
+        size_t chunkSize = std::max(pData->grainSize, unclaimed / (2 * pData->numWorkers));
+        chunkSize = std::min(chunkSize, unclaimed);
+
+        if (!pData->next.compare_exchange_weak(next, next + chunkSize, std::memory_order_relaxed))
+            continue;
+
+        pData->task(pData->pContext, next, next + chunkSize);
+
+        if (pData->remaining.fetch_sub(chunkSize, std::memory_order_acq_rel) == chunkSize)
+            pData->remaining.notify_all();
+
+        next = pData->next.load(std::memory_order_relaxed);
+    }
+}
+
+void helperTask(void *pContext) {
+    ParallelForData *pData = (ParallelForData *)pContext;
+
+    processChunks(pData);
+    releaseData(pData);
+}
+
+} // namespace
+
+extern "C" foeResultSet foeParallelFor(foeSplitThreadPool pool,
+                                       size_t begin,
+                                       size_t end,
+                                       size_t grainSize,
+                                       PFN_foeParallelForTask task,
+                                       void *pContext) {
+    if (begin >= end)
+        return to_foeResult(FOE_SUCCESS);
+
+    if (grainSize == 0)
+        grainSize = 1;
+
+    size_t const count = end - begin;
+    size_t const numChunks = (count + grainSize - 1) / grainSize;
+
+    // Not worth the overhead of involving other threads
+    if (numChunks == 1) {
+        task(pContext, begin, end);
+        return to_foeResult(FOE_SUCCESS);
+    }
+
+    size_t const numHelpers = std::min<size_t>(foeNumSyncThreads(pool), numChunks - 1);
+
+    ParallelForData *pData = new (std::nothrow) ParallelForData{
+        .next = begin,
+        .remaining = count,
+        .refCount = 1,
+        .end = end,
+        .grainSize = grainSize,
+        .numWorkers = numHelpers + 1,
+        .task = task,
+        .pContext = pContext,
+    };
+    if (pData == nullptr)
+        return to_foeResult(FOE_ERROR_OUT_OF_MEMORY);
+
+    for (size_t i = 0; i < numHelpers; ++i) {
+        ++pData->refCount;
+
+        // If a helper can't be scheduled, the remaining threads will pick up the slack
+        if (foeScheduleSyncTask(pool, helperTask, pData).value != FOE_SUCCESS) {
+            --pData->refCount;
+            break;
+        }
+    }
+
+    processChunks(pData);
+
+    // Wait for chunks still being processed by other threads
+    size_t remaining = pData->remaining.load(std::memory_order_acquire);
+    while (remaining != 0) {
+        pData->remaining.wait(remaining, std::memory_order_acquire);
+        remaining = pData->remaining.load(std::memory_order_acquire);
+    }
+
+    releaseData(pData);
+
+    return to_foeResult(FOE_SUCCESS);
+}
@@ -1,4 +1,4 @@
-// Copyright (C) 2022-2024 George Cave.
+// Copyright (C) 2022-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
@@ -19,6 +19,7 @@ void foeResultToString(foeResult value, char buffer[FOE_MAX_RESULT_STRING_SIZE])
 
     switch (value) {
         RESULT_CASE(FOE_SUCCESS)
+        RESULT_CASE(FOE_TIMEOUT)
         RESULT_CASE(FOE_ERROR_OUT_OF_MEMORY)
         RESULT_CASE(FOE_ERROR_FAILED_TO_OPEN_FILE)
         RESULT_CASE(FOE_ERROR_FAILED_TO_STAT_FILE)
@@ -32,6 +33,7 @@ void foeResultToString(foeResult value, char buffer[FOE_MAX_RESULT_STRING_SIZE])
         RESULT_CASE(FOE_ERROR_DESTINATION_BUFFER_TOO_SMALL)
         RESULT_CASE(FOE_ERROR_INVALID_HEX_DATA_SIZE)
         RESULT_CASE(FOE_ERROR_MALFORMED_HEX_DATA)
+        RESULT_CASE(FOE_ERROR_TASK_GROUP_CLOSED)
 
     default:
         if (value > 0) {
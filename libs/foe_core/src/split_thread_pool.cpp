@@ -1,4 +1,4 @@
-// Copyright (C) 2021-2025 George Cave.
+// Copyright (C) 2021-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
@@ -10,11 +10,13 @@
     #include <timeapi.h>
 #endif
 
+#include "deadline.hpp"
 #include "result.h"
 
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <new>
 #include <queue>
 #include <thread>
 
@@ -25,150 +27,425 @@ struct Task {
     void *pTaskContext;
 };
 
+/// A single entry in a work-stealing buffer, atomic so that thieves can read a slot while the owner
+/// may be overwriting it, with the result being discarded if the steal loses the race
+struct TaskSlot {
+    std::atomic<PFN_foeTask> task;
+    std::atomic<void *> pTaskContext;
+};
+
+/// Circular array of task slots, followed in memory by 'capacity' TaskSlot items
+struct TaskBuffer {
+    /// Number of slots, always a power of two
+    int64_t capacity;
+    /// Buffers that have been grown out of are kept until the deque is destroyed, as thieves may
+    /// still be reading from them
+    TaskBuffer *pPrevious;
+};
+
+inline TaskSlot *getTaskSlot(TaskBuffer *pBuffer, int64_t index) {
+    return reinterpret_cast<TaskSlot *>(pBuffer + 1) + (index & (pBuffer->capacity - 1));
+}
+
+TaskBuffer *createTaskBuffer(int64_t capacity, TaskBuffer *pPrevious) {
+    TaskBuffer *pNewBuffer =
+        (TaskBuffer *)malloc(sizeof(TaskBuffer) + capacity * sizeof(TaskSlot));
+    if (pNewBuffer == nullptr)
+        return nullptr;
+
+    pNewBuffer->capacity = capacity;
+    pNewBuffer->pPrevious = pPrevious;
+
+    TaskSlot *pSlots = reinterpret_cast<TaskSlot *>(pNewBuffer + 1);
+    for (int64_t i = 0; i < capacity; ++i)
+        new (pSlots + i) TaskSlot{};
+
+    return pNewBuffer;
+}
+
+void destroyTaskBuffers(TaskBuffer *pBuffer) {
+    while (pBuffer != nullptr) {
+        TaskBuffer *pPrevious = pBuffer->pPrevious;
+        free(pBuffer);
+        pBuffer = pPrevious;
+    }
+}
+
+/** @brief Chase-Lev work-stealing deque
+ *
+ * Only the owning worker thread pushes and pops from the bottom, while any other worker can steal
+ * from the top. The owner and thieves only contend when fighting over the very last item.
+ */
+struct TaskDeque {
+    alignas(64) std::atomic<int64_t> top;
+    alignas(64) std::atomic<int64_t> bottom;
+    std::atomic<TaskBuffer *> pBuffer;
+};
+
+/// Only to be called from the owning thread
+bool pushTask(TaskDeque &deque, Task task) {
+    int64_t const bottom = deque.bottom.load(std::memory_order_relaxed);
+    int64_t const top = deque.top.load(std::memory_order_acquire);
+    TaskBuffer *pBuffer = deque.pBuffer.load(std::memory_order_relaxed);
+
+    if (bottom - top > pBuffer->capacity - 1) {
+        // Full, grow into a new buffer, keeping the old one around for any current thieves
+        TaskBuffer *pNewBuffer = createTaskBuffer(pBuffer->capacity * 2, pBuffer);
+        if (pNewBuffer == nullptr)
+            return false;
+
+        for (int64_t i = top; i < bottom; ++i) {
+            TaskSlot *pSrc = getTaskSlot(pBuffer, i);
+            TaskSlot *pDst = getTaskSlot(pNewBuffer, i);
+
+            pDst->task.store(pSrc->task.load(std::memory_order_relaxed),
+                             std::memory_order_relaxed);
+            pDst->pTaskContext.store(pSrc->pTaskContext.load(std::memory_order_relaxed),
+                                     std::memory_order_relaxed);
+        }
+
+        deque.pBuffer.store(pNewBuffer, std::memory_order_release);
+        pBuffer = pNewBuffer;
+    }
+
+    TaskSlot *pSlot = getTaskSlot(pBuffer, bottom);
+    pSlot->task.store(task.task, std::memory_order_relaxed);
+    pSlot->pTaskContext.store(task.pTaskContext, std::memory_order_relaxed);
+
+    deque.bottom.store(bottom + 1, std::memory_order_release);
+
+    return true;
+}
+
+/// Only to be called from the owning thread
+bool popTask(TaskDeque &deque, Task *pTask) {
+    int64_t const bottom = deque.bottom.load(std::memory_order_relaxed) - 1;
+    TaskBuffer *pBuffer = deque.pBuffer.load(std::memory_order_relaxed);
+
+    deque.bottom.store(bottom, std::memory_order_seq_cst);
+    int64_t top = deque.top.load(std::memory_order_seq_cst);
+
+    if (top > bottom) {
+        // Empty
+        deque.bottom.store(bottom + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    TaskSlot *pSlot = getTaskSlot(pBuffer, bottom);
+    *pTask = Task{
+        .task = pSlot->task.load(std::memory_order_relaxed),
+        .pTaskContext = pSlot->pTaskContext.load(std::memory_order_relaxed),
+    };
+
+    if (top == bottom) {
+        // Last item, need to race any thieves for it
+        bool const won = deque.top.compare_exchange_strong(
+            top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        deque.bottom.store(bottom + 1, std::memory_order_relaxed);
+
+        return won;
+    }
+
+    return true;
+}
+
+/// Can be called from any thread, returns false if empty or if the race for the item was lost
+bool stealTask(TaskDeque &deque, Task *pTask) {
+    int64_t top = deque.top.load(std::memory_order_seq_cst);
+    int64_t const bottom = deque.bottom.load(std::memory_order_seq_cst);
+
+    if (top >= bottom)
+        return false;
+
+    TaskSlot *pSlot = getTaskSlot(deque.pBuffer.load(std::memory_order_acquire), top);
+    Task task{
+        .task = pSlot->task.load(std::memory_order_relaxed),
+        .pTaskContext = pSlot->pTaskContext.load(std::memory_order_relaxed),
+    };
+
+    if (!deque.top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                           std::memory_order_relaxed))
+        return false;
+
+    *pTask = task;
+    return true;
+}
+
 struct TaskGroupData {
     /// Number of threads in the task group
     uint32_t threadCount;
 
-    /// Synchronizes the task list
+    /// Synchronizes the injected task list and sleeping threads
     std::mutex sync;
-    /// Upcoming scheduled tasks
+    /// Tasks scheduled from threads outside of the pool
     std::queue<Task> tasks;
+    /// Number of tasks in the injected task list
+    std::atomic_uint injectedCount;
     /// Notified when a new task has been scheduled/queued
     std::condition_variable available;
+    /// Number of threads waiting on 'available'
+    std::atomic_uint sleepingCount;
     /// Number of tasks queued
     std::atomic_uint queuedCount;
     /// Number of tasks running/processing
     std::atomic_uint runningCount;
+
+    /// Number of tasks scheduled that have not yet completed
+    std::atomic_uint pendingCount;
+    /// Synchronizes threads waiting for all the group's tasks to complete
+    std::mutex idleSync;
+    /// Notified when the pending count reaches zero
+    std::condition_variable idle;
 };
 
-void scheduleTask(TaskGroupData &taskGroup, PFN_foeTask task, void *pTaskContext) {
-    taskGroup.sync.lock();
-    ++taskGroup.queuedCount;
-    taskGroup.tasks.emplace(Task{
-        .task = task,
-        .pTaskContext = pTaskContext,
-    });
-    taskGroup.sync.unlock();
+struct SplitThreadPoolImpl;
 
-    taskGroup.available.notify_one();
-}
+/// Each thread in the pool owns a deque for each type of task that it schedules itself
+struct Worker {
+    SplitThreadPoolImpl *pPool;
+    uint32_t index;
+
+    TaskDeque syncTasks;
+    TaskDeque asyncTasks;
+};
 
 struct SplitThreadPoolImpl {
     /// Tracks if the threads have been requested to end
     std::atomic_bool terminate;
-    // Number of threads started
-    std::atomic_uint runners;
 
     /// Sync task data
     TaskGroupData syncTasks;
     /// Async task data
     TaskGroupData asyncTasks;
+
+    /// Per-thread data, sync threads first followed by async threads
+    Worker *pWorkers;
 };
 
+/// The worker associated with the current thread, if it is part of any thread pool
+thread_local Worker *tWorker = nullptr;
+
 inline std::thread *getThreadArray(SplitThreadPoolImpl *pThreadPool) {
     return (std::thread *)(((uint8_t *)pThreadPool) + sizeof(SplitThreadPoolImpl));
 }
 
+inline uint32_t getTotalThreadCount(SplitThreadPoolImpl *pThreadPool) {
+    return pThreadPool->syncTasks.threadCount + pThreadPool->asyncTasks.threadCount;
+}
+
 FOE_DEFINE_HANDLE_CASTS(split_thread_pool, SplitThreadPoolImpl, foeSplitThreadPool)
 
-void syncTaskRunner(SplitThreadPoolImpl *pPool) {
-    Task task;
-    std::unique_lock syncLock{pPool->syncTasks.sync};
+void wakeThread(TaskGroupData &taskGroup) {
+    if (taskGroup.sleepingCount == 0)
+        return;
 
-    while (true) {
-        if (!pPool->syncTasks.tasks.empty()) {
-            // Work available
-            ++pPool->syncTasks.runningCount;
+    // Acquiring the lock guarantees that any thread that counted itself as sleeping is now actually
+    // waiting on the condition variable
+    taskGroup.sync.lock();
+    taskGroup.sync.unlock();
+
+    taskGroup.available.notify_one();
+}
 
-            // Get work
-            task = pPool->syncTasks.tasks.front();
-            pPool->syncTasks.tasks.pop();
-            --pPool->syncTasks.queuedCount;
+void completeTask(TaskGroupData &taskGroup) {
+    if (--taskGroup.pendingCount != 0)
+        return;
 
-            // Release tasklist lock
-            syncLock.unlock();
+    // Acquiring the lock guarantees that any thread that saw pending work is now actually waiting
+    // on the condition variable
+    taskGroup.idleSync.lock();
+    taskGroup.idleSync.unlock();
 
-            // Run the task
-            task.task(task.pTaskContext);
+    taskGroup.idle.notify_all();
+}
 
-            // Task complete, cleanup
-            --pPool->syncTasks.runningCount;
+/// Returns false if the deadline was reached before the task group became idle
+bool waitIdle(TaskGroupData &taskGroup, std::chrono::steady_clock::time_point const *pDeadline) {
+    if (taskGroup.pendingCount == 0)
+        return true;
 
-            syncLock.lock();
-        } else if (pPool->terminate) {
-            break;
-        } else {
-            pPool->syncTasks.available.wait(syncLock);
+    auto isIdle = [&taskGroup]() { return taskGroup.pendingCount == 0; };
+    std::unique_lock idleLock{taskGroup.idleSync};
+
+    if (pDeadline != nullptr)
+        return taskGroup.idle.wait_until(idleLock, *pDeadline, isIdle);
+
+    taskGroup.idle.wait(idleLock, isIdle);
+    return true;
+}
+
+foeResultSet waitSync(SplitThreadPoolImpl *pPool,
+                      std::chrono::steady_clock::time_point const *pDeadline) {
+    if (!waitIdle(pPool->syncTasks, pDeadline))
+        return to_foeResult(FOE_TIMEOUT);
+
+    return to_foeResult(FOE_SUCCESS);
+}
+
+foeResultSet waitAsync(SplitThreadPoolImpl *pPool,
+                       std::chrono::steady_clock::time_point const *pDeadline) {
+    if (!waitIdle(pPool->asyncTasks, pDeadline))
+        return to_foeResult(FOE_TIMEOUT);
+
+    return to_foeResult(FOE_SUCCESS);
+}
+
+foeResultSet waitAll(SplitThreadPoolImpl *pPool,
+                     std::chrono::steady_clock::time_point const *pDeadline) {
+    // Tasks of either type can schedule more of the other, so keep going until both are idle at
+    // the same time
+    do {
+        if (!waitIdle(pPool->syncTasks, pDeadline) || !waitIdle(pPool->asyncTasks, pDeadline))
+            return to_foeResult(FOE_TIMEOUT);
+    } while (pPool->syncTasks.pendingCount > 0 || pPool->asyncTasks.pendingCount > 0);
+
+    return to_foeResult(FOE_SUCCESS);
+}
+
+foeResultSet scheduleTask(SplitThreadPoolImpl *pPool,
+                          TaskGroupData &taskGroup,
+                          TaskDeque Worker::*pWorkerDeque,
+                          PFN_foeTask task,
+                          void *pTaskContext) {
+    Task newTask{
+        .task = task,
+        .pTaskContext = pTaskContext,
+    };
+
+    // Incremented before the task is made available so that the counts never underflow
+    ++taskGroup.pendingCount;
+    ++taskGroup.queuedCount;
+
+    if (tWorker != nullptr && tWorker->pPool == pPool) {
+        // Scheduled from a thread of this pool, push onto its own deque
+        if (!pushTask(tWorker->*pWorkerDeque, newTask)) {
+            --taskGroup.queuedCount;
+            completeTask(taskGroup);
+            return to_foeResult(FOE_ERROR_OUT_OF_MEMORY);
         }
+    } else {
+        taskGroup.sync.lock();
+        taskGroup.tasks.emplace(newTask);
+        ++taskGroup.injectedCount;
+        taskGroup.sync.unlock();
     }
 
-    --pPool->runners;
+    return to_foeResult(FOE_SUCCESS);
 }
 
-void asyncTaskRunner(SplitThreadPoolImpl *pPool) {
-    Task task;
-    std::unique_lock asyncLock{pPool->asyncTasks.sync};
+bool acquireTask(SplitThreadPoolImpl *pPool,
+                 Worker *pWorker,
+                 TaskGroupData &taskGroup,
+                 TaskDeque Worker::*pWorkerDeque,
+                 Task *pTask) {
+    if (taskGroup.queuedCount == 0)
+        return false;
+
+    // Own work first, most recently scheduled items are the most likely to be cache-hot
+    bool gotWork = popTask(pWorker->*pWorkerDeque, pTask);
+
+    // Then anything scheduled from outside the pool
+    if (!gotWork && taskGroup.injectedCount > 0) {
+        taskGroup.sync.lock();
+        if (!taskGroup.tasks.empty()) {
+            gotWork = true;
+            *pTask = taskGroup.tasks.front();
+            taskGroup.tasks.pop();
+            --taskGroup.injectedCount;
+        }
+        taskGroup.sync.unlock();
+    }
 
-    while (true) {
-        if (!pPool->asyncTasks.tasks.empty()) {
-            // Work available
-            ++pPool->asyncTasks.runningCount;
+    // Finally, try to steal from the other threads, starting with the next one along
+    if (!gotWork) {
+        uint32_t const totalThreads = getTotalThreadCount(pPool);
+        for (uint32_t i = 1; i < totalThreads; ++i) {
+            Worker *pVictim = pPool->pWorkers + ((pWorker->index + i) % totalThreads);
+            if (stealTask(pVictim->*pWorkerDeque, pTask)) {
+                gotWork = true;
+                break;
+            }
+        }
+    }
 
-            // Get work
-            task = std::move(pPool->asyncTasks.tasks.front());
-            pPool->asyncTasks.tasks.pop();
-            --pPool->asyncTasks.queuedCount;
+    if (gotWork) {
+        ++taskGroup.runningCount;
+        --taskGroup.queuedCount;
+    }
 
-            // Release tasklist lock
-            asyncLock.unlock();
+    return gotWork;
+}
 
-            // Run the task
-            task.task(task.pTaskContext);
+void runTask(TaskGroupData &taskGroup, Task task) {
+    task.task(task.pTaskContext);
 
-            // Task complete, cleanup
-            --pPool->asyncTasks.runningCount;
+    --taskGroup.runningCount;
+    completeTask(taskGroup);
+}
+
+void syncTaskRunner(SplitThreadPoolImpl *pPool, Worker *pWorker) {
+    tWorker = pWorker;
+    Task task;
 
-            asyncLock.lock();
+    while (true) {
+        if (acquireTask(pPool, pWorker, pPool->syncTasks, &Worker::syncTasks, &task)) {
+            runTask(pPool->syncTasks, task);
         } else if (pPool->syncTasks.queuedCount > 0) {
-            if (!pPool->syncTasks.sync.try_lock()) {
-                // Sync tasks available, but could not secure a lock this time, go around again
-                // immediately
-                continue;
-            }
-            // Might have synchronous work available, unlock the async mutex as we're working with
-            // sync stuff, leave for other async threads to interact in the meantime
-            asyncLock.unlock();
+            // Work is queued but not yet visible or was lost to another thread, back off before
+            // going around again rather than spinning
+            std::this_thread::yield();
+        } else if (pPool->terminate && popTask(pWorker->asyncTasks, &task)) {
+            // Async tasks scheduled by sync tasks on this thread are normally taken by the async
+            // threads, but they may have already exited when terminating, so run any left here
+            ++pPool->asyncTasks.runningCount;
+            --pPool->asyncTasks.queuedCount;
+            runTask(pPool->asyncTasks, task);
+        } else if (pPool->terminate) {
+            break;
+        } else {
+            std::unique_lock syncLock{pPool->syncTasks.sync};
+            ++pPool->syncTasks.sleepingCount;
 
-            // Attempt to pull a job
-            bool gotWork{false};
-            if (!pPool->syncTasks.tasks.empty()) {
-                gotWork = true;
-                ++pPool->syncTasks.runningCount;
+            while (pPool->syncTasks.queuedCount == 0 && !pPool->terminate)
+                pPool->syncTasks.available.wait(syncLock);
 
-                task = std::move(pPool->syncTasks.tasks.front());
-                pPool->syncTasks.tasks.pop();
-                --pPool->syncTasks.queuedCount;
-            }
-            // Unlock the sync mutex, we're done with it
-            pPool->syncTasks.sync.unlock();
+            --pPool->syncTasks.sleepingCount;
+        }
+    }
 
-            // If we got sync work, run it
-            if (gotWork) {
-                task.task(task.pTaskContext);
-                --pPool->syncTasks.runningCount;
-            }
+    tWorker = nullptr;
+}
+
+void asyncTaskRunner(SplitThreadPoolImpl *pPool, Worker *pWorker) {
+    tWorker = pWorker;
+    Task task;
 
-            // Before we loop again, acquire the async mutex
-            asyncLock.lock();
+    while (true) {
+        if (acquireTask(pPool, pWorker, pPool->asyncTasks, &Worker::asyncTasks, &task)) {
+            runTask(pPool->asyncTasks, task);
+        } else if (acquireTask(pPool, pWorker, pPool->syncTasks, &Worker::syncTasks, &task)) {
+            // No async work available, help out with sync work instead
+            runTask(pPool->syncTasks, task);
+        } else if (pPool->asyncTasks.queuedCount > 0 || pPool->syncTasks.queuedCount > 0) {
+            // Work is queued but not yet visible or was lost to another thread, back off before
+            // going around again rather than spinning
+            std::this_thread::yield();
         } else if (pPool->terminate) {
             break;
         } else {
             // Nothing available to run for either async or sync task lists, wait
-            pPool->asyncTasks.available.wait(asyncLock);
+            std::unique_lock asyncLock{pPool->asyncTasks.sync};
+            ++pPool->asyncTasks.sleepingCount;
+
+            while (pPool->asyncTasks.queuedCount == 0 && pPool->syncTasks.queuedCount == 0 &&
+                   !pPool->terminate)
+                pPool->asyncTasks.available.wait(asyncLock);
+
+            --pPool->asyncTasks.sleepingCount;
         }
     }
 
-    --pPool->runners;
+    tWorker = nullptr;
 }
 
 } // namespace
@@ -181,13 +458,45 @@ extern "C" foeResultSet foeCreateThreadPool(uint32_t syncThreads,
     if (asyncThreads == 0)
         return to_foeResult(FOE_ERROR_ZERO_ASYNC_THREADS);
 
+    uint32_t const totalThreadCount = syncThreads + asyncThreads;
+
     // Allocation is the implementation + (total num threads * std::thread) so that it is one
     // contiguous allocation
     SplitThreadPoolImpl *pNewPool = (SplitThreadPoolImpl *)malloc(
-        sizeof(SplitThreadPoolImpl) + (syncThreads + asyncThreads) * sizeof(std::thread));
+        sizeof(SplitThreadPoolImpl) + totalThreadCount * sizeof(std::thread));
     if (pNewPool == nullptr)
         return to_foeResult(FOE_ERROR_OUT_OF_MEMORY);
 
+    Worker *pWorkers = new (std::nothrow) Worker[totalThreadCount];
+    if (pWorkers == nullptr) {
+        free(pNewPool);
+        return to_foeResult(FOE_ERROR_OUT_OF_MEMORY);
+    }
+
+    bool buffersAllocated = true;
+    for (uint32_t i = 0; i < totalThreadCount; ++i) {
+        pWorkers[i].pPool = pNewPool;
+        pWorkers[i].index = i;
+
+        for (TaskDeque *pDeque : {&pWorkers[i].syncTasks, &pWorkers[i].asyncTasks}) {
+            pDeque->top = 0;
+            pDeque->bottom = 0;
+            pDeque->pBuffer = createTaskBuffer(64, nullptr);
+            if (pDeque->pBuffer == nullptr)
+                buffersAllocated = false;
+        }
+    }
+
+    if (!buffersAllocated) {
+        for (uint32_t i = 0; i < totalThreadCount; ++i) {
+            destroyTaskBuffers(pWorkers[i].syncTasks.pBuffer);
+            destroyTaskBuffers(pWorkers[i].asyncTasks.pBuffer);
+        }
+        delete[] pWorkers;
+        free(pNewPool);
+        return to_foeResult(FOE_ERROR_OUT_OF_MEMORY);
+    }
+
 #ifdef _WIN32
     // On Windows, set the kernel rate to 1000Hz
     timeBeginPeriod(1);
@@ -195,27 +504,29 @@ extern "C" foeResultSet foeCreateThreadPool(uint32_t syncThreads,
 
     new (pNewPool) SplitThreadPoolImpl{
         .terminate = false,
-        .runners = 0,
         .syncTasks =
             {
                 .threadCount = syncThreads,
             },
-        .asyncTasks = {
-            .threadCount = asyncThreads,
-        },
+        .asyncTasks =
+            {
+                .threadCount = asyncThreads,
+            },
+        .pWorkers = pWorkers,
     };
 
     std::thread *pThreads = getThreadArray(pNewPool);
     // Start sync threads
     for (uint32_t i = 0; i < pNewPool->syncTasks.threadCount; ++i) {
-        ++pNewPool->runners;
-        new (pThreads + i) std::thread(syncTaskRunner, pNewPool);
+        new (pThreads + i) std::thread(syncTaskRunner, pNewPool, pWorkers + i);
     }
 
     // Start async threads
     for (uint32_t i = 0; i < pNewPool->asyncTasks.threadCount; ++i) {
-        ++pNewPool->runners;
-        new (pThreads + pNewPool->syncTasks.threadCount + i) std::thread(asyncTaskRunner, pNewPool);
+        uint32_t const threadIndex = pNewPool->syncTasks.threadCount + i;
+
+        new (pThreads + threadIndex)
+            std::thread(asyncTaskRunner, pNewPool, pWorkers + threadIndex);
     }
 
     *pPool = split_thread_pool_to_handle(pNewPool);
@@ -226,19 +537,27 @@ extern "C" foeResultSet foeCreateThreadPool(uint32_t syncThreads,
 extern "C" void foeDestroyThreadPool(foeSplitThreadPool pool) {
     auto *pPool = split_thread_pool_from_handle(pool);
 
-    // Terminate running threads
+    // Terminate running threads, with the locks guaranteeing that any thread about to sleep either
+    // sees the request or is already waiting to be notified
     pPool->terminate = true;
 
-    while (pPool->runners > 0) {
-        pPool->syncTasks.available.notify_all();
-        pPool->asyncTasks.available.notify_all();
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    for (TaskGroupData *pTaskGroup : {&pPool->syncTasks, &pPool->asyncTasks}) {
+        pTaskGroup->sync.lock();
+        pTaskGroup->sync.unlock();
+        pTaskGroup->available.notify_all();
     }
 
     std::thread *pThreads = getThreadArray(pPool);
-    auto const totalThreadCount = pPool->syncTasks.threadCount + pPool->asyncTasks.threadCount;
+    auto const totalThreadCount = getTotalThreadCount(pPool);
     for (uint32_t i = 0; i < totalThreadCount; ++i) {
         pThreads[i].join();
+        pThreads[i].~thread();
+    }
+
+    // Only once every thread has finished, as any of them could be stealing from any other's deques
+    for (uint32_t i = 0; i < totalThreadCount; ++i) {
+        destroyTaskBuffers(pPool->pWorkers[i].syncTasks.pBuffer);
+        destroyTaskBuffers(pPool->pWorkers[i].asyncTasks.pBuffer);
     }
 
 #ifdef _WIN32
@@ -247,6 +566,7 @@ extern "C" void foeDestroyThreadPool(foeSplitThreadPool pool) {
 #endif
 
     // Free used memory
+    delete[] pPool->pWorkers;
     pPool->~SplitThreadPoolImpl();
     free(pPool);
 }
@@ -292,10 +612,15 @@ extern "C" foeResultSet foeScheduleSyncTask(foeSplitThreadPool pool,
                                             void *pTaskContext) {
     auto *pPool = split_thread_pool_from_handle(pool);
 
-    scheduleTask(pPool->syncTasks, task, pTaskContext);
-    pPool->asyncTasks.available.notify_one();
+    foeResultSet result =
+        scheduleTask(pPool, pPool->syncTasks, &Worker::syncTasks, task, pTaskContext);
 
-    return to_foeResult(FOE_SUCCESS);
+    if (result.value == FOE_SUCCESS) {
+        wakeThread(pPool->syncTasks);
+        wakeThread(pPool->asyncTasks);
+    }
+
+    return result;
 }
 
 extern "C" foeResultSet foeScheduleAsyncTask(foeSplitThreadPool pool,
@@ -303,35 +628,44 @@ extern "C" foeResultSet foeScheduleAsyncTask(foeSplitThreadPool pool,
                                              void *pTaskContext) {
     auto *pPool = split_thread_pool_from_handle(pool);
 
-    scheduleTask(pPool->asyncTasks, task, pTaskContext);
+    foeResultSet result =
+        scheduleTask(pPool, pPool->asyncTasks, &Worker::asyncTasks, task, pTaskContext);
 
-    return to_foeResult(FOE_SUCCESS);
+    if (result.value == FOE_SUCCESS)
+        wakeThread(pPool->asyncTasks);
+
+    return result;
 }
 
 extern "C" foeResultSet foeWaitSyncThreads(foeSplitThreadPool pool) {
-    auto *pPool = split_thread_pool_from_handle(pool);
-
-    while (pPool->syncTasks.queuedCount > 0 || pPool->syncTasks.runningCount > 0)
-        std::this_thread::yield();
-
-    return to_foeResult(FOE_SUCCESS);
+    return waitSync(split_thread_pool_from_handle(pool), nullptr);
 }
 
 extern "C" foeResultSet foeWaitAsyncThreads(foeSplitThreadPool pool) {
-    auto *pPool = split_thread_pool_from_handle(pool);
+    return waitAsync(split_thread_pool_from_handle(pool), nullptr);
+}
 
-    while (pPool->asyncTasks.queuedCount > 0 || pPool->asyncTasks.runningCount > 0)
-        std::this_thread::yield();
+extern "C" foeResultSet foeWaitAllThreads(foeSplitThreadPool pool) {
+    return waitAll(split_thread_pool_from_handle(pool), nullptr);
+}
 
-    return to_foeResult(FOE_SUCCESS);
+extern "C" foeResultSet foeTimedWaitSyncThreads(foeSplitThreadPool pool,
+                                                uint64_t timeoutNanoseconds) {
+    auto const deadline = getDeadline(timeoutNanoseconds);
+
+    return waitSync(split_thread_pool_from_handle(pool), &deadline);
 }
 
-extern "C" foeResultSet foeWaitAllThreads(foeSplitThreadPool pool) {
-    auto *pPool = split_thread_pool_from_handle(pool);
+extern "C" foeResultSet foeTimedWaitAsyncThreads(foeSplitThreadPool pool,
+                                                 uint64_t timeoutNanoseconds) {
+    auto const deadline = getDeadline(timeoutNanoseconds);
 
-    while (pPool->syncTasks.queuedCount > 0 || pPool->syncTasks.runningCount > 0 ||
-           pPool->asyncTasks.queuedCount > 0 || pPool->asyncTasks.runningCount > 0)
-        std::this_thread::yield();
+    return waitAsync(split_thread_pool_from_handle(pool), &deadline);
+}
 
-    return to_foeResult(FOE_SUCCESS);
-}
\ No newline at end of file
+extern "C" foeResultSet foeTimedWaitAllThreads(foeSplitThreadPool pool,
+                                               uint64_t timeoutNanoseconds) {
+    auto const deadline = getDeadline(timeoutNanoseconds);
+
+    return waitAll(split_thread_pool_from_handle(pool), &deadline);
+}
@@ -0,0 +1,319 @@
+// Copyright (C) 2026 George Cave.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <foe/task_group.h>
+
+#include "deadline.hpp"
+#include "result.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace {
+
+struct TaskGroupImpl;
+
+struct GroupTask {
+    PFN_foeTask task;
+    void *pTaskContext;
+    TaskGroupImpl *pTaskGroup;
+    bool async;
+};
+
+struct Continuation {
+    PFN_foeTask task;
+    void *pTaskContext;
+    bool async;
+};
+
+struct TaskGroupImpl {
+    foeSplitThreadPool pool;
+
+    /// Synchronizes all other members
+    std::mutex sync;
+    /// Notified when the group completes
+    std::condition_variable completed;
+
+    /// No more tasks may be scheduled
+    bool closed;
+    /// All tasks are done, continuations and dependents are being released
+    bool finishing;
+    /// Continuations and dependents have been released, group may now be destroyed
+    bool complete;
+
+    /// Number of groups this one is still waiting on
+    uint32_t unresolvedDependencies;
+    /// Number of tasks scheduled that have not yet finished, including deferred ones
+    uint32_t incompleteTasks;
+
+    /// Tasks scheduled while dependencies were unresolved
+    std::vector<GroupTask *> deferredTasks;
+    /// Tasks to be scheduled when the group completes
+    std::vector<Continuation> continuations;
+    /// Groups that are waiting for this one to complete
+    std::vector<TaskGroupImpl *> dependents;
+};
+
+FOE_DEFINE_HANDLE_CASTS(task_group, TaskGroupImpl, foeTaskGroup)
+
+foeResultSet scheduleTask(foeSplitThreadPool pool,
+                          PFN_foeTask task,
+                          void *pTaskContext,
+                          bool async) {
+    if (async)
+        return foeScheduleAsyncTask(pool, task, pTaskContext);
+    else
+        return foeScheduleSyncTask(pool, task, pTaskContext);
+}
+
+/** @brief If the group is done, releases its continuations and dependents then marks it complete
+ * @param pTaskGroup Group to check
+ * @param lock Lock held on the group, unlocked upon return
+ *
+ * Once marked complete the group may be destroyed by a waiting thread at any point, so it cannot
+ * be touched afterwards.
+ */
+void finishIfDone(TaskGroupImpl *pTaskGroup, std::unique_lock<std::mutex> &lock);
+
+void resolveDependency(TaskGroupImpl *pTaskGroup);
+
+void runGroupTask(void *pContext) {
+    GroupTask *pGroupTask = (GroupTask *)pContext;
+    TaskGroupImpl *pTaskGroup = pGroupTask->pTaskGroup;
+
+    pGroupTask->task(pGroupTask->pTaskContext);
+    free(pGroupTask);
+
+    std::unique_lock lock{pTaskGroup->sync};
+    --pTaskGroup->incompleteTasks;
+    finishIfDone(pTaskGroup, lock);
+}
+
+void finishIfDone(TaskGroupImpl *pTaskGroup, std::unique_lock<std::mutex> &lock) {
+    if (!pTaskGroup->closed || pTaskGroup->finishing || pTaskGroup->incompleteTasks != 0 ||
+        pTaskGroup->unresolvedDependencies != 0) {
+        lock.unlock();
+        return;
+    }
+
+    pTaskGroup->finishing = true;
+    std::vector<Continuation> continuations = std::move(pTaskGroup->continuations);
+    std::vector<TaskGroupImpl *> dependents = std::move(pTaskGroup->dependents);
+    lock.unlock();
+
+    for (auto const &it : continuations) {
+        // With no-one to report a failure to, run it here instead
+        if (scheduleTask(pTaskGroup->pool, it.task, it.pTaskContext, it.async).value !=
+            FOE_SUCCESS)
+            it.task(it.pTaskContext);
+    }
+
+    for (auto *pDependent : dependents)
+        resolveDependency(pDependent);
+
+    lock.lock();
+    pTaskGroup->complete = true;
+    pTaskGroup->completed.notify_all();
+    lock.unlock();
+}
+
+void resolveDependency(TaskGroupImpl *pTaskGroup) {
+    std::unique_lock lock{pTaskGroup->sync};
+    --pTaskGroup->unresolvedDependencies;
+    if (pTaskGroup->unresolvedDependencies != 0)
+        return;
+
+    if (pTaskGroup->deferredTasks.empty()) {
+        finishIfDone(pTaskGroup, lock);
+        return;
+    }
+
+    // The last of these tasks to finish will complete the group, which could then be destroyed, so
+    // the group must not be touched after releasing them
+    std::vector<GroupTask *> releasedTasks = std::move(pTaskGroup->deferredTasks);
+    foeSplitThreadPool pool = pTaskGroup->pool;
+    lock.unlock();
+
+    for (auto *pGroupTask : releasedTasks) {
+        // With no-one to report a failure to, run it here instead
+        if (scheduleTask(pool, runGroupTask, pGroupTask, pGroupTask->async).value != FOE_SUCCESS)
+            runGroupTask(pGroupTask);
+    }
+}
+
+foeResultSet scheduleGroupTask(TaskGroupImpl *pTaskGroup,
+                               PFN_foeTask task,
+                               void *pTaskContext,
+                               bool async) {
+    GroupTask *pGroupTask = (GroupTask *)malloc(sizeof(GroupTask));
+    if (pGroupTask == nullptr)
+        return to_foeResult(FOE_ERROR_OUT_OF_MEMORY);
+
+    *pGroupTask = GroupTask{
+        .task = task,
+        .pTaskContext = pTaskContext,
+        .pTaskGroup = pTaskGroup,
+        .async = async,
+    };
+
+    std::unique_lock lock{pTaskGroup->sync};
+    if (pTaskGroup->closed) {
+        lock.unlock();
+        free(pGroupTask);
+        return to_foeResult(FOE_ERROR_TASK_GROUP_CLOSED);
+    }
+
+    ++pTaskGroup->incompleteTasks;
+
+    if (pTaskGroup->unresolvedDependencies > 0) {
+        pTaskGroup->deferredTasks.emplace_back(pGroupTask);
+        return to_foeResult(FOE_SUCCESS);
+    }
+    lock.unlock();
+
+    foeResultSet result = scheduleTask(pTaskGroup->pool, runGroupTask, pGroupTask, async);
+    if (result.value != FOE_SUCCESS) {
+        free(pGroupTask);
+
+        lock.lock();
+        --pTaskGroup->incompleteTasks;
+        finishIfDone(pTaskGroup, lock);
+    }
+
+    return result;
+}
+
+foeResultSet addContinuation(TaskGroupImpl *pTaskGroup,
+                             PFN_foeTask task,
+                             void *pTaskContext,
+                             bool async) {
+    std::unique_lock lock{pTaskGroup->sync};
+
+    if (!pTaskGroup->finishing) {
+        pTaskGroup->continuations.emplace_back(Continuation{
+            .task = task,
+            .pTaskContext = pTaskContext,
+            .async = async,
+        });
+        return to_foeResult(FOE_SUCCESS);
+    }
+    lock.unlock();
+
+    // Group has already finished, so can go straight to the thread pool
+    return scheduleTask(pTaskGroup->pool, task, pTaskContext, async);
+}
+
+} // namespace
+
+extern "C" foeResultSet foeCreateTaskGroup(foeSplitThreadPool pool, foeTaskGroup *pTaskGroup) {
+    TaskGroupImpl *pNewTaskGroup = new (std::nothrow) TaskGroupImpl{
+        .pool = pool,
+        .closed = false,
+        .finishing = false,
+        .complete = false,
+        .unresolvedDependencies = 0,
+        .incompleteTasks = 0,
+    };
+    if (pNewTaskGroup == nullptr)
+        return to_foeResult(FOE_ERROR_OUT_OF_MEMORY);
+
+    *pTaskGroup = task_group_to_handle(pNewTaskGroup);
+
+    return to_foeResult(FOE_SUCCESS);
+}
+
+extern "C" void foeDestroyTaskGroup(foeTaskGroup taskGroup) {
+    auto *pTaskGroup = task_group_from_handle(taskGroup);
+
+    foeTaskGroupClose(taskGroup);
+    foeWaitTaskGroup(taskGroup);
+
+    delete pTaskGroup;
+}
+
+extern "C" foeResultSet foeTaskGroupScheduleSyncTask(foeTaskGroup taskGroup,
+                                                     PFN_foeTask task,
+                                                     void *pTaskContext) {
+    return scheduleGroupTask(task_group_from_handle(taskGroup), task, pTaskContext, false);
+}
+
+extern "C" foeResultSet foeTaskGroupScheduleAsyncTask(foeTaskGroup taskGroup,
+                                                      PFN_foeTask task,
+                                                      void *pTaskContext) {
+    return scheduleGroupTask(task_group_from_handle(taskGroup), task, pTaskContext, true);
+}
+
+extern "C" foeResultSet foeTaskGroupAddSyncContinuation(foeTaskGroup taskGroup,
+                                                        PFN_foeTask task,
+                                                        void *pTaskContext) {
+    return addContinuation(task_group_from_handle(taskGroup), task, pTaskContext, false);
+}
+
+extern "C" foeResultSet foeTaskGroupAddAsyncContinuation(foeTaskGroup taskGroup,
+                                                         PFN_foeTask task,
+                                                         void *pTaskContext) {
+    return addContinuation(task_group_from_handle(taskGroup), task, pTaskContext, true);
+}
+
+extern "C" foeResultSet foeTaskGroupAddDependency(foeTaskGroup taskGroup,
+                                                  foeTaskGroup dependency) {
+    auto *pTaskGroup = task_group_from_handle(taskGroup);
+    auto *pDependency = task_group_from_handle(dependency);
+
+    std::unique_lock lock{pTaskGroup->sync};
+    if (pTaskGroup->closed)
+        return to_foeResult(FOE_ERROR_TASK_GROUP_CLOSED);
+
+    ++pTaskGroup->unresolvedDependencies;
+    lock.unlock();
+
+    std::unique_lock dependencyLock{pDependency->sync};
+    if (!pDependency->finishing) {
+        pDependency->dependents.emplace_back(pTaskGroup);
+        return to_foeResult(FOE_SUCCESS);
+    }
+    dependencyLock.unlock();
+
+    // Dependency has already finished
+    resolveDependency(pTaskGroup);
+
+    return to_foeResult(FOE_SUCCESS);
+}
+
+extern "C" void foeTaskGroupClose(foeTaskGroup taskGroup) {
+    auto *pTaskGroup = task_group_from_handle(taskGroup);
+
+    std::unique_lock lock{pTaskGroup->sync};
+    if (pTaskGroup->closed)
+        return;
+
+    pTaskGroup->closed = true;
+    finishIfDone(pTaskGroup, lock);
+}
+
+extern "C" foeResultSet foeWaitTaskGroup(foeTaskGroup taskGroup) {
+    auto *pTaskGroup = task_group_from_handle(taskGroup);
+
+    std::unique_lock lock{pTaskGroup->sync};
+    pTaskGroup->completed.wait(lock, [pTaskGroup]() { return pTaskGroup->complete; });
+
+    return to_foeResult(FOE_SUCCESS);
+}
+
+extern "C" foeResultSet foeTimedWaitTaskGroup(foeTaskGroup taskGroup,
+                                              uint64_t timeoutNanoseconds) {
+    auto *pTaskGroup = task_group_from_handle(taskGroup);
+
+    auto const deadline = getDeadline(timeoutNanoseconds);
+
+    std::unique_lock lock{pTaskGroup->sync};
+    if (!pTaskGroup->completed.wait_until(lock, deadline,
+                                          [pTaskGroup]() { return pTaskGroup->complete; }))
+        return to_foeResult(FOE_TIMEOUT);
+
+    return to_foeResult(FOE_SUCCESS);
+}
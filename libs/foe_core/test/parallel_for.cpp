@@ -0,0 +1,119 @@
+// Copyright (C) 2026 George Cave.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <foe/parallel_for.h>
+#include <foe/split_thread_pool.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct CoverageContext {
+    std::vector<std::atomic_int> visits;
+    size_t grainSize;
+    size_t end;
+    std::atomic_int undersizedChunks;
+    std::mutex threadSync;
+    std::vector<std::thread::id> threads;
+};
+
+void coverageTask(void *pContext, size_t begin, size_t end) {
+    CoverageContext *pCoverage = (CoverageContext *)pContext;
+
+    // Only the final chunk may be smaller than the grain size
+    if (end - begin < pCoverage->grainSize && end != pCoverage->end)
+        ++pCoverage->undersizedChunks;
+
+    for (size_t i = begin; i < end; ++i) {
+        ++pCoverage->visits[i];
+    }
+
+    std::scoped_lock lock{pCoverage->threadSync};
+    pCoverage->threads.emplace_back(std::this_thread::get_id());
+}
+
+struct NestedContext {
+    foeSplitThreadPool pool;
+    std::atomic<size_t> sum;
+};
+
+void innerTask(void *pContext, size_t begin, size_t end) {
+    NestedContext *pNested = (NestedContext *)pContext;
+
+    for (size_t i = begin; i < end; ++i)
+        pNested->sum += i;
+}
+
+void outerTask(void *pContext, size_t begin, size_t end) {
+    NestedContext *pNested = (NestedContext *)pContext;
+
+    for (size_t i = begin; i < end; ++i)
+        foeParallelFor(pNested->pool, 0, 1000, 10, innerTask, pContext);
+}
+
+} // namespace
+
+TEST_CASE("ParallelFor - Range coverage") {
+    foeSplitThreadPool pool{FOE_NULL_HANDLE};
+    REQUIRE(foeCreateThreadPool(4, 1, &pool).value == FOE_SUCCESS);
+
+    CoverageContext coverage{
+        .visits = std::vector<std::atomic_int>(100000),
+        .grainSize = 1,
+        .end = 100000,
+    };
+
+    SECTION("Empty range does not call the task") {
+        REQUIRE(foeParallelFor(pool, 10, 10, 1, coverageTask, &coverage).value == FOE_SUCCESS);
+        CHECK(coverage.threads.empty());
+    }
+
+    SECTION("Range within a single grain runs on the calling thread") {
+        coverage.grainSize = 64;
+        coverage.end = 50;
+
+        REQUIRE(foeParallelFor(pool, 0, 50, 64, coverageTask, &coverage).value == FOE_SUCCESS);
+        REQUIRE(coverage.threads.size() == 1);
+        CHECK(coverage.threads[0] == std::this_thread::get_id());
+
+        for (size_t i = 0; i < 50; ++i)
+            REQUIRE(coverage.visits[i] == 1);
+    }
+
+    SECTION("Every item in the range is visited exactly once") {
+        size_t const begin = 7;
+
+        SECTION("Grain size of 1") { coverage.grainSize = 1; }
+        SECTION("Grain size of 100") { coverage.grainSize = 100; }
+        SECTION("Grain size of 4096") { coverage.grainSize = 4096; }
+
+        REQUIRE(foeParallelFor(pool, begin, coverage.end, coverage.grainSize, coverageTask,
+                               &coverage)
+                    .value == FOE_SUCCESS);
+
+        CHECK(coverage.undersizedChunks == 0);
+        for (size_t i = 0; i < coverage.end; ++i)
+            REQUIRE(coverage.visits[i] == ((i < begin) ? 0 : 1));
+    }
+
+    foeDestroyThreadPool(pool);
+}
+
+TEST_CASE("ParallelFor - Nested calls from within pool threads") {
+    foeSplitThreadPool pool{FOE_NULL_HANDLE};
+    REQUIRE(foeCreateThreadPool(2, 1, &pool).value == FOE_SUCCESS);
+
+    NestedContext nested{
+        .pool = pool,
+        .sum = 0,
+    };
+
+    REQUIRE(foeParallelFor(pool, 0, 16, 1, outerTask, &nested).value == FOE_SUCCESS);
+    CHECK(nested.sum == 16 * (999 * 1000 / 2));
+
+    foeDestroyThreadPool(pool);
+}
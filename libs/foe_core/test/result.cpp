@@ -1,4 +1,4 @@
-// Copyright (C) 2022-2023 George Cave.
+// Copyright (C) 2022-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
@@ -24,6 +24,7 @@ TEST_CASE("foeResult - Ensure error codes return correct values and strings") {
     }
 
     ERROR_CODE_CATCH_CHECK(FOE_SUCCESS)
+    ERROR_CODE_CATCH_CHECK(FOE_TIMEOUT)
     ERROR_CODE_CATCH_CHECK(FOE_ERROR_OUT_OF_MEMORY)
     ERROR_CODE_CATCH_CHECK(FOE_ERROR_FAILED_TO_OPEN_FILE)
     ERROR_CODE_CATCH_CHECK(FOE_ERROR_FAILED_TO_STAT_FILE)
@@ -37,4 +38,5 @@ TEST_CASE("foeResult - Ensure error codes return correct values and strings") {
     ERROR_CODE_CATCH_CHECK(FOE_ERROR_DESTINATION_BUFFER_TOO_SMALL)
     ERROR_CODE_CATCH_CHECK(FOE_ERROR_INVALID_HEX_DATA_SIZE)
     ERROR_CODE_CATCH_CHECK(FOE_ERROR_MALFORMED_HEX_DATA)
+    ERROR_CODE_CATCH_CHECK(FOE_ERROR_TASK_GROUP_CLOSED)
 }
@@ -1,11 +1,14 @@
-// Copyright (C) 2021-2023 George Cave.
+// Copyright (C) 2021-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
+#include <algorithm>
 #include <atomic>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <foe/chrono/easy_clock.hpp>
 #include <foe/split_thread_pool.h>
+#include <string>
 #include <thread>
 
 using namespace std::chrono_literals;
@@ -30,6 +33,38 @@ void waitTask(void *) {
     --waitingThreads;
 }
 
+struct SpawnContext {
+    foeSplitThreadPool pool;
+    uint32_t numChildren;
+    std::atomic_int *pTaskCount;
+};
+
+void countTask(void *pContext) {
+    std::atomic_int *pTaskCount = (std::atomic_int *)pContext;
+    ++(*pTaskCount);
+}
+
+void spawnTask(void *pContext) {
+    SpawnContext *pSpawnContext = (SpawnContext *)pContext;
+
+    for (uint32_t i = 0; i < pSpawnContext->numChildren; ++i)
+        foeScheduleSyncTask(pSpawnContext->pool, countTask, pSpawnContext->pTaskCount);
+
+    ++(*pSpawnContext->pTaskCount);
+}
+
+void delayedAsyncSpawnTask(void *pContext) {
+    SpawnContext *pSpawnContext = (SpawnContext *)pContext;
+
+    // Gives the async threads time to finish if the pool is being destroyed
+    std::this_thread::sleep_for(50ms);
+
+    for (uint32_t i = 0; i < pSpawnContext->numChildren; ++i)
+        foeScheduleAsyncTask(pSpawnContext->pool, countTask, pSpawnContext->pTaskCount);
+
+    ++(*pSpawnContext->pTaskCount);
+}
+
 } // namespace
 
 TEST_CASE("SplitThreadPool - Creating the pool") {
@@ -201,6 +236,50 @@ TEST_CASE("SplitThreadPool - Waiting on all tasks") {
     foeDestroyThreadPool(pool);
 }
 
+TEST_CASE("SplitThreadPool - Timed waits") {
+    foeSplitThreadPool pool{FOE_NULL_HANDLE};
+    REQUIRE(foeCreateThreadPool(numThreads, numThreads, &pool).value == FOE_SUCCESS);
+
+    SECTION("Waiting with no tasks succeeds immediately, even with a zero timeout") {
+        CHECK(foeTimedWaitSyncThreads(pool, 0).value == FOE_SUCCESS);
+        CHECK(foeTimedWaitAsyncThreads(pool, 0).value == FOE_SUCCESS);
+        CHECK(foeTimedWaitAllThreads(pool, 0).value == FOE_SUCCESS);
+    }
+
+    SECTION("Waiting on blocked tasks times out") {
+        pauseThreads = true;
+
+        SECTION("Sync") {
+            REQUIRE(foeScheduleSyncTask(pool, waitTask, nullptr).value == FOE_SUCCESS);
+
+            foeEasySteadyClock timer;
+            CHECK(foeTimedWaitSyncThreads(pool, 20'000'000).value == FOE_TIMEOUT);
+            timer.update();
+
+            CHECK(timer.elapsed<std::chrono::milliseconds>().count() >= 20);
+            CHECK(foeTimedWaitAsyncThreads(pool, 0).value == FOE_SUCCESS);
+            CHECK(foeTimedWaitAllThreads(pool, 1'000'000).value == FOE_TIMEOUT);
+        }
+        SECTION("Async") {
+            REQUIRE(foeScheduleAsyncTask(pool, waitTask, nullptr).value == FOE_SUCCESS);
+
+            foeEasySteadyClock timer;
+            CHECK(foeTimedWaitAsyncThreads(pool, 20'000'000).value == FOE_TIMEOUT);
+            timer.update();
+
+            CHECK(timer.elapsed<std::chrono::milliseconds>().count() >= 20);
+            CHECK(foeTimedWaitSyncThreads(pool, 0).value == FOE_SUCCESS);
+            CHECK(foeTimedWaitAllThreads(pool, 1'000'000).value == FOE_TIMEOUT);
+        }
+
+        pauseThreads = false;
+
+        CHECK(foeTimedWaitAllThreads(pool, UINT64_MAX).value == FOE_SUCCESS);
+    }
+
+    foeDestroyThreadPool(pool);
+}
+
 TEST_CASE("SplitThreadPool - Destroying pool awaits completion of all tasks") {
     foeSplitThreadPool pool{FOE_NULL_HANDLE};
     REQUIRE(foeCreateThreadPool(numThreads, numThreads, &pool).value == FOE_SUCCESS);
@@ -220,4 +299,84 @@ TEST_CASE("SplitThreadPool - Destroying pool awaits completion of all tasks") {
     CHECK(taskCount == 10 * numThreads * 2);
     CHECK(timer.elapsed<std::chrono::milliseconds>().count() >=
           std::chrono::milliseconds(100).count());
-}
\ No newline at end of file
+}
+
+TEST_CASE("SplitThreadPool - Destroying pool runs async tasks scheduled by the last sync tasks") {
+    foeSplitThreadPool pool{FOE_NULL_HANDLE};
+    REQUIRE(foeCreateThreadPool(numThreads, 1, &pool).value == FOE_SUCCESS);
+
+    std::atomic_int taskCount = 0;
+    SpawnContext spawnContext{
+        .pool = pool,
+        .numChildren = 100,
+        .pTaskCount = &taskCount,
+    };
+
+    for (int i = 0; i < numThreads; ++i)
+        REQUIRE(foeScheduleSyncTask(pool, delayedAsyncSpawnTask, &spawnContext).value ==
+                FOE_SUCCESS);
+
+    foeDestroyThreadPool(pool);
+
+    CHECK(taskCount == numThreads * (100 + 1));
+}
+
+TEST_CASE("SplitThreadPool - Tasks scheduled from within running tasks") {
+    foeSplitThreadPool pool{FOE_NULL_HANDLE};
+    REQUIRE(foeCreateThreadPool(numThreads, numThreads, &pool).value == FOE_SUCCESS);
+
+    std::atomic_int taskCount = 0;
+    SpawnContext spawnContext{
+        .pool = pool,
+        .numChildren = 1000,
+        .pTaskCount = &taskCount,
+    };
+
+    SECTION("Spawned from sync tasks") {
+        for (int i = 0; i < 10; ++i)
+            REQUIRE(foeScheduleSyncTask(pool, spawnTask, &spawnContext).value == FOE_SUCCESS);
+    }
+    SECTION("Spawned from async tasks") {
+        for (int i = 0; i < 10; ++i)
+            REQUIRE(foeScheduleAsyncTask(pool, spawnTask, &spawnContext).value == FOE_SUCCESS);
+    }
+
+    REQUIRE(foeWaitAllThreads(pool).value == FOE_SUCCESS);
+
+    CHECK(taskCount == 10 * 1000 + 10);
+    CHECK(foeNumQueuedSyncTasks(pool) == 0);
+    CHECK(foeNumQueuedAsyncTasks(pool) == 0);
+
+    foeDestroyThreadPool(pool);
+}
+
+TEST_CASE("SplitThreadPool - Throughput scaling", "[.][benchmark]") {
+    uint32_t const maxThreads = std::max(std::thread::hardware_concurrency(), 1U);
+
+    for (uint32_t syncThreads = 1; syncThreads <= maxThreads; syncThreads *= 2) {
+        foeSplitThreadPool pool{FOE_NULL_HANDLE};
+        REQUIRE(foeCreateThreadPool(syncThreads, 1, &pool).value == FOE_SUCCESS);
+
+        std::atomic_int taskCount = 0;
+        SpawnContext spawnContext{
+            .pool = pool,
+            .numChildren = 100,
+            .pTaskCount = &taskCount,
+        };
+        std::string const threadStr = std::to_string(syncThreads) + " sync threads";
+
+        BENCHMARK("10k external tasks - " + threadStr) {
+            for (int i = 0; i < 10000; ++i)
+                foeScheduleSyncTask(pool, countTask, &taskCount);
+            return foeWaitAllThreads(pool);
+        };
+
+        BENCHMARK("100x100 nested tasks - " + threadStr) {
+            for (int i = 0; i < 100; ++i)
+                foeScheduleSyncTask(pool, spawnTask, &spawnContext);
+            return foeWaitAllThreads(pool);
+        };
+
+        foeDestroyThreadPool(pool);
+    }
+}
@@ -0,0 +1,218 @@
+// Copyright (C) 2026 George Cave.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <foe/split_thread_pool.h>
+#include <foe/task_group.h>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+void countTask(void *pContext) {
+    std::this_thread::sleep_for(1ms);
+
+    std::atomic_int *pTaskCount = (std::atomic_int *)pContext;
+    ++(*pTaskCount);
+}
+
+struct OrderContext {
+    std::atomic_int *pCounter;
+    int observed;
+};
+
+// Records how many tasks had completed when this one ran
+void orderTask(void *pContext) {
+    OrderContext *pOrderContext = (OrderContext *)pContext;
+    pOrderContext->observed = pOrderContext->pCounter->load();
+}
+
+std::atomic_bool pauseTasks = true;
+
+void pauseTask(void *) {
+    while (pauseTasks)
+        std::this_thread::sleep_for(1ms);
+}
+
+} // namespace
+
+TEST_CASE("TaskGroup - Scheduling and waiting") {
+    foeSplitThreadPool pool{FOE_NULL_HANDLE};
+    foeTaskGroup taskGroup{FOE_NULL_HANDLE};
+    std::atomic_int taskCount = 0;
+
+    REQUIRE(foeCreateThreadPool(2, 2, &pool).value == FOE_SUCCESS);
+    REQUIRE(foeCreateTaskGroup(pool, &taskGroup).value == FOE_SUCCESS);
+
+    SECTION("An open group with no tasks is not complete") {
+        CHECK(foeTimedWaitTaskGroup(taskGroup, 0).value == FOE_TIMEOUT);
+
+        foeTaskGroupClose(taskGroup);
+
+        CHECK(foeTimedWaitTaskGroup(taskGroup, 0).value == FOE_SUCCESS);
+    }
+
+    SECTION("Waiting returns once all sync and async tasks of the group complete") {
+        for (int i = 0; i < 20; ++i) {
+            REQUIRE(foeTaskGroupScheduleSyncTask(taskGroup, countTask, &taskCount).value ==
+                    FOE_SUCCESS);
+            REQUIRE(foeTaskGroupScheduleAsyncTask(taskGroup, countTask, &taskCount).value ==
+                    FOE_SUCCESS);
+        }
+        foeTaskGroupClose(taskGroup);
+
+        REQUIRE(foeWaitTaskGroup(taskGroup).value == FOE_SUCCESS);
+        CHECK(taskCount == 40);
+    }
+
+    SECTION("Waiting on a group is unaffected by other tasks on the pool") {
+        pauseTasks = true;
+        REQUIRE(foeScheduleAsyncTask(pool, pauseTask, nullptr).value == FOE_SUCCESS);
+
+        REQUIRE(foeTaskGroupScheduleSyncTask(taskGroup, countTask, &taskCount).value ==
+                FOE_SUCCESS);
+        foeTaskGroupClose(taskGroup);
+
+        REQUIRE(foeWaitTaskGroup(taskGroup).value == FOE_SUCCESS);
+        CHECK(taskCount == 1);
+        CHECK(foeTimedWaitAsyncThreads(pool, 0).value == FOE_TIMEOUT);
+
+        pauseTasks = false;
+    }
+
+    SECTION("Scheduling onto a closed group fails") {
+        foeTaskGroupClose(taskGroup);
+
+        CHECK(foeTaskGroupScheduleSyncTask(taskGroup, countTask, &taskCount).value ==
+              FOE_ERROR_TASK_GROUP_CLOSED);
+        CHECK(foeTaskGroupScheduleAsyncTask(taskGroup, countTask, &taskCount).value ==
+              FOE_ERROR_TASK_GROUP_CLOSED);
+    }
+
+    foeDestroyTaskGroup(taskGroup);
+    foeDestroyThreadPool(pool);
+}
+
+TEST_CASE("TaskGroup - Continuations") {
+    foeSplitThreadPool pool{FOE_NULL_HANDLE};
+    foeTaskGroup taskGroup{FOE_NULL_HANDLE};
+    std::atomic_int taskCount = 0;
+    OrderContext syncContinuation{.pCounter = &taskCount, .observed = -1};
+    OrderContext asyncContinuation{.pCounter = &taskCount, .observed = -1};
+
+    REQUIRE(foeCreateThreadPool(2, 2, &pool).value == FOE_SUCCESS);
+    REQUIRE(foeCreateTaskGroup(pool, &taskGroup).value == FOE_SUCCESS);
+
+    SECTION("Continuations added before completion run after all tasks") {
+        REQUIRE(foeTaskGroupAddSyncContinuation(taskGroup, orderTask, &syncContinuation).value ==
+                FOE_SUCCESS);
+        REQUIRE(foeTaskGroupAddAsyncContinuation(taskGroup, orderTask, &asyncContinuation).value ==
+                FOE_SUCCESS);
+
+        for (int i = 0; i < 10; ++i) {
+            REQUIRE(foeTaskGroupScheduleSyncTask(taskGroup, countTask, &taskCount).value ==
+                    FOE_SUCCESS);
+        }
+        foeTaskGroupClose(taskGroup);
+    }
+
+    SECTION("Continuations added after completion are scheduled immediately") {
+        for (int i = 0; i < 10; ++i) {
+            REQUIRE(foeTaskGroupScheduleSyncTask(taskGroup, countTask, &taskCount).value ==
+                    FOE_SUCCESS);
+        }
+        foeTaskGroupClose(taskGroup);
+        REQUIRE(foeWaitTaskGroup(taskGroup).value == FOE_SUCCESS);
+
+        REQUIRE(foeTaskGroupAddSyncContinuation(taskGroup, orderTask, &syncContinuation).value ==
+                FOE_SUCCESS);
+        REQUIRE(foeTaskGroupAddAsyncContinuation(taskGroup, orderTask, &asyncContinuation).value ==
+                FOE_SUCCESS);
+    }
+
+    foeDestroyTaskGroup(taskGroup);
+    REQUIRE(foeWaitAllThreads(pool).value == FOE_SUCCESS);
+    foeDestroyThreadPool(pool);
+
+    CHECK(syncContinuation.observed == 10);
+    CHECK(asyncContinuation.observed == 10);
+}
+
+TEST_CASE("TaskGroup - Dependencies") {
+    foeSplitThreadPool pool{FOE_NULL_HANDLE};
+    foeTaskGroup firstGroup{FOE_NULL_HANDLE};
+    foeTaskGroup secondGroup{FOE_NULL_HANDLE};
+    foeTaskGroup thirdGroup{FOE_NULL_HANDLE};
+    std::atomic_int taskCount = 0;
+    OrderContext secondContext{.pCounter = &taskCount, .observed = -1};
+    OrderContext thirdContext{.pCounter = &taskCount, .observed = -1};
+
+    REQUIRE(foeCreateThreadPool(2, 2, &pool).value == FOE_SUCCESS);
+    REQUIRE(foeCreateTaskGroup(pool, &firstGroup).value == FOE_SUCCESS);
+    REQUIRE(foeCreateTaskGroup(pool, &secondGroup).value == FOE_SUCCESS);
+    REQUIRE(foeCreateTaskGroup(pool, &thirdGroup).value == FOE_SUCCESS);
+
+    SECTION("Dependent tasks are held until the dependencies complete") {
+        // first -> second -> third, with third also directly depending on first
+        REQUIRE(foeTaskGroupAddDependency(secondGroup, firstGroup).value == FOE_SUCCESS);
+        REQUIRE(foeTaskGroupAddDependency(thirdGroup, firstGroup).value == FOE_SUCCESS);
+        REQUIRE(foeTaskGroupAddDependency(thirdGroup, secondGroup).value == FOE_SUCCESS);
+
+        REQUIRE(foeTaskGroupScheduleSyncTask(thirdGroup, orderTask, &thirdContext).value ==
+                FOE_SUCCESS);
+        REQUIRE(foeTaskGroupScheduleAsyncTask(secondGroup, countTask, &taskCount).value ==
+                FOE_SUCCESS);
+        REQUIRE(foeTaskGroupScheduleSyncTask(secondGroup, orderTask, &secondContext).value ==
+                FOE_SUCCESS);
+        for (int i = 0; i < 10; ++i) {
+            REQUIRE(foeTaskGroupScheduleSyncTask(firstGroup, countTask, &taskCount).value ==
+                    FOE_SUCCESS);
+        }
+
+        foeTaskGroupClose(thirdGroup);
+        foeTaskGroupClose(secondGroup);
+
+        // Nothing downstream can complete while the first group is open
+        std::this_thread::sleep_for(20ms);
+        CHECK(foeTimedWaitTaskGroup(secondGroup, 0).value == FOE_TIMEOUT);
+        CHECK(foeTimedWaitTaskGroup(thirdGroup, 0).value == FOE_TIMEOUT);
+        CHECK(secondContext.observed == -1);
+
+        foeTaskGroupClose(firstGroup);
+
+        REQUIRE(foeWaitTaskGroup(thirdGroup).value == FOE_SUCCESS);
+        CHECK(foeTimedWaitTaskGroup(firstGroup, 0).value == FOE_SUCCESS);
+        CHECK(foeTimedWaitTaskGroup(secondGroup, 0).value == FOE_SUCCESS);
+
+        CHECK(secondContext.observed >= 10);
+        CHECK(thirdContext.observed == 11);
+    }
+
+    SECTION("Depending on an already completed group does not block") {
+        foeTaskGroupClose(firstGroup);
+        REQUIRE(foeWaitTaskGroup(firstGroup).value == FOE_SUCCESS);
+
+        REQUIRE(foeTaskGroupAddDependency(secondGroup, firstGroup).value == FOE_SUCCESS);
+        REQUIRE(foeTaskGroupScheduleSyncTask(secondGroup, countTask, &taskCount).value ==
+                FOE_SUCCESS);
+        foeTaskGroupClose(secondGroup);
+
+        REQUIRE(foeWaitTaskGroup(secondGroup).value == FOE_SUCCESS);
+        CHECK(taskCount == 1);
+    }
+
+    SECTION("Adding a dependency to a closed group fails") {
+        foeTaskGroupClose(secondGroup);
+
+        CHECK(foeTaskGroupAddDependency(secondGroup, firstGroup).value ==
+              FOE_ERROR_TASK_GROUP_CLOSED);
+    }
+
+    foeDestroyTaskGroup(thirdGroup);
+    foeDestroyTaskGroup(secondGroup);
+    foeDestroyTaskGroup(firstGroup);
+    foeDestroyThreadPool(pool);
+}
@@ -1,4 +1,4 @@
-// Copyright (C) 2023 George Cave.
+// Copyright (C) 2023-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
@@ -11,7 +11,9 @@
 #include <foe/handle.h>
 #include <foe/result.h>
 
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -21,6 +23,30 @@ FOE_DEFINE_HANDLE(foeEcsComponentPool)
 
 typedef void (*PFN_foeEcsComponentDestructor)(void *);
 
+/** @brief Controls how the stored capacity of a component pool changes during maintenance
+ *
+ * When more capacity is needed, the pool grows to the largest of the expansion rate, the required
+ * count plus headroom, and the current capacity multiplied by the growth factor.
+ *
+ * To avoid repeatedly growing and shrinking, the shrink threshold should be comfortably below
+ * 100 / growthFactor.
+ */
+typedef struct foeEcsComponentPoolGrowthPolicy {
+    /// Multiplier of the current capacity when growing, 1 or less to only use the expansion rate
+    float growthFactor;
+    /// Free space to leave when resizing, as a percentage of the number of stored items
+    uint32_t minHeadroomPercent;
+    /// Shrinks to fit when fewer than this percentage of the capacity is used, 0 to never shrink
+    uint32_t shrinkThresholdPercent;
+} foeEcsComponentPoolGrowthPolicy;
+
+typedef struct foeEcsComponentPoolStatistics {
+    /// Number of times the stored data has been reallocated, either growing or shrinking
+    uint64_t reallocations;
+    /// Total bytes of IDs and component data copied or moved during maintenance
+    uint64_t bytesMoved;
+} foeEcsComponentPoolStatistics;
+
 FOE_ECS_EXPORT
 foeResultSet foeEcsCreateComponentPool(size_t initialCapacity,
                                        size_t expansionRate,
@@ -37,6 +63,18 @@ foeResultSet foeEcsComponentPoolMaintenance(foeEcsComponentPool componentPool);
 FOE_ECS_EXPORT
 void foeEcsComponentPoolExpansionRate(foeEcsComponentPool componentPool, size_t expansionRate);
 
+FOE_ECS_EXPORT
+void foeEcsComponentPoolGetGrowthPolicy(foeEcsComponentPool componentPool,
+                                        foeEcsComponentPoolGrowthPolicy *pGrowthPolicy);
+
+FOE_ECS_EXPORT
+void foeEcsComponentPoolSetGrowthPolicy(foeEcsComponentPool componentPool,
+                                        foeEcsComponentPoolGrowthPolicy const *pGrowthPolicy);
+
+FOE_ECS_EXPORT
+void foeEcsComponentPoolGetStatistics(foeEcsComponentPool componentPool,
+                                      foeEcsComponentPoolStatistics *pStatistics);
+
 FOE_ECS_EXPORT
 size_t foeEcsComponentPoolSize(foeEcsComponentPool componentPool);
 
@@ -46,18 +84,99 @@ foeEntityID const *foeEcsComponentPoolIdPtr(foeEcsComponentPool componentPool);
 FOE_ECS_EXPORT
 void *foeEcsComponentPoolDataPtr(foeEcsComponentPool componentPool);
 
+/** @brief Enables an index of the stored entities, for constant-time offset lookups
+ * @return FOE_ECS_SUCCESS on success, FOE_ECS_ERROR_OUT_OF_MEMORY if the index couldn't be built.
+ *
+ * The index is built from the currently stored entities, then kept up to date during each
+ * maintenance, where only the entries from the first removal or insertion onwards are updated.
+ *
+ * If the index can't be fully updated, lookups fall back to searching the stored IDs until it is
+ * rebuilt during a following maintenance.
+ */
+FOE_ECS_EXPORT
+foeResultSet foeEcsComponentPoolEnableOffsetIndex(foeEcsComponentPool componentPool);
+
+/** @brief Finds the offset of an entity within the stored IDs and data
+ * @param entity Entity to find.
+ * @param pOffset Set to the offset of the entity, if it is stored.
+ * @return True if the entity is stored, false otherwise.
+ *
+ * Uses the offset index if it has been enabled, otherwise a binary search of the stored IDs.
+ */
+FOE_ECS_EXPORT
+bool foeEcsComponentPoolFindOffset(foeEcsComponentPool componentPool,
+                                   foeEntityID entity,
+                                   size_t *pOffset);
+
+/** @brief Enables tracking of when each stored component was last changed
+ *
+ * Each stored component keeps the version at which it was last marked as changed or inserted,
+ * which is carried along as components shift during maintenance. Components already stored when
+ * enabled are treated as changed at the current version.
+ *
+ * Consumers keep the last version they have processed up to, and each time they process changes
+ * they first advance the version, then scan for components changed since their previous one. That
+ * way, changes made while they are scanning are picked up the next time around.
+ *
+ * Consumers that also mark changes themselves, and don't want to process their own, instead scan
+ * first and then advance the version after their own changes are marked. Changes made by others
+ * while they are updating end up at the same version as their own, so are skipped as well.
+ */
+FOE_ECS_EXPORT
+void foeEcsComponentPoolEnableChangeTracking(foeEcsComponentPool componentPool);
+
+/** @brief Returns the current change version, then advances it
+ *
+ * Components marked as changed from here on will have a newer version than the one returned.
+ * Versions wrap around, so a consumer must not go more than 2^31 advances without checking.
+ */
+FOE_ECS_EXPORT
+uint32_t foeEcsComponentPoolAdvanceChangeVersion(foeEcsComponentPool componentPool);
+
+/** @brief Marks the component stored at the offset as changed at the current version
+ * @note Does nothing if change tracking has not been enabled.
+ */
+FOE_ECS_EXPORT
+void foeEcsComponentPoolMarkChanged(foeEcsComponentPool componentPool, size_t offset);
+
+/** @brief Finds the next component changed after the given version
+ * @param version Version to find changes made after.
+ * @param offset Offset to start searching from.
+ * @return The offset of the next changed component at or after the given offset, or the pool size
+ * if there are no more, which is always the case if change tracking has not been enabled.
+ */
+FOE_ECS_EXPORT
+size_t foeEcsComponentPoolNextChanged(foeEcsComponentPool componentPool,
+                                      uint32_t version,
+                                      size_t offset);
+
 FOE_ECS_EXPORT
 size_t foeEcsComponentPoolCapacity(foeEcsComponentPool componentPool);
 
 FOE_ECS_EXPORT
 void foeEcsComponentPoolReserve(foeEcsComponentPool componentPool, size_t capacity);
 
+/// Total capacity for staged insertions, across all threads
 FOE_ECS_EXPORT
 size_t foeEcsComponentPoolInsertCapacity(foeEcsComponentPool componentPool);
 
+/** @brief Reserves space for insertions staged by the calling thread
+ *
+ * Insertions are staged separately per thread so that threads don't contend with each other, so
+ * each thread about to insert many items should make its own reservation.
+ */
 FOE_ECS_EXPORT
 void foeEcsComponentPoolReserveInsertCapacity(foeEcsComponentPool componentPool, size_t capacity);
 
+/** @brief Stages the entity's component data to be inserted during the next maintenance
+ *
+ * If the same entity is staged more than once before maintenance, only one is inserted and the
+ * others are destroyed. From the same thread, the last one staged is kept. From different threads,
+ * which is kept depends on the order of the threads' staging shards, not the order the insertions
+ * were made in, so callers that need a particular one must not stage it from multiple threads.
+ *
+ * Entities already in the pool are not replaced, unless also staged for removal in the same pass.
+ */
 FOE_ECS_EXPORT
 foeResultSet foeEcsComponentPoolInsert(foeEcsComponentPool componentPool,
                                        foeEntityID entity,
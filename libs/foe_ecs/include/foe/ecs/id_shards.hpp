@@ -0,0 +1,54 @@
+// Copyright (C) 2026 George Cave.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef FOE_ECS_ID_SHARDS_HPP
+#define FOE_ECS_ID_SHARDS_HPP
+
+#include <foe/ecs/id.h>
+
+#include <algorithm>
+#include <stdint.h>
+#include <vector>
+
+/** @brief Returns which of a set of shards an ID belongs to, by the low bits of its index
+ * @tparam ShardCount Number of shards, must be a power of two.
+ *
+ * Sequentially assigned IDs are spread evenly across the shards this way.
+ */
+template <uint32_t ShardCount>
+inline uint32_t foeIdGetShardIndex(foeId id) {
+    static_assert((ShardCount & (ShardCount - 1)) == 0, "ShardCount must be a power of two");
+
+    return foeIdGetIndex(id) & (ShardCount - 1);
+}
+
+/** @brief Groups a set of IDs by their shard, so each shard only needs to be visited once
+ * @tparam ShardCount Number of shards, must be a power of two.
+ * @param count Number of IDs in pIDs.
+ * @param pIDs IDs to group, which may contain duplicates.
+ * @param pShardOffsets Written with where each shard's entries start in grouped, with the last
+ * element being the total count.
+ * @param grouped Resized and written with the indices into pIDs, grouped by shard and in their
+ * original order within each shard.
+ */
+template <uint32_t ShardCount>
+void foeIdGroupByShard(uint32_t count,
+                       foeId const *pIDs,
+                       uint32_t pShardOffsets[ShardCount + 1],
+                       std::vector<uint32_t> &grouped) {
+    std::fill_n(pShardOffsets, ShardCount + 1, 0);
+    for (uint32_t i = 0; i < count; ++i)
+        ++pShardOffsets[foeIdGetShardIndex<ShardCount>(pIDs[i]) + 1];
+    for (uint32_t i = 0; i < ShardCount; ++i)
+        pShardOffsets[i + 1] += pShardOffsets[i];
+
+    uint32_t nextOffsets[ShardCount];
+    std::copy_n(pShardOffsets, ShardCount, nextOffsets);
+
+    grouped.resize(count);
+    for (uint32_t i = 0; i < count; ++i)
+        grouped[nextOffsets[foeIdGetShardIndex<ShardCount>(pIDs[i])]++] = i;
+}
+
+#endif // FOE_ECS_ID_SHARDS_HPP
@@ -1,4 +1,4 @@
-// Copyright (C) 2021-2022 George Cave.
+// Copyright (C) 2021-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
@@ -16,15 +16,24 @@ extern "C" {
 
 typedef void (*PFN_foeEcsForEachCall)(void *, foeId);
 
+/// A run of consecutive indices
+typedef struct foeIdIndexRange {
+    foeIdIndex first;
+    uint32_t count;
+} foeIdIndexRange;
+
+/// Number of times an index has been freed, distinguishing recycled uses of the same index
+typedef uint32_t foeIdGeneration;
+
 /** @brief Used to generate/free/manage indices within a group
  *
  * For each group, a particular index should be unique, representing a single specific object in the
  * simulation.
  *
  * At it's heart, to determine unique IDs it looks at two items, the first is the set of recycled
- * indices which is held in a queue, access to which is guarded by a mutex. If there are no items
- * that have been freed are available, it will move on to using the nextFreeID, which is a value
- * that has never been entered into circulation before.
+ * indices which is held in a ring buffer, access to which is guarded by a mutex. If there are no
+ * items that have been freed are available, it will move on to using the nextFreeID, which is a
+ * value that has never been entered into circulation before.
  *
  * A fresh indexes starts under the assumption that no indices exist. To change this, the
  * importState function can be called, or to otherwise get the current state exportState can be
@@ -32,7 +41,13 @@ typedef void (*PFN_foeEcsForEachCall)(void *, foeId);
  *
  * To determine the totality of all IDs that are currently 'active', it will be all IDs from
  * foeIdIndexMinValue to the nextFreeID, minus any recycled IDs. This information can be retrieved
- * using the exportState function.
+ * using the exportState function. A bitmap of the recycled indices is also kept, so the live ones
+ * can be iterated or exported as ranges without stepping over each recycled index.
+ *
+ * Each index also has a generation, incremented each time it is freed. Anything holding on to an
+ * ID can keep the generation it saw alongside it, and later compare it against the current one to
+ * cheaply tell if the ID was freed, and possibly reused, in the meantime. Generations are runtime
+ * state only, they are not imported or exported.
  *
  * @note This class is thread-safe.
  */
@@ -50,15 +65,72 @@ foeIdGroup foeEcsIndexesGetGroupID(foeEcsIndexes indexes);
 FOE_ECS_EXPORT
 foeResultSet foeEcsGenerateID(foeEcsIndexes indexes, foeId *pID);
 
+/** @brief Generates several IDs at once
+ * @param idCount Number of IDs to generate.
+ * @param pIDs Receives the generated IDs.
+ * @return FOE_ECS_SUCCESS on success, FOE_ECS_ERROR_OUT_OF_INDEXES if the group doesn't have enough
+ * indices left, in which case none are generated.
+ *
+ * Recycled indices are used first, with any remainder taken as a single block of new indices,
+ * all while only taking the lock once. If there is nothing to recycle, the new indices are
+ * reserved without taking the lock at all.
+ */
+FOE_ECS_EXPORT
+foeResultSet foeEcsGenerateIDs(foeEcsIndexes indexes, uint32_t idCount, foeId *pIDs);
+
 FOE_ECS_EXPORT
 foeResultSet foeEcsFreeID(foeEcsIndexes indexes, foeId id);
 
+/** @brief Frees the IDs for reuse, advancing the generation of each of their indices
+ * @return FOE_ECS_SUCCESS on success. If any of the IDs are invalid, or the generations couldn't be
+ * stored with FOE_ECS_ERROR_OUT_OF_MEMORY, none of them are freed. FOE_ECS_ERROR_ID_ALREADY_FREED
+ * if any of the IDs are not currently live, including the same ID appearing more than once.
+ */
 FOE_ECS_EXPORT
 foeResultSet foeEcsFreeIDs(foeEcsIndexes indexes, uint32_t idCount, foeId const *pIDs);
 
+/** @brief Returns the current generation of the ID's index
+ *
+ * Indices that have never been freed are at generation 0. The group of the ID is not checked.
+ *
+ * Can be called at any time from any thread without blocking.
+ */
+FOE_ECS_EXPORT
+foeIdGeneration foeEcsGetIDGeneration(foeEcsIndexes indexes, foeId id);
+
+/// Returns the number of currently live IDs, those generated and not since freed
+FOE_ECS_EXPORT
+uint32_t foeEcsGetLiveIDCount(foeEcsIndexes indexes);
+
+/** @brief Exports the live indices as runs of consecutive indices, in ascending order
+ * @param pRangeCount Number of ranges available in pRanges, set to the number of ranges written.
+ * @param pRanges Receives the ranges. If null, pRangeCount is set to the total number of ranges.
+ * @return FOE_ECS_SUCCESS if all ranges were returned, FOE_ECS_INCOMPLETE if there are more ranges
+ * than fit.
+ *
+ * Takes time proportional to the number of ranges plus a single pass over the recycled bitmap,
+ * rather than to each index ever generated.
+ */
+FOE_ECS_EXPORT
+foeResultSet foeEcsExportLiveIndexRanges(foeEcsIndexes indexes,
+                                         uint32_t *pRangeCount,
+                                         foeIdIndexRange *pRanges);
+
+/** @brief Calls the function with each live ID, in ascending order
+ *
+ * The live IDs are taken as a snapshot beforehand, so the call is free to use the indexes itself.
+ */
 FOE_ECS_EXPORT
 void foeEcsForEachID(foeEcsIndexes indexes, PFN_foeEcsForEachCall forEachCall, void *pCallContext);
 
+/** @brief Replaces the state of the indexes
+ * @param nextNewIndex Next index to be generated, with all those below it not recycled being live.
+ * @param recycledCount Number of indices in pRecycledIndexes.
+ * @param pRecycledIndexes Indices to be reused before new ones, in the order to be reused.
+ * @return FOE_ECS_SUCCESS on success. FOE_ECS_ERROR_INDEX_BELOW_MINIMUM if nextNewIndex or a
+ * recycled index is below the minimum, FOE_ECS_ERROR_INDEX_ABOVE_GENERATED if a recycled index is
+ * not below nextNewIndex, in which cases the indexes are left unchanged.
+ */
 FOE_ECS_EXPORT
 foeResultSet foeEcsImportIndexes(foeEcsIndexes indexes,
                                  foeIdIndex nextNewIndex,
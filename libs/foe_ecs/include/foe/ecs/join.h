@@ -0,0 +1,65 @@
+// Copyright (C) 2026 George Cave.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef FOE_ECS_JOIN_H
+#define FOE_ECS_JOIN_H
+
+#include <foe/ecs/component_pool.h>
+#include <foe/ecs/export.h>
+#include <foe/ecs/id.h>
+#include <foe/result.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Maximum number of component pools that can be joined together at once
+#define FOE_ECS_MAX_JOIN_POOLS 8
+
+/** @brief Returns the index of the pool with the fewest stored entities
+ *
+ * As every joined entity must be in every pool, the smallest pool is the one to drive a join,
+ * with the others only being searched for its entities.
+ */
+FOE_ECS_EXPORT
+uint32_t foeEcsJoinDriver(uint32_t poolCount, foeEcsComponentPool const *pPools);
+
+/** @brief Finds the entities stored in all of the given pools, along with their offset in each
+ * @param poolCount Number of pools to join, from 1 to FOE_ECS_MAX_JOIN_POOLS.
+ * @param pPools Pools to join.
+ * @param driver Index of the pool whose stored entities are walked, see foeEcsJoinDriver.
+ * @param pDriverOffset Offset within the driver pool to continue from, updated to where the next
+ * call should continue from.
+ * @param driverEndOffset Offset within the driver pool to stop at.
+ * @param pCount Number of entities that can be written, set to the number actually written.
+ * @param pEntities Receives the joined entities, in ascending order.
+ * @param pOffsets Receives the offset of each joined entity in each pool, with the offset of the
+ * i-th entity in pool p at pOffsets[i * poolCount + p].
+ * @return FOE_ECS_SUCCESS if the end offset was reached, FOE_ECS_INCOMPLETE if there was not enough
+ * room for all of the joined entities, in which case it should be called again to continue.
+ *
+ * The other pools are searched by galloping forwards from the last match, so that each is only
+ * walked once no matter how many entities are joined.
+ *
+ * Splitting the range of the driver pool into chunks, each joined separately, allows the work to be
+ * spread across threads.
+ */
+FOE_ECS_EXPORT
+foeResultSet foeEcsJoin(uint32_t poolCount,
+                        foeEcsComponentPool const *pPools,
+                        uint32_t driver,
+                        size_t *pDriverOffset,
+                        size_t driverEndOffset,
+                        uint32_t *pCount,
+                        foeEntityID *pEntities,
+                        size_t *pOffsets);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FOE_ECS_JOIN_H
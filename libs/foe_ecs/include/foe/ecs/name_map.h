@@ -1,4 +1,4 @@
-// Copyright (C) 2021-2022 George Cave.
+// Copyright (C) 2021-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
@@ -24,8 +24,9 @@ extern "C" {
  * IDs and strings.
  *
  * To aid this, all operations are synchronized through a shared mutex, meaning operations on this
- * are slower, thus why it is meant only for development purposes, however to speed things up
- * slightly there are maps for going both ways.
+ * are slower, thus why it is meant only for development purposes. To speed things up, names are
+ * stored together in a single string pool, with an open-addressed hash table for finding IDs by
+ * name and a vector sorted by ID for finding names by ID.
  *
  * It is also meant to be universal for a simulation, ie. each ID or editorName must be unique in
  * the map and, hopefully, simulation.
@@ -34,6 +35,12 @@ extern "C" {
  */
 FOE_DEFINE_HANDLE(foeEcsNameMap)
 
+/// An ID and its name, as added together by foeEcsNameMapAddMany
+typedef struct foeEcsNameMapEntry {
+    foeId id;
+    char const *pName;
+} foeEcsNameMapEntry;
+
 FOE_ECS_EXPORT
 foeResultSet foeEcsCreateNameMap(foeEcsNameMap *pNameMap);
 
@@ -52,6 +59,22 @@ foeResultSet foeEcsNameMapFindName(foeEcsNameMap nameMap,
 FOE_ECS_EXPORT
 foeResultSet foeEcsNameMapAdd(foeEcsNameMap nameMap, foeId id, char const *pName);
 
+/** @brief Adds many IDs and names at once, such as when importing
+ * @param count Number of entries to add.
+ * @param pEntries Entries to add.
+ * @return FOE_ECS_SUCCESS if all were added, otherwise the error of the first entry that failed.
+ *
+ * Each entry is checked as with foeEcsNameMapAdd, with any that fail skipped while the rest are
+ * still added. Entries are processed in order of ID, so where two entries share a name, the one
+ * with the lower ID is added.
+ *
+ * Storage is reserved for all entries up front and the lock is only taken once.
+ */
+FOE_ECS_EXPORT
+foeResultSet foeEcsNameMapAddMany(foeEcsNameMap nameMap,
+                                  uint32_t count,
+                                  foeEcsNameMapEntry const *pEntries);
+
 FOE_ECS_EXPORT
 foeResultSet foeEcsNameMapUpdate(foeEcsNameMap nameMap, foeId id, char const *pName);
 
@@ -1,4 +1,4 @@
-// Copyright (C) 2022-2025 George Cave.
+// Copyright (C) 2022-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
@@ -28,6 +28,7 @@ typedef enum foeEcsResult {
     FOE_ECS_ERROR_ID_ALREADY_EXISTS = -1000001010,
     FOE_ECS_ERROR_NAME_ALREADY_EXISTS = -1000001011,
     FOE_ECS_ERROR_NO_MATCH = -1000001012,
+    FOE_ECS_ERROR_ID_ALREADY_FREED = -1000001013,
 } foeEcsResult;
 
 FOE_ECS_EXPORT
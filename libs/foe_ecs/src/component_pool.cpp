@@ -1,15 +1,17 @@
-// Copyright (C) 2023-2025 George Cave.
+// Copyright (C) 2023-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
 #include <foe/ecs/component_pool.h>
 
+#include "galloping_search.hpp"
 #include "result.h"
 
 #include <algorithm>
 #include <atomic>
 #include <cstring>
 #include <mutex>
+#include <new>
 #include <vector>
 
 namespace {
@@ -27,12 +29,60 @@ struct InsertOffsets {
     size_t dstOffset;
 };
 
+/** @brief Insertions and removals staged by a subset of threads
+ *
+ * Each thread always stages into the same shard, so its changes stay in the order they were made,
+ * while threads on different shards never wait on each other or share cache lines.
+ */
+struct alignas(64) StagingShard {
+    std::mutex sync;
+    DataSet toInsertData;
+    std::vector<foeEntityID> toRemoveIDs;
+};
+
+constexpr size_t cStagingShardCount = 16;
+
+std::atomic_uint32_t nextStagingShard{0};
+
+thread_local uint32_t const tStagingShard =
+    nextStagingShard.fetch_add(1, std::memory_order_relaxed) % cStagingShardCount;
+
+constexpr size_t cOffsetIndexPageBits = 10;
+constexpr size_t cOffsetIndexPageSize = size_t(1) << cOffsetIndexPageBits;
+
+/** @brief Paged sparse index from stored entity IDs to their offset in the stored data
+ *
+ * Each ID group has its own set of pages, covering the index bits of IDs, with pages only being
+ * allocated once an ID within them is stored. Entries aren't cleared when entities are removed,
+ * instead lookups check the ID stored at the found offset, so only the entries of entities whose
+ * offset changed need to be updated during maintenance.
+ */
+struct OffsetIndex {
+    bool enabled;
+    /// If false, entries may be out of date and it is to be rebuilt fully on the next maintenance
+    bool valid;
+    std::vector<uint32_t *> groupPages[foeIdGroupMaxValue + 1];
+};
+
+/// Version at which each stored entry was last changed, kept parallel to the stored data
+struct ChangeTracking {
+    bool enabled;
+    std::atomic_uint32_t version;
+    std::vector<uint32_t> versions;
+    // Reused between maintenance cycles to rebuild versions into
+    std::vector<uint32_t> spareVersions;
+};
+
 struct ComponentPool {
     // Regular Pool
     DataSet storedData;
+    OffsetIndex offsetIndex;
+    ChangeTracking changeTracking;
+
+    // Staged insertions and removals, array of cStagingShardCount
+    StagingShard *pStagingShards;
 
-    // To Insert
-    std::mutex toInsertSync;
+    // To Insert, gathered from the staging shards during maintenance
     DataSet toInsertData;
     std::vector<InsertOffsets> toInsertOffsets;
     // Inserted
@@ -40,11 +90,12 @@ struct ComponentPool {
     size_t insertedCount;
     size_t *pInsertedOffsets;
 
-    // To Remove
-    std::mutex toRemoveSync;
+    // To Remove, gathered from the staging shards during maintenance
     std::vector<foeEntityID> toRemoveIDs;
     // Removed
     DataSet removedData;
+    // Stored offsets of the entries being removed during maintenance
+    std::vector<size_t> removeOffsets;
 
     // Entity Lists
     std::vector<foeEcsEntityList> modifiedEntityLists;
@@ -55,7 +106,9 @@ struct ComponentPool {
         dataDestructor;           // Function to call when component data is being destroyed
     size_t expansionRate;         // The linear rate at which the storage capacity increases
     size_t desiredCapacity;       // The desired minimum capacity, enforced during maintenance cycle
-    size_t desiredInsertCapacity; // Desired capacity to items toInsert, to reduce reallocations
+    foeEcsComponentPoolGrowthPolicy growthPolicy;
+
+    foeEcsComponentPoolStatistics statistics;
 };
 
 FOE_DEFINE_HANDLE_CASTS(component_pool, ComponentPool, foeEcsComponentPool)
@@ -84,7 +137,7 @@ bool allocDataSet(size_t capacity, size_t dataSize, DataSet *pDataSet) {
     };
 
     if (newDataSet.pIDs == nullptr || newDataSet.pData == nullptr) {
-        deallocDataSet(pDataSet);
+        deallocDataSet(&newDataSet);
         return false;
     } else {
         *pDataSet = newDataSet;
@@ -92,122 +145,239 @@ bool allocDataSet(size_t capacity, size_t dataSize, DataSet *pDataSet) {
     }
 }
 
-void moveData(DataSet *pDstPool,
-              size_t dstOffset,
-              DataSet *pSrcPool,
-              size_t srcOffset,
-              size_t count,
-              size_t dataSize) {
+/// @return Number of bytes moved
+size_t moveData(DataSet *pDstPool,
+                size_t dstOffset,
+                DataSet *pSrcPool,
+                size_t srcOffset,
+                size_t count,
+                size_t dataSize) {
     if (count == 0)
-        return;
+        return 0;
 
     // IDs
     memmove(pDstPool->pIDs + dstOffset, pSrcPool->pIDs + srcOffset, count * sizeof(foeEntityID));
     // Data
     memmove((uint8_t *)(pDstPool->pData) + dstOffset * dataSize,
             (uint8_t *)(pSrcPool->pData) + srcOffset * dataSize, count * dataSize);
+
+    return count * (sizeof(foeEntityID) + dataSize);
 }
 
-foeResultSet removePass(ComponentPool *pComponentPool) {
-    // Acquire lock, and get the data we're going to use, then unlock it to allow
-    // new incoming removals
-    pComponentPool->toRemoveSync.lock();
+/// @return Number of bytes copied
+size_t copyData(DataSet *pDstPool,
+                size_t dstOffset,
+                DataSet const *pSrcPool,
+                size_t srcOffset,
+                size_t count,
+                size_t dataSize) {
+    if (count == 0)
+        return 0;
+
+    // IDs
+    memcpy(pDstPool->pIDs + dstOffset, pSrcPool->pIDs + srcOffset, count * sizeof(foeEntityID));
+    // Data
+    memcpy((uint8_t *)(pDstPool->pData) + dstOffset * dataSize,
+           (uint8_t *)(pSrcPool->pData) + srcOffset * dataSize, count * dataSize);
+
+    return count * (sizeof(foeEntityID) + dataSize);
+}
 
-    auto toRemoveIDs = std::move(pComponentPool->toRemoveIDs);
+/** @brief Reallocates a data set to a larger capacity, keeping its current contents
+ * @return True on success, false if the allocation failed, in which case the set is unchanged.
+ */
+bool growDataSet(size_t capacity, size_t dataSize, DataSet *pDataSet) {
+    DataSet newDataSet = {};
+    if (!allocDataSet(capacity, dataSize, &newDataSet))
+        return false;
 
-    pComponentPool->toRemoveSync.unlock();
+    copyData(&newDataSet, 0, pDataSet, 0, pDataSet->count, dataSize);
+    newDataSet.count = pDataSet->count;
 
-    // If there aren't any to remove, leave early
-    if (toRemoveIDs.empty())
-        return to_foeResult(FOE_ECS_SUCCESS);
+    deallocDataSet(pDataSet);
+    *pDataSet = newDataSet;
 
-    // Sort the IDs to be in-order
-    std::sort(toRemoveIDs.begin(), toRemoveIDs.end());
+    return true;
+}
 
-    // Prepare removed storage for new items, make sure it has enough capacity
-    if (pComponentPool->removedData.capacity < toRemoveIDs.size()) {
-        deallocDataSet(&pComponentPool->removedData);
-        pComponentPool->removedData = {};
+/** @brief Updates the offset index entries of all stored entities from the given offset onwards
+ * @return True on success, false if a page couldn't be allocated.
+ */
+bool updateOffsetIndex(ComponentPool *pComponentPool, size_t firstOffset) {
+    DataSet const *const pStoredData = &pComponentPool->storedData;
+
+    for (size_t offset = firstOffset; offset < pStoredData->count; ++offset) {
+        foeEntityID const entity = pStoredData->pIDs[offset];
+        std::vector<uint32_t *> &pages =
+            pComponentPool->offsetIndex.groupPages[entity >> foeIdGroupBitShift];
+        size_t const page = foeIdGetIndex(entity) >> cOffsetIndexPageBits;
+
+        if (page >= pages.size())
+            pages.resize(page + 1, nullptr);
+
+        if (pages[page] == nullptr) {
+            pages[page] = (uint32_t *)malloc(cOffsetIndexPageSize * sizeof(uint32_t));
+            if (pages[page] == nullptr)
+                return false;
+        }
 
-        if (!allocDataSet(toRemoveIDs.size(), pComponentPool->dataSize,
-                          &pComponentPool->removedData))
-            return to_foeResult(FOE_ECS_ERROR_OUT_OF_MEMORY);
+        pages[page][foeIdGetIndex(entity) & (cOffsetIndexPageSize - 1)] = (uint32_t)offset;
     }
 
-    foeEntityID const *pID = pComponentPool->storedData.pIDs;
-    foeEntityID const *const pStartID = pID;
-    foeEntityID const *const pEndID = pStartID + pComponentPool->storedData.count;
+    return true;
+}
+
+void freeOffsetIndex(OffsetIndex *pOffsetIndex) {
+    for (auto &pages : pOffsetIndex->groupPages) {
+        for (uint32_t *pPage : pages)
+            free(pPage);
+        pages.clear();
+    }
+}
 
-    foeEntityID const *pRemoveID = toRemoveIDs.data();
-    foeEntityID const *const pEndRemoveID = pRemoveID + toRemoveIDs.size();
+/** @brief Finds the offset of the entity in the stored data using the offset index
+ * @note The offset index must be enabled and valid
+ */
+bool findIndexedOffset(ComponentPool const *pComponentPool, foeEntityID entity, size_t *pOffset) {
+    std::vector<uint32_t *> const &pages =
+        pComponentPool->offsetIndex.groupPages[entity >> foeIdGroupBitShift];
+    size_t const page = foeIdGetIndex(entity) >> cOffsetIndexPageBits;
 
-    size_t removedCount = 0;
-    size_t lastShiftedOffset = 0;
+    if (page >= pages.size() || pages[page] == nullptr)
+        return false;
 
-    while (pID != pEndID && pRemoveID != pEndRemoveID) {
-        // If we haven't found the next item to remove yet, continue the search
-        pID = std::lower_bound(pID, pEndID, *pRemoveID);
-        if (pID == pEndID)
-            break;
+    // Entries of removed entities are left as they were, so the offset needs to be checked
+    size_t const offset = pages[page][foeIdGetIndex(entity) & (cOffsetIndexPageSize - 1)];
+    if (offset >= pComponentPool->storedData.count ||
+        pComponentPool->storedData.pIDs[offset] != entity)
+        return false;
 
-        if (*pID == *pRemoveID) {
-            // Move the removed entry out
-            size_t const offset = pID - pStartID;
-            moveData(&pComponentPool->removedData, removedCount, &pComponentPool->storedData,
-                     offset, 1, pComponentPool->dataSize);
-
-            // Move any other objects that need to be shifted down in the regular storage
-            if (lastShiftedOffset != 0) {
-                moveData(&pComponentPool->storedData, lastShiftedOffset - removedCount,
-                         &pComponentPool->storedData, lastShiftedOffset, offset - lastShiftedOffset,
-                         pComponentPool->dataSize);
-            }
+    *pOffset = offset;
+    return true;
+}
 
-            ++pID;
-            ++pRemoveID;
-            ++removedCount;
-            lastShiftedOffset = offset + 1;
-        } else {
-            // The ID is larger than the ID to remove, so the ID isn't in the pool, so skip it
-            ++pRemoveID;
+/** @brief Rebuilds the change versions to match the stored data after a maintenance pass
+ *
+ * Versions of the remaining entries are carried over in order, skipping the removed ones, while
+ * inserted entries are given the current version.
+ */
+void updateChangeVersions(ComponentPool *pComponentPool) {
+    ChangeTracking *const pChangeTracking = &pComponentPool->changeTracking;
+    std::vector<size_t> const &removeOffsets = pComponentPool->removeOffsets;
+
+    if (removeOffsets.empty() && pComponentPool->insertedCount == 0)
+        return;
+
+    std::vector<uint32_t> const &versions = pChangeTracking->versions;
+    std::vector<uint32_t> &newVersions = pChangeTracking->spareVersions;
+    newVersions.resize(pComponentPool->storedData.count);
+
+    uint32_t const currentVersion = pChangeTracking->version.load(std::memory_order_relaxed);
+
+    size_t const *pRemoveOffset = removeOffsets.data();
+    size_t const *const pEndRemoveOffset = pRemoveOffset + removeOffsets.size();
+
+    size_t const *pInsertedOffset = pComponentPool->pInsertedOffsets;
+    size_t const *const pEndInsertedOffset = pInsertedOffset + pComponentPool->insertedCount;
+
+    size_t srcOffset = 0;
+    for (size_t dstOffset = 0; dstOffset < newVersions.size(); ++dstOffset) {
+        if (pInsertedOffset != pEndInsertedOffset && *pInsertedOffset == dstOffset) {
+            newVersions[dstOffset] = currentVersion;
+            ++pInsertedOffset;
+            continue;
         }
+
+        while (pRemoveOffset != pEndRemoveOffset && *pRemoveOffset == srcOffset) {
+            ++pRemoveOffset;
+            ++srcOffset;
+        }
+
+        newVersions[dstOffset] = versions[srcOffset];
+        ++srcOffset;
     }
 
-    // Need to move any remaining objects
-    if (lastShiftedOffset != 0) {
-        moveData(&pComponentPool->storedData, lastShiftedOffset - removedCount,
-                 &pComponentPool->storedData, lastShiftedOffset,
-                 pComponentPool->storedData.count - lastShiftedOffset, pComponentPool->dataSize);
+    std::swap(pChangeTracking->versions, newVersions);
+}
+
+/** @brief Finds the stored offsets of the entities queued for removal
+ * @return FOE_ECS_SUCCESS on success, FOE_ECS_ERROR_OUT_OF_MEMORY if the removed storage could not
+ * be allocated.
+ *
+ * Offsets are placed into removeOffsets in ascending order, IDs not in the pool are ignored.
+ */
+foeResultSet findRemovals(ComponentPool *pComponentPool) {
+    // Take everything staged so far, new removals can continue being staged in the meantime
+    std::vector<foeEntityID> &toRemoveIDs = pComponentPool->toRemoveIDs;
+    toRemoveIDs.clear();
+
+    for (size_t i = 0; i < cStagingShardCount; ++i) {
+        StagingShard &shard = pComponentPool->pStagingShards[i];
+        std::scoped_lock lock{shard.sync};
+
+        if (toRemoveIDs.empty()) {
+            toRemoveIDs.swap(shard.toRemoveIDs);
+        } else {
+            toRemoveIDs.insert(toRemoveIDs.end(), shard.toRemoveIDs.begin(),
+                               shard.toRemoveIDs.end());
+            shard.toRemoveIDs.clear();
+        }
     }
 
-    pComponentPool->storedData.count -= removedCount;
-    pComponentPool->removedData.count = removedCount;
+    pComponentPool->removeOffsets.clear();
 
-    return to_foeResult(FOE_ECS_SUCCESS);
-}
+    // If there aren't any to remove, leave early
+    if (toRemoveIDs.empty())
+        return to_foeResult(FOE_ECS_SUCCESS);
 
-foeResultSet insertPass(ComponentPool *pComponentPool) {
-    // Acquire lock, and get the data we're going to use, then unlock it to allow
-    // new incoming insertions
-    pComponentPool->toInsertSync.lock();
+    // Sort the IDs to be in-order, often already the case when removing in bulk
+    if (!std::is_sorted(toRemoveIDs.begin(), toRemoveIDs.end()))
+        std::sort(toRemoveIDs.begin(), toRemoveIDs.end());
 
-    DataSet toInsertDataSet = pComponentPool->toInsertData;
-    pComponentPool->toInsertData = {};
-    std::vector<InsertOffsets> toInsertOffsets = std::move(pComponentPool->toInsertOffsets);
+    foeEntityID const *pID = pComponentPool->storedData.pIDs;
+    foeEntityID const *const pStartID = pID;
+    foeEntityID const *const pEndID = pStartID + pComponentPool->storedData.count;
 
-    pComponentPool->toInsertSync.unlock();
+    for (foeEntityID removeID : toRemoveIDs) {
+        pID = gallopingLowerBound(pID, pEndID, removeID);
+        if (pID == pEndID)
+            break;
 
-    // If there's nothing to actually insert, leave early
-    if (toInsertDataSet.count == 0) {
-        deallocDataSet(&toInsertDataSet);
-        return to_foeResult(FOE_ECS_SUCCESS);
+        if (*pID == removeID) {
+            pComponentPool->removeOffsets.emplace_back(pID - pStartID);
+            ++pID;
+        }
     }
 
-    // Sort data to insert
-    std::sort(toInsertOffsets.begin(), toInsertOffsets.end(),
-              [](InsertOffsets const &a, InsertOffsets const &b) {
-                  return a.entity < b.entity;
-              });
+    // Prepare removed storage for new items, make sure it has enough capacity
+    if (pComponentPool->removedData.capacity < pComponentPool->removeOffsets.size()) {
+        deallocDataSet(&pComponentPool->removedData);
+        pComponentPool->removedData = {};
+
+        if (!allocDataSet(pComponentPool->removeOffsets.size(), pComponentPool->dataSize,
+                          &pComponentPool->removedData)) {
+            pComponentPool->removeOffsets.clear();
+            return to_foeResult(FOE_ECS_ERROR_OUT_OF_MEMORY);
+        }
+    }
+
+    return to_foeResult(FOE_ECS_SUCCESS);
+}
+
+/** @brief Sorts the queued insertions and finds where each is to be placed in the stored data
+ * @return The number of entities that are to be inserted
+ *
+ * Duplicates, of which only the last one queued is kept, and entities already in the pool that are
+ * not also being removed are marked with FOE_INVALID_ID. Otherwise the dstOffset is set to the
+ * offset of the stored entity it is to be placed before.
+ */
+size_t findInsertions(ComponentPool *pComponentPool, std::vector<InsertOffsets> &toInsertOffsets) {
+    // Sort data to insert, with duplicates in the order they were queued
+    auto const insertOrder = [](InsertOffsets const &a, InsertOffsets const &b) {
+        return a.entity < b.entity || (a.entity == b.entity && a.srcOffset < b.srcOffset);
+    };
+    if (!std::is_sorted(toInsertOffsets.begin(), toInsertOffsets.end(), insertOrder))
+        std::sort(toInsertOffsets.begin(), toInsertOffsets.end(), insertOrder);
 
     // Insertion offset pointers
     InsertOffsets *pInsert = toInsertOffsets.data();
@@ -218,132 +388,470 @@ foeResultSet insertPass(ComponentPool *pComponentPool) {
     foeEntityID const *const pStartID = pID;
     foeEntityID const *const pEndID = pID + pComponentPool->storedData.count;
 
+    // Removal offset iterators
+    size_t const *pRemoveOffset = pComponentPool->removeOffsets.data();
+    size_t const *const pEndRemoveOffset = pRemoveOffset + pComponentPool->removeOffsets.size();
+
     size_t toInsertCount = 0;
-    while (pInsert != pInsertEnd) {
+    for (; pInsert != pInsertEnd; ++pInsert) {
         // If the next entity has the same ID, skip this one, we always want to use the last one
         if (auto const pNextInsert = pInsert + 1;
             pNextInsert != pInsertEnd && pInsert->entity == pNextInsert->entity) {
             pInsert->entity = FOE_INVALID_ID;
-            ++pInsert;
             continue;
         }
 
-        // Try to shortcut a linear search by doing binary search
-        pID = std::lower_bound(pID, pEndID, pInsert->entity);
+        pID = gallopingLowerBound(pID, pEndID, pInsert->entity);
+        size_t const offset = pID - pStartID;
 
         // If the IDs match, meaning the item is already in the regular list, skip the insertion of
-        // this element
+        // this element, unless that entry is also being removed
         if (pID != pEndID && *pID == pInsert->entity) {
-            // Mark the ID as invalid, so it is skipped when doing actual insertion pass later
-            pInsert->entity = FOE_INVALID_ID;
-            ++pInsert;
-            continue;
+            while (pRemoveOffset != pEndRemoveOffset && *pRemoveOffset < offset)
+                ++pRemoveOffset;
+
+            if (pRemoveOffset == pEndRemoveOffset || *pRemoveOffset != offset) {
+                // Mark the ID as invalid, so it is skipped when doing actual insertion pass later
+                pInsert->entity = FOE_INVALID_ID;
+                continue;
+            }
         }
 
         // At this point, it is not already in the pool, is unique, so to be added
-        pInsert->dstOffset = (pID - pStartID);
-
+        pInsert->dstOffset = offset;
         ++toInsertCount;
-        ++pInsert;
     }
 
-    if (toInsertCount == 0) {
-        destructAllDataSet(pComponentPool->dataDestructor, pComponentPool->dataSize,
-                           &toInsertDataSet);
-        deallocDataSet(&toInsertDataSet);
-        return to_foeResult(FOE_ECS_SUCCESS);
+    return toInsertCount;
+}
+
+/// Moves the entries at removeOffsets out to the removed storage, shifting down the remaining ones
+void removeInPlace(ComponentPool *pComponentPool) {
+    std::vector<size_t> const &removeOffsets = pComponentPool->removeOffsets;
+    DataSet *const pStoredData = &pComponentPool->storedData;
+    size_t const dataSize = pComponentPool->dataSize;
+
+    if (removeOffsets.empty())
+        return;
+
+    size_t bytesMoved = 0;
+    size_t dstOffset = removeOffsets[0];
+    for (size_t i = 0; i < removeOffsets.size(); ++i) {
+        size_t const offset = removeOffsets[i];
+        size_t const nextOffset =
+            (i + 1 < removeOffsets.size()) ? removeOffsets[i + 1] : pStoredData->count;
+
+        bytesMoved += copyData(&pComponentPool->removedData, i, pStoredData, offset, 1, dataSize);
+
+        // Shift down everything up to the next removed entry in one go
+        bytesMoved += moveData(pStoredData, dstOffset, pStoredData, offset + 1,
+                               nextOffset - offset - 1, dataSize);
+        dstOffset += nextOffset - offset - 1;
     }
 
-    // Resize data pool if necessary
-    DataSet dstPool = pComponentPool->storedData;
-    size_t newCapacity = std::max(pComponentPool->expansionRate, dstPool.count + toInsertCount);
-    // Check if there's an external larger requested capacity
-    if (pComponentPool->desiredCapacity > newCapacity)
-        newCapacity = pComponentPool->desiredCapacity;
+    pStoredData->count -= removeOffsets.size();
+    pComponentPool->removedData.count = removeOffsets.size();
+    pComponentPool->statistics.bytesMoved += bytesMoved;
+}
 
-    if (dstPool.capacity < newCapacity) {
-        if (!allocDataSet(newCapacity, pComponentPool->dataSize, &dstPool)) {
-            destructAllDataSet(pComponentPool->dataDestructor, pComponentPool->dataSize,
-                               &toInsertDataSet);
-            deallocDataSet(&toInsertDataSet);
-            return to_foeResult(FOE_ECS_ERROR_OUT_OF_MEMORY);
+/** @brief Does removal and insertion together in place, in a single pass over the stored data
+ *
+ * Each unchanged entry only needs to move by the number of insertions before it, less the number of
+ * removals before it. Runs of entries that move down are shifted first, front to back, then those
+ * that move up, back to front, so that no run is overwritten before it has been moved. Entries
+ * where the insertions and removals before them cancel out aren't moved at all.
+ */
+void applyInPlace(ComponentPool *pComponentPool,
+                  DataSet const *pToInsertDataSet,
+                  std::vector<InsertOffsets> const &toInsertOffsets,
+                  size_t toInsertCount) {
+    DataSet *const pStoredData = &pComponentPool->storedData;
+    size_t const dataSize = pComponentPool->dataSize;
+
+    std::vector<size_t> const &removeOffsets = pComponentPool->removeOffsets;
+    size_t const *const pStartRemoveOffset = removeOffsets.data();
+    size_t const *const pEndRemoveOffset = pStartRemoveOffset + removeOffsets.size();
+
+    InsertOffsets const *const pStartInsert = toInsertOffsets.data();
+    InsertOffsets const *const pEndInsert = pStartInsert + toInsertOffsets.size();
+
+    size_t bytesMoved = 0;
+
+    // Move the removed entries out before anything can be moved over them
+    for (size_t i = 0; i < removeOffsets.size(); ++i) {
+        bytesMoved += copyData(&pComponentPool->removedData, i, pStoredData, removeOffsets[i], 1,
+                               dataSize);
+    }
+
+    { // Runs moving down, front to back
+        size_t const *pRemoveOffset = pStartRemoveOffset;
+        InsertOffsets const *pInsert = pStartInsert;
+        size_t srcOffset = 0;
+        ptrdiff_t shift = 0;
+
+        for (;;) {
+            while (pInsert != pEndInsert && pInsert->entity == FOE_INVALID_ID)
+                ++pInsert;
+
+            size_t const nextRemove =
+                (pRemoveOffset != pEndRemoveOffset) ? *pRemoveOffset : pStoredData->count;
+            size_t const nextInsert =
+                (pInsert != pEndInsert) ? pInsert->dstOffset : pStoredData->count;
+            size_t const nextOffset = std::min(nextRemove, nextInsert);
+
+            if (shift < 0) {
+                bytesMoved += moveData(pStoredData, srcOffset + shift, pStoredData, srcOffset,
+                                       nextOffset - srcOffset, dataSize);
+            }
+            srcOffset = nextOffset;
+
+            // Insertions go before any removal at the same offset
+            if (pInsert != pEndInsert && nextInsert <= nextRemove) {
+                ++shift;
+                ++pInsert;
+            } else if (pRemoveOffset != pEndRemoveOffset) {
+                --shift;
+                ++srcOffset;
+                ++pRemoveOffset;
+            } else {
+                break;
+            }
         }
     }
 
-    // Check capacity for inserted array
-    if (pComponentPool->insertedCapacity < toInsertCount) {
-        free(pComponentPool->pInsertedOffsets);
-        pComponentPool->pInsertedOffsets = (size_t *)malloc(toInsertCount * sizeof(size_t));
-        if (pComponentPool->pInsertedOffsets == nullptr) {
-            destructAllDataSet(pComponentPool->dataDestructor, pComponentPool->dataSize,
-                               &toInsertDataSet);
-            deallocDataSet(&toInsertDataSet);
-            return to_foeResult(FOE_ECS_ERROR_OUT_OF_MEMORY);
+    { // Runs moving up, back to front
+        size_t const *pRemoveOffset = pEndRemoveOffset;
+        InsertOffsets const *pInsert = pEndInsert;
+        size_t srcEnd = pStoredData->count;
+        ptrdiff_t shift = (ptrdiff_t)toInsertCount - (ptrdiff_t)removeOffsets.size();
+
+        for (;;) {
+            while (pInsert != pStartInsert && (pInsert - 1)->entity == FOE_INVALID_ID)
+                --pInsert;
+
+            // The run ends just after the previous removal, or at the previous insertion
+            size_t const prevRemoveEnd =
+                (pRemoveOffset != pStartRemoveOffset) ? *(pRemoveOffset - 1) + 1 : 0;
+            size_t const prevInsert = (pInsert != pStartInsert) ? (pInsert - 1)->dstOffset : 0;
+            size_t const runStart = std::max(prevRemoveEnd, prevInsert);
+
+            if (shift > 0) {
+                bytesMoved += moveData(pStoredData, runStart + shift, pStoredData, runStart,
+                                       srcEnd - runStart, dataSize);
+            }
+            srcEnd = runStart;
+
+            // Going backwards, insertions come after any removal just before them
+            if (pInsert != pStartInsert && prevInsert == runStart) {
+                --shift;
+                --pInsert;
+            } else if (pRemoveOffset != pStartRemoveOffset) {
+                ++shift;
+                --srcEnd;
+                --pRemoveOffset;
+            } else {
+                break;
+            }
         }
-        pComponentPool->insertedCapacity = toInsertCount;
     }
-    pComponentPool->insertedCount = toInsertCount;
 
-    // Setup pointers for actual insertion pass
-    pInsert = toInsertOffsets.data() + toInsertOffsets.size() - 1;
-    InsertOffsets const *const pEndReverseInsert = toInsertOffsets.data() - 1;
+    { // With everything else in place, the new entries can now be placed into the gaps left
+        size_t const *pRemoveOffset = pStartRemoveOffset;
+        size_t *pInsertedOffset = pComponentPool->pInsertedOffsets;
+        size_t insertedCount = 0;
 
-    size_t *pInsertedOffset = pComponentPool->pInsertedOffsets + toInsertCount - 1;
+        for (InsertOffsets const *pInsert = pStartInsert; pInsert != pEndInsert; ++pInsert) {
+            if (pInsert->entity == FOE_INVALID_ID)
+                continue;
 
-    size_t lastShiftedOffset = pComponentPool->storedData.count;
-    size_t shiftDistance = toInsertCount;
+            while (pRemoveOffset != pEndRemoveOffset && *pRemoveOffset < pInsert->dstOffset)
+                ++pRemoveOffset;
 
-    // In reverse order, insert the items, shifting required items to the right
-    for (; pInsert != pEndReverseInsert; --pInsert) {
-        // Some items need to be skipped
-        if (pInsert->entity == FOE_INVALID_ID) {
-            // If there is a destructor, call it
-            if (pComponentPool->dataDestructor) {
-                void *const pSkippedData = (uint8_t *)toInsertDataSet.pData +
-                                           (pInsert->srcOffset * pComponentPool->dataSize);
-                pComponentPool->dataDestructor(pSkippedData);
-            }
-            continue;
+            size_t const dstOffset =
+                pInsert->dstOffset - (pRemoveOffset - pStartRemoveOffset) + insertedCount;
+            bytesMoved += copyData(pStoredData, dstOffset, pToInsertDataSet, pInsert->srcOffset, 1,
+                                   dataSize);
+
+            *pInsertedOffset = dstOffset;
+            ++pInsertedOffset;
+            ++insertedCount;
+        }
+    }
+
+    pStoredData->count = pStoredData->count - removeOffsets.size() + toInsertCount;
+    pComponentPool->removedData.count = removeOffsets.size();
+    pComponentPool->statistics.bytesMoved += bytesMoved;
+}
+
+/// Does removal and insertion together as a single forward merge into a new, larger data set
+void mergeInto(ComponentPool *pComponentPool,
+               DataSet const *pToInsertDataSet,
+               std::vector<InsertOffsets> const &toInsertOffsets,
+               DataSet *pDstPool) {
+    DataSet const *const pStoredData = &pComponentPool->storedData;
+    size_t const dataSize = pComponentPool->dataSize;
+
+    size_t const *pRemoveOffset = pComponentPool->removeOffsets.data();
+    size_t const *const pEndRemoveOffset = pRemoveOffset + pComponentPool->removeOffsets.size();
+
+    InsertOffsets const *pInsert = toInsertOffsets.data();
+    InsertOffsets const *const pInsertEnd = pInsert + toInsertOffsets.size();
+
+    size_t *pInsertedOffset = pComponentPool->pInsertedOffsets;
+
+    size_t srcOffset = 0;
+    size_t dstOffset = 0;
+    size_t removedCount = 0;
+    size_t bytesMoved = 0;
+
+    for (;;) {
+        while (pInsert != pInsertEnd && pInsert->entity == FOE_INVALID_ID)
+            ++pInsert;
+
+        size_t const nextRemove =
+            (pRemoveOffset != pEndRemoveOffset) ? *pRemoveOffset : pStoredData->count;
+        size_t const nextInsert = (pInsert != pInsertEnd) ? pInsert->dstOffset : pStoredData->count;
+        size_t const nextOffset = std::min(nextRemove, nextInsert);
+
+        // Copy the unchanged run of entries up to the next change
+        bytesMoved +=
+            copyData(pDstPool, dstOffset, pStoredData, srcOffset, nextOffset - srcOffset, dataSize);
+        dstOffset += nextOffset - srcOffset;
+        srcOffset = nextOffset;
+
+        if (pInsert != pInsertEnd && nextInsert <= nextRemove) {
+            bytesMoved +=
+                copyData(pDstPool, dstOffset, pToInsertDataSet, pInsert->srcOffset, 1, dataSize);
+            *pInsertedOffset = dstOffset;
+
+            ++pInsertedOffset;
+            ++dstOffset;
+            ++pInsert;
+        } else if (pRemoveOffset != pEndRemoveOffset) {
+            bytesMoved += copyData(&pComponentPool->removedData, removedCount, pStoredData,
+                                   srcOffset, 1, dataSize);
+
+            ++removedCount;
+            ++srcOffset;
+            ++pRemoveOffset;
+        } else {
+            break;
+        }
+    }
+
+    pDstPool->count = dstOffset;
+    pComponentPool->removedData.count = removedCount;
+    pComponentPool->statistics.bytesMoved += bytesMoved;
+}
+
+/// Calls the destructor on the queued insertion data that ended up being skipped
+void destructSkippedInsertions(ComponentPool *pComponentPool,
+                               DataSet const *pToInsertDataSet,
+                               std::vector<InsertOffsets> const &toInsertOffsets) {
+    if (pComponentPool->dataDestructor == NULL)
+        return;
+
+    for (auto const &it : toInsertOffsets) {
+        if (it.entity == FOE_INVALID_ID) {
+            pComponentPool->dataDestructor((uint8_t *)pToInsertDataSet->pData +
+                                           (it.srcOffset * pComponentPool->dataSize));
         }
+    }
+}
+
+/** @brief Determines the capacity to grow to in order to fit the required count
+ * @return The new capacity, or the current one if no growth is necessary
+ */
+size_t growthCapacity(ComponentPool const *pComponentPool, size_t requiredCount) {
+    foeEcsComponentPoolGrowthPolicy const &policy = pComponentPool->growthPolicy;
+    size_t const capacity = pComponentPool->storedData.capacity;
+
+    size_t const minCapacity =
+        std::max({pComponentPool->expansionRate, requiredCount, pComponentPool->desiredCapacity});
+    if (capacity >= minCapacity)
+        return capacity;
+
+    size_t newCapacity = requiredCount + (requiredCount * policy.minHeadroomPercent) / 100;
+    if (policy.growthFactor > 1.f)
+        newCapacity = std::max(newCapacity, (size_t)((double)capacity * policy.growthFactor));
+
+    return std::max(newCapacity, minCapacity);
+}
+
+/// Reallocates the stored data to a smaller capacity if the growth policy calls for it
+void shrinkToFit(ComponentPool *pComponentPool) {
+    foeEcsComponentPoolGrowthPolicy const &policy = pComponentPool->growthPolicy;
+    DataSet *const pStoredData = &pComponentPool->storedData;
+
+    if (policy.shrinkThresholdPercent == 0 ||
+        pStoredData->count * 100 >= pStoredData->capacity * policy.shrinkThresholdPercent)
+        return;
+
+    size_t const newCapacity = std::max(
+        {pComponentPool->expansionRate, pComponentPool->desiredCapacity,
+         pStoredData->count + (pStoredData->count * policy.minHeadroomPercent) / 100});
+    if (newCapacity >= pStoredData->capacity)
+        return;
+
+    DataSet newDataSet = {};
+    if (newCapacity != 0) {
+        // If the smaller allocation fails, can just keep using the current one
+        if (!allocDataSet(newCapacity, pComponentPool->dataSize, &newDataSet))
+            return;
+
+        pComponentPool->statistics.bytesMoved +=
+            copyData(&newDataSet, 0, pStoredData, 0, pStoredData->count, pComponentPool->dataSize);
+        newDataSet.count = pStoredData->count;
+    }
+
+    deallocDataSet(pStoredData);
+    *pStoredData = newDataSet;
+    ++pComponentPool->statistics.reallocations;
+}
 
-        if (pInsert->dstOffset < lastShiftedOffset) {
-            size_t const srcOffset = pInsert->dstOffset;
-            size_t const dstOffset = srcOffset + shiftDistance;
-            size_t const numMove = lastShiftedOffset - srcOffset;
+/** @brief Gathers all staged insertions into toInsertData and toInsertOffsets
+ * @return FOE_ECS_SUCCESS on success, FOE_ECS_ERROR_OUT_OF_MEMORY if toInsertData couldn't fit
+ * them, in which case the staged data that couldn't be gathered is destroyed.
+ */
+foeResultSet gatherInsertions(ComponentPool *pComponentPool) {
+    DataSet *const pToInsertData = &pComponentPool->toInsertData;
+    size_t const dataSize = pComponentPool->dataSize;
+    foeResultSet result = to_foeResult(FOE_ECS_SUCCESS);
 
-            moveData(&dstPool, dstOffset, &pComponentPool->storedData, srcOffset, numMove,
-                     pComponentPool->dataSize);
+    // Take everything staged so far, one shard at a time so that new insertions only wait on their
+    // own shard being taken
+    pToInsertData->count = 0;
 
-            lastShiftedOffset = srcOffset;
+    for (size_t i = 0; i < cStagingShardCount; ++i) {
+        StagingShard &shard = pComponentPool->pStagingShards[i];
+        std::scoped_lock lock{shard.sync};
+
+        if (shard.toInsertData.count == 0)
+            continue;
+
+        // The first shard with data is swapped out, so the single-threaded case never copies
+        if (pToInsertData->count == 0) {
+            std::swap(*pToInsertData, shard.toInsertData);
+            continue;
         }
 
-        // Everything necessary has been shifted out of the way, place new entry now
-        --shiftDistance;
+        size_t const required = pToInsertData->count + shard.toInsertData.count;
+        if (pToInsertData->capacity < required &&
+            !growDataSet(std::max(required, pToInsertData->capacity * 2), dataSize,
+                         pToInsertData)) {
+            destructAllDataSet(pComponentPool->dataDestructor, dataSize, &shard.toInsertData);
+            shard.toInsertData.count = 0;
+            result = to_foeResult(FOE_ECS_ERROR_OUT_OF_MEMORY);
+            continue;
+        }
+
+        copyData(pToInsertData, pToInsertData->count, &shard.toInsertData, 0,
+                 shard.toInsertData.count, dataSize);
+        pToInsertData->count = required;
+        shard.toInsertData.count = 0;
+    }
+
+    if (result.value != FOE_SUCCESS) {
+        destructAllDataSet(pComponentPool->dataDestructor, dataSize, pToInsertData);
+        pToInsertData->count = 0;
+        return result;
+    }
+
+    std::vector<InsertOffsets> &toInsertOffsets = pComponentPool->toInsertOffsets;
+    toInsertOffsets.clear();
+    toInsertOffsets.reserve(pToInsertData->count);
+
+    for (size_t i = 0; i < pToInsertData->count; ++i) {
+        toInsertOffsets.emplace_back(InsertOffsets{
+            .entity = pToInsertData->pIDs[i],
+            .srcOffset = i,
+        });
+    }
+
+    return result;
+}
+
+/// Destroys all gathered insertion data, for when it can't be inserted
+void discardInsertions(ComponentPool *pComponentPool) {
+    destructAllDataSet(pComponentPool->dataDestructor, pComponentPool->dataSize,
+                       &pComponentPool->toInsertData);
+    pComponentPool->toInsertData.count = 0;
+}
+
+foeResultSet maintenancePass(ComponentPool *pComponentPool) {
+    foeResultSet result = findRemovals(pComponentPool);
+    if (result.value != FOE_SUCCESS)
+        return result;
+
+    result = gatherInsertions(pComponentPool);
+    if (result.value != FOE_SUCCESS) {
+        // Removals can still go ahead
+        removeInPlace(pComponentPool);
+        return result;
+    }
+
+    DataSet const *const pToInsertData = &pComponentPool->toInsertData;
+    std::vector<InsertOffsets> &toInsertOffsets = pComponentPool->toInsertOffsets;
+
+    size_t const toRemoveCount = pComponentPool->removeOffsets.size();
+    size_t const toInsertCount =
+        (pToInsertData->count != 0) ? findInsertions(pComponentPool, toInsertOffsets) : 0;
+
+    // With nothing to insert, the removals can just be done in place
+    if (toInsertCount == 0) {
+        removeInPlace(pComponentPool);
+        if (toRemoveCount != 0)
+            shrinkToFit(pComponentPool);
+
+        discardInsertions(pComponentPool);
+        return to_foeResult(FOE_ECS_SUCCESS);
+    }
 
-        moveData(&dstPool, pInsert->dstOffset + shiftDistance, &toInsertDataSet, pInsert->srcOffset,
-                 1, pComponentPool->dataSize);
+    // Check capacity for inserted array
+    if (pComponentPool->insertedCapacity < toInsertCount) {
+        free(pComponentPool->pInsertedOffsets);
+        pComponentPool->insertedCapacity = 0;
+        pComponentPool->pInsertedOffsets = (size_t *)malloc(toInsertCount * sizeof(size_t));
+        if (pComponentPool->pInsertedOffsets == nullptr) {
+            removeInPlace(pComponentPool);
 
-        *pInsertedOffset = pInsert->dstOffset + shiftDistance;
-        --pInsertedOffset;
+            discardInsertions(pComponentPool);
+            return to_foeResult(FOE_ECS_ERROR_OUT_OF_MEMORY);
+        }
+        pComponentPool->insertedCapacity = toInsertCount;
     }
+    pComponentPool->insertedCount = toInsertCount;
 
-    // If there is a new storage mediam, then move any remaining items from the old, and free the
-    // old allocs
-    dstPool.count = pComponentPool->storedData.count + toInsertCount;
-    if (dstPool.pIDs != pComponentPool->storedData.pIDs) {
-        // Move remaining old data
-        if (0 < lastShiftedOffset) {
-            moveData(&dstPool, 0, &pComponentPool->storedData, 0, lastShiftedOffset,
-                     pComponentPool->dataSize);
+    // Determine the new capacity
+    DataSet *const pStoredData = &pComponentPool->storedData;
+    size_t const newCount = pStoredData->count - toRemoveCount + toInsertCount;
+    size_t const newCapacity = growthCapacity(pComponentPool, newCount);
+
+    if (pStoredData->capacity < newCapacity) {
+        // Needs a new allocation, which can be merged directly into
+        DataSet dstPool = {};
+        if (!allocDataSet(newCapacity, pComponentPool->dataSize, &dstPool)) {
+            removeInPlace(pComponentPool);
+
+            pComponentPool->insertedCount = 0;
+            discardInsertions(pComponentPool);
+            return to_foeResult(FOE_ECS_ERROR_OUT_OF_MEMORY);
         }
+        ++pComponentPool->statistics.reallocations;
+
+        mergeInto(pComponentPool, pToInsertData, toInsertOffsets, &dstPool);
 
-        // Dealloc
-        deallocDataSet(&pComponentPool->storedData);
+        deallocDataSet(pStoredData);
+        *pStoredData = dstPool;
+    } else {
+        applyInPlace(pComponentPool, pToInsertData, toInsertOffsets, toInsertCount);
     }
-    pComponentPool->storedData = dstPool;
 
-    // Dealloc old toInsert
-    deallocDataSet(&toInsertDataSet);
+    if (toRemoveCount > toInsertCount)
+        shrinkToFit(pComponentPool);
+
+    destructSkippedInsertions(pComponentPool, pToInsertData, toInsertOffsets);
+    pComponentPool->toInsertData.count = 0;
 
     return to_foeResult(FOE_ECS_SUCCESS);
 }
@@ -362,10 +870,22 @@ extern "C" foeResultSet foeEcsCreateComponentPool(size_t initialCapacity,
     // Initialize in-place for C++ elements
     new (pNewComponentPool) ComponentPool;
 
+    pNewComponentPool->pStagingShards = new (std::nothrow) StagingShard[cStagingShardCount]{};
+    if (pNewComponentPool->pStagingShards == nullptr) {
+        pNewComponentPool->~ComponentPool();
+        free(pNewComponentPool);
+        return to_foeResult(FOE_ECS_ERROR_OUT_OF_MEMORY);
+    }
+
     pNewComponentPool->dataSize = dataSize;
     pNewComponentPool->dataDestructor = dataDestructor;
     pNewComponentPool->expansionRate = expansionRate;
     pNewComponentPool->desiredCapacity = initialCapacity;
+    pNewComponentPool->growthPolicy = foeEcsComponentPoolGrowthPolicy{
+        .growthFactor = 2.f,
+        .minHeadroomPercent = 0,
+        .shrinkThresholdPercent = 0,
+    };
 
     *pComponentPool = component_pool_to_handle(pNewComponentPool);
 
@@ -381,8 +901,13 @@ extern "C" void foeEcsDestroyComponentPool(foeEcsComponentPool componentPool) {
     deallocDataSet(&pComponentPool->removedData);
 
     // toInsert
-    destructAllDataSet(pComponentPool->dataDestructor, pComponentPool->dataSize,
-                       &pComponentPool->toInsertData);
+    for (size_t i = 0; i < cStagingShardCount; ++i) {
+        DataSet *pShardData = &pComponentPool->pStagingShards[i].toInsertData;
+
+        destructAllDataSet(pComponentPool->dataDestructor, pComponentPool->dataSize, pShardData);
+        deallocDataSet(pShardData);
+    }
+    delete[] pComponentPool->pStagingShards;
     deallocDataSet(&pComponentPool->toInsertData);
     free(pComponentPool->pInsertedOffsets);
 
@@ -390,6 +915,7 @@ extern "C" void foeEcsDestroyComponentPool(foeEcsComponentPool componentPool) {
     destructAllDataSet(pComponentPool->dataDestructor, pComponentPool->dataSize,
                        &pComponentPool->storedData);
     deallocDataSet(&pComponentPool->storedData);
+    freeOffsetIndex(&pComponentPool->offsetIndex);
 
     // Destruct/Free
     pComponentPool->~ComponentPool();
@@ -410,11 +936,27 @@ extern "C" foeResultSet foeEcsComponentPoolMaintenance(foeEcsComponentPool compo
     pComponentPool->removedData.count = 0;
     pComponentPool->insertedCount = 0;
 
-    foeResultSet result = removePass(pComponentPool);
-    if (result.value != FOE_SUCCESS)
-        return result;
+    foeResultSet result = maintenancePass(pComponentPool);
+
+    OffsetIndex *const pOffsetIndex = &pComponentPool->offsetIndex;
+    if (pOffsetIndex->enabled) {
+        // Only entities at or after the first removal or insertion have changed offset
+        size_t firstChanged = 0;
+        if (pOffsetIndex->valid) {
+            firstChanged = pComponentPool->storedData.count;
+            if (!pComponentPool->removeOffsets.empty())
+                firstChanged = std::min(firstChanged, pComponentPool->removeOffsets[0]);
+            if (pComponentPool->insertedCount != 0)
+                firstChanged = std::min(firstChanged, pComponentPool->pInsertedOffsets[0]);
+        }
 
-    result = insertPass(pComponentPool);
+        pOffsetIndex->valid = updateOffsetIndex(pComponentPool, firstChanged);
+        if (!pOffsetIndex->valid && result.value == FOE_SUCCESS)
+            result = to_foeResult(FOE_ECS_ERROR_OUT_OF_MEMORY);
+    }
+
+    if (pComponentPool->changeTracking.enabled)
+        updateChangeVersions(pComponentPool);
 
     return result;
 }
@@ -426,6 +968,27 @@ extern "C" void foeEcsComponentPoolExpansionRate(foeEcsComponentPool componentPo
     pComponentPool->expansionRate = expansionRate;
 }
 
+extern "C" void foeEcsComponentPoolGetGrowthPolicy(foeEcsComponentPool componentPool,
+                                                   foeEcsComponentPoolGrowthPolicy *pGrowthPolicy) {
+    ComponentPool *pComponentPool = component_pool_from_handle(componentPool);
+
+    *pGrowthPolicy = pComponentPool->growthPolicy;
+}
+
+extern "C" void foeEcsComponentPoolSetGrowthPolicy(
+    foeEcsComponentPool componentPool, foeEcsComponentPoolGrowthPolicy const *pGrowthPolicy) {
+    ComponentPool *pComponentPool = component_pool_from_handle(componentPool);
+
+    pComponentPool->growthPolicy = *pGrowthPolicy;
+}
+
+extern "C" void foeEcsComponentPoolGetStatistics(foeEcsComponentPool componentPool,
+                                                 foeEcsComponentPoolStatistics *pStatistics) {
+    ComponentPool *pComponentPool = component_pool_from_handle(componentPool);
+
+    *pStatistics = pComponentPool->statistics;
+}
+
 extern "C" size_t foeEcsComponentPoolSize(foeEcsComponentPool componentPool) {
     ComponentPool *pComponentPool = component_pool_from_handle(componentPool);
 
@@ -444,6 +1007,85 @@ extern "C" void *foeEcsComponentPoolDataPtr(foeEcsComponentPool componentPool) {
     return pComponentPool->storedData.pData;
 }
 
+extern "C" foeResultSet foeEcsComponentPoolEnableOffsetIndex(foeEcsComponentPool componentPool) {
+    ComponentPool *pComponentPool = component_pool_from_handle(componentPool);
+    OffsetIndex *const pOffsetIndex = &pComponentPool->offsetIndex;
+
+    if (pOffsetIndex->enabled)
+        return to_foeResult(FOE_ECS_SUCCESS);
+
+    pOffsetIndex->enabled = true;
+    pOffsetIndex->valid = updateOffsetIndex(pComponentPool, 0);
+
+    return to_foeResult(pOffsetIndex->valid ? FOE_ECS_SUCCESS : FOE_ECS_ERROR_OUT_OF_MEMORY);
+}
+
+extern "C" bool foeEcsComponentPoolFindOffset(foeEcsComponentPool componentPool,
+                                              foeEntityID entity,
+                                              size_t *pOffset) {
+    ComponentPool *pComponentPool = component_pool_from_handle(componentPool);
+
+    if (pComponentPool->offsetIndex.valid)
+        return findIndexedOffset(pComponentPool, entity, pOffset);
+
+    foeEntityID const *const pStartID = pComponentPool->storedData.pIDs;
+    foeEntityID const *const pEndID = pStartID + pComponentPool->storedData.count;
+
+    foeEntityID const *pID = std::lower_bound(pStartID, pEndID, entity);
+    if (pID == pEndID || *pID != entity)
+        return false;
+
+    *pOffset = pID - pStartID;
+    return true;
+}
+
+extern "C" void foeEcsComponentPoolEnableChangeTracking(foeEcsComponentPool componentPool) {
+    ComponentPool *pComponentPool = component_pool_from_handle(componentPool);
+    ChangeTracking *const pChangeTracking = &pComponentPool->changeTracking;
+
+    if (pChangeTracking->enabled)
+        return;
+
+    pChangeTracking->enabled = true;
+    pChangeTracking->versions.assign(pComponentPool->storedData.count,
+                                     pChangeTracking->version.load(std::memory_order_relaxed));
+}
+
+extern "C" uint32_t foeEcsComponentPoolAdvanceChangeVersion(foeEcsComponentPool componentPool) {
+    ComponentPool *pComponentPool = component_pool_from_handle(componentPool);
+
+    return pComponentPool->changeTracking.version.fetch_add(1, std::memory_order_relaxed);
+}
+
+extern "C" void foeEcsComponentPoolMarkChanged(foeEcsComponentPool componentPool, size_t offset) {
+    ComponentPool *pComponentPool = component_pool_from_handle(componentPool);
+    ChangeTracking *const pChangeTracking = &pComponentPool->changeTracking;
+
+    if (pChangeTracking->enabled)
+        pChangeTracking->versions[offset] =
+            pChangeTracking->version.load(std::memory_order_relaxed);
+}
+
+extern "C" size_t foeEcsComponentPoolNextChanged(foeEcsComponentPool componentPool,
+                                                 uint32_t version,
+                                                 size_t offset) {
+    ComponentPool *pComponentPool = component_pool_from_handle(componentPool);
+    ChangeTracking const *const pChangeTracking = &pComponentPool->changeTracking;
+    size_t const count = pComponentPool->storedData.count;
+
+    if (!pChangeTracking->enabled)
+        return count;
+
+    // Compared by difference so that versions can wrap around
+    uint32_t const *const pVersions = pChangeTracking->versions.data();
+    for (; offset < count; ++offset) {
+        if ((int32_t)(pVersions[offset] - version) > 0)
+            return offset;
+    }
+
+    return count;
+}
+
 extern "C" size_t foeEcsComponentPoolCapacity(foeEcsComponentPool componentPool) {
     ComponentPool *pComponentPool = component_pool_from_handle(componentPool);
 
@@ -459,58 +1101,49 @@ extern "C" void foeEcsComponentPoolReserve(foeEcsComponentPool componentPool, si
 extern "C" size_t foeEcsComponentPoolInsertCapacity(foeEcsComponentPool componentPool) {
     ComponentPool *pComponentPool = component_pool_from_handle(componentPool);
 
-    return pComponentPool->toInsertData.capacity;
+    size_t capacity = 0;
+    for (size_t i = 0; i < cStagingShardCount; ++i) {
+        StagingShard &shard = pComponentPool->pStagingShards[i];
+        std::scoped_lock lock{shard.sync};
+
+        capacity += shard.toInsertData.capacity;
+    }
+
+    return capacity;
 }
 
 extern "C" void foeEcsComponentPoolReserveInsertCapacity(foeEcsComponentPool componentPool,
                                                          size_t capacity) {
     ComponentPool *pComponentPool = component_pool_from_handle(componentPool);
 
-    pComponentPool->desiredInsertCapacity =
-        std::max(pComponentPool->desiredInsertCapacity, capacity);
+    // Only the calling thread's shard is reserved, as that's where its insertions will go
+    StagingShard &shard = pComponentPool->pStagingShards[tStagingShard];
+    std::scoped_lock lock{shard.sync};
+
+    // If the allocation fails, the staging data will just grow as needed instead
+    if (shard.toInsertData.capacity < capacity)
+        growDataSet(capacity, pComponentPool->dataSize, &shard.toInsertData);
 }
 
 extern "C" foeResultSet foeEcsComponentPoolInsert(foeEcsComponentPool componentPool,
                                                   foeEntityID entity,
                                                   void *pData) {
     ComponentPool *pComponentPool = component_pool_from_handle(componentPool);
-    std::unique_lock toInsertLock{pComponentPool->toInsertSync};
-
-    // Check if we need to expand the capacity of the toInsert data pool
-    size_t newCapacity = 0;
-    if (pComponentPool->desiredInsertCapacity != 0) {
-        newCapacity = pComponentPool->desiredInsertCapacity;
-        pComponentPool->desiredInsertCapacity = 0;
-    }
-    if (newCapacity < pComponentPool->toInsertData.capacity + 1) {
-        newCapacity = pComponentPool->toInsertData.capacity + 16;
-    }
 
-    if (pComponentPool->toInsertData.capacity < newCapacity) {
-        DataSet newDataSet = {};
-        if (!allocDataSet(newCapacity, pComponentPool->dataSize, &newDataSet))
-            return to_foeResult(FOE_ECS_ERROR_OUT_OF_MEMORY);
+    StagingShard &shard = pComponentPool->pStagingShards[tStagingShard];
+    std::scoped_lock lock{shard.sync};
+    DataSet &toInsertData = shard.toInsertData;
 
-        moveData(&newDataSet, 0, &pComponentPool->toInsertData, 0,
-                 pComponentPool->toInsertData.count, pComponentPool->dataSize);
-
-        deallocDataSet(&pComponentPool->toInsertData);
-        newDataSet.count = pComponentPool->toInsertData.count;
-        pComponentPool->toInsertData = newDataSet;
-    }
-
-    // Actually add the data to be inserted
-    pComponentPool->toInsertData.pIDs[pComponentPool->toInsertData.count] = entity;
-    memcpy((uint8_t *)pComponentPool->toInsertData.pData +
-               (pComponentPool->toInsertData.count * pComponentPool->dataSize),
-           pData, pComponentPool->dataSize);
-
-    pComponentPool->toInsertOffsets.emplace_back(InsertOffsets{
-        .entity = entity,
-        .srcOffset = pComponentPool->toInsertData.count,
-    });
+    // Grow geometrically, so that staging many insertions doesn't keep copying everything
+    if (toInsertData.count == toInsertData.capacity &&
+        !growDataSet(std::max<size_t>(16, toInsertData.capacity * 2), pComponentPool->dataSize,
+                     &toInsertData))
+        return to_foeResult(FOE_ECS_ERROR_OUT_OF_MEMORY);
 
-    ++pComponentPool->toInsertData.count;
+    toInsertData.pIDs[toInsertData.count] = entity;
+    memcpy((uint8_t *)toInsertData.pData + (toInsertData.count * pComponentPool->dataSize), pData,
+           pComponentPool->dataSize);
+    ++toInsertData.count;
 
     return to_foeResult(FOE_ECS_SUCCESS);
 }
@@ -531,11 +1164,10 @@ extern "C" foeResultSet foeEcsComponentPoolRemove(foeEcsComponentPool componentP
                                                   foeEntityID entity) {
     ComponentPool *pComponentPool = component_pool_from_handle(componentPool);
 
-    pComponentPool->toRemoveSync.lock();
-
-    pComponentPool->toRemoveIDs.emplace_back(entity);
+    StagingShard &shard = pComponentPool->pStagingShards[tStagingShard];
+    std::scoped_lock lock{shard.sync};
 
-    pComponentPool->toRemoveSync.unlock();
+    shard.toRemoveIDs.emplace_back(entity);
 
     return to_foeResult(FOE_ECS_SUCCESS);
 }
@@ -0,0 +1,30 @@
+// Copyright (C) 2026 George Cave.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef GALLOPING_SEARCH_HPP
+#define GALLOPING_SEARCH_HPP
+
+#include <foe/ecs/id.h>
+
+#include <algorithm>
+#include <stddef.h>
+
+/** @brief Finds the first ID not less than the given one, searching outwards from the start
+ *
+ * Doubles the search range until it passes the ID before doing a binary search, so IDs near the
+ * start, as when walking through a dense set of changes, are found in just a few steps.
+ */
+inline foeEntityID const *gallopingLowerBound(foeEntityID const *pFirst,
+                                              foeEntityID const *pLast,
+                                              foeEntityID id) {
+    size_t step = 1;
+    while (step < size_t(pLast - pFirst) && pFirst[step] < id) {
+        pFirst += step;
+        step *= 2;
+    }
+
+    return std::lower_bound(pFirst, pFirst + std::min(step, size_t(pLast - pFirst)), id);
+}
+
+#endif // GALLOPING_SEARCH_HPP
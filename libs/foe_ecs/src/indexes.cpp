@@ -1,4 +1,4 @@
-// Copyright (C) 2021-2022 George Cave.
+// Copyright (C) 2021-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
@@ -8,25 +8,199 @@
 
 #include <algorithm>
 #include <atomic>
+#include <bit>
+#include <cstdlib>
+#include <cstring>
 #include <mutex>
-#include <queue>
+#include <new>
+#include <vector>
 
 namespace {
 
+constexpr size_t cGenerationPageBits = 16;
+constexpr size_t cGenerationPageSize = size_t(1) << cGenerationPageBits;
+constexpr size_t cGenerationPageCount = size_t(1) << (foeIdNumIndexBits - cGenerationPageBits);
+
 struct Indexes {
     /// The group of the entity IDs being managed
     foeIdGroup groupID;
 
     /// Synchronizes the recycle list
     std::mutex sync;
-    /// The next free IndexID, never yet used.
+    /// The next free IndexID, never yet used. New indices are reserved from here without the lock.
     std::atomic<foeIdIndexValue> nextNewIndex;
-    /// The list of recyclable IndexIDs.
-    std::queue<foeIdIndex> recycled;
+
+    /// Ring buffer of recyclable IndexIDs, reused in the order they were freed
+    foeIdIndex *pRecycled;
+    /// Capacity of the ring buffer, always zero or a power of two
+    uint32_t recycledCapacity;
+    /// Position of the oldest recyclable index in the ring buffer
+    uint32_t recycledFirst;
+    /// Only changed with the lock held, but read without it to check if there's anything to recycle
+    std::atomic_uint32_t recycledCount;
+
+    /// Bitmap of the indices in the recycle list. Every index below nextNewIndex without its bit
+    /// set is live, so reserving new indices doesn't need to touch it.
+    uint64_t *pRecycledBits;
+    /// Number of 64-bit words allocated for the recycled bitmap, bits beyond it are all clear
+    uint32_t recycledWordCapacity;
+
+    /// Pages of index generations, only allocated once an index within them is freed. Pages are
+    /// never freed before the indexes themselves, so can be read without taking the lock.
+    std::atomic<std::atomic<foeIdGeneration> *> generationPages[cGenerationPageCount];
 };
 
 FOE_DEFINE_HANDLE_CASTS(indexes, Indexes, foeEcsIndexes)
 
+/** @brief Returns the generation page for the index, allocating it if it doesn't exist yet
+ * @return The page, or nullptr if it couldn't be allocated.
+ * @note The lock must be held.
+ */
+std::atomic<foeIdGeneration> *getGenerationPage(Indexes *pIndexes, foeIdIndex index) {
+    auto &page = pIndexes->generationPages[index >> cGenerationPageBits];
+
+    std::atomic<foeIdGeneration> *pPage = page.load(std::memory_order_relaxed);
+    if (pPage == nullptr) {
+        pPage = new (std::nothrow) std::atomic<foeIdGeneration>[cGenerationPageSize]{};
+        page.store(pPage, std::memory_order_release);
+    }
+
+    return pPage;
+}
+
+/** @brief Makes sure the recycled ring buffer can hold the given number of indices
+ * @return True on success, false if a larger buffer couldn't be allocated.
+ * @note The lock must be held.
+ */
+bool reserveRecycled(Indexes *pIndexes, uint32_t count) {
+    if (count <= pIndexes->recycledCapacity)
+        return true;
+
+    uint32_t newCapacity = std::max<uint32_t>(pIndexes->recycledCapacity, 64);
+    while (newCapacity < count)
+        newCapacity *= 2;
+
+    foeIdIndex *pNewRecycled = (foeIdIndex *)malloc(newCapacity * sizeof(foeIdIndex));
+    if (pNewRecycled == nullptr)
+        return false;
+
+    // Unwrap the current contents to the start of the new buffer
+    uint32_t const mask = pIndexes->recycledCapacity - 1;
+    for (uint32_t i = 0; i < pIndexes->recycledCount; ++i)
+        pNewRecycled[i] = pIndexes->pRecycled[(pIndexes->recycledFirst + i) & mask];
+
+    free(pIndexes->pRecycled);
+    pIndexes->pRecycled = pNewRecycled;
+    pIndexes->recycledCapacity = newCapacity;
+    pIndexes->recycledFirst = 0;
+
+    return true;
+}
+
+/** @brief Makes sure the recycled bitmap can hold bits for all indices below the given one
+ * @return True on success, false if a larger bitmap couldn't be allocated.
+ * @note The lock must be held.
+ */
+bool reserveRecycledBits(Indexes *pIndexes, foeIdIndexValue endIndex) {
+    uint32_t const wordCount = (endIndex + 63) / 64;
+    if (wordCount <= pIndexes->recycledWordCapacity)
+        return true;
+
+    uint32_t newCapacity = std::max<uint32_t>(pIndexes->recycledWordCapacity, 16);
+    while (newCapacity < wordCount)
+        newCapacity *= 2;
+
+    uint64_t *pNewBits =
+        (uint64_t *)realloc(pIndexes->pRecycledBits, newCapacity * sizeof(uint64_t));
+    if (pNewBits == nullptr)
+        return false;
+
+    memset(pNewBits + pIndexes->recycledWordCapacity, 0,
+           (newCapacity - pIndexes->recycledWordCapacity) * sizeof(uint64_t));
+    pIndexes->pRecycledBits = pNewBits;
+    pIndexes->recycledWordCapacity = newCapacity;
+
+    return true;
+}
+
+/// Returns the number of live indices, those generated but not waiting to be recycled
+uint32_t liveCount(Indexes const *pIndexes) {
+    return pIndexes->nextNewIndex.load(std::memory_order_relaxed) - foeIdIndexMinValue -
+           pIndexes->recycledCount.load(std::memory_order_relaxed);
+}
+
+/// Returns the first index at or after the given one that is live, or recycled, or the end index
+template <bool Live>
+foeIdIndexValue findLiveBit(Indexes const *pIndexes, foeIdIndexValue index, foeIdIndexValue end) {
+    if (index >= end)
+        return end;
+
+    uint64_t const *const pBits = pIndexes->pRecycledBits;
+    uint32_t const wordCount = pIndexes->recycledWordCapacity;
+
+    // Beyond the bitmap nothing is recycled, so everything is live
+    uint32_t word = index / 64;
+    if (word >= wordCount)
+        return Live ? index : end;
+
+    uint64_t bits = (Live ? ~pBits[word] : pBits[word]) & (~uint64_t(0) << (index % 64));
+
+    while (bits == 0) {
+        if (++word == wordCount)
+            return Live ? std::min<foeIdIndexValue>(word * 64, end) : end;
+        bits = Live ? ~pBits[word] : pBits[word];
+    }
+
+    return std::min<foeIdIndexValue>(word * 64 + std::countr_zero(bits), end);
+}
+
+/** @brief Reserves a block of never used indices, without needing the lock
+ * @param pFirst Set to the first index of the block.
+ * @return FOE_ECS_SUCCESS on success, FOE_ECS_ERROR_OUT_OF_INDEXES if the group can't fit the whole
+ * block, in which case nothing is reserved.
+ *
+ * A compare-exchange rather than a fetch_add, so that running out is caught before nextNewIndex is
+ * advanced past the maximum.
+ */
+foeResultSet reserveNewIndices(Indexes *pIndexes, uint32_t count, foeIdIndexValue *pFirst) {
+    foeIdIndexValue first = pIndexes->nextNewIndex.load(std::memory_order_relaxed);
+    do {
+        if (count > foeIdIndexMaxValue - first) {
+            // Not enough indexes left in the group
+            return to_foeResult(FOE_ECS_ERROR_OUT_OF_INDEXES);
+        }
+    } while (!pIndexes->nextNewIndex.compare_exchange_weak(first, first + count,
+                                                           std::memory_order_relaxed));
+
+    *pFirst = first;
+    return to_foeResult(FOE_ECS_SUCCESS);
+}
+
+/** @brief Calls the function with each run of consecutive live indices, in ascending order
+ *
+ * Only the words of the bitmap and the runs themselves are visited, so it doesn't step over each
+ * dead index.
+ *
+ * @note The lock must be held.
+ */
+template <typename Fn>
+void forEachLiveRange(Indexes const *pIndexes, Fn &&fn) {
+    foeIdIndexValue const end = pIndexes->nextNewIndex.load(std::memory_order_relaxed);
+    foeIdIndexValue index = foeIdIndexMinValue;
+
+    while (true) {
+        index = findLiveBit<true>(pIndexes, index, end);
+        if (index == end)
+            break;
+
+        foeIdIndexValue const rangeEnd = findLiveBit<false>(pIndexes, index, end);
+        if (!fn(foeIdIndexRange{.first = index, .count = rangeEnd - index}))
+            break;
+
+        index = rangeEnd;
+    }
+}
+
 } // namespace
 
 extern "C" foeResultSet foeEcsCreateIndexes(foeIdGroup groupID, foeEcsIndexes *pIndexes) {
@@ -34,7 +208,7 @@ extern "C" foeResultSet foeEcsCreateIndexes(foeIdGroup groupID, foeEcsIndexes *p
         return to_foeResult(FOE_ECS_ERROR_NOT_GROUP_ID);
     }
 
-    Indexes *pNewIndexes = new (std::nothrow) Indexes;
+    Indexes *pNewIndexes = new (std::nothrow) Indexes{};
     if (pNewIndexes == nullptr)
         return to_foeResult(FOE_ECS_ERROR_OUT_OF_MEMORY);
 
@@ -49,6 +223,11 @@ extern "C" foeResultSet foeEcsCreateIndexes(foeIdGroup groupID, foeEcsIndexes *p
 extern "C" void foeEcsDestroyIndexes(foeEcsIndexes indexes) {
     Indexes *pIndexes = indexes_from_handle(indexes);
 
+    for (auto &page : pIndexes->generationPages)
+        delete[] page.load(std::memory_order_relaxed);
+    free(pIndexes->pRecycled);
+    free(pIndexes->pRecycledBits);
+
     delete pIndexes;
 }
 
@@ -59,22 +238,58 @@ extern "C" foeIdGroup foeEcsIndexesGetGroupID(foeEcsIndexes indexes) {
 }
 
 extern "C" foeResultSet foeEcsGenerateID(foeEcsIndexes indexes, foeId *pID) {
+    return foeEcsGenerateIDs(indexes, 1, pID);
+}
+
+extern "C" foeResultSet foeEcsGenerateIDs(foeEcsIndexes indexes, uint32_t idCount, foeId *pIDs) {
     Indexes *pIndexes = indexes_from_handle(indexes);
+    foeResultSet result = to_foeResult(FOE_ECS_SUCCESS);
+    foeIdIndexValue firstNewIndex;
+
+    // With nothing to recycle only new indices are needed, which don't need the lock
+    if (pIndexes->recycledCount.load(std::memory_order_relaxed) == 0) {
+        result = reserveNewIndices(pIndexes, idCount, &firstNewIndex);
+        if (result.value != FOE_SUCCESS)
+            return result;
+
+        for (uint32_t i = 0; i < idCount; ++i)
+            pIDs[i] = foeIdCreate(pIndexes->groupID, firstNewIndex + i);
+
+        return result;
+    }
 
     std::unique_lock lock{pIndexes->sync};
 
-    if (pIndexes->recycled.size() != 0) {
-        *pID = foeIdCreate(pIndexes->groupID, pIndexes->recycled.front());
-        pIndexes->recycled.pop();
+    uint32_t const recycledCount = pIndexes->recycledCount.load(std::memory_order_relaxed);
+    uint32_t const recycledTaken = std::min(idCount, recycledCount);
+    uint32_t const newCount = idCount - recycledTaken;
 
-        return to_foeResult(FOE_ECS_SUCCESS);
-    } else if (pIndexes->nextNewIndex == foeIdIndexMaxValue) {
-        // Ran out of indexes in the group
-        return to_foeResult(FOE_ECS_ERROR_OUT_OF_INDEXES);
+    // Reserve any new indices first, as it is the only part that can fail
+    if (newCount != 0) {
+        result = reserveNewIndices(pIndexes, newCount, &firstNewIndex);
+        if (result.value != FOE_SUCCESS)
+            return result;
     }
 
-    *pID = foeIdCreate(pIndexes->groupID, pIndexes->nextNewIndex++);
-    return to_foeResult(FOE_ECS_SUCCESS);
+    uint32_t const first = pIndexes->recycledFirst;
+    uint32_t const mask = pIndexes->recycledCapacity - 1;
+
+    pIndexes->recycledFirst = (first + recycledTaken) & mask;
+    pIndexes->recycledCount.store(recycledCount - recycledTaken, std::memory_order_relaxed);
+
+    // The ring buffer may be reallocated once unlocked, but the new indices are already reserved
+    for (uint32_t i = 0; i < recycledTaken; ++i) {
+        foeIdIndex const index = pIndexes->pRecycled[(first + i) & mask];
+
+        pIndexes->pRecycledBits[index / 64] &= ~(uint64_t(1) << (index % 64));
+        pIDs[i] = foeIdCreate(pIndexes->groupID, index);
+    }
+    lock.unlock();
+
+    for (uint32_t i = 0; i < newCount; ++i)
+        pIDs[recycledTaken + i] = foeIdCreate(pIndexes->groupID, firstNewIndex + i);
+
+    return result;
 }
 
 extern "C" foeResultSet foeEcsFreeID(foeEcsIndexes indexes, foeId id) {
@@ -97,48 +312,126 @@ extern "C" foeResultSet foeEcsFreeIDs(foeEcsIndexes indexes, uint32_t idCount, f
             return to_foeResult(FOE_ECS_ERROR_INDEX_BELOW_MINIMUM);
     }
 
+    foeIdIndexValue endIndex = 0;
+    for (uint32_t i = 0; i < idCount; ++i)
+        endIndex = std::max<foeIdIndexValue>(endIndex, foeIdGetIndex(pIDs[i]) + 1);
+
     std::unique_lock lock{pIndexes->sync};
 
-    for (uint32_t i = 0; i < idCount; ++i)
-        pIndexes->recycled.push(foeIdGetIndex(pIDs[i]));
+    uint32_t const recycledCount = pIndexes->recycledCount.load(std::memory_order_relaxed);
+
+    // Make sure every generation can be advanced and index recycled before freeing any of them
+    if (!reserveRecycled(pIndexes, recycledCount + idCount) ||
+        !reserveRecycledBits(pIndexes, endIndex))
+        return to_foeResult(FOE_ECS_ERROR_OUT_OF_MEMORY);
+
+    for (uint32_t i = 0; i < idCount; ++i) {
+        if (getGenerationPage(pIndexes, foeIdGetIndex(pIDs[i])) == nullptr)
+            return to_foeResult(FOE_ECS_ERROR_OUT_OF_MEMORY);
+    }
+
+    // Mark each as recycled, if any already are then it is either already freed or in the list
+    // twice, so undo those marked so far and free none of them
+    for (uint32_t i = 0; i < idCount; ++i) {
+        foeIdIndex const index = foeIdGetIndex(pIDs[i]);
+        uint64_t &word = pIndexes->pRecycledBits[index / 64];
+        uint64_t const bit = uint64_t(1) << (index % 64);
+
+        if (word & bit) {
+            for (uint32_t j = 0; j < i; ++j) {
+                foeIdIndex const markedIndex = foeIdGetIndex(pIDs[j]);
+                pIndexes->pRecycledBits[markedIndex / 64] &= ~(uint64_t(1) << (markedIndex % 64));
+            }
+            return to_foeResult(FOE_ECS_ERROR_ID_ALREADY_FREED);
+        }
+
+        word |= bit;
+    }
+
+    uint32_t const mask = pIndexes->recycledCapacity - 1;
+    uint32_t const last = pIndexes->recycledFirst + recycledCount;
+
+    for (uint32_t i = 0; i < idCount; ++i) {
+        foeIdIndex const index = foeIdGetIndex(pIDs[i]);
+
+        getGenerationPage(pIndexes, index)[index & (cGenerationPageSize - 1)].fetch_add(
+            1, std::memory_order_release);
+        pIndexes->pRecycled[(last + i) & mask] = index;
+    }
+    pIndexes->recycledCount.store(recycledCount + idCount, std::memory_order_relaxed);
 
     return to_foeResult(FOE_ECS_SUCCESS);
 }
 
-extern "C" void foeEcsForEachID(foeEcsIndexes indexes,
-                                PFN_foeEcsForEachCall forEachCall,
-                                void *pCallContext) {
+extern "C" foeIdGeneration foeEcsGetIDGeneration(foeEcsIndexes indexes, foeId id) {
     Indexes *pIndexes = indexes_from_handle(indexes);
+    foeIdIndex const index = foeIdGetIndex(id);
 
-    foeResultSet result;
-    foeIdIndex nextNewIndex;
-    std::vector<foeIdIndex> recycledIndexes;
+    std::atomic<foeIdGeneration> const *pPage =
+        pIndexes->generationPages[index >> cGenerationPageBits].load(std::memory_order_acquire);
+    if (pPage == nullptr)
+        return 0;
 
-    do {
-        uint32_t count;
-        foeEcsExportIndexes(indexes, nullptr, &count, nullptr);
+    return pPage[index & (cGenerationPageSize - 1)].load(std::memory_order_acquire);
+}
 
-        recycledIndexes.resize(count);
-        result = foeEcsExportIndexes(indexes, &nextNewIndex, &count, recycledIndexes.data());
-        recycledIndexes.resize(count);
-    } while (result.value != FOE_SUCCESS);
+extern "C" uint32_t foeEcsGetLiveIDCount(foeEcsIndexes indexes) {
+    Indexes *pIndexes = indexes_from_handle(indexes);
 
-    std::sort(recycledIndexes.begin(), recycledIndexes.end());
+    std::scoped_lock lock{pIndexes->sync};
 
-    foeIdIndex const *pRecycledIt = recycledIndexes.data();
-    foeIdIndex const *const cRecycledEnd = pRecycledIt + recycledIndexes.size();
+    return liveCount(pIndexes);
+}
 
-    for (foeIdIndex indexID = foeIdIndexMinValue; indexID < nextNewIndex; ++indexID) {
-        // Skip through any recycled indexes
-        while (pRecycledIt != cRecycledEnd && indexID == *pRecycledIt) {
-            ++pRecycledIt;
-            ++indexID;
-        }
+extern "C" foeResultSet foeEcsExportLiveIndexRanges(foeEcsIndexes indexes,
+                                                    uint32_t *pRangeCount,
+                                                    foeIdIndexRange *pRanges) {
+    Indexes *pIndexes = indexes_from_handle(indexes);
 
-        if (indexID >= nextNewIndex)
-            break;
+    foeResultSet result = to_foeResult(FOE_ECS_SUCCESS);
+    uint32_t rangeCount = 0;
+    std::scoped_lock lock{pIndexes->sync};
+
+    if (pRanges == nullptr) {
+        forEachLiveRange(pIndexes, [&](foeIdIndexRange) {
+            ++rangeCount;
+            return true;
+        });
+    } else {
+        forEachLiveRange(pIndexes, [&](foeIdIndexRange range) {
+            if (rangeCount == *pRangeCount) {
+                result = to_foeResult(FOE_ECS_INCOMPLETE);
+                return false;
+            }
+
+            pRanges[rangeCount++] = range;
+            return true;
+        });
+    }
+    *pRangeCount = rangeCount;
+
+    return result;
+}
+
+extern "C" void foeEcsForEachID(foeEcsIndexes indexes,
+                                PFN_foeEcsForEachCall forEachCall,
+                                void *pCallContext) {
+    Indexes *pIndexes = indexes_from_handle(indexes);
+
+    // Take a snapshot so that the call can use the indexes without deadlocking
+    std::vector<foeIdIndexRange> ranges;
+    {
+        std::scoped_lock lock{pIndexes->sync};
 
-        forEachCall(pCallContext, foeIdCreate(pIndexes->groupID, indexID));
+        forEachLiveRange(pIndexes, [&](foeIdIndexRange range) {
+            ranges.emplace_back(range);
+            return true;
+        });
+    }
+
+    for (auto const &range : ranges) {
+        for (foeIdIndex indexID = range.first; indexID < range.first + range.count; ++indexID)
+            forEachCall(pCallContext, foeIdCreate(pIndexes->groupID, indexID));
     }
 }
 
@@ -152,19 +445,34 @@ extern "C" foeResultSet foeEcsImportIndexes(foeEcsIndexes indexes,
         return to_foeResult(FOE_ECS_ERROR_INDEX_BELOW_MINIMUM);
     }
 
+    // Recycled indices must be ones that could have been generated, otherwise they could be handed
+    // out beyond the live bits
+    for (uint32_t i = 0; i < recycledCount; ++i) {
+        if (pRecycledIndexes[i] < foeIdIndexMinValue)
+            return to_foeResult(FOE_ECS_ERROR_INDEX_BELOW_MINIMUM);
+        if (pRecycledIndexes[i] >= nextNewIndex)
+            return to_foeResult(FOE_ECS_ERROR_INDEX_ABOVE_GENERATED);
+    }
+
     std::scoped_lock lock{pIndexes->sync};
 
-    pIndexes->nextNewIndex = nextNewIndex;
+    if (!reserveRecycled(pIndexes, recycledCount) || !reserveRecycledBits(pIndexes, nextNewIndex))
+        return to_foeResult(FOE_ECS_ERROR_OUT_OF_MEMORY);
 
-    // Clear the old recycled list
-    while (!pIndexes->recycled.empty())
-        pIndexes->recycled.pop();
+    pIndexes->nextNewIndex = nextNewIndex;
 
-    // Insert new indices
+    // Everything below the next new index is live, except for the recycled indices
+    memset(pIndexes->pRecycledBits, 0, pIndexes->recycledWordCapacity * sizeof(uint64_t));
     for (uint32_t i = 0; i < recycledCount; ++i) {
-        pIndexes->recycled.emplace(pRecycledIndexes[i]);
+        foeIdIndex const index = pRecycledIndexes[i];
+        pIndexes->pRecycledBits[index / 64] |= uint64_t(1) << (index % 64);
     }
 
+    // Replace the old recycled list with the new indices
+    pIndexes->recycledFirst = 0;
+    std::copy(pRecycledIndexes, pRecycledIndexes + recycledCount, pIndexes->pRecycled);
+    pIndexes->recycledCount = recycledCount;
+
     return to_foeResult(FOE_ECS_SUCCESS);
 }
 
@@ -180,22 +488,20 @@ extern "C" foeResultSet foeEcsExportIndexes(foeEcsIndexes indexes,
     if (pNextNewIndex != nullptr)
         *pNextNewIndex = pIndexes->nextNewIndex;
     if (pRecycledIndexes == nullptr) {
-        *pRecycledCount = pIndexes->recycled.size();
+        *pRecycledCount = pIndexes->recycledCount;
         return result;
     }
 
-    auto tempList = pIndexes->recycled;
-    lock.unlock();
-
-    uint32_t returnCount = std::min((uint32_t)tempList.size(), *pRecycledCount);
-    if (returnCount < tempList.size()) {
+    uint32_t returnCount = std::min<uint32_t>(pIndexes->recycledCount, *pRecycledCount);
+    if (returnCount < pIndexes->recycledCount) {
         result = to_foeResult(FOE_ECS_INCOMPLETE);
     }
 
+    uint32_t const mask = pIndexes->recycledCapacity - 1;
     for (uint32_t i = 0; i < returnCount; ++i) {
-        pRecycledIndexes[i] = tempList.front();
-        tempList.pop();
+        pRecycledIndexes[i] = pIndexes->pRecycled[(pIndexes->recycledFirst + i) & mask];
     }
+    *pRecycledCount = returnCount;
 
     return result;
 }
\ No newline at end of file
@@ -0,0 +1,109 @@
+// Copyright (C) 2026 George Cave.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <foe/ecs/join.h>
+
+#include <foe/ecs/result.h>
+
+#include "galloping_search.hpp"
+#include "result.h"
+
+#include <algorithm>
+
+extern "C" uint32_t foeEcsJoinDriver(uint32_t poolCount, foeEcsComponentPool const *pPools) {
+    uint32_t driver = 0;
+    size_t driverSize = foeEcsComponentPoolSize(pPools[0]);
+
+    for (uint32_t i = 1; i < poolCount; ++i) {
+        size_t const size = foeEcsComponentPoolSize(pPools[i]);
+        if (size < driverSize) {
+            driver = i;
+            driverSize = size;
+        }
+    }
+
+    return driver;
+}
+
+extern "C" foeResultSet foeEcsJoin(uint32_t poolCount,
+                                   foeEcsComponentPool const *pPools,
+                                   uint32_t driver,
+                                   size_t *pDriverOffset,
+                                   size_t driverEndOffset,
+                                   uint32_t *pCount,
+                                   foeEntityID *pEntities,
+                                   size_t *pOffsets) {
+    foeEntityID const *pStartIDs[FOE_ECS_MAX_JOIN_POOLS];
+    foeEntityID const *pEndIDs[FOE_ECS_MAX_JOIN_POOLS];
+    foeEntityID const *pCursors[FOE_ECS_MAX_JOIN_POOLS];
+
+    for (uint32_t i = 0; i < poolCount; ++i) {
+        pStartIDs[i] = foeEcsComponentPoolIdPtr(pPools[i]);
+        pEndIDs[i] = pStartIDs[i] + foeEcsComponentPoolSize(pPools[i]);
+    }
+
+    foeEntityID const *pDriverID = pStartIDs[driver] + *pDriverOffset;
+    foeEntityID const *const pDriverEndID =
+        pStartIDs[driver] +
+        std::min(driverEndOffset, foeEcsComponentPoolSize(pPools[driver]));
+
+    // Starting somewhere in the middle of the driver pool, so each other pool needs a full search
+    // for where to start from
+    if (pDriverID < pDriverEndID) {
+        for (uint32_t i = 0; i < poolCount; ++i) {
+            pCursors[i] = std::lower_bound(pStartIDs[i], pEndIDs[i], *pDriverID);
+        }
+    }
+
+    foeEcsResult result = FOE_ECS_SUCCESS;
+    uint32_t const capacity = *pCount;
+    uint32_t count = 0;
+
+    while (pDriverID < pDriverEndID) {
+        foeEntityID const entity = *pDriverID;
+        bool matched = true;
+
+        for (uint32_t i = 0; i < poolCount; ++i) {
+            if (i == driver)
+                continue;
+
+            pCursors[i] = gallopingLowerBound(pCursors[i], pEndIDs[i], entity);
+            if (pCursors[i] == pEndIDs[i]) {
+                // Nothing further in the driver pool can be in this one
+                pDriverID = pDriverEndID;
+                matched = false;
+                break;
+            }
+            if (*pCursors[i] != entity) {
+                // Skip the driver ahead to the next entity that could be in this pool
+                pDriverID = gallopingLowerBound(pDriverID, pDriverEndID, *pCursors[i]);
+                matched = false;
+                break;
+            }
+        }
+
+        if (!matched)
+            continue;
+
+        if (count == capacity) {
+            result = FOE_ECS_INCOMPLETE;
+            break;
+        }
+
+        pCursors[driver] = pDriverID;
+        pEntities[count] = entity;
+        size_t *const pEntityOffsets = pOffsets + (size_t)count * poolCount;
+        for (uint32_t i = 0; i < poolCount; ++i) {
+            pEntityOffsets[i] = pCursors[i] - pStartIDs[i];
+        }
+
+        ++count;
+        ++pDriverID;
+    }
+
+    *pDriverOffset = pDriverID - pStartIDs[driver];
+    *pCount = count;
+
+    return to_foeResult(result);
+}
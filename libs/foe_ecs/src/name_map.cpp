@@ -1,4 +1,4 @@
-// Copyright (C) 2021-2022 George Cave.
+// Copyright (C) 2021-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
@@ -10,26 +10,230 @@
 #include "log.hpp"
 #include "result.h"
 
-#include <map>
+#include <algorithm>
+#include <cstring>
 #include <mutex>
+#include <numeric>
 #include <shared_mutex>
-#include <string>
+#include <string_view>
+#include <vector>
 
 namespace {
 
+/// An ID and where its name is in the string arena
+struct Entry {
+    foeId id;
+    uint32_t nameOffset;
+    uint32_t nameLength;
+};
+
+/// Open-addressed slot for looking up IDs by name, empty if the ID is FOE_INVALID_ID
+struct Slot {
+    uint32_t hash;
+    foeId id;
+    uint32_t nameOffset;
+    uint32_t nameLength;
+};
+
 struct NameMap {
     std::shared_mutex sync{};
 
-    std::map<std::string, foeId> editorToId;
-    std::map<foeId, std::string> idToEditor;
+    /// All names, each followed by a null terminator. Removed or replaced names are left in place
+    /// until enough have built up to be worth compacting.
+    std::vector<char> arena;
+    /// Bytes in the arena belonging to removed or replaced names
+    size_t deadBytes;
+
+    /// Entries sorted by ID, for looking up names by ID
+    std::vector<Entry> entries;
+
+    /// Linear-probed table for looking up IDs by name, capacity is zero or a power of two
+    std::vector<Slot> slots;
 };
 
 FOE_DEFINE_HANDLE_CASTS(name_map, NameMap, foeEcsNameMap)
 
+uint32_t hashName(std::string_view name) {
+    return static_cast<uint32_t>(std::hash<std::string_view>{}(name));
+}
+
+std::string_view getName(NameMap const *pNameMap, uint32_t offset, uint32_t length) {
+    return std::string_view{pNameMap->arena.data() + offset, length};
+}
+
+/// Returns the slot holding the name, or nullptr if the name isn't in the map
+Slot const *findSlot(NameMap const *pNameMap, std::string_view name, uint32_t hash) {
+    if (pNameMap->slots.empty())
+        return nullptr;
+
+    size_t const mask = pNameMap->slots.size() - 1;
+
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        Slot const &slot = pNameMap->slots[i];
+
+        if (slot.id == FOE_INVALID_ID)
+            return nullptr;
+        if (slot.hash == hash && slot.nameLength == name.size() &&
+            getName(pNameMap, slot.nameOffset, slot.nameLength) == name)
+            return &slot;
+    }
+}
+
+/// Inserts into the table, which must have a free slot and not already hold the name
+void insertSlot(NameMap *pNameMap, Slot const &newSlot) {
+    size_t const mask = pNameMap->slots.size() - 1;
+
+    size_t i = newSlot.hash & mask;
+    while (pNameMap->slots[i].id != FOE_INVALID_ID)
+        i = (i + 1) & mask;
+
+    pNameMap->slots[i] = newSlot;
+}
+
+/// Removes the ID's slot, shifting back any following slots so no tombstones are needed
+void eraseSlot(NameMap *pNameMap, foeId id, uint32_t hash) {
+    size_t const mask = pNameMap->slots.size() - 1;
+
+    size_t hole = hash & mask;
+    while (pNameMap->slots[hole].id != id)
+        hole = (hole + 1) & mask;
+
+    for (size_t i = (hole + 1) & mask;; i = (i + 1) & mask) {
+        Slot &slot = pNameMap->slots[i];
+        if (slot.id == FOE_INVALID_ID)
+            break;
+
+        // Only move slots whose home position isn't between the hole and themselves
+        size_t const home = slot.hash & mask;
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            pNameMap->slots[hole] = slot;
+            hole = i;
+        }
+    }
+
+    pNameMap->slots[hole].id = FOE_INVALID_ID;
+}
+
+/// Rebuilds the lookup table from the entries, with room for at least the given number of names
+void rebuildSlots(NameMap *pNameMap, size_t nameCapacity) {
+    size_t capacity = 16;
+    while (capacity * 3 < nameCapacity * 4)
+        capacity *= 2;
+
+    pNameMap->slots.assign(capacity, Slot{.id = FOE_INVALID_ID});
+
+    for (auto const &entry : pNameMap->entries) {
+        insertSlot(pNameMap,
+                   Slot{
+                       .hash = hashName(getName(pNameMap, entry.nameOffset, entry.nameLength)),
+                       .id = entry.id,
+                       .nameOffset = entry.nameOffset,
+                       .nameLength = entry.nameLength,
+                   });
+    }
+}
+
+/// Makes sure the lookup table can take the given number of additional names within its load limit
+void reserveSlots(NameMap *pNameMap, size_t additionalCount) {
+    size_t const nameCount = pNameMap->entries.size() + additionalCount;
+
+    if (nameCount * 4 > pNameMap->slots.size() * 3)
+        rebuildSlots(pNameMap, std::max(nameCount, pNameMap->slots.size()));
+}
+
+/// Copies the name to the end of the arena, returning its offset
+uint32_t appendName(NameMap *pNameMap, std::string_view name) {
+    uint32_t const offset = pNameMap->arena.size();
+
+    pNameMap->arena.insert(pNameMap->arena.end(), name.begin(), name.end());
+    pNameMap->arena.push_back('\0');
+
+    return offset;
+}
+
+/// Marks the name as no longer used, compacting the arena if at least half of it is unused
+void releaseName(NameMap *pNameMap, uint32_t nameLength) {
+    pNameMap->deadBytes += nameLength + 1;
+    if (pNameMap->deadBytes * 2 < pNameMap->arena.size())
+        return;
+
+    std::vector<char> oldArena;
+    oldArena.swap(pNameMap->arena);
+    pNameMap->arena.reserve(oldArena.size() - pNameMap->deadBytes);
+    pNameMap->deadBytes = 0;
+
+    for (auto &entry : pNameMap->entries) {
+        entry.nameOffset = appendName(
+            pNameMap, std::string_view{oldArena.data() + entry.nameOffset, entry.nameLength});
+    }
+
+    rebuildSlots(pNameMap, pNameMap->entries.size());
+}
+
+auto findEntry(NameMap *pNameMap, foeId id) {
+    auto searchIt =
+        std::lower_bound(pNameMap->entries.begin(), pNameMap->entries.end(), id,
+                         [](Entry const &entry, foeId id) { return entry.id < id; });
+
+    if (searchIt != pNameMap->entries.end() && searchIt->id != id)
+        return pNameMap->entries.end();
+
+    return searchIt;
+}
+
+/** @brief Checks whether the ID and name can be added to the map
+ * @note The lock must be held.
+ */
+foeEcsResult validateAdd(NameMap *pNameMap, foeId id, std::string_view name, uint32_t hash) {
+    if (id == FOE_INVALID_ID) {
+        FOE_LOG(foeECS, FOE_LOG_LEVEL_WARNING,
+                "Attempted to add an invalid ID with an editor name of '{}'", name)
+        return FOE_ECS_ERROR_INVALID_ID;
+    }
+    if (name.empty()) {
+        FOE_LOG(foeECS, FOE_LOG_LEVEL_WARNING, "Attempted to add ID {} with a blank editor name",
+                foeIdToString(id))
+        return FOE_ECS_ERROR_EMPTY_NAME;
+    }
+    if (findEntry(pNameMap, id) != pNameMap->entries.end()) {
+        FOE_LOG(foeECS, FOE_LOG_LEVEL_WARNING,
+                "Attempted to add ID {} that already has an editor name", foeIdToString(id))
+        return FOE_ECS_ERROR_ID_ALREADY_EXISTS;
+    }
+    if (Slot const *pSlot = findSlot(pNameMap, name, hash); pSlot != nullptr) {
+        FOE_LOG(foeECS, FOE_LOG_LEVEL_WARNING,
+                "Attempted to add ID {} that with editor name {} that is already used by ID {}",
+                foeIdToString(id), name, foeIdToString(pSlot->id))
+        return FOE_ECS_ERROR_NAME_ALREADY_EXISTS;
+    }
+
+    return FOE_ECS_SUCCESS;
+}
+
+/** @brief Adds the name to the arena and lookup table, returning the new entry
+ * @note The lock must be held, with the lookup table already having room for the name.
+ */
+Entry addName(NameMap *pNameMap, foeId id, std::string_view name, uint32_t hash) {
+    Entry newEntry{
+        .id = id,
+        .nameOffset = appendName(pNameMap, name),
+        .nameLength = static_cast<uint32_t>(name.size()),
+    };
+
+    insertSlot(pNameMap, Slot{
+                             .hash = hash,
+                             .id = id,
+                             .nameOffset = newEntry.nameOffset,
+                             .nameLength = newEntry.nameLength,
+                         });
+
+    return newEntry;
+}
+
 } // namespace
 
 extern "C" foeResultSet foeEcsCreateNameMap(foeEcsNameMap *pNameMap) {
-    NameMap *pNewNameMap = new (std::nothrow) NameMap;
+    NameMap *pNewNameMap = new (std::nothrow) NameMap{};
     if (pNewNameMap == nullptr)
         return to_foeResult(FOE_ECS_ERROR_OUT_OF_MEMORY);
 
@@ -46,11 +250,14 @@ extern "C" void foeEcsDestroyNameMap(foeEcsNameMap nameMap) {
 
 extern "C" foeResultSet foeEcsNameMapFindID(foeEcsNameMap nameMap, char const *pName, foeId *pID) {
     NameMap *pNameMap = name_map_from_handle(nameMap);
+    std::string_view name{pName};
+    uint32_t const hash = hashName(name);
+
     std::shared_lock lock{pNameMap->sync};
 
-    auto searchIt = pNameMap->editorToId.find(pName);
-    if (searchIt != pNameMap->editorToId.end()) {
-        *pID = searchIt->second;
+    Slot const *pSlot = findSlot(pNameMap, name, hash);
+    if (pSlot != nullptr) {
+        *pID = pSlot->id;
         return to_foeResult(FOE_ECS_SUCCESS);
     }
 
@@ -64,19 +271,19 @@ extern "C" foeResultSet foeEcsNameMapFindName(foeEcsNameMap nameMap,
     NameMap *pNameMap = name_map_from_handle(nameMap);
     std::shared_lock lock{pNameMap->sync};
 
-    auto searchIt = pNameMap->idToEditor.find(id);
-    if (searchIt != pNameMap->idToEditor.end()) {
+    auto searchIt = findEntry(pNameMap, id);
+    if (searchIt != pNameMap->entries.end()) {
         foeResultSet result = to_foeResult(FOE_ECS_SUCCESS);
         if (pName == nullptr) {
-            *pNameLength = searchIt->second.size() + 1;
+            *pNameLength = searchIt->nameLength + 1;
             return result;
         }
 
-        // Otherwise copy operation
-        uint32_t copySize = std::min((uint32_t)searchIt->second.size() + 1, *pNameLength);
-        if (copySize < searchIt->second.size() + 1)
+        // Otherwise copy operation, the stored null terminator is copied along with the name
+        uint32_t copySize = std::min(searchIt->nameLength + 1, *pNameLength);
+        if (copySize < searchIt->nameLength + 1)
             result = to_foeResult(FOE_ECS_INCOMPLETE);
-        memcpy(pName, searchIt->second.data(), copySize);
+        memcpy(pName, pNameMap->arena.data() + searchIt->nameOffset, copySize);
         *pNameLength = copySize;
 
         return result;
@@ -86,36 +293,94 @@ extern "C" foeResultSet foeEcsNameMapFindName(foeEcsNameMap nameMap,
 }
 
 extern "C" foeResultSet foeEcsNameMapAdd(foeEcsNameMap nameMap, foeId id, char const *pName) {
-    if (id == FOE_INVALID_ID) {
-        FOE_LOG(foeECS, FOE_LOG_LEVEL_WARNING,
-                "Attempted to add an invalid ID with an editor name of '{}'", pName)
-        return to_foeResult(FOE_ECS_ERROR_INVALID_ID);
-    }
-    if (strlen(pName) == 0) {
-        FOE_LOG(foeECS, FOE_LOG_LEVEL_WARNING, "Attempted to add ID {} with a blank editor name",
-                foeIdToString(id))
-        return to_foeResult(FOE_ECS_ERROR_EMPTY_NAME);
-    }
-
     NameMap *pNameMap = name_map_from_handle(nameMap);
+    std::string_view name{pName};
+    uint32_t const hash = hashName(name);
+
     std::unique_lock lock{pNameMap->sync};
 
-    if (pNameMap->idToEditor.find(id) != pNameMap->idToEditor.end()) {
-        FOE_LOG(foeECS, FOE_LOG_LEVEL_WARNING,
-                "Attempted to add ID {} that already has an editor name", foeIdToString(id))
-        return to_foeResult(FOE_ECS_ERROR_ID_ALREADY_EXISTS);
+    foeEcsResult result = validateAdd(pNameMap, id, name, hash);
+    if (result != FOE_ECS_SUCCESS)
+        return to_foeResult(result);
+
+    reserveSlots(pNameMap, 1);
+    Entry newEntry = addName(pNameMap, id, name, hash);
+
+    // IDs are commonly added in ascending order, in which case this appends
+    auto insertIt =
+        std::upper_bound(pNameMap->entries.begin(), pNameMap->entries.end(), id,
+                         [](foeId id, Entry const &entry) { return id < entry.id; });
+    pNameMap->entries.insert(insertIt, newEntry);
+
+    return to_foeResult(FOE_ECS_SUCCESS);
+}
+
+extern "C" foeResultSet foeEcsNameMapAddMany(foeEcsNameMap nameMap,
+                                             uint32_t count,
+                                             foeEcsNameMapEntry const *pEntries) {
+    NameMap *pNameMap = name_map_from_handle(nameMap);
+
+    // Order the new entries by ID, so they can be merged in with the existing ones in one pass
+    std::vector<uint32_t> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [pEntries](uint32_t lhs, uint32_t rhs) {
+        return pEntries[lhs].id < pEntries[rhs].id;
+    });
+
+    std::vector<uint32_t> hashes(count);
+    size_t nameBytes = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string_view name{pEntries[i].pName};
+
+        hashes[i] = hashName(name);
+        nameBytes += name.size() + 1;
     }
-    if (pNameMap->editorToId.find(pName) != pNameMap->editorToId.end()) {
-        FOE_LOG(foeECS, FOE_LOG_LEVEL_WARNING,
-                "Attempted to add ID {} that with editor name {} that is already used by ID {}",
-                foeIdToString(id), pName, foeIdToString(pNameMap->editorToId.find(pName)->second))
-        return to_foeResult(FOE_ECS_ERROR_NAME_ALREADY_EXISTS);
+
+    foeEcsResult result = FOE_ECS_SUCCESS;
+    std::vector<Entry> newEntries;
+    newEntries.reserve(count);
+
+    std::unique_lock lock{pNameMap->sync};
+
+    pNameMap->arena.reserve(pNameMap->arena.size() + nameBytes);
+    reserveSlots(pNameMap, count);
+
+    for (uint32_t i : order) {
+        foeId const id = pEntries[i].id;
+        std::string_view name{pEntries[i].pName};
+
+        foeEcsResult entryResult;
+        if (!newEntries.empty() && newEntries.back().id == id) {
+            FOE_LOG(foeECS, FOE_LOG_LEVEL_WARNING,
+                    "Attempted to add ID {} more than once in the same set of editor names",
+                    foeIdToString(id))
+            entryResult = FOE_ECS_ERROR_ID_ALREADY_EXISTS;
+        } else {
+            entryResult = validateAdd(pNameMap, id, name, hashes[i]);
+        }
+
+        if (entryResult != FOE_ECS_SUCCESS) {
+            if (result == FOE_ECS_SUCCESS)
+                result = entryResult;
+            continue;
+        }
+
+        newEntries.emplace_back(addName(pNameMap, id, name, hashes[i]));
     }
 
-    pNameMap->idToEditor.emplace(id, pName);
-    pNameMap->editorToId.emplace(pName, id);
+    // Both sets are sorted, so only need merging if the new IDs don't all follow the existing ones
+    size_t const existingCount = pNameMap->entries.size();
+    pNameMap->entries.insert(pNameMap->entries.end(), newEntries.begin(), newEntries.end());
 
-    return to_foeResult(FOE_ECS_SUCCESS);
+    auto existingEnd = pNameMap->entries.begin() + existingCount;
+    if (existingCount != 0 && !newEntries.empty() &&
+        (existingEnd - 1)->id > newEntries.front().id) {
+        std::inplace_merge(
+            pNameMap->entries.begin(), existingEnd, pNameMap->entries.end(),
+            [](Entry const &lhs, Entry const &rhs) { return lhs.id < rhs.id; });
+    }
+
+    return to_foeResult(result);
 }
 
 extern "C" foeResultSet foeEcsNameMapUpdate(foeEcsNameMap nameMap, foeId id, char const *pName) {
@@ -126,27 +391,33 @@ extern "C" foeResultSet foeEcsNameMapUpdate(foeEcsNameMap nameMap, foeId id, cha
     }
 
     NameMap *pNameMap = name_map_from_handle(nameMap);
+    std::string_view name{pName};
+    uint32_t const hash = hashName(name);
+
     std::unique_lock lock{pNameMap->sync};
 
     // Make sure editor name not already in use
-    if (pNameMap->editorToId.find(pName) != pNameMap->editorToId.end()) {
+    if (Slot const *pSlot = findSlot(pNameMap, name, hash); pSlot != nullptr) {
         FOE_LOG(foeECS, FOE_LOG_LEVEL_WARNING,
                 "Attempted to update ID {} with editor name '{}' already used by ID {}",
-                foeIdToString(id), pName, foeIdToString(pNameMap->editorToId.find(pName)->second))
+                foeIdToString(id), pName, foeIdToString(pSlot->id))
         return to_foeResult(FOE_ECS_ERROR_NAME_ALREADY_EXISTS);
     }
 
-    auto searchIt = pNameMap->idToEditor.find(id);
-    if (searchIt == pNameMap->idToEditor.end()) {
+    auto searchIt = findEntry(pNameMap, id);
+    if (searchIt == pNameMap->entries.end()) {
         FOE_LOG(foeECS, FOE_LOG_LEVEL_INFO,
                 "Attempted to update ID {} that did not have an editorName", foeIdToString(id))
         return to_foeResult(FOE_ECS_ERROR_NO_MATCH);
     }
 
-    pNameMap->editorToId.erase(pName);
-    pNameMap->editorToId.emplace(pName, id);
+    eraseSlot(pNameMap, id,
+              hashName(getName(pNameMap, searchIt->nameOffset, searchIt->nameLength)));
+    Entry newEntry = addName(pNameMap, id, name, hash);
 
-    searchIt->second = pName;
+    uint32_t const oldNameLength = searchIt->nameLength;
+    *searchIt = newEntry;
+    releaseName(pNameMap, oldNameLength);
 
     return to_foeResult(FOE_ECS_SUCCESS);
 }
@@ -155,15 +426,19 @@ extern "C" foeResultSet foeEcsNameMapRemove(foeEcsNameMap nameMap, foeId id) {
     NameMap *pNameMap = name_map_from_handle(nameMap);
     std::unique_lock lock{pNameMap->sync};
 
-    auto searchIt = pNameMap->idToEditor.find(id);
-    if (searchIt == pNameMap->idToEditor.end()) {
+    auto searchIt = findEntry(pNameMap, id);
+    if (searchIt == pNameMap->entries.end()) {
         FOE_LOG(foeECS, FOE_LOG_LEVEL_INFO,
                 "Attempted to remove ID {} that did not have an editorName", foeIdToString(id))
         return to_foeResult(FOE_ECS_NO_MATCH);
     }
 
-    pNameMap->editorToId.erase(searchIt->second);
-    pNameMap->idToEditor.erase(searchIt);
+    eraseSlot(pNameMap, id,
+              hashName(getName(pNameMap, searchIt->nameOffset, searchIt->nameLength)));
+
+    uint32_t const oldNameLength = searchIt->nameLength;
+    pNameMap->entries.erase(searchIt);
+    releaseName(pNameMap, oldNameLength);
 
     return to_foeResult(FOE_ECS_SUCCESS);
-}
\ No newline at end of file
+}
@@ -1,4 +1,4 @@
-// Copyright (C) 2022-2025 George Cave.
+// Copyright (C) 2022-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
@@ -33,6 +33,7 @@ void foeEcsResultToString(int value, char buffer[FOE_MAX_RESULT_STRING_SIZE]) {
         RESULT_CASE(FOE_ECS_ERROR_ID_ALREADY_EXISTS)
         RESULT_CASE(FOE_ECS_ERROR_NAME_ALREADY_EXISTS)
         RESULT_CASE(FOE_ECS_ERROR_NO_MATCH)
+        RESULT_CASE(FOE_ECS_ERROR_ID_ALREADY_FREED)
 
     default:
         if (value > 0) {
@@ -1,11 +1,18 @@
-// Copyright (C) 2023 George Cave.
+// Copyright (C) 2023-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <foe/ecs/component_pool.h>
 
+#include <algorithm>
 #include <atomic>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 TEST_CASE("ComponentPool - Check destructors called when component data is freed") {
     foeEcsComponentPool testPool = FOE_NULL_HANDLE;
@@ -245,6 +252,111 @@ TEST_CASE("ComponentPool - Test setting insertion capacity") {
 
     CHECK(foeEcsComponentPoolInsertCapacity(testPool) == 8192);
 
+    // Further insertions that fit don't grow it any more
+    for (int i = 2; i < 64; ++i) {
+        result = foeEcsComponentPoolInsert(testPool, foeEntityID(i), &val);
+        REQUIRE(result.value == FOE_SUCCESS);
+    }
+
+    CHECK(foeEcsComponentPoolInsertCapacity(testPool) == 8192);
+
+    foeEcsDestroyComponentPool(testPool);
+}
+
+TEST_CASE("ComponentPool - Growth policy") {
+    foeEcsComponentPool testPool = FOE_NULL_HANDLE;
+    foeResultSet result;
+
+    result = foeEcsCreateComponentPool(0, 1, sizeof(uint32_t), NULL, &testPool);
+    REQUIRE(result.value == FOE_SUCCESS);
+    REQUIRE(testPool != FOE_NULL_HANDLE);
+
+    auto insertAndMaintain = [&](uint32_t first, uint32_t count) {
+        for (uint32_t i = first; i < first + count; ++i) {
+            result = foeEcsComponentPoolInsert(testPool, foeEntityID(i), &i);
+            REQUIRE(result.value == FOE_SUCCESS);
+        }
+        result = foeEcsComponentPoolMaintenance(testPool);
+        REQUIRE(result.value == FOE_SUCCESS);
+    };
+
+    foeEcsComponentPoolStatistics statistics;
+
+    SECTION("Default is geometric growth") {
+        insertAndMaintain(1, 3);
+        CHECK(foeEcsComponentPoolCapacity(testPool) == 3);
+
+        insertAndMaintain(4, 1);
+        CHECK(foeEcsComponentPoolCapacity(testPool) == 6);
+
+        insertAndMaintain(5, 2);
+        CHECK(foeEcsComponentPoolCapacity(testPool) == 6);
+
+        insertAndMaintain(7, 1);
+        CHECK(foeEcsComponentPoolCapacity(testPool) == 12);
+
+        foeEcsComponentPoolGetStatistics(testPool, &statistics);
+        CHECK(statistics.reallocations == 3);
+        CHECK(statistics.bytesMoved != 0);
+    }
+
+    SECTION("Linear growth with headroom") {
+        foeEcsComponentPoolGrowthPolicy const policy{
+            .growthFactor = 1.f,
+            .minHeadroomPercent = 50,
+            .shrinkThresholdPercent = 0,
+        };
+        foeEcsComponentPoolSetGrowthPolicy(testPool, &policy);
+
+        insertAndMaintain(1, 10);
+        CHECK(foeEcsComponentPoolCapacity(testPool) == 15);
+
+        insertAndMaintain(11, 6);
+        CHECK(foeEcsComponentPoolCapacity(testPool) == 24);
+
+        foeEcsComponentPoolGetStatistics(testPool, &statistics);
+        CHECK(statistics.reallocations == 2);
+    }
+
+    SECTION("Shrinks when occupancy falls below the threshold") {
+        foeEcsComponentPoolGrowthPolicy const policy{
+            .growthFactor = 2.f,
+            .minHeadroomPercent = 0,
+            .shrinkThresholdPercent = 25,
+        };
+        foeEcsComponentPoolSetGrowthPolicy(testPool, &policy);
+
+        foeEcsComponentPoolGrowthPolicy readPolicy;
+        foeEcsComponentPoolGetGrowthPolicy(testPool, &readPolicy);
+        CHECK(readPolicy.shrinkThresholdPercent == 25);
+
+        insertAndMaintain(1, 100);
+        CHECK(foeEcsComponentPoolCapacity(testPool) == 100);
+
+        // Down to 30% used, no change
+        for (uint32_t i = 1; i <= 70; ++i)
+            foeEcsComponentPoolRemove(testPool, foeEntityID(i));
+        REQUIRE(foeEcsComponentPoolMaintenance(testPool).value == FOE_SUCCESS);
+        CHECK(foeEcsComponentPoolCapacity(testPool) == 100);
+
+        // Down to 20% used, shrinks to fit
+        for (uint32_t i = 71; i <= 80; ++i)
+            foeEcsComponentPoolRemove(testPool, foeEntityID(i));
+        REQUIRE(foeEcsComponentPoolMaintenance(testPool).value == FOE_SUCCESS);
+        CHECK(foeEcsComponentPoolCapacity(testPool) == 20);
+        CHECK(foeEcsComponentPoolRemoved(testPool) == 10);
+
+        foeEntityID const *pIDs = foeEcsComponentPoolIdPtr(testPool);
+        uint32_t const *pData = (uint32_t *)foeEcsComponentPoolDataPtr(testPool);
+        for (uint32_t i = 0; i < 20; ++i) {
+            CHECK(pIDs[i] == foeEntityID(81 + i));
+            CHECK(pData[i] == 81 + i);
+        }
+
+        foeEcsComponentPoolGetStatistics(testPool, &statistics);
+        CHECK(statistics.reallocations == 2);
+    }
+
     foeEcsDestroyComponentPool(testPool);
 }
 
@@ -479,6 +591,79 @@ TEST_CASE(
     foeEcsDestroyComponentPool(testPool);
 }
 
+TEST_CASE("ComponentPool - Duplicate insertions of many entities keep the last one queued") {
+    foeEcsComponentPool testPool = FOE_NULL_HANDLE;
+    foeResultSet result;
+
+    result = foeEcsCreateComponentPool(0, 1, sizeof(int), NULL, &testPool);
+    REQUIRE(result.value == FOE_SUCCESS);
+    REQUIRE(testPool != FOE_NULL_HANDLE);
+
+    // Enough entries that the sort isn't just an insertion sort, which would keep the order anyway
+    for (int pass = 0; pass < 4; ++pass) {
+        for (int i = 0; i < 256; ++i) {
+            int temp = pass;
+            result = foeEcsComponentPoolInsert(testPool, foeEntityID(256 - i), &temp);
+            REQUIRE(result.value == FOE_SUCCESS);
+        }
+    }
+
+    result = foeEcsComponentPoolMaintenance(testPool);
+    REQUIRE(result.value == FOE_SUCCESS);
+
+    REQUIRE(foeEcsComponentPoolSize(testPool) == 256);
+    REQUIRE(foeEcsComponentPoolInserted(testPool) == 256);
+
+    foeEntityID const *pIDs = foeEcsComponentPoolIdPtr(testPool);
+    int const *pData = (int *)foeEcsComponentPoolDataPtr(testPool);
+    for (size_t i = 0; i < 256; ++i) {
+        CHECK(pIDs[i] == foeEntityID(i + 1));
+        CHECK(pData[i] == 3);
+    }
+
+    foeEcsDestroyComponentPool(testPool);
+}
+
+TEST_CASE("ComponentPool - Duplicate insertions from different threads keep those of one thread") {
+    constexpr int numThreads = 4;
+
+    foeEcsComponentPool testPool = FOE_NULL_HANDLE;
+    foeResultSet result;
+
+    result = foeEcsCreateComponentPool(0, 1, sizeof(int), NULL, &testPool);
+    REQUIRE(result.value == FOE_SUCCESS);
+    REQUIRE(testPool != FOE_NULL_HANDLE);
+
+    // Every thread stages the same entities, with its own index as the data
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < 256; ++i) {
+                int temp = t;
+                foeEcsComponentPoolInsert(testPool, foeEntityID(i + 1), &temp);
+            }
+        });
+    }
+    for (auto &it : threads)
+        it.join();
+
+    result = foeEcsComponentPoolMaintenance(testPool);
+    REQUIRE(result.value == FOE_SUCCESS);
+
+    REQUIRE(foeEcsComponentPoolSize(testPool) == 256);
+    REQUIRE(foeEcsComponentPoolInserted(testPool) == 256);
+
+    // Which thread is kept depends on staging shard order, but it is the same one for every entity
+    int const *pData = (int *)foeEcsComponentPoolDataPtr(testPool);
+    REQUIRE(pData[0] >= 0);
+    REQUIRE(pData[0] < numThreads);
+    for (size_t i = 1; i < 256; ++i) {
+        CHECK(pData[i] == pData[0]);
+    }
+
+    foeEcsDestroyComponentPool(testPool);
+}
+
 TEST_CASE("ComponentPool - Attempting to add same entity in a different pass fails, original stays "
           "intact") {
     foeEcsComponentPool testPool = FOE_NULL_HANDLE;
@@ -850,3 +1035,895 @@ TEST_CASE("ComponentPool - Attempting to remove items not in the pool has no und
 
     foeEcsDestroyComponentPool(testPool);
 }
+
+TEST_CASE("ComponentPool - Removal and insertion in the same maintenance") {
+    foeEcsComponentPool testPool = FOE_NULL_HANDLE;
+    foeResultSet result;
+
+    result = foeEcsCreateComponentPool(0, 1, sizeof(int), NULL, &testPool);
+    REQUIRE(result.value == FOE_SUCCESS);
+    REQUIRE(testPool != FOE_NULL_HANDLE);
+
+    for (int i = 2; i <= 16; i += 2) {
+        result = foeEcsComponentPoolInsert(testPool, foeEntityID(i), &i);
+        REQUIRE(result.value == FOE_SUCCESS);
+    }
+
+    result = foeEcsComponentPoolMaintenance(testPool);
+    REQUIRE(result.value == FOE_SUCCESS);
+    REQUIRE(foeEcsComponentPoolSize(testPool) == 8);
+
+    SECTION("Changes throughout the pool") {
+        // Entity 6 is removed and re-inserted with new data in the same pass
+        for (int i : {2, 6, 10, 14}) {
+            result = foeEcsComponentPoolRemove(testPool, foeEntityID(i));
+            REQUIRE(result.value == FOE_SUCCESS);
+        }
+        for (int i : {3, 6, 7, 11, 15}) {
+            int temp = i * 10;
+            result = foeEcsComponentPoolInsert(testPool, foeEntityID(i), &temp);
+            REQUIRE(result.value == FOE_SUCCESS);
+        }
+
+        result = foeEcsComponentPoolMaintenance(testPool);
+        REQUIRE(result.value == FOE_SUCCESS);
+
+        REQUIRE(foeEcsComponentPoolSize(testPool) == 9);
+        REQUIRE(foeEcsComponentPoolRemoved(testPool) == 4);
+        REQUIRE(foeEcsComponentPoolInserted(testPool) == 5);
+
+        foeEntityID const expectedIDs[] = {3, 4, 6, 7, 8, 11, 12, 15, 16};
+        int const expectedData[] = {30, 4, 60, 70, 8, 110, 12, 150, 16};
+        foeEntityID const *pIDs = foeEcsComponentPoolIdPtr(testPool);
+        int const *pData = (int *)foeEcsComponentPoolDataPtr(testPool);
+        for (size_t i = 0; i < 9; ++i) {
+            CHECK(pIDs[i] == expectedIDs[i]);
+            CHECK(pData[i] == expectedData[i]);
+        }
+
+        foeEntityID const expectedRemovedIDs[] = {2, 6, 10, 14};
+        foeEntityID const *pRemovedIDs = foeEcsComponentPoolRemovedIdPtr(testPool);
+        int const *pRemovedData = (int *)foeEcsComponentPoolRemovedDataPtr(testPool);
+        for (size_t i = 0; i < 4; ++i) {
+            CHECK(pRemovedIDs[i] == expectedRemovedIDs[i]);
+            CHECK(pRemovedData[i] == (int)expectedRemovedIDs[i]);
+        }
+
+        size_t const expectedInsertedOffsets[] = {0, 2, 3, 5, 7};
+        size_t const *pInsertedOffsets = foeEcsComponentPoolInsertedOffsetPtr(testPool);
+        for (size_t i = 0; i < 5; ++i)
+            CHECK(pInsertedOffsets[i] == expectedInsertedOffsets[i]);
+
+        // Once more, to make sure everything carries over to the following pass
+        result = foeEcsComponentPoolRemove(testPool, foeEntityID(3));
+        REQUIRE(result.value == FOE_SUCCESS);
+        int temp = 1;
+        result = foeEcsComponentPoolInsert(testPool, foeEntityID(1), &temp);
+        REQUIRE(result.value == FOE_SUCCESS);
+
+        result = foeEcsComponentPoolMaintenance(testPool);
+        REQUIRE(result.value == FOE_SUCCESS);
+
+        REQUIRE(foeEcsComponentPoolSize(testPool) == 9);
+        pIDs = foeEcsComponentPoolIdPtr(testPool);
+        pData = (int *)foeEcsComponentPoolDataPtr(testPool);
+        CHECK(pIDs[0] == foeEntityID(1));
+        CHECK(pData[0] == 1);
+        for (size_t i = 1; i < 9; ++i) {
+            CHECK(pIDs[i] == expectedIDs[i]);
+            CHECK(pData[i] == expectedData[i]);
+        }
+    }
+
+    SECTION("Changes only at the end of the pool") {
+        result = foeEcsComponentPoolRemove(testPool, foeEntityID(16));
+        REQUIRE(result.value == FOE_SUCCESS);
+        int temp = 170;
+        result = foeEcsComponentPoolInsert(testPool, foeEntityID(17), &temp);
+        REQUIRE(result.value == FOE_SUCCESS);
+
+        result = foeEcsComponentPoolMaintenance(testPool);
+        REQUIRE(result.value == FOE_SUCCESS);
+
+        REQUIRE(foeEcsComponentPoolSize(testPool) == 8);
+        REQUIRE(foeEcsComponentPoolRemoved(testPool) == 1);
+        REQUIRE(foeEcsComponentPoolInserted(testPool) == 1);
+
+        foeEntityID const *pIDs = foeEcsComponentPoolIdPtr(testPool);
+        int const *pData = (int *)foeEcsComponentPoolDataPtr(testPool);
+        for (size_t i = 0; i < 7; ++i) {
+            CHECK(pIDs[i] == foeEntityID(2 * i + 2));
+            CHECK(pData[i] == (int)(2 * i + 2));
+        }
+        CHECK(pIDs[7] == foeEntityID(17));
+        CHECK(pData[7] == 170);
+
+        CHECK(foeEcsComponentPoolRemovedIdPtr(testPool)[0] == foeEntityID(16));
+        CHECK(foeEcsComponentPoolInsertedOffsetPtr(testPool)[0] == 7);
+    }
+
+    foeEcsDestroyComponentPool(testPool);
+}
+
+TEST_CASE("ComponentPool - Finding offsets") {
+    foeEcsComponentPool testPool = FOE_NULL_HANDLE;
+    foeResultSet result;
+
+    result = foeEcsCreateComponentPool(0, 1, sizeof(foeEntityID), NULL, &testPool);
+    REQUIRE(result.value == FOE_SUCCESS);
+    REQUIRE(testPool != FOE_NULL_HANDLE);
+
+    // IDs in two different groups with the same index bits, spread over several index pages
+    std::vector<foeEntityID> stored;
+    for (foeIdIndex index = 1; index < 5000; index += 3) {
+        stored.emplace_back(foeIdCreate(0, index));
+        stored.emplace_back(foeIdCreate(foeIdPersistentGroup, index));
+    }
+
+    auto checkOffsets = [&]() {
+        REQUIRE(foeEcsComponentPoolSize(testPool) == stored.size());
+
+        foeEntityID const *pIDs = foeEcsComponentPoolIdPtr(testPool);
+        for (foeEntityID entity : stored) {
+            size_t offset = SIZE_MAX;
+            REQUIRE(foeEcsComponentPoolFindOffset(testPool, entity, &offset));
+            REQUIRE(offset < foeEcsComponentPoolSize(testPool));
+            REQUIRE(pIDs[offset] == entity);
+        }
+
+        size_t offset;
+        CHECK_FALSE(foeEcsComponentPoolFindOffset(testPool, foeIdCreate(0, 3), &offset));
+        CHECK_FALSE(foeEcsComponentPoolFindOffset(testPool, foeIdCreate(0, 100000), &offset));
+        CHECK_FALSE(foeEcsComponentPoolFindOffset(testPool, foeIdCreate(foeIdTemporaryGroup, 1),
+                                                  &offset));
+    };
+
+    bool enableAfterInserting = false;
+    SECTION("Offset index enabled before inserting") {
+        REQUIRE(foeEcsComponentPoolEnableOffsetIndex(testPool).value == FOE_SUCCESS);
+    }
+    SECTION("Offset index enabled after inserting") { enableAfterInserting = true; }
+    SECTION("Without an offset index") {}
+
+    for (foeEntityID entity : stored)
+        foeEcsComponentPoolInsert(testPool, entity, &entity);
+    result = foeEcsComponentPoolMaintenance(testPool);
+    REQUIRE(result.value == FOE_SUCCESS);
+
+    if (enableAfterInserting)
+        REQUIRE(foeEcsComponentPoolEnableOffsetIndex(testPool).value == FOE_SUCCESS);
+    checkOffsets();
+
+    // Remove every fourth stored entity and insert some new ones before them
+    std::vector<foeEntityID> kept;
+    for (size_t i = 0; i < stored.size(); ++i) {
+        if (i % 4 == 0)
+            foeEcsComponentPoolRemove(testPool, stored[i]);
+        else
+            kept.emplace_back(stored[i]);
+    }
+    for (foeIdIndex index = 2; index < 5000; index += 30) {
+        foeEntityID const entity = foeIdCreate(0, index);
+        foeEcsComponentPoolInsert(testPool, entity, (void *)&entity);
+        kept.emplace_back(entity);
+    }
+    stored = kept;
+
+    result = foeEcsComponentPoolMaintenance(testPool);
+    REQUIRE(result.value == FOE_SUCCESS);
+
+    checkOffsets();
+
+    foeEcsDestroyComponentPool(testPool);
+}
+
+TEST_CASE("ComponentPool - Tracking changes") {
+    foeEcsComponentPool testPool = FOE_NULL_HANDLE;
+    foeResultSet result;
+
+    result = foeEcsCreateComponentPool(0, 1, sizeof(foeEntityID), NULL, &testPool);
+    REQUIRE(result.value == FOE_SUCCESS);
+    REQUIRE(testPool != FOE_NULL_HANDLE);
+
+    auto changedSince = [&](uint32_t version) {
+        std::vector<foeEntityID> changed;
+        size_t const size = foeEcsComponentPoolSize(testPool);
+        foeEntityID const *pIDs = foeEcsComponentPoolIdPtr(testPool);
+
+        for (size_t offset = foeEcsComponentPoolNextChanged(testPool, version, 0); offset < size;
+             offset = foeEcsComponentPoolNextChanged(testPool, version, offset + 1)) {
+            changed.emplace_back(pIDs[offset]);
+        }
+
+        return changed;
+    };
+    auto markChanged = [&](foeEntityID entity) {
+        size_t offset;
+        REQUIRE(foeEcsComponentPoolFindOffset(testPool, entity, &offset));
+        foeEcsComponentPoolMarkChanged(testPool, offset);
+    };
+
+    SECTION("Without change tracking, nothing is ever changed") {
+        for (foeEntityID entity = 2; entity <= 200; entity += 2)
+            foeEcsComponentPoolInsert(testPool, entity, &entity);
+        result = foeEcsComponentPoolMaintenance(testPool);
+        REQUIRE(result.value == FOE_SUCCESS);
+
+        uint32_t const version = foeEcsComponentPoolAdvanceChangeVersion(testPool);
+        markChanged(10);
+
+        CHECK(changedSince(version).empty());
+        CHECK(changedSince(version - 1).empty());
+    }
+    SECTION("With change tracking") {
+        bool enableAfterInserting = false;
+        SECTION("Enabled before inserting") { foeEcsComponentPoolEnableChangeTracking(testPool); }
+        SECTION("Enabled after inserting") { enableAfterInserting = true; }
+
+        for (foeEntityID entity = 2; entity <= 200; entity += 2)
+            foeEcsComponentPoolInsert(testPool, entity, &entity);
+        result = foeEcsComponentPoolMaintenance(testPool);
+        REQUIRE(result.value == FOE_SUCCESS);
+
+        if (enableAfterInserting)
+            foeEcsComponentPoolEnableChangeTracking(testPool);
+
+        // Everything stored so far is newer than any earlier version
+        CHECK(changedSince(foeEcsComponentPoolAdvanceChangeVersion(testPool) - 1).size() == 100);
+
+        uint32_t const firstVersion = foeEcsComponentPoolAdvanceChangeVersion(testPool);
+        CHECK(changedSince(firstVersion).empty());
+
+        markChanged(10);
+        markChanged(30);
+        markChanged(20);
+        CHECK(changedSince(firstVersion) == std::vector<foeEntityID>{10, 20, 30});
+
+        uint32_t const secondVersion = foeEcsComponentPoolAdvanceChangeVersion(testPool);
+        CHECK(changedSince(secondVersion).empty());
+
+        // Changed versions move along with their entities, and insertions count as changes
+        markChanged(50);
+        foeEcsComponentPoolRemove(testPool, 20);
+        foeEcsComponentPoolRemove(testPool, 40);
+        for (foeEntityID entity : {25, 201}) {
+            foeEcsComponentPoolInsert(testPool, entity, &entity);
+        }
+        result = foeEcsComponentPoolMaintenance(testPool);
+        REQUIRE(result.value == FOE_SUCCESS);
+
+        CHECK(changedSince(secondVersion) == std::vector<foeEntityID>{25, 50, 201});
+        CHECK(changedSince(firstVersion) == std::vector<foeEntityID>{10, 25, 30, 50, 201});
+
+        // Maintenance with only removals
+        foeEcsComponentPoolRemove(testPool, 10);
+        result = foeEcsComponentPoolMaintenance(testPool);
+        REQUIRE(result.value == FOE_SUCCESS);
+
+        CHECK(changedSince(firstVersion) == std::vector<foeEntityID>{25, 30, 50, 201});
+    }
+
+    foeEcsDestroyComponentPool(testPool);
+}
+
+TEST_CASE("ComponentPool - Inserting and removing from multiple threads during maintenance") {
+    constexpr uint32_t numThreads = 8;
+    constexpr uint32_t perThread = 5000;
+
+    foeEcsComponentPool testPool = FOE_NULL_HANDLE;
+    foeResultSet result;
+
+    result = foeEcsCreateComponentPool(0, 1, sizeof(uint32_t), NULL, &testPool);
+    REQUIRE(result.value == FOE_SUCCESS);
+    REQUIRE(testPool != FOE_NULL_HANDLE);
+
+    std::atomic_bool threadsDone{false};
+    std::atomic_uint32_t failures{0};
+    std::thread maintenanceThread{[&]() {
+        while (!threadsDone) {
+            if (foeEcsComponentPoolMaintenance(testPool).value != FOE_SUCCESS)
+                ++failures;
+        }
+    }};
+
+    // Each thread inserts its own range of IDs, removing every second one again afterwards
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            uint32_t const firstID = t * perThread + 1;
+
+            for (uint32_t id = firstID; id < firstID + perThread; ++id) {
+                if (foeEcsComponentPoolInsert(testPool, foeEntityID(id), &id).value != FOE_SUCCESS)
+                    ++failures;
+            }
+            for (uint32_t id = firstID; id < firstID + perThread; id += 2) {
+                if (foeEcsComponentPoolRemove(testPool, foeEntityID(id)).value != FOE_SUCCESS)
+                    ++failures;
+            }
+        });
+    }
+    for (auto &it : threads)
+        it.join();
+
+    threadsDone = true;
+    maintenanceThread.join();
+    CHECK(failures == 0);
+
+    // Removals processed in the same pass as their insertion are ignored, so need to be done again
+    result = foeEcsComponentPoolMaintenance(testPool);
+    REQUIRE(result.value == FOE_SUCCESS);
+    for (uint32_t id = 1; id <= numThreads * perThread; id += 2)
+        foeEcsComponentPoolRemove(testPool, foeEntityID(id));
+    result = foeEcsComponentPoolMaintenance(testPool);
+    REQUIRE(result.value == FOE_SUCCESS);
+
+    REQUIRE(foeEcsComponentPoolSize(testPool) == numThreads * perThread / 2);
+
+    foeEntityID const *pIDs = foeEcsComponentPoolIdPtr(testPool);
+    uint32_t const *pData = (uint32_t *)foeEcsComponentPoolDataPtr(testPool);
+    for (uint32_t i = 0; i < numThreads * perThread / 2; ++i) {
+        CHECK(pIDs[i] == foeEntityID(2 * i + 2));
+        CHECK(pData[i] == 2 * i + 2);
+    }
+
+    foeEcsDestroyComponentPool(testPool);
+}
+
+namespace {
+
+/** @brief Baseline for benchmarks, working the way component pools did before staging and merging
+ *
+ * Insertions and removals are queued behind a single lock each. Maintenance compacts the stored
+ * data for removals in one pass, then shifts it back up in reverse for insertions in another.
+ */
+class BaselinePool {
+  public:
+    explicit BaselinePool(size_t dataSize) : mDataSize{dataSize} {}
+
+    void reserveInsertCapacity(size_t capacity) {
+        std::scoped_lock lock{mToInsertSync};
+        mToInsertIDs.reserve(capacity);
+        mToInsertData.reserve(capacity * mDataSize);
+    }
+
+    void insert(foeEntityID entity, void const *pData) {
+        std::scoped_lock lock{mToInsertSync};
+        mToInsertIDs.emplace_back(entity);
+        mToInsertData.insert(mToInsertData.end(), (uint8_t const *)pData,
+                             (uint8_t const *)pData + mDataSize);
+    }
+
+    void remove(foeEntityID entity) {
+        std::scoped_lock lock{mToRemoveSync};
+        mToRemoveIDs.emplace_back(entity);
+    }
+
+    void maintenance() {
+        removePass();
+        insertPass();
+    }
+
+    size_t size() const { return mIDs.size(); }
+    foeEntityID const *ids() const { return mIDs.data(); }
+    uint8_t const *data() const { return mData.data(); }
+
+  private:
+    void moveEntries(size_t dstOffset, size_t srcOffset, size_t count) {
+        memmove(mIDs.data() + dstOffset, mIDs.data() + srcOffset, count * sizeof(foeEntityID));
+        memmove(mData.data() + dstOffset * mDataSize, mData.data() + srcOffset * mDataSize,
+                count * mDataSize);
+    }
+
+    void removePass() {
+        mToRemoveSync.lock();
+        std::vector<foeEntityID> toRemoveIDs = std::move(mToRemoveIDs);
+        mToRemoveSync.unlock();
+
+        std::sort(toRemoveIDs.begin(), toRemoveIDs.end());
+        mRemovedIDs.clear();
+        mRemovedData.clear();
+
+        foeEntityID const *const pStartID = mIDs.data();
+        foeEntityID const *const pEndID = pStartID + mIDs.size();
+        foeEntityID const *pID = pStartID;
+
+        size_t removedCount = 0;
+        size_t lastShiftedOffset = 0;
+        for (foeEntityID removeID : toRemoveIDs) {
+            pID = std::lower_bound(pID, pEndID, removeID);
+            if (pID == pEndID)
+                break;
+            if (*pID != removeID)
+                continue;
+
+            size_t const offset = pID - pStartID;
+            mRemovedIDs.emplace_back(removeID);
+            mRemovedData.insert(mRemovedData.end(), mData.data() + offset * mDataSize,
+                                mData.data() + (offset + 1) * mDataSize);
+
+            if (lastShiftedOffset != 0)
+                moveEntries(lastShiftedOffset - removedCount, lastShiftedOffset,
+                            offset - lastShiftedOffset);
+
+            ++pID;
+            ++removedCount;
+            lastShiftedOffset = offset + 1;
+        }
+
+        if (lastShiftedOffset != 0)
+            moveEntries(lastShiftedOffset - removedCount, lastShiftedOffset,
+                        mIDs.size() - lastShiftedOffset);
+
+        mIDs.resize(mIDs.size() - removedCount);
+        mData.resize(mIDs.size() * mDataSize);
+    }
+
+    void insertPass() {
+        mToInsertSync.lock();
+        std::vector<foeEntityID> toInsertIDs = std::move(mToInsertIDs);
+        std::vector<uint8_t> toInsertData = std::move(mToInsertData);
+        mToInsertSync.unlock();
+
+        struct InsertOffsets {
+            foeEntityID entity;
+            size_t srcOffset;
+            size_t dstOffset;
+        };
+        std::vector<InsertOffsets> toInsertOffsets;
+        toInsertOffsets.reserve(toInsertIDs.size());
+        for (size_t i = 0; i < toInsertIDs.size(); ++i)
+            toInsertOffsets.emplace_back(InsertOffsets{toInsertIDs[i], i, 0});
+
+        std::sort(toInsertOffsets.begin(), toInsertOffsets.end(),
+                  [](InsertOffsets const &a, InsertOffsets const &b) {
+                      return a.entity < b.entity ||
+                             (a.entity == b.entity && a.srcOffset < b.srcOffset);
+                  });
+
+        foeEntityID const *const pStartID = mIDs.data();
+        foeEntityID const *const pEndID = pStartID + mIDs.size();
+        foeEntityID const *pID = pStartID;
+
+        size_t toInsertCount = 0;
+        for (size_t i = 0; i < toInsertOffsets.size(); ++i) {
+            InsertOffsets &insert = toInsertOffsets[i];
+            if (i + 1 < toInsertOffsets.size() && insert.entity == toInsertOffsets[i + 1].entity) {
+                insert.entity = FOE_INVALID_ID;
+                continue;
+            }
+
+            pID = std::lower_bound(pID, pEndID, insert.entity);
+            if (pID != pEndID && *pID == insert.entity) {
+                insert.entity = FOE_INVALID_ID;
+                continue;
+            }
+
+            insert.dstOffset = pID - pStartID;
+            ++toInsertCount;
+        }
+
+        size_t lastShiftedOffset = mIDs.size();
+        size_t shiftDistance = toInsertCount;
+        mIDs.resize(mIDs.size() + toInsertCount);
+        mData.resize(mIDs.size() * mDataSize);
+
+        for (auto it = toInsertOffsets.rbegin(); it != toInsertOffsets.rend(); ++it) {
+            if (it->entity == FOE_INVALID_ID)
+                continue;
+
+            if (it->dstOffset < lastShiftedOffset) {
+                moveEntries(it->dstOffset + shiftDistance, it->dstOffset,
+                            lastShiftedOffset - it->dstOffset);
+                lastShiftedOffset = it->dstOffset;
+            }
+
+            --shiftDistance;
+            mIDs[it->dstOffset + shiftDistance] = it->entity;
+            memcpy(mData.data() + (it->dstOffset + shiftDistance) * mDataSize,
+                   toInsertData.data() + it->srcOffset * mDataSize, mDataSize);
+        }
+    }
+
+    size_t mDataSize;
+
+    std::vector<foeEntityID> mIDs;
+    std::vector<uint8_t> mData;
+
+    std::vector<foeEntityID> mRemovedIDs;
+    std::vector<uint8_t> mRemovedData;
+
+    std::mutex mToInsertSync;
+    std::vector<foeEntityID> mToInsertIDs;
+    std::vector<uint8_t> mToInsertData;
+
+    std::mutex mToRemoveSync;
+    std::vector<foeEntityID> mToRemoveIDs;
+};
+
+} // namespace
+
+TEST_CASE("ComponentPool - Baseline pool used for benchmarks matches the component pool") {
+    foeEcsComponentPool testPool = FOE_NULL_HANDLE;
+    foeResultSet result;
+
+    result = foeEcsCreateComponentPool(0, 1, sizeof(int), NULL, &testPool);
+    REQUIRE(result.value == FOE_SUCCESS);
+
+    BaselinePool baselinePool{sizeof(int)};
+
+    for (int i = 2; i <= 64; i += 2) {
+        REQUIRE(foeEcsComponentPoolInsert(testPool, foeEntityID(i), &i).value == FOE_SUCCESS);
+        baselinePool.insert(foeEntityID(i), &i);
+    }
+    REQUIRE(foeEcsComponentPoolMaintenance(testPool).value == FOE_SUCCESS);
+    baselinePool.maintenance();
+
+    for (int i = 4; i <= 64; i += 6) {
+        REQUIRE(foeEcsComponentPoolRemove(testPool, foeEntityID(i)).value == FOE_SUCCESS);
+        baselinePool.remove(foeEntityID(i));
+    }
+    for (int i = 65; i > 0; i -= 5) {
+        REQUIRE(foeEcsComponentPoolInsert(testPool, foeEntityID(i), &i).value == FOE_SUCCESS);
+        baselinePool.insert(foeEntityID(i), &i);
+    }
+    REQUIRE(foeEcsComponentPoolMaintenance(testPool).value == FOE_SUCCESS);
+    baselinePool.maintenance();
+
+    REQUIRE(foeEcsComponentPoolSize(testPool) == baselinePool.size());
+    CHECK(memcmp(foeEcsComponentPoolIdPtr(testPool), baselinePool.ids(),
+                 baselinePool.size() * sizeof(foeEntityID)) == 0);
+    CHECK(memcmp(foeEcsComponentPoolDataPtr(testPool), baselinePool.data(),
+                 baselinePool.size() * sizeof(int)) == 0);
+
+    foeEcsDestroyComponentPool(testPool);
+}
+
+TEST_CASE("ComponentPool - Removals and insertions done in place match the baseline pool") {
+    foeEcsComponentPool testPool = FOE_NULL_HANDLE;
+    foeResultSet result;
+
+    // Capacity is set so that the changes are all done in place, rather than merged while growing
+    result = foeEcsCreateComponentPool(1024, 1, sizeof(int), NULL, &testPool);
+    REQUIRE(result.value == FOE_SUCCESS);
+
+    BaselinePool baselinePool{sizeof(int)};
+
+    for (int i = 2; i <= 256; i += 2) {
+        REQUIRE(foeEcsComponentPoolInsert(testPool, foeEntityID(i), &i).value == FOE_SUCCESS);
+        baselinePool.insert(foeEntityID(i), &i);
+    }
+    REQUIRE(foeEcsComponentPoolMaintenance(testPool).value == FOE_SUCCESS);
+    baselinePool.maintenance();
+
+    // Each pass removes and inserts a differently spread set of entities, so that runs of stored
+    // entries move both up and down, and removals and insertions land on the same offsets
+    uint32_t state = 1;
+    auto nextValue = [&state]() {
+        state = state * 1664525u + 1013904223u;
+        return int((state >> 8) % 512) + 1;
+    };
+
+    for (int pass = 0; pass < 64; ++pass) {
+        int const removeCount = nextValue() % 32;
+        int const insertCount = nextValue() % 32;
+
+        for (int i = 0; i < removeCount; ++i) {
+            foeEntityID const *const pIDs = foeEcsComponentPoolIdPtr(testPool);
+            size_t const size = foeEcsComponentPoolSize(testPool);
+            if (size == 0)
+                break;
+
+            foeEntityID const entity = pIDs[nextValue() % size];
+            REQUIRE(foeEcsComponentPoolRemove(testPool, entity).value == FOE_SUCCESS);
+            baselinePool.remove(entity);
+        }
+        for (int i = 0; i < insertCount; ++i) {
+            int value = nextValue();
+            foeEntityID const entity = foeEntityID(value);
+            REQUIRE(foeEcsComponentPoolInsert(testPool, entity, &value).value == FOE_SUCCESS);
+            baselinePool.insert(entity, &value);
+        }
+
+        REQUIRE(foeEcsComponentPoolMaintenance(testPool).value == FOE_SUCCESS);
+        baselinePool.maintenance();
+
+        REQUIRE(foeEcsComponentPoolSize(testPool) == baselinePool.size());
+        REQUIRE(memcmp(foeEcsComponentPoolIdPtr(testPool), baselinePool.ids(),
+                       baselinePool.size() * sizeof(foeEntityID)) == 0);
+        REQUIRE(memcmp(foeEcsComponentPoolDataPtr(testPool), baselinePool.data(),
+                       baselinePool.size() * sizeof(int)) == 0);
+
+        // Inserted offsets are in order, and each points to an entity queued for insertion
+        size_t const *const pInsertedOffsets = foeEcsComponentPoolInsertedOffsetPtr(testPool);
+        for (size_t i = 0; i < foeEcsComponentPoolInserted(testPool); ++i) {
+            if (i != 0)
+                REQUIRE(pInsertedOffsets[i - 1] < pInsertedOffsets[i]);
+            int const *const pData = (int const *)foeEcsComponentPoolDataPtr(testPool);
+            REQUIRE(foeEntityID(pData[pInsertedOffsets[i]]) ==
+                    foeEcsComponentPoolIdPtr(testPool)[pInsertedOffsets[i]]);
+        }
+    }
+
+    foeEcsDestroyComponentPool(testPool);
+}
+
+TEST_CASE("ComponentPool - Maintenance entity churn", "[.][benchmark]") {
+    struct ComponentData {
+        uint64_t data[8];
+    };
+    constexpr size_t poolSize = 1000000;
+
+    foeEcsComponentPool testPool = FOE_NULL_HANDLE;
+    foeResultSet result;
+
+    result = foeEcsCreateComponentPool(0, 1, sizeof(ComponentData), NULL, &testPool);
+    REQUIRE(result.value == FOE_SUCCESS);
+
+    BaselinePool baselinePool{sizeof(ComponentData)};
+
+    // Each pair of IDs (2i+1, 2i+2) has exactly one of the two in the pool at a time, churning a
+    // pair swaps which one that is, keeping the pool size constant
+    ComponentData const data{};
+    foeEcsComponentPoolReserveInsertCapacity(testPool, poolSize);
+    baselinePool.reserveInsertCapacity(poolSize);
+    for (size_t i = 0; i < poolSize; ++i) {
+        foeEcsComponentPoolInsert(testPool, foeEntityID(2 * i + 1), (void *)&data);
+        baselinePool.insert(foeEntityID(2 * i + 1), &data);
+    }
+    REQUIRE(foeEcsComponentPoolMaintenance(testPool).value == FOE_SUCCESS);
+    REQUIRE(foeEcsComponentPoolSize(testPool) == poolSize);
+    baselinePool.maintenance();
+    REQUIRE(baselinePool.size() == poolSize);
+
+    std::vector<bool> oddPresent(poolSize, true);
+    std::vector<bool> baselineOddPresent(poolSize, true);
+
+    for (size_t churn : {1000, 100000, 1000000}) {
+        size_t const stride = poolSize / churn;
+
+        BENCHMARK("1M entity pool, " + std::to_string(churn) + " entity churn - Baseline") {
+            baselinePool.reserveInsertCapacity(churn);
+            for (size_t i = 0; i < poolSize; i += stride) {
+                foeEntityID const present = foeEntityID(2 * i + (baselineOddPresent[i] ? 1 : 2));
+                foeEntityID const absent = foeEntityID(2 * i + (baselineOddPresent[i] ? 2 : 1));
+
+                baselinePool.remove(present);
+                baselinePool.insert(absent, &data);
+                baselineOddPresent[i] = !baselineOddPresent[i];
+            }
+
+            baselinePool.maintenance();
+        };
+
+        BENCHMARK("1M entity pool, " + std::to_string(churn) + " entity churn - Current") {
+            foeEcsComponentPoolReserveInsertCapacity(testPool, churn);
+            for (size_t i = 0; i < poolSize; i += stride) {
+                foeEntityID const present = foeEntityID(2 * i + (oddPresent[i] ? 1 : 2));
+                foeEntityID const absent = foeEntityID(2 * i + (oddPresent[i] ? 2 : 1));
+
+                foeEcsComponentPoolRemove(testPool, present);
+                foeEcsComponentPoolInsert(testPool, absent, (void *)&data);
+                oddPresent[i] = !oddPresent[i];
+            }
+
+            return foeEcsComponentPoolMaintenance(testPool);
+        };
+
+        REQUIRE(baselinePool.size() == poolSize);
+        REQUIRE(foeEcsComponentPoolSize(testPool) == poolSize);
+    }
+
+    foeEcsDestroyComponentPool(testPool);
+}
+
+TEST_CASE("ComponentPool - Random offset lookups", "[.][benchmark]") {
+    constexpr size_t poolSize = 1000000;
+    constexpr size_t lookups = 100000;
+
+    foeEcsComponentPool testPool = FOE_NULL_HANDLE;
+    foeResultSet result;
+
+    result = foeEcsCreateComponentPool(0, 1, sizeof(uint32_t), NULL, &testPool);
+    REQUIRE(result.value == FOE_SUCCESS);
+
+    foeEcsComponentPoolReserveInsertCapacity(testPool, poolSize);
+    for (uint32_t i = 0; i < poolSize; ++i)
+        foeEcsComponentPoolInsert(testPool, foeEntityID(2 * i + 1), &i);
+    REQUIRE(foeEcsComponentPoolMaintenance(testPool).value == FOE_SUCCESS);
+
+    // Half of the looked up entities are in the pool
+    std::vector<foeEntityID> toFind;
+    uint32_t state = 1;
+    for (size_t i = 0; i < lookups; ++i) {
+        state = state * 1664525u + 1013904223u;
+        toFind.emplace_back(foeEntityID(state % (2 * poolSize) + 1));
+    }
+
+    auto findAll = [&]() {
+        size_t found = 0;
+        for (foeEntityID entity : toFind) {
+            size_t offset;
+            found += foeEcsComponentPoolFindOffset(testPool, entity, &offset) ? 1 : 0;
+        }
+        return found;
+    };
+
+    BENCHMARK("100k lookups in 1M entity pool, binary search") { return findAll(); };
+
+    REQUIRE(foeEcsComponentPoolEnableOffsetIndex(testPool).value == FOE_SUCCESS);
+
+    BENCHMARK("100k lookups in 1M entity pool, offset index") { return findAll(); };
+
+    foeEcsDestroyComponentPool(testPool);
+}
+
+TEST_CASE("ComponentPool - Physics write-back to inline and heap-allocated positions",
+          "[.][benchmark]") {
+    // Same layout as foePosition3d
+    struct Transform {
+        float position[3];
+        float orientation[4];
+    };
+    // Stands in for the rigid bodies the physics system keeps for each active world object
+    struct ActiveWorldObject {
+        foeEntityID entity;
+        Transform *pRigidBody;
+    };
+    constexpr uint32_t numEntities = 50000;
+
+    foeEcsComponentPool inlinePool = FOE_NULL_HANDLE;
+    foeEcsComponentPool pointerPool = FOE_NULL_HANDLE;
+    foeResultSet result;
+
+    result = foeEcsCreateComponentPool(0, 1, sizeof(Transform), NULL, &inlinePool);
+    REQUIRE(result.value == FOE_SUCCESS);
+    result = foeEcsCreateComponentPool(
+        0, 1, sizeof(Transform *), [](void *pData) { delete *(Transform **)pData; },
+        &pointerPool);
+    REQUIRE(result.value == FOE_SUCCESS);
+
+    // Heap allocations are made in a scattered order, as when entities are created over time
+    std::vector<Transform *> allocations(numEntities);
+    std::vector<Transform *> rigidBodies(numEntities);
+    for (uint32_t i = 0; i < numEntities; ++i) {
+        allocations[(i * 7919) % numEntities] = new Transform{};
+        rigidBodies[(i * 7907) % numEntities] =
+            new Transform{{1.f, 2.f, 3.f}, {0.f, 0.f, 0.f, 1.f}};
+    }
+
+    // Not every positioned entity has a rigid body, so the active objects are a sorted subset
+    std::vector<ActiveWorldObject> activeWorldObjects;
+    for (uint32_t i = 0; i < numEntities; ++i) {
+        Transform data{};
+        foeEcsComponentPoolInsert(inlinePool, foeEntityID(i + 1), &data);
+        foeEcsComponentPoolInsert(pointerPool, foeEntityID(i + 1), &allocations[i]);
+
+        if (i % 5 != 0)
+            activeWorldObjects.push_back({foeEntityID(i + 1), rigidBodies[i]});
+    }
+    REQUIRE(foeEcsComponentPoolMaintenance(inlinePool).value == FOE_SUCCESS);
+    REQUIRE(foeEcsComponentPoolMaintenance(pointerPool).value == FOE_SUCCESS);
+
+    foeEcsComponentPoolEnableChangeTracking(inlinePool);
+    foeEcsComponentPoolEnableChangeTracking(pointerPool);
+
+    // Follows the position write-back at the end of foePhysicsProcessSystem
+    auto writeBack = [&](foeEcsComponentPool positionPool, auto const &getPosition) {
+        foeEntityID const *pPositionID = foeEcsComponentPoolIdPtr(positionPool);
+
+        foeEntityID const *const pStartPositionID = pPositionID;
+        foeEntityID const *const pEndPositionID =
+            pStartPositionID + foeEcsComponentPoolSize(positionPool);
+
+        for (auto const &activeWorldObject : activeWorldObjects) {
+            pPositionID = std::lower_bound(pPositionID, pEndPositionID, activeWorldObject.entity);
+            if (pPositionID == pEndPositionID)
+                break;
+            if (*pPositionID != activeWorldObject.entity)
+                continue;
+
+            size_t const positionOffset = pPositionID - pStartPositionID;
+            *getPosition(positionOffset) = *activeWorldObject.pRigidBody;
+
+            foeEcsComponentPoolMarkChanged(positionPool, positionOffset);
+        }
+
+        return foeEcsComponentPoolAdvanceChangeVersion(positionPool);
+    };
+
+    BENCHMARK("50k positions, 40k rigid bodies, inline") {
+        Transform *const pStartData = (Transform *)foeEcsComponentPoolDataPtr(inlinePool);
+
+        return writeBack(inlinePool, [&](size_t offset) { return pStartData + offset; });
+    };
+
+    BENCHMARK("50k positions, 40k rigid bodies, heap-allocated") {
+        Transform *const *const ppStartData =
+            (Transform **)foeEcsComponentPoolDataPtr(pointerPool);
+
+        return writeBack(pointerPool, [&](size_t offset) { return ppStartData[offset]; });
+    };
+
+    for (auto *pRigidBody : rigidBodies)
+        delete pRigidBody;
+    foeEcsDestroyComponentPool(pointerPool);
+    foeEcsDestroyComponentPool(inlinePool);
+}
+
+TEST_CASE("ComponentPool - Contended staging", "[.][benchmark]") {
+    struct ComponentData {
+        uint64_t data[4];
+    };
+    constexpr uint32_t numThreads = 16;
+    constexpr uint32_t perThread = 10000;
+
+    foeEcsComponentPool testPool = FOE_NULL_HANDLE;
+    foeResultSet result;
+
+    result = foeEcsCreateComponentPool(0, 1, sizeof(ComponentData), NULL, &testPool);
+    REQUIRE(result.value == FOE_SUCCESS);
+
+    size_t reservePerThread = 0;
+
+    auto stageFromThreads = [&](int run, auto const &stage) {
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < numThreads; ++t) {
+            threads.emplace_back([&, t]() {
+                foeEntityID const firstID = (run * numThreads + t) * perThread + 1;
+                stage(firstID, firstID + perThread);
+            });
+        }
+        for (auto &it : threads)
+            it.join();
+    };
+
+    auto stageInPool = [&](foeEntityID firstID, foeEntityID endID) {
+        ComponentData const data{};
+
+        if (reservePerThread != 0)
+            foeEcsComponentPoolReserveInsertCapacity(testPool, reservePerThread);
+
+        for (foeEntityID id = firstID; id < endID; ++id) {
+            foeEcsComponentPoolInsert(testPool, id, (void *)&data);
+            foeEcsComponentPoolRemove(testPool, id);
+        }
+    };
+
+    auto clearPool = [&]() {
+        REQUIRE(foeEcsComponentPoolMaintenance(testPool).value == FOE_SUCCESS);
+        for (size_t i = 0; i < foeEcsComponentPoolSize(testPool); ++i)
+            foeEcsComponentPoolRemove(testPool, foeEcsComponentPoolIdPtr(testPool)[i]);
+        REQUIRE(foeEcsComponentPoolMaintenance(testPool).value == FOE_SUCCESS);
+    };
+
+    BENCHMARK_ADVANCED("16 producers, 160k insertions and 160k removals - Baseline")
+    (Catch::Benchmark::Chronometer meter) {
+        BaselinePool baselinePool{sizeof(ComponentData)};
+
+        meter.measure([&](int run) {
+            stageFromThreads(run, [&](foeEntityID firstID, foeEntityID endID) {
+                ComponentData const data{};
+
+                for (foeEntityID id = firstID; id < endID; ++id) {
+                    baselinePool.insert(id, &data);
+                    baselinePool.remove(id);
+                }
+            });
+        });
+    };
+
+    BENCHMARK_ADVANCED("16 producers, 160k insertions and 160k removals - Current")
+    (Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](int run) { stageFromThreads(run, stageInPool); });
+        clearPool();
+    };
+
+    BENCHMARK_ADVANCED("16 producers, 160k insertions and 160k removals - Current, reserved")
+    (Catch::Benchmark::Chronometer meter) {
+        reservePerThread = meter.runs() * perThread;
+        meter.measure([&](int run) { stageFromThreads(run, stageInPool); });
+        clearPool();
+    };
+
+    foeEcsDestroyComponentPool(testPool);
+}
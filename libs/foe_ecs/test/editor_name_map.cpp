@@ -1,12 +1,15 @@
-// Copyright (C) 2021-2022 George Cave.
+// Copyright (C) 2021-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <foe/ecs/name_map.h>
 #include <foe/ecs/result.h>
 
 #include <cstring>
+#include <string>
+#include <vector>
 
 TEST_CASE("EditorNameMap - Adding") {
     foeEcsNameMap testNameMap = FOE_NULL_HANDLE;
@@ -93,6 +96,15 @@ TEST_CASE("EditorNameMap - Updating") {
 
     SECTION("Updating with unused names succeeds") {
         REQUIRE(foeEcsNameMapUpdate(testNameMap, 1, "entity2").value == FOE_ECS_SUCCESS);
+
+        foeId id;
+        REQUIRE(foeEcsNameMapFindID(testNameMap, "entity2", &id).value == FOE_ECS_SUCCESS);
+        CHECK(id == 1);
+
+        SECTION("The old name is released for reuse") {
+            CHECK(foeEcsNameMapFindID(testNameMap, "entity0", &id).value == FOE_ECS_NO_MATCH);
+            CHECK(foeEcsNameMapAdd(testNameMap, 3, "entity0").value == FOE_ECS_SUCCESS);
+        }
     }
 
     SECTION("Updating set with already used name fails") {
@@ -134,4 +146,160 @@ TEST_CASE("EditorNameMap - Removal") {
     }
 
     foeEcsDestroyNameMap(testNameMap);
-}
\ No newline at end of file
+}
+
+TEST_CASE("EditorNameMap - Adding many") {
+    foeEcsNameMap testNameMap = FOE_NULL_HANDLE;
+
+    REQUIRE(foeEcsCreateNameMap(&testNameMap).value == FOE_ECS_SUCCESS);
+    REQUIRE(foeEcsNameMapAdd(testNameMap, 2, "two").value == FOE_ECS_SUCCESS);
+    REQUIRE(foeEcsNameMapAdd(testNameMap, 5, "five").value == FOE_ECS_SUCCESS);
+
+    SECTION("Valid entries are all added, interleaved with existing IDs") {
+        foeEcsNameMapEntry const entries[] = {{6, "six"}, {1, "one"}, {3, "three"}};
+        REQUIRE(foeEcsNameMapAddMany(testNameMap, 3, entries).value == FOE_ECS_SUCCESS);
+
+        char const *const expectedNames[] = {"one", "two", "three", nullptr, "five", "six"};
+        for (foeId id = 1; id <= 6; ++id) {
+            char name[8];
+            uint32_t nameLength = sizeof(name);
+            foeResultSet result = foeEcsNameMapFindName(testNameMap, id, &nameLength, name);
+
+            if (expectedNames[id - 1] == nullptr) {
+                CHECK(result.value == FOE_ECS_NO_MATCH);
+            } else {
+                REQUIRE(result.value == FOE_ECS_SUCCESS);
+                CHECK(strcmp(name, expectedNames[id - 1]) == 0);
+
+                foeId foundID;
+                REQUIRE(foeEcsNameMapFindID(testNameMap, name, &foundID).value ==
+                        FOE_ECS_SUCCESS);
+                CHECK(foundID == id);
+            }
+        }
+    }
+
+    SECTION("Invalid entries are skipped, returning the first error") {
+        foeEcsNameMapEntry const entries[] = {
+            {7, "five"}, {1, "one"}, {5, "other"}, {3, ""}, {4, "four"}, {4, "four again"},
+        };
+        REQUIRE(foeEcsNameMapAddMany(testNameMap, 6, entries).value == FOE_ECS_ERROR_EMPTY_NAME);
+
+        foeId id;
+        CHECK(foeEcsNameMapFindID(testNameMap, "one", &id).value == FOE_ECS_SUCCESS);
+        CHECK(foeEcsNameMapFindID(testNameMap, "four", &id).value == FOE_ECS_SUCCESS);
+        CHECK(id == 4);
+        CHECK(foeEcsNameMapFindID(testNameMap, "four again", &id).value == FOE_ECS_NO_MATCH);
+        CHECK(foeEcsNameMapFindID(testNameMap, "other", &id).value == FOE_ECS_NO_MATCH);
+        CHECK(foeEcsNameMapFindID(testNameMap, "five", &id).value == FOE_ECS_SUCCESS);
+        CHECK(id == 5);
+
+        uint32_t nameLength;
+        CHECK(foeEcsNameMapFindName(testNameMap, 3, &nameLength, nullptr).value ==
+              FOE_ECS_NO_MATCH);
+        CHECK(foeEcsNameMapFindName(testNameMap, 7, &nameLength, nullptr).value ==
+              FOE_ECS_NO_MATCH);
+    }
+
+    foeEcsDestroyNameMap(testNameMap);
+}
+
+TEST_CASE("EditorNameMap - Names stay correct through many removals and updates") {
+    foeEcsNameMap testNameMap = FOE_NULL_HANDLE;
+    REQUIRE(foeEcsCreateNameMap(&testNameMap).value == FOE_ECS_SUCCESS);
+
+    for (foeId id = 1; id <= 1000; ++id) {
+        REQUIRE(foeEcsNameMapAdd(testNameMap, id, ("name" + std::to_string(id)).c_str()).value ==
+                FOE_ECS_SUCCESS);
+    }
+
+    // Remove odd IDs, rename even ones, which leaves most of the original names unused
+    for (foeId id = 1; id <= 1000; ++id) {
+        if (id % 2 == 1) {
+            REQUIRE(foeEcsNameMapRemove(testNameMap, id).value == FOE_ECS_SUCCESS);
+        } else {
+            REQUIRE(foeEcsNameMapUpdate(testNameMap, id, ("new" + std::to_string(id)).c_str())
+                        .value == FOE_ECS_SUCCESS);
+        }
+    }
+
+    for (foeId id = 1; id <= 1000; ++id) {
+        foeId foundID;
+        CHECK(foeEcsNameMapFindID(testNameMap, ("name" + std::to_string(id)).c_str(), &foundID)
+                  .value == FOE_ECS_NO_MATCH);
+
+        char name[16];
+        uint32_t nameLength = sizeof(name);
+        foeResultSet result = foeEcsNameMapFindName(testNameMap, id, &nameLength, name);
+
+        if (id % 2 == 1) {
+            CHECK(result.value == FOE_ECS_NO_MATCH);
+        } else {
+            REQUIRE(result.value == FOE_ECS_SUCCESS);
+            CHECK(std::string{name} == "new" + std::to_string(id));
+            REQUIRE(foeEcsNameMapFindID(testNameMap, name, &foundID).value == FOE_ECS_SUCCESS);
+            CHECK(foundID == id);
+        }
+    }
+
+    foeEcsDestroyNameMap(testNameMap);
+}
+
+TEST_CASE("EditorNameMap - Loading 1M names", "[.][benchmark]") {
+    constexpr uint32_t nameCount = 1000000;
+
+    std::vector<std::string> names;
+    names.reserve(nameCount);
+    for (uint32_t i = 0; i < nameCount; ++i)
+        names.emplace_back("entity_name_" + std::to_string(uint64_t(i) * 7919 % nameCount));
+
+    BENCHMARK("Adding one at a time") {
+        foeEcsNameMap nameMap = FOE_NULL_HANDLE;
+        foeEcsCreateNameMap(&nameMap);
+
+        for (uint32_t i = 0; i < nameCount; ++i)
+            foeEcsNameMapAdd(nameMap, i + 1, names[i].c_str());
+
+        foeEcsDestroyNameMap(nameMap);
+    };
+
+    std::vector<foeEcsNameMapEntry> entries(nameCount);
+    for (uint32_t i = 0; i < nameCount; ++i)
+        entries[i] = {.id = i + 1, .pName = names[i].c_str()};
+
+    BENCHMARK("Adding all at once") {
+        foeEcsNameMap nameMap = FOE_NULL_HANDLE;
+        foeEcsCreateNameMap(&nameMap);
+
+        foeEcsNameMapAddMany(nameMap, nameCount, entries.data());
+
+        foeEcsDestroyNameMap(nameMap);
+    };
+
+    foeEcsNameMap nameMap = FOE_NULL_HANDLE;
+    REQUIRE(foeEcsCreateNameMap(&nameMap).value == FOE_ECS_SUCCESS);
+    REQUIRE(foeEcsNameMapAddMany(nameMap, nameCount, entries.data()).value == FOE_ECS_SUCCESS);
+
+    BENCHMARK("Finding every ID by name") {
+        foeId sum = 0;
+        for (uint32_t i = 0; i < nameCount; ++i) {
+            foeId id;
+            foeEcsNameMapFindID(nameMap, names[i].c_str(), &id);
+            sum += id;
+        }
+        return sum;
+    };
+
+    BENCHMARK("Finding every name by ID") {
+        char buffer[32];
+        uint32_t sum = 0;
+        for (uint32_t i = 0; i < nameCount; ++i) {
+            uint32_t length = sizeof(buffer);
+            foeEcsNameMapFindName(nameMap, i + 1, &length, buffer);
+            sum += length;
+        }
+        return sum;
+    };
+
+    foeEcsDestroyNameMap(nameMap);
+}
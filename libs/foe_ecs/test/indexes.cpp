@@ -1,7 +1,8 @@
-// Copyright (C) 2021-2023 George Cave
+// Copyright (C) 2021-2026 George Cave
 //
 // SPDX-License-Identifier: Apache-2.0
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <foe/ecs/indexes.h>
 #include <foe/ecs/result.h>
@@ -111,7 +112,7 @@ TEST_CASE("foeEcsIndexes - Reset with custom values", "[foe][ecs][foeEcsIndexes]
     REQUIRE(recyclableCount == 1);
 
     std::vector<foeIdIndex> list = {
-        0, 1, 2, 3, 4, 5, 6, 7, 8, 9,
+        1, 2, 3, 4, 5, 6, 7, 8, 9, 10,
     };
 
     REQUIRE(foeEcsImportIndexes(testIndexes, 100, list.size(), list.data()).value ==
@@ -131,7 +132,7 @@ TEST_CASE("foeEcsIndexes - Reset with custom values", "[foe][ecs][foeEcsIndexes]
 
         REQUIRE(nextIndex == 100);
         REQUIRE(recyclableCount == 9U - i);
-        REQUIRE(id == foeId(i));
+        REQUIRE(id == foeId(i + 1));
     }
 
     REQUIRE(foeEcsExportIndexes(testIndexes, &nextIndex, &recyclableCount, nullptr).value ==
@@ -165,6 +166,45 @@ TEST_CASE("foeEcsIndexes - Import fails with a value less than the minimum index
     foeEcsDestroyIndexes(testIndexes);
 }
 
+TEST_CASE("foeEcsIndexes - Import fails with recycled indices that couldn't have been generated",
+          "[foe][ecs][foeEcsIndexes]") {
+    foeEcsIndexes testIndexes{FOE_NULL_HANDLE};
+
+    REQUIRE(foeEcsCreateIndexes(0, &testIndexes).value == FOE_ECS_SUCCESS);
+    CHECK(testIndexes != FOE_NULL_HANDLE);
+
+    SECTION("Recycled index at or above the next new index") {
+        foeIdIndex const recycled[] = {3, 10};
+        CHECK(foeEcsImportIndexes(testIndexes, 10, 2, recycled).value ==
+              FOE_ECS_ERROR_INDEX_ABOVE_GENERATED);
+
+        foeIdIndex const farRecycled[] = {100000};
+        CHECK(foeEcsImportIndexes(testIndexes, 10, 1, farRecycled).value ==
+              FOE_ECS_ERROR_INDEX_ABOVE_GENERATED);
+    }
+
+    SECTION("Recycled index below the minimum") {
+        foeIdIndex const recycled[] = {foeIdIndexMinValue - 1};
+        CHECK(foeEcsImportIndexes(testIndexes, 10, 1, recycled).value ==
+              FOE_ECS_ERROR_INDEX_BELOW_MINIMUM);
+    }
+
+    // The indexes are left as they were, so IDs continue to be generated from the start
+    foeIdIndex nextIndex;
+    uint32_t recycledCount;
+    REQUIRE(foeEcsExportIndexes(testIndexes, &nextIndex, &recycledCount, nullptr).value ==
+            FOE_ECS_SUCCESS);
+    CHECK(nextIndex == foeIdIndexMinValue);
+    CHECK(recycledCount == 0);
+
+    foeId id;
+    REQUIRE(foeEcsGenerateID(testIndexes, &id).value == FOE_ECS_SUCCESS);
+    CHECK(id == foeIdCreate(0, foeIdIndexMinValue));
+    CHECK(foeEcsGetLiveIDCount(testIndexes) == 1);
+
+    foeEcsDestroyIndexes(testIndexes);
+}
+
 TEST_CASE("foeEcsIndexes - GroupID of 0x0", "[foe][ecs][foeEcsIndexes]") {
     foeEcsIndexes testIndexes{FOE_NULL_HANDLE};
 
@@ -353,6 +393,180 @@ TEST_CASE("foeEcsIndexes - Attempting to free incorrect/invalid IDs from list",
         REQUIRE(foeEcsFreeID(testIndexes, 0xF0000015).value == FOE_ECS_ERROR_INDEX_ABOVE_GENERATED);
     }
 
+    SECTION("ID already freed") {
+        foeId ids[3];
+        REQUIRE(foeEcsGenerateIDs(testIndexes, 3, ids).value == FOE_ECS_SUCCESS);
+        REQUIRE(foeEcsFreeID(testIndexes, ids[1]).value == FOE_ECS_SUCCESS);
+
+        REQUIRE(foeEcsFreeID(testIndexes, ids[1]).value == FOE_ECS_ERROR_ID_ALREADY_FREED);
+        REQUIRE(foeEcsFreeIDs(testIndexes, 3, ids).value == FOE_ECS_ERROR_ID_ALREADY_FREED);
+
+        // Nothing else was freed or recycled twice
+        CHECK(foeEcsGetLiveIDCount(testIndexes) == 2);
+        CHECK(foeEcsGetIDGeneration(testIndexes, ids[0]) == 0);
+        CHECK(foeEcsGetIDGeneration(testIndexes, ids[1]) == 1);
+
+        uint32_t count;
+        REQUIRE(foeEcsExportIndexes(testIndexes, nullptr, &count, nullptr).value ==
+                FOE_ECS_SUCCESS);
+        CHECK(count == 1);
+    }
+
+    SECTION("Same ID more than once in the list") {
+        foeId ids[3];
+        REQUIRE(foeEcsGenerateIDs(testIndexes, 2, ids).value == FOE_ECS_SUCCESS);
+        ids[2] = ids[0];
+
+        REQUIRE(foeEcsFreeIDs(testIndexes, 3, ids).value == FOE_ECS_ERROR_ID_ALREADY_FREED);
+        CHECK(foeEcsGetLiveIDCount(testIndexes) == 2);
+
+        // The failed call left both still able to be freed
+        REQUIRE(foeEcsFreeIDs(testIndexes, 2, ids).value == FOE_ECS_SUCCESS);
+        CHECK(foeEcsGetLiveIDCount(testIndexes) == 0);
+    }
+
+    foeEcsDestroyIndexes(testIndexes);
+}
+
+TEST_CASE("foeEcsIndexes - Generating IDs in bulk", "[foe][ecs][foeEcsIndexes]") {
+    foeEcsIndexes testIndexes{FOE_NULL_HANDLE};
+
+    REQUIRE(foeEcsCreateIndexes(foeIdPersistentGroup, &testIndexes).value == FOE_ECS_SUCCESS);
+    CHECK(testIndexes != FOE_NULL_HANDLE);
+
+    std::array<foeId, 8> ids;
+
+    SECTION("New IDs are generated in order") {
+        REQUIRE(foeEcsGenerateIDs(testIndexes, ids.size(), ids.data()).value == FOE_ECS_SUCCESS);
+
+        for (size_t i = 0; i < ids.size(); ++i)
+            CHECK(ids[i] == foeIdCreate(foeIdPersistentGroup, foeIdIndexMinValue + i));
+    }
+    SECTION("Recycled IDs are used first, in the order they were freed") {
+        std::vector<foeIdIndex> const recycled = {7, 3, 5};
+        REQUIRE(foeEcsImportIndexes(testIndexes, 10, recycled.size(), recycled.data()).value ==
+                FOE_ECS_SUCCESS);
+
+        REQUIRE(foeEcsGenerateIDs(testIndexes, 5, ids.data()).value == FOE_ECS_SUCCESS);
+
+        CHECK(ids[0] == foeIdCreate(foeIdPersistentGroup, 7));
+        CHECK(ids[1] == foeIdCreate(foeIdPersistentGroup, 3));
+        CHECK(ids[2] == foeIdCreate(foeIdPersistentGroup, 5));
+        CHECK(ids[3] == foeIdCreate(foeIdPersistentGroup, 10));
+        CHECK(ids[4] == foeIdCreate(foeIdPersistentGroup, 11));
+    }
+    SECTION("Not enough indexes left generates none") {
+        REQUIRE(foeEcsImportIndexes(testIndexes, foeIdIndexMaxValue - 4, 0, nullptr).value ==
+                FOE_ECS_SUCCESS);
+
+        CHECK(foeEcsGenerateIDs(testIndexes, 5, ids.data()).value ==
+              FOE_ECS_ERROR_OUT_OF_INDEXES);
+
+        foeIdIndex nextIndex;
+        uint32_t recycledCount;
+        REQUIRE(foeEcsExportIndexes(testIndexes, &nextIndex, &recycledCount, nullptr).value ==
+                FOE_ECS_SUCCESS);
+        CHECK(nextIndex == foeIdIndexMaxValue - 4);
+
+        CHECK(foeEcsGenerateIDs(testIndexes, 4, ids.data()).value == FOE_ECS_SUCCESS);
+        CHECK(ids[3] == foeIdCreate(foeIdPersistentGroup, foeIdIndexMaxValue - 1));
+    }
+    SECTION("Recycled IDs stay in order as the recycle list wraps around and grows") {
+        std::vector<foeId> generated(100);
+        REQUIRE(foeEcsGenerateIDs(testIndexes, generated.size(), generated.data()).value ==
+                FOE_ECS_SUCCESS);
+
+        // Repeatedly free a batch and take back fewer, so the list wraps and has to grow
+        std::vector<foeId> expected;
+        size_t freed = 0;
+        while (freed < generated.size()) {
+            size_t const freeCount = std::min<size_t>(13, generated.size() - freed);
+            REQUIRE(foeEcsFreeIDs(testIndexes, freeCount, generated.data() + freed).value ==
+                    FOE_ECS_SUCCESS);
+            expected.insert(expected.end(), generated.begin() + freed,
+                            generated.begin() + freed + freeCount);
+            freed += freeCount;
+
+            REQUIRE(foeEcsGenerateIDs(testIndexes, 4, ids.data()).value == FOE_ECS_SUCCESS);
+            for (size_t i = 0; i < 4; ++i) {
+                CHECK(ids[i] == expected.front());
+                expected.erase(expected.begin());
+            }
+        }
+
+        uint32_t recycledCount = expected.size();
+        std::vector<foeIdIndex> recycled(recycledCount);
+        REQUIRE(foeEcsExportIndexes(testIndexes, nullptr, &recycledCount, recycled.data()).value ==
+                FOE_ECS_SUCCESS);
+        REQUIRE(recycledCount == expected.size());
+        for (size_t i = 0; i < expected.size(); ++i)
+            CHECK(foeIdCreate(foeIdPersistentGroup, recycled[i]) == expected[i]);
+    }
+
+    foeEcsDestroyIndexes(testIndexes);
+}
+
+TEST_CASE("foeEcsIndexes - ID generations", "[foe][ecs][foeEcsIndexes]") {
+    foeEcsIndexes testIndexes{FOE_NULL_HANDLE};
+
+    REQUIRE(foeEcsCreateIndexes(foeIdPersistentGroup, &testIndexes).value == FOE_ECS_SUCCESS);
+    CHECK(testIndexes != FOE_NULL_HANDLE);
+
+    foeId first, second;
+    REQUIRE(foeEcsGenerateID(testIndexes, &first).value == FOE_ECS_SUCCESS);
+    REQUIRE(foeEcsGenerateID(testIndexes, &second).value == FOE_ECS_SUCCESS);
+
+    CHECK(foeEcsGetIDGeneration(testIndexes, first) == 0);
+    CHECK(foeEcsGetIDGeneration(testIndexes, second) == 0);
+    CHECK(foeEcsGetIDGeneration(testIndexes, foeIdCreate(foeIdPersistentGroup, 1000)) == 0);
+
+    SECTION("Freeing an ID advances only its generation") {
+        REQUIRE(foeEcsFreeID(testIndexes, first).value == FOE_ECS_SUCCESS);
+
+        CHECK(foeEcsGetIDGeneration(testIndexes, first) == 1);
+        CHECK(foeEcsGetIDGeneration(testIndexes, second) == 0);
+    }
+    SECTION("Recycled IDs keep their generation until freed again") {
+        REQUIRE(foeEcsFreeID(testIndexes, first).value == FOE_ECS_SUCCESS);
+
+        foeId recycled;
+        REQUIRE(foeEcsGenerateID(testIndexes, &recycled).value == FOE_ECS_SUCCESS);
+        REQUIRE(recycled == first);
+        CHECK(foeEcsGetIDGeneration(testIndexes, recycled) == 1);
+
+        REQUIRE(foeEcsFreeID(testIndexes, recycled).value == FOE_ECS_SUCCESS);
+        CHECK(foeEcsGetIDGeneration(testIndexes, first) == 2);
+    }
+    SECTION("Invalid IDs in a list prevent any generations from advancing") {
+        foeId const ids[] = {first, second, FOE_INVALID_ID};
+
+        REQUIRE(foeEcsFreeIDs(testIndexes, 3, ids).value == FOE_ECS_ERROR_INVALID_ID);
+        CHECK(foeEcsGetIDGeneration(testIndexes, first) == 0);
+        CHECK(foeEcsGetIDGeneration(testIndexes, second) == 0);
+    }
+    SECTION("Generations of indices far apart are kept separately") {
+        REQUIRE(foeEcsImportIndexes(testIndexes, 200000, 0, nullptr).value == FOE_ECS_SUCCESS);
+
+        foeId const ids[] = {
+            foeIdCreate(foeIdPersistentGroup, 5),
+            foeIdCreate(foeIdPersistentGroup, 70000),
+            foeIdCreate(foeIdPersistentGroup, 150000),
+        };
+
+        REQUIRE(foeEcsFreeIDs(testIndexes, 3, ids).value == FOE_ECS_SUCCESS);
+
+        // Recycled in the order freed, so reissue the first two before freeing the second again
+        foeId reissued[2];
+        REQUIRE(foeEcsGenerateIDs(testIndexes, 2, reissued).value == FOE_ECS_SUCCESS);
+        REQUIRE(reissued[1] == ids[1]);
+        REQUIRE(foeEcsFreeIDs(testIndexes, 1, ids + 1).value == FOE_ECS_SUCCESS);
+
+        CHECK(foeEcsGetIDGeneration(testIndexes, ids[0]) == 1);
+        CHECK(foeEcsGetIDGeneration(testIndexes, ids[1]) == 2);
+        CHECK(foeEcsGetIDGeneration(testIndexes, ids[2]) == 1);
+        CHECK(foeEcsGetIDGeneration(testIndexes, foeIdCreate(foeIdPersistentGroup, 70001)) == 0);
+    }
+
     foeEcsDestroyIndexes(testIndexes);
 }
 
@@ -405,6 +619,86 @@ TEST_CASE("foeEcsIndexes - Iterating through IDs", "[foe][ecs][foeEcsIndexes]")
     foeEcsDestroyIndexes(testIndexes);
 }
 
+TEST_CASE("foeEcsIndexes - Live ID ranges", "[foe][ecs][foeEcsIndexes]") {
+    foeEcsIndexes testIndexes{FOE_NULL_HANDLE};
+    std::array<foeId, 200> ids;
+
+    REQUIRE(foeEcsCreateIndexes(0x0, &testIndexes).value == FOE_ECS_SUCCESS);
+    REQUIRE(foeEcsGenerateIDs(testIndexes, ids.size(), ids.data()).value == FOE_ECS_SUCCESS);
+
+    // Free indices 1, 64-127 and 150, leaving 2-63, 128-149 and 151-200 live
+    REQUIRE(foeEcsFreeID(testIndexes, 1).value == FOE_ECS_SUCCESS);
+    REQUIRE(foeEcsFreeIDs(testIndexes, 64, ids.data() + 63).value == FOE_ECS_SUCCESS);
+    REQUIRE(foeEcsFreeID(testIndexes, 150).value == FOE_ECS_SUCCESS);
+
+    CHECK(foeEcsGetLiveIDCount(testIndexes) == 134);
+
+    std::array<foeIdIndexRange, 4> ranges;
+    uint32_t rangeCount = ranges.size();
+
+    SECTION("Ranges are of consecutive live indices, in ascending order") {
+        REQUIRE(foeEcsExportLiveIndexRanges(testIndexes, &rangeCount, nullptr).value ==
+                FOE_ECS_SUCCESS);
+        REQUIRE(rangeCount == 3);
+
+        REQUIRE(foeEcsExportLiveIndexRanges(testIndexes, &rangeCount, ranges.data()).value ==
+                FOE_ECS_SUCCESS);
+        REQUIRE(rangeCount == 3);
+        CHECK(ranges[0].first == 2);
+        CHECK(ranges[0].count == 62);
+        CHECK(ranges[1].first == 128);
+        CHECK(ranges[1].count == 22);
+        CHECK(ranges[2].first == 151);
+        CHECK(ranges[2].count == 50);
+    }
+
+    SECTION("If the output array is too small, then FOE_ECS_INCOMPLETE is returned") {
+        rangeCount = 2;
+        REQUIRE(foeEcsExportLiveIndexRanges(testIndexes, &rangeCount, ranges.data()).value ==
+                FOE_ECS_INCOMPLETE);
+        REQUIRE(rangeCount == 2);
+        CHECK(ranges[1].first == 128);
+    }
+
+    SECTION("Regenerating recycled IDs makes them live again") {
+        REQUIRE(foeEcsGenerateIDs(testIndexes, 66, ids.data()).value == FOE_ECS_SUCCESS);
+        CHECK(foeEcsGetLiveIDCount(testIndexes) == 200);
+
+        REQUIRE(foeEcsExportLiveIndexRanges(testIndexes, &rangeCount, ranges.data()).value ==
+                FOE_ECS_SUCCESS);
+        REQUIRE(rangeCount == 1);
+        CHECK(ranges[0].first == 1);
+        CHECK(ranges[0].count == 200);
+    }
+
+    SECTION("Importing replaces the live set") {
+        foeIdIndex const recycled[] = {3, 1, 5};
+        REQUIRE(foeEcsImportIndexes(testIndexes, 10, 3, recycled).value == FOE_ECS_SUCCESS);
+        CHECK(foeEcsGetLiveIDCount(testIndexes) == 6);
+
+        REQUIRE(foeEcsExportLiveIndexRanges(testIndexes, &rangeCount, ranges.data()).value ==
+                FOE_ECS_SUCCESS);
+        REQUIRE(rangeCount == 3);
+        CHECK(ranges[0].first == 2);
+        CHECK(ranges[0].count == 1);
+        CHECK(ranges[1].first == 4);
+        CHECK(ranges[1].count == 1);
+        CHECK(ranges[2].first == 6);
+        CHECK(ranges[2].count == 4);
+    }
+
+    SECTION("With no live IDs there are no ranges") {
+        foeEcsImportIndexes(testIndexes, foeIdIndexMinValue, 0, nullptr);
+        CHECK(foeEcsGetLiveIDCount(testIndexes) == 0);
+
+        REQUIRE(foeEcsExportLiveIndexRanges(testIndexes, &rangeCount, nullptr).value ==
+                FOE_ECS_SUCCESS);
+        CHECK(rangeCount == 0);
+    }
+
+    foeEcsDestroyIndexes(testIndexes);
+}
+
 TEST_CASE("foeEcsIndexes - ImexData import/export", "[foe][ecs][foeEcsIndexes]") {
     foeEcsIndexes testIndexes{FOE_NULL_HANDLE};
 
@@ -623,4 +917,116 @@ TEST_CASE("foeEcsIndexes - Multi-threaded synchronization tests", "[foe][ecs][fo
     }
 
     foeEcsDestroyIndexes(testIndexes);
-}
\ No newline at end of file
+}
+
+TEST_CASE("foeEcsIndexes - Generating and freeing IDs across threads", "[.][benchmark]") {
+    constexpr int threadCount = 8;
+    constexpr uint32_t idsPerThread = 250000;
+    constexpr uint32_t batchSize = 1000;
+
+    foeEcsIndexes testIndexes = FOE_NULL_HANDLE;
+    REQUIRE(foeEcsCreateIndexes(foeIdPersistentGroup, &testIndexes).value == FOE_ECS_SUCCESS);
+
+    std::vector<foeId> idLists[threadCount];
+    for (auto &idList : idLists)
+        idList.resize(idsPerThread);
+
+    auto runThreads = [&](auto &&threadFn) {
+        std::thread threads[threadCount];
+        for (int i = 0; i < threadCount; ++i)
+            threads[i] = std::thread(threadFn, idLists[i].data());
+        for (auto &thread : threads)
+            thread.join();
+    };
+
+    // Each run generates 2M IDs then frees them all, after the first run they are all recycled
+    BENCHMARK("8 threads, 2M IDs, one at a time") {
+        runThreads([&](foeId *pIDs) {
+            for (uint32_t i = 0; i < idsPerThread; ++i)
+                foeEcsGenerateID(testIndexes, pIDs + i);
+            for (uint32_t i = 0; i < idsPerThread; ++i)
+                foeEcsFreeID(testIndexes, pIDs[i]);
+        });
+    };
+
+    BENCHMARK("8 threads, 2M IDs, in batches of 1000") {
+        runThreads([&](foeId *pIDs) {
+            for (uint32_t i = 0; i < idsPerThread; i += batchSize)
+                foeEcsGenerateIDs(testIndexes, batchSize, pIDs + i);
+            for (uint32_t i = 0; i < idsPerThread; i += batchSize)
+                foeEcsFreeIDs(testIndexes, batchSize, pIDs + i);
+        });
+    };
+
+    // Nothing is ever recycled, so every ID is new
+    BENCHMARK("8 threads, 2M new IDs, one at a time") {
+        foeEcsIndexes newIndexes = FOE_NULL_HANDLE;
+        foeEcsCreateIndexes(foeIdPersistentGroup, &newIndexes);
+
+        runThreads([&](foeId *pIDs) {
+            for (uint32_t i = 0; i < idsPerThread; ++i)
+                foeEcsGenerateID(newIndexes, pIDs + i);
+        });
+
+        foeEcsDestroyIndexes(newIndexes);
+    };
+
+    foeEcsDestroyIndexes(testIndexes);
+}
+
+TEST_CASE("foeEcsIndexes - Iterating sparse live IDs", "[.][benchmark]") {
+    constexpr uint32_t highWaterMark = 4000000;
+    constexpr uint32_t liveCount = 1000;
+
+    foeEcsIndexes testIndexes = FOE_NULL_HANDLE;
+    REQUIRE(foeEcsCreateIndexes(foeIdPersistentGroup, &testIndexes).value == FOE_ECS_SUCCESS);
+
+    // Leave every 4000th index live, with all the others recycled
+    std::vector<foeIdIndex> recycled;
+    recycled.reserve(highWaterMark - liveCount);
+    for (foeIdIndex i = foeIdIndexMinValue; i <= highWaterMark; ++i) {
+        if (i % (highWaterMark / liveCount) != 0)
+            recycled.emplace_back(i);
+    }
+    REQUIRE(foeEcsImportIndexes(testIndexes, highWaterMark + 1, recycled.size(), recycled.data())
+                .value == FOE_ECS_SUCCESS);
+    REQUIRE(foeEcsGetLiveIDCount(testIndexes) == liveCount);
+
+    BENCHMARK("Exported recycled list, sorted and stepped over") {
+        foeIdIndex nextIndex;
+        uint32_t count;
+        std::vector<foeIdIndex> unused;
+
+        foeEcsExportIndexes(testIndexes, nullptr, &count, nullptr);
+        unused.resize(count);
+        foeEcsExportIndexes(testIndexes, &nextIndex, &count, unused.data());
+        std::sort(unused.begin(), unused.end());
+
+        uint32_t found = 0;
+        auto unusedIt = unused.begin();
+        for (foeIdIndex idx = foeIdIndexMinValue; idx < nextIndex; ++idx) {
+            if (unusedIt != unused.end() && idx == *unusedIt) {
+                ++unusedIt;
+                continue;
+            }
+            ++found;
+        }
+        return found;
+    };
+
+    BENCHMARK("Exported live index ranges") {
+        uint32_t count;
+        std::vector<foeIdIndexRange> ranges;
+
+        foeEcsExportLiveIndexRanges(testIndexes, &count, nullptr);
+        ranges.resize(count);
+        foeEcsExportLiveIndexRanges(testIndexes, &count, ranges.data());
+
+        uint32_t found = 0;
+        for (auto const &range : ranges)
+            found += range.count;
+        return found;
+    };
+
+    foeEcsDestroyIndexes(testIndexes);
+}
@@ -0,0 +1,220 @@
+// Copyright (C) 2026 George Cave.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <foe/ecs/join.h>
+#include <foe/ecs/result.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+foeEcsComponentPool createPool(std::vector<foeEntityID> const &entities) {
+    foeEcsComponentPool pool{FOE_NULL_HANDLE};
+    REQUIRE(foeEcsCreateComponentPool(0, 1, sizeof(foeEntityID), NULL, &pool).value ==
+            FOE_SUCCESS);
+
+    foeEcsComponentPoolReserveInsertCapacity(pool, entities.size());
+    for (foeEntityID entity : entities) {
+        foeEcsComponentPoolInsert(pool, entity, &entity);
+    }
+    REQUIRE(foeEcsComponentPoolMaintenance(pool).value == FOE_SUCCESS);
+
+    return pool;
+}
+
+std::vector<foeEntityID> everyNth(foeEntityID count, foeEntityID n) {
+    std::vector<foeEntityID> entities;
+    for (foeEntityID i = 1; i <= count; ++i) {
+        if (i % n == 0)
+            entities.emplace_back(i);
+    }
+    return entities;
+}
+
+/// Joins the whole driver range, checking that all offsets point at the joined entity
+std::vector<foeEntityID> joinAll(uint32_t poolCount,
+                                 foeEcsComponentPool const *pPools,
+                                 uint32_t driver,
+                                 size_t startOffset,
+                                 size_t endOffset,
+                                 uint32_t chunkSize) {
+    std::vector<foeEntityID> joined;
+    std::vector<foeEntityID> entities(chunkSize);
+    std::vector<size_t> offsets(chunkSize * poolCount);
+    size_t driverOffset = startOffset;
+    foeResultSet result;
+
+    do {
+        uint32_t count = chunkSize;
+        result = foeEcsJoin(poolCount, pPools, driver, &driverOffset, endOffset, &count,
+                            entities.data(), offsets.data());
+        REQUIRE((result.value == FOE_ECS_SUCCESS || result.value == FOE_ECS_INCOMPLETE));
+        REQUIRE(count <= chunkSize);
+
+        for (uint32_t i = 0; i < count; ++i) {
+            for (uint32_t p = 0; p < poolCount; ++p) {
+                size_t const offset = offsets[i * poolCount + p];
+                REQUIRE(offset < foeEcsComponentPoolSize(pPools[p]));
+                REQUIRE(foeEcsComponentPoolIdPtr(pPools[p])[offset] == entities[i]);
+                REQUIRE(((foeEntityID *)foeEcsComponentPoolDataPtr(pPools[p]))[offset] ==
+                        entities[i]);
+            }
+            joined.emplace_back(entities[i]);
+        }
+    } while (result.value == FOE_ECS_INCOMPLETE);
+
+    return joined;
+}
+
+} // namespace
+
+TEST_CASE("Join - Selecting the driver pool") {
+    foeEcsComponentPool pools[3] = {
+        createPool(everyNth(100, 2)),
+        createPool(everyNth(100, 5)),
+        createPool(everyNth(100, 3)),
+    };
+
+    CHECK(foeEcsJoinDriver(1, pools) == 0);
+    CHECK(foeEcsJoinDriver(2, pools) == 1);
+    CHECK(foeEcsJoinDriver(3, pools) == 1);
+
+    for (auto pool : pools)
+        foeEcsDestroyComponentPool(pool);
+}
+
+TEST_CASE("Join - Entities in all pools are found") {
+    foeEcsComponentPool pools[3] = {
+        createPool(everyNth(1000, 2)),
+        createPool(everyNth(1000, 3)),
+        createPool(everyNth(1000, 5)),
+    };
+    std::vector<foeEntityID> expected = everyNth(1000, 30);
+
+    SECTION("With a single pool, all of its entities are found") {
+        CHECK(joinAll(1, pools + 1, 0, 0, SIZE_MAX, 64) == everyNth(1000, 3));
+    }
+    SECTION("Any pool can drive the join") {
+        for (uint32_t driver = 0; driver < 3; ++driver) {
+            CHECK(joinAll(3, pools, driver, 0, SIZE_MAX, 64) == expected);
+        }
+    }
+    SECTION("Output too small for all entities continues over several calls") {
+        CHECK(joinAll(3, pools, 2, 0, SIZE_MAX, 1) == expected);
+        CHECK(joinAll(3, pools, 2, 0, SIZE_MAX, 7) == expected);
+    }
+    SECTION("Splitting the driver range into chunks finds the same entities") {
+        uint32_t const driver = foeEcsJoinDriver(3, pools);
+        size_t const driverSize = foeEcsComponentPoolSize(pools[driver]);
+        constexpr size_t chunks = 7;
+
+        std::vector<foeEntityID> joined;
+        for (size_t i = 0; i < chunks; ++i) {
+            auto chunk = joinAll(3, pools, driver, driverSize * i / chunks,
+                                 driverSize * (i + 1) / chunks, 5);
+            joined.insert(joined.end(), chunk.begin(), chunk.end());
+        }
+
+        CHECK(joined == expected);
+    }
+    SECTION("Zero capacity reports there are entities to get") {
+        size_t driverOffset = 0;
+        uint32_t count = 0;
+
+        CHECK(foeEcsJoin(3, pools, 0, &driverOffset, SIZE_MAX, &count, nullptr, nullptr).value ==
+              FOE_ECS_INCOMPLETE);
+        CHECK(count == 0);
+    }
+
+    for (auto pool : pools)
+        foeEcsDestroyComponentPool(pool);
+}
+
+TEST_CASE("Join - Pools with no entities in common") {
+    foeEcsComponentPool pools[3] = {
+        createPool(everyNth(100, 2)),
+        createPool({}),
+        createPool({1, 3, 5, 7, 9}),
+    };
+
+    SECTION("Empty pool") {
+        CHECK(joinAll(3, pools, 0, 0, SIZE_MAX, 8).empty());
+        CHECK(joinAll(3, pools, 1, 0, SIZE_MAX, 8).empty());
+    }
+    SECTION("Disjoint pools") {
+        foeEcsComponentPool disjoint[2] = {pools[0], pools[2]};
+        CHECK(joinAll(2, disjoint, 0, 0, SIZE_MAX, 8).empty());
+        CHECK(joinAll(2, disjoint, 1, 0, SIZE_MAX, 8).empty());
+    }
+    SECTION("Driver range already finished") {
+        size_t driverOffset = 50;
+        uint32_t count = 8;
+        foeEntityID entities[8];
+        size_t offsets[8 * 3];
+
+        CHECK(foeEcsJoin(3, pools, 0, &driverOffset, 50, &count, entities, offsets).value ==
+              FOE_ECS_SUCCESS);
+        CHECK(count == 0);
+        CHECK(driverOffset == 50);
+    }
+
+    for (auto pool : pools)
+        foeEcsDestroyComponentPool(pool);
+}
+
+TEST_CASE("Join - Sparse pool against dense pools", "[.][benchmark]") {
+    constexpr foeEntityID denseCount = 1000000;
+
+    foeEcsComponentPool pools[3] = {
+        createPool(everyNth(denseCount, 1)),
+        createPool(everyNth(denseCount, 2)),
+        createPool(everyNth(denseCount, 100)),
+    };
+
+    BENCHMARK("Searching each pool for every entity of the sparse pool") {
+        size_t found = 0;
+        foeEntityID const *pSparseID = foeEcsComponentPoolIdPtr(pools[2]);
+        foeEntityID const *const pSparseEndID = pSparseID + foeEcsComponentPoolSize(pools[2]);
+
+        for (; pSparseID != pSparseEndID; ++pSparseID) {
+            bool inAll = true;
+            for (int i = 0; i < 2; ++i) {
+                foeEntityID const *pStartID = foeEcsComponentPoolIdPtr(pools[i]);
+                foeEntityID const *pEndID = pStartID + foeEcsComponentPoolSize(pools[i]);
+                foeEntityID const *pID = std::lower_bound(pStartID, pEndID, *pSparseID);
+                if (pID == pEndID || *pID != *pSparseID) {
+                    inAll = false;
+                    break;
+                }
+            }
+            found += inAll ? 1 : 0;
+        }
+
+        return found;
+    };
+
+    BENCHMARK("Joining the pools") {
+        size_t found = 0;
+        foeEntityID entities[256];
+        size_t offsets[256 * 3];
+        size_t driverOffset = 0;
+        uint32_t const driver = foeEcsJoinDriver(3, pools);
+        foeResultSet result;
+
+        do {
+            uint32_t count = 256;
+            result = foeEcsJoin(3, pools, driver, &driverOffset, SIZE_MAX, &count, entities,
+                                offsets);
+            found += count;
+        } while (result.value == FOE_ECS_INCOMPLETE);
+
+        return found;
+    };
+
+    for (auto pool : pools)
+        foeEcsDestroyComponentPool(pool);
+}
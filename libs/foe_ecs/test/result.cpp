@@ -1,4 +1,4 @@
-// Copyright (C) 2022 George Cave.
+// Copyright (C) 2022-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
@@ -38,4 +38,5 @@ TEST_CASE("foeEcsResult - Ensure error codes return correct values and strings")
     ERROR_CODE_CATCH_CHECK(FOE_ECS_ERROR_ID_ALREADY_EXISTS)
     ERROR_CODE_CATCH_CHECK(FOE_ECS_ERROR_NAME_ALREADY_EXISTS)
     ERROR_CODE_CATCH_CHECK(FOE_ECS_ERROR_NO_MATCH)
+    ERROR_CODE_CATCH_CHECK(FOE_ECS_ERROR_ID_ALREADY_FREED)
 }
@@ -154,6 +154,11 @@ void foeImageLoader::gfxMaintenance() {
                     new (pDst) foeImage(std::move(*pSrcData));
                 };
 
+                // Report the device memory used, for the pool's memory budget
+                VmaAllocationInfo allocationInfo;
+                vmaGetAllocationInfo(foeGfxVkGetAllocator(mGfxSession), it.data.alloc,
+                                     &allocationInfo);
+
                 if (foeResourceGetType(it.resource) == FOE_RESOURCE_RESOURCE_TYPE_UNDEFINED) {
                     // Need to replace the placeholder with the actual resource
                     foeResource newResource = foeResourcePoolLoadedReplace(
@@ -165,9 +170,12 @@ void foeImageLoader::gfxMaintenance() {
                         // @TODO - Handle failure
                         std::abort();
 
+                    foeResourceSetMemoryUsage(newResource, 0, allocationInfo.size);
+
                     foeResourceDecrementRefCount(it.resource);
                     foeResourceDecrementRefCount(newResource);
                 } else {
+                    foeResourceSetMemoryUsage(it.resource, 0, allocationInfo.size);
                     it.postLoadFn(it.resource, to_foeResult(FOE_GRAPHICS_RESOURCE_SUCCESS),
                                   &it.data, moveFn, this, foeImageLoader::unloadResource);
                 }
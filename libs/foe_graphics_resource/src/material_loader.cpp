@@ -1,4 +1,4 @@
-// Copyright (C) 2021-2023 George Cave.
+// Copyright (C) 2021-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
@@ -110,24 +110,21 @@ bool foeMaterialLoader::initializedGraphics() const noexcept {
 namespace {
 
 bool processResourceReplacement(foeResource *pResource) {
-    bool replaced = false;
-
-    if (*pResource == FOE_NULL_HANDLE)
+    if (*pResource == FOE_NULL_HANDLE ||
+        foeResourceGetType(*pResource) != FOE_RESOURCE_RESOURCE_TYPE_REPLACED)
         return false;
 
-    while (foeResourceGetType(*pResource) == FOE_RESOURCE_RESOURCE_TYPE_REPLACED) {
-        foeResource replacement = foeResourceGetReplacement(*pResource);
+    // Move straight to the latest replacement
+    foeResource replacement = foeResourceGetCurrent(*pResource);
 
-        foeResourceIncrementUseCount(replacement);
+    foeResourceIncrementUseCount(replacement);
 
-        foeResourceDecrementUseCount(*pResource);
-        foeResourceDecrementRefCount(*pResource);
+    foeResourceDecrementUseCount(*pResource);
+    foeResourceDecrementRefCount(*pResource);
 
-        *pResource = replacement;
-        replaced = true;
-    }
+    *pResource = replacement;
 
-    return replaced;
+    return true;
 }
 
 foeResourceStateFlags processResourceLoadState(foeResource *pResource,
@@ -280,6 +277,8 @@ void foeMaterialLoader::gfxMaintenance() {
                     new (pDst) foeMaterial(std::move(*pSrcData));
                 };
 
+                // Only the material's own data is reported for the pool's memory budget, the
+                // shader and image it uses report their own
                 if (foeResourceGetType(it.resource) == FOE_RESOURCE_RESOURCE_TYPE_UNDEFINED) {
                     // Need to replace the placeholder with the actual resource
                     foeResource newResource = foeResourcePoolLoadedReplace(
@@ -291,9 +290,12 @@ void foeMaterialLoader::gfxMaintenance() {
                         // @TODO - Handle failure
                         std::abort();
 
+                    foeResourceSetMemoryUsage(newResource, sizeof(foeMaterial), 0);
+
                     foeResourceDecrementRefCount(it.resource);
                     foeResourceDecrementRefCount(newResource);
                 } else {
+                    foeResourceSetMemoryUsage(it.resource, sizeof(foeMaterial), 0);
                     it.postLoadFn(it.resource, {}, &it.data, moveFn, this,
                                   foeMaterialLoader::unloadResource);
                 }
@@ -366,12 +368,10 @@ void foeMaterialLoader::load(foeResource resource,
 
     // Find all required sub-resources, and make sure they are compatible types
     if (pMaterialCI->fragmentShader != FOE_INVALID_ID) {
-        while (data.fragmentShader == FOE_NULL_HANDLE) {
-            data.fragmentShader = foeResourcePoolFind(mResourcePool, pMaterialCI->fragmentShader);
-
-            if (data.fragmentShader == FOE_NULL_HANDLE)
-                data.fragmentShader =
-                    foeResourcePoolAdd(mResourcePool, pMaterialCI->fragmentShader);
+        data.fragmentShader = foeResourcePoolFindOrAdd(mResourcePool, pMaterialCI->fragmentShader);
+        if (data.fragmentShader == FOE_NULL_HANDLE) {
+            result = to_foeResult(FOE_GRAPHICS_RESOURCE_ERROR_OUT_OF_MEMORY);
+            goto LOAD_FAILED;
         }
 
         if (foeResourceType type = foeResourceGetType(data.fragmentShader);
@@ -385,11 +385,10 @@ void foeMaterialLoader::load(foeResource resource,
     }
 
     if (pMaterialCI->image != FOE_INVALID_ID) {
-        while (data.image == FOE_NULL_HANDLE) {
-            data.image = foeResourcePoolFind(mResourcePool, pMaterialCI->image);
-
-            if (data.image == FOE_NULL_HANDLE)
-                data.image = foeResourcePoolAdd(mResourcePool, pMaterialCI->image);
+        data.image = foeResourcePoolFindOrAdd(mResourcePool, pMaterialCI->image);
+        if (data.image == FOE_NULL_HANDLE) {
+            result = to_foeResult(FOE_GRAPHICS_RESOURCE_ERROR_OUT_OF_MEMORY);
+            goto LOAD_FAILED;
         }
 
         if (foeResourceType type = foeResourceGetType(data.image);
@@ -20,6 +20,33 @@
 
 #include <memory>
 
+namespace {
+
+/// Device memory taken up by the vertex and index buffers of the mesh
+uint64_t getMeshDeviceMemoryUsage(foeGfxSession session, foeGfxMesh mesh) {
+    VmaAllocator allocator = foeGfxVkGetAllocator(session);
+    VkBuffer buffer;
+    VmaAllocation allocation;
+    VmaAllocationInfo allocationInfo;
+    uint64_t bytes = 0;
+
+    foeGfxVkGetMeshVertexData(mesh, &buffer, &allocation);
+    if (allocation != VK_NULL_HANDLE) {
+        vmaGetAllocationInfo(allocator, allocation, &allocationInfo);
+        bytes += allocationInfo.size;
+    }
+
+    foeGfxVkGetMeshIndexData(mesh, &buffer, &allocation);
+    if (allocation != VK_NULL_HANDLE) {
+        vmaGetAllocationInfo(allocator, allocation, &allocationInfo);
+        bytes += allocationInfo.size;
+    }
+
+    return bytes;
+}
+
+} // namespace
+
 foeResultSet foeMeshLoader::initialize(foeResourcePool resourcePool,
                                        void *pExternalFileSearchContext,
                                        PFN_foeSimulationExternalFileSearch pfnExternalFileSearch) {
@@ -138,6 +165,9 @@ void foeMeshLoader::gfxMaintenance() {
                     new (pDst) foeMesh(std::move(*pSrcData));
                 };
 
+                // Report the device memory used, for the pool's memory budget
+                uint64_t const gpuBytes = getMeshDeviceMemoryUsage(mGfxSession, it.data.gfxData);
+
                 if (foeResourceGetType(it.resource) == FOE_RESOURCE_RESOURCE_TYPE_UNDEFINED) {
                     foeResource newResource = foeResourcePoolLoadedReplace(
                         mResourcePool, foeResourceGetID(it.resource),
@@ -148,9 +178,12 @@ void foeMeshLoader::gfxMaintenance() {
                         // @TODO - Handle failure
                         std::abort();
 
+                    foeResourceSetMemoryUsage(newResource, 0, gpuBytes);
+
                     foeResourceDecrementRefCount(it.resource);
                     foeResourceDecrementRefCount(newResource);
                 } else {
+                    foeResourceSetMemoryUsage(it.resource, 0, gpuBytes);
                     it.postLoadFn(it.resource, to_foeResult(FOE_GRAPHICS_RESOURCE_SUCCESS),
                                   &it.data, moveFn, this, foeMeshLoader::unloadResource);
                 }
@@ -21,6 +21,28 @@
 
 namespace {
 
+foeResourceCreateInfoType const cImageCreateInfoTypes[] = {
+    FOE_GRAPHICS_RESOURCE_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+};
+
+foeResourceCreateInfoType const cMaterialCreateInfoTypes[] = {
+    FOE_GRAPHICS_RESOURCE_STRUCTURE_TYPE_MATERIAL_CREATE_INFO,
+};
+
+foeResourceCreateInfoType const cShaderCreateInfoTypes[] = {
+    FOE_GRAPHICS_RESOURCE_STRUCTURE_TYPE_SHADER_CREATE_INFO,
+};
+
+foeResourceCreateInfoType const cVertexDescriptorCreateInfoTypes[] = {
+    FOE_GRAPHICS_RESOURCE_STRUCTURE_TYPE_VERTEX_DESCRIPTOR_CREATE_INFO,
+};
+
+foeResourceCreateInfoType const cMeshCreateInfoTypes[] = {
+    FOE_GRAPHICS_RESOURCE_STRUCTURE_TYPE_MESH_FILE_CREATE_INFO,
+    FOE_GRAPHICS_RESOURCE_STRUCTURE_TYPE_MESH_CUBE_CREATE_INFO,
+    FOE_GRAPHICS_RESOURCE_STRUCTURE_TYPE_MESH_ICOSPHERE_CREATE_INFO,
+};
+
 struct TypeSelection {
     // Loaders
     bool imageLoader;
@@ -120,6 +142,8 @@ foeResultSet create(foeSimulation simulation) {
             .sType = FOE_GRAPHICS_RESOURCE_STRUCTURE_TYPE_IMAGE_LOADER,
             .pLoader = new (std::nothrow) foeImageLoader,
             .pCanProcessCreateInfoFn = foeImageLoader::canProcessCreateInfo,
+            .createInfoTypeCount = 1,
+            .pCreateInfoTypes = cImageCreateInfoTypes,
             .pLoadFn = foeImageLoader::load,
             .pGfxMaintenanceFn = [](void *pLoader) {
                 reinterpret_cast<foeImageLoader *>(pLoader)->gfxMaintenance();
@@ -155,6 +179,8 @@ foeResultSet create(foeSimulation simulation) {
             .sType = FOE_GRAPHICS_RESOURCE_STRUCTURE_TYPE_MATERIAL_LOADER,
             .pLoader = new (std::nothrow) foeMaterialLoader,
             .pCanProcessCreateInfoFn = foeMaterialLoader::canProcessCreateInfo,
+            .createInfoTypeCount = 1,
+            .pCreateInfoTypes = cMaterialCreateInfoTypes,
             .pLoadFn = foeMaterialLoader::load,
             .pGfxMaintenanceFn = [](void *pLoader) {
                 reinterpret_cast<foeMaterialLoader *>(pLoader)->gfxMaintenance();
@@ -190,6 +216,8 @@ foeResultSet create(foeSimulation simulation) {
             .sType = FOE_GRAPHICS_RESOURCE_STRUCTURE_TYPE_SHADER_LOADER,
             .pLoader = new (std::nothrow) foeShaderLoader,
             .pCanProcessCreateInfoFn = foeShaderLoader::canProcessCreateInfo,
+            .createInfoTypeCount = 1,
+            .pCreateInfoTypes = cShaderCreateInfoTypes,
             .pLoadFn = foeShaderLoader::load,
             .pGfxMaintenanceFn = [](void *pLoader) {
                 reinterpret_cast<foeShaderLoader *>(pLoader)->gfxMaintenance();
@@ -225,6 +253,8 @@ foeResultSet create(foeSimulation simulation) {
             .sType = FOE_GRAPHICS_RESOURCE_STRUCTURE_TYPE_VERTEX_DESCRIPTOR_LOADER,
             .pLoader = new (std::nothrow) foeVertexDescriptorLoader,
             .pCanProcessCreateInfoFn = foeVertexDescriptorLoader::canProcessCreateInfo,
+            .createInfoTypeCount = 1,
+            .pCreateInfoTypes = cVertexDescriptorCreateInfoTypes,
             .pLoadFn = foeVertexDescriptorLoader::load,
             .pGfxMaintenanceFn = [](void *pLoader) {
                 reinterpret_cast<foeVertexDescriptorLoader *>(pLoader)->gfxMaintenance();
@@ -261,6 +291,8 @@ foeResultSet create(foeSimulation simulation) {
             .sType = FOE_GRAPHICS_RESOURCE_STRUCTURE_TYPE_MESH_LOADER,
             .pLoader = new (std::nothrow) foeMeshLoader,
             .pCanProcessCreateInfoFn = foeMeshLoader::canProcessCreateInfo,
+            .createInfoTypeCount = 3,
+            .pCreateInfoTypes = cMeshCreateInfoTypes,
             .pLoadFn = foeMeshLoader::load,
             .pGfxMaintenanceFn = [](void *pLoader) {
                 reinterpret_cast<foeMeshLoader *>(pLoader)->gfxMaintenance();
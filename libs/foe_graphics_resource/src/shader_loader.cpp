@@ -122,11 +122,15 @@ void foeShaderLoader::gfxMaintenance() {
                 // @TODO - Handle failure
                 std::abort();
 
+            // Report the memory used, for the pool's memory budget
+            foeResourceSetMemoryUsage(newResource, it.codeSize, 0);
+
             // Decrement references we no longer need/use
             foeResourceDecrementRefCount(it.resource);
             foeResourceDecrementRefCount(newResource);
         } else {
             // The resource handle is of the desired type already, use the regular load function
+            foeResourceSetMemoryUsage(it.resource, it.codeSize, 0);
             it.postLoadFn(it.resource, to_foeResult(FOE_GRAPHICS_RESOURCE_SUCCESS), &it.data,
                           moveFn, this, foeShaderLoader::unloadResource);
         }
@@ -177,6 +181,7 @@ void foeShaderLoader::load(foeResource resource,
     foeShader data{
         .rType = FOE_GRAPHICS_RESOURCE_STRUCTURE_TYPE_SHADER,
     };
+    uint32_t codeSize = 0;
 
     { // Load Shader SPIR-V from external file
         foeManagedMemory managedMemory = FOE_NULL_HANDLE;
@@ -188,7 +193,6 @@ void foeShaderLoader::load(foeResource resource,
         }
 
         uint32_t *pCode;
-        uint32_t codeSize;
         foeManagedMemoryGetData(managedMemory, (void **)&pCode, &codeSize);
 
         result = foeGfxVkCreateShader(mGfxSession, &pShaderCI->gfxCreateInfo, codeSize, pCode,
@@ -218,6 +222,7 @@ LOAD_FAILED:
             .resource = resource,
             .postLoadFn = postLoadFn,
             .data = std::move(data),
+            .codeSize = codeSize,
         });
         mLoadSync.unlock();
     }
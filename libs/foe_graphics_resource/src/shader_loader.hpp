@@ -58,6 +58,8 @@ class foeShaderLoader {
         foeResource resource;
         PFN_foeResourcePostLoad postLoadFn;
         foeShader data;
+        /// Size of the SPIR-V code, which the driver keeps its own form of
+        uint32_t codeSize;
     };
 
     std::mutex mLoadSync;
@@ -1,4 +1,4 @@
-// Copyright (C) 2021-2023 George Cave.
+// Copyright (C) 2021-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
@@ -69,24 +69,21 @@ void foeVertexDescriptorLoader::deinitializeGraphics() {
 namespace {
 
 bool processResourceReplacement(foeResource *pResource) {
-    bool replaced = false;
-
-    if (*pResource == FOE_NULL_HANDLE)
+    if (*pResource == FOE_NULL_HANDLE ||
+        foeResourceGetType(*pResource) != FOE_RESOURCE_RESOURCE_TYPE_REPLACED)
         return false;
 
-    while (foeResourceGetType(*pResource) == FOE_RESOURCE_RESOURCE_TYPE_REPLACED) {
-        foeResource replacement = foeResourceGetReplacement(*pResource);
+    // Move straight to the latest replacement
+    foeResource replacement = foeResourceGetCurrent(*pResource);
 
-        foeResourceIncrementUseCount(replacement);
+    foeResourceIncrementUseCount(replacement);
 
-        foeResourceDecrementUseCount(*pResource);
-        foeResourceDecrementRefCount(*pResource);
+    foeResourceDecrementUseCount(*pResource);
+    foeResourceDecrementRefCount(*pResource);
 
-        *pResource = replacement;
-        replaced = true;
-    }
+    *pResource = replacement;
 
-    return replaced;
+    return true;
 }
 
 foeResourceStateFlags processResourceLoadState(foeResource *pResource,
@@ -341,11 +338,10 @@ void foeVertexDescriptorLoader::load(foeResource resource,
 
     // Find all required sub-resources, and make sure they are compatible types
     if (pCI->vertexShader != FOE_INVALID_ID) {
-        while (data.vertexShader == FOE_NULL_HANDLE) {
-            data.vertexShader = foeResourcePoolFind(mResourcePool, pCI->vertexShader);
-
-            if (data.vertexShader == FOE_NULL_HANDLE)
-                data.vertexShader = foeResourcePoolAdd(mResourcePool, pCI->vertexShader);
+        data.vertexShader = foeResourcePoolFindOrAdd(mResourcePool, pCI->vertexShader);
+        if (data.vertexShader == FOE_NULL_HANDLE) {
+            result = to_foeResult(FOE_GRAPHICS_RESOURCE_ERROR_OUT_OF_MEMORY);
+            goto LOAD_FAILED;
         }
 
         if (foeResourceType type = foeResourceGetType(data.vertexShader);
@@ -359,13 +355,11 @@ void foeVertexDescriptorLoader::load(foeResource resource,
         }
     }
     if (pCI->tessellationControlShader != FOE_INVALID_ID) {
-        while (data.tessellationControlShader == FOE_NULL_HANDLE) {
-            data.tessellationControlShader =
-                foeResourcePoolFind(mResourcePool, pCI->tessellationControlShader);
-
-            if (data.tessellationControlShader == FOE_NULL_HANDLE)
-                data.tessellationControlShader =
-                    foeResourcePoolAdd(mResourcePool, pCI->tessellationControlShader);
+        data.tessellationControlShader =
+            foeResourcePoolFindOrAdd(mResourcePool, pCI->tessellationControlShader);
+        if (data.tessellationControlShader == FOE_NULL_HANDLE) {
+            result = to_foeResult(FOE_GRAPHICS_RESOURCE_ERROR_OUT_OF_MEMORY);
+            goto LOAD_FAILED;
         }
 
         if (foeResourceType type = foeResourceGetType(data.tessellationControlShader);
@@ -380,13 +374,11 @@ void foeVertexDescriptorLoader::load(foeResource resource,
         }
     }
     if (pCI->tessellationEvaluationShader != FOE_INVALID_ID) {
-        while (data.tessellationEvaluationShader == FOE_NULL_HANDLE) {
-            data.tessellationEvaluationShader =
-                foeResourcePoolFind(mResourcePool, pCI->tessellationEvaluationShader);
-
-            if (data.tessellationEvaluationShader == FOE_NULL_HANDLE)
-                data.tessellationEvaluationShader =
-                    foeResourcePoolAdd(mResourcePool, pCI->tessellationEvaluationShader);
+        data.tessellationEvaluationShader =
+            foeResourcePoolFindOrAdd(mResourcePool, pCI->tessellationEvaluationShader);
+        if (data.tessellationEvaluationShader == FOE_NULL_HANDLE) {
+            result = to_foeResult(FOE_GRAPHICS_RESOURCE_ERROR_OUT_OF_MEMORY);
+            goto LOAD_FAILED;
         }
 
         if (foeResourceType type = foeResourceGetType(data.tessellationEvaluationShader);
@@ -401,11 +393,10 @@ void foeVertexDescriptorLoader::load(foeResource resource,
         }
     }
     if (pCI->geometryShader != FOE_INVALID_ID) {
-        while (data.geometryShader == FOE_NULL_HANDLE) {
-            data.geometryShader = foeResourcePoolFind(mResourcePool, pCI->geometryShader);
-
-            if (data.geometryShader == FOE_NULL_HANDLE)
-                data.geometryShader = foeResourcePoolAdd(mResourcePool, pCI->geometryShader);
+        data.geometryShader = foeResourcePoolFindOrAdd(mResourcePool, pCI->geometryShader);
+        if (data.geometryShader == FOE_NULL_HANDLE) {
+            result = to_foeResult(FOE_GRAPHICS_RESOURCE_ERROR_OUT_OF_MEMORY);
+            goto LOAD_FAILED;
         }
 
         if (foeResourceType type = foeResourceGetType(data.geometryShader);
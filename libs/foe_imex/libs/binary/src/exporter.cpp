@@ -101,6 +101,23 @@ foeResultSet exportDependencyData(foeSimulation simulation, uint32_t *pDataSize,
     return to_foeResult(FOE_IMEX_BINARY_SUCCESS);
 }
 
+/// Returns the runs of currently live indices, in ascending order
+std::vector<foeIdIndexRange> getLiveIndexRanges(foeEcsIndexes indexes) {
+    foeResultSet result;
+    std::vector<foeIdIndexRange> ranges;
+
+    do {
+        uint32_t count;
+        foeEcsExportLiveIndexRanges(indexes, &count, nullptr);
+
+        ranges.resize(count);
+        result = foeEcsExportLiveIndexRanges(indexes, &count, ranges.data());
+        ranges.resize(count);
+    } while (result.value != FOE_SUCCESS);
+
+    return ranges;
+}
+
 foeResultSet exportIndexData(foeEcsIndexes indexes, uint32_t *pDataSize, void **pData) {
     foeResultSet result;
     foeIdIndex nextNewIndex;
@@ -213,46 +230,24 @@ foeResultSet exportResourceData(foeIdGroup groupID,
                                 std::vector<foeImexBinarySet> *pBinarySets,
                                 std::vector<foeImexBinaryFiles> *pFiles) {
     // Get the valid set of resource indices
-    foeResultSet result;
-    foeIdIndex maxIndices;
-    std::vector<foeIdIndex> unusedIndices;
+    foeResultSet result = to_foeResult(FOE_IMEX_BINARY_SUCCESS);
+    std::vector<foeIdIndexRange> liveRanges = getLiveIndexRanges(
+        foeSimulationResourceIndexes(foeSimulationGetGroupData(simulation), groupID));
 
-    do {
-        uint32_t count;
-        foeEcsExportIndexes(
-            foeSimulationResourceIndexes(foeSimulationGetGroupData(simulation), groupID), nullptr,
-            &count, nullptr);
-
-        unusedIndices.resize(count);
-        result = foeEcsExportIndexes(
-            foeSimulationResourceIndexes(foeSimulationGetGroupData(simulation), groupID),
-            &maxIndices, &count, unusedIndices.data());
-        unusedIndices.resize(count);
-    } while (result.value != FOE_SUCCESS);
-    std::sort(unusedIndices.begin(), unusedIndices.end());
-
-    foeResourceID resourceID;
-    auto unused = unusedIndices.begin();
     uint32_t totalResourceDataSize = 0;
 
-    for (foeIdIndex idx = foeIdIndexMinValue; idx < maxIndices; ++idx) {
-        // Check if unused, then skip if it is
-        if (unused != unusedIndices.end()) {
-            if (idx == *unused) {
-                ++unused;
-                continue;
-            }
-        }
-
-        resourceID = foeIdCreate(groupID, idx);
+    for (auto const &range : liveRanges) {
+        for (foeIdIndex idx = range.first; idx < range.first + range.count; ++idx) {
+            foeResourceID resourceID = foeIdCreate(groupID, idx);
 
-        uint32_t dataSize;
-        result = exportResource(resourceID, totalResourceDataSize, &dataSize, simulation,
-                                pResourceSets, pBinarySets, pFiles);
-        totalResourceDataSize += dataSize;
+            uint32_t dataSize;
+            result = exportResource(resourceID, totalResourceDataSize, &dataSize, simulation,
+                                    pResourceSets, pBinarySets, pFiles);
+            totalResourceDataSize += dataSize;
 
-        if (result.value != FOE_SUCCESS)
-            break;
+            if (result.value != FOE_SUCCESS)
+                return result;
+        }
     }
 
     return result;
@@ -300,59 +295,31 @@ foeResultSet exportComponentData(foeIdGroup groupID,
                                  std::vector<EntitySet> *pEntitySets,
                                  std::vector<foeImexBinarySet> *pBinarySets) {
     // Get the valid set of entity indices
-    foeResultSet result;
-    foeIdIndex maxIndices;
-    std::vector<foeIdIndex> unusedIndices;
-
-    do {
-        uint32_t count;
-        foeEcsExportIndexes(
-            foeSimulationEntityIndexes(foeSimulationGetGroupData(simulation), groupID), nullptr,
-            &count, nullptr);
+    foeResultSet result = to_foeResult(FOE_IMEX_BINARY_SUCCESS);
+    std::vector<foeIdIndexRange> liveRanges = getLiveIndexRanges(
+        foeSimulationEntityIndexes(foeSimulationGetGroupData(simulation), groupID));
 
-        unusedIndices.resize(count);
-        result = foeEcsExportIndexes(
-            foeSimulationEntityIndexes(foeSimulationGetGroupData(simulation), groupID), &maxIndices,
-            &count, unusedIndices.data());
-        unusedIndices.resize(count);
-    } while (result.value != FOE_SUCCESS);
-    std::sort(unusedIndices.begin(), unusedIndices.end());
+    for (auto const &range : liveRanges) {
+        for (foeIdIndex idx = range.first; idx < range.first + range.count; ++idx) {
+            foeEntityID entityID = foeIdCreate(groupID, idx);
 
-    foeEntityID entityID;
-    auto unused = unusedIndices.begin();
+            result = exportEntity(entityID, simulation, pEntitySets, pBinarySets);
 
-    for (foeIdIndex idx = foeIdIndexMinValue; idx < maxIndices; ++idx) {
-        // Check if unused, then skip if it is
-        if (unused != unusedIndices.end()) {
-            if (idx == *unused) {
-                ++unused;
-                continue;
-            }
+            if (result.value != FOE_SUCCESS)
+                return result;
         }
-
-        entityID = foeIdCreate(groupID, idx);
-
-        result = exportEntity(entityID, simulation, pEntitySets, pBinarySets);
-
-        if (result.value != FOE_SUCCESS)
-            break;
     }
 
     return result;
 }
 
 void binary_write_EditorNames(foeIdGroup groupID,
-                              foeIdIndex maxIndexID,
-                              foeIdIndex *pUnusedIndexes,
-                              uint32_t unusedIndexCount,
+                              std::vector<foeIdIndexRange> const &liveRanges,
                               foeEcsNameMap nameMap,
                               uint32_t *pOffset,
                               uint32_t *pNamesWritten,
                               uint32_t *pWriteSize,
                               FILE *pWriteFile) {
-    foeIdIndex *pUnused = pUnusedIndexes;
-    foeIdIndex *const pEndUnusedIndex = pUnusedIndexes + unusedIndexCount;
-
     uint32_t numNames = 0;
     uint32_t maxNameLength = 0;
     uint32_t editorNameDataOffset = 0;
@@ -361,32 +328,28 @@ void binary_write_EditorNames(foeIdGroup groupID,
     *pOffset = ftell(pWriteFile);
 
     // Write out indexes
-    for (foeIdIndex indexID = foeIdIndexMinValue; indexID < maxIndexID; ++indexID) {
-        // Check if this particular index is unused, skip if it is
-        if (pUnused != pEndUnusedIndex && *pUnused == indexID) {
-            ++pUnused;
-            continue;
-        }
-
-        foeId fullID = foeIdCreate(groupID, indexID);
+    for (auto const &range : liveRanges) {
+        for (foeIdIndex indexID = range.first; indexID < range.first + range.count; ++indexID) {
+            foeId fullID = foeIdCreate(groupID, indexID);
 
-        uint32_t nameLength;
-        foeResultSet result = foeEcsNameMapFindName(nameMap, fullID, &nameLength, nullptr);
-        if (result.value == FOE_ECS_NO_MATCH) {
-            continue;
-        }
-        if (nameLength > maxNameLength) {
-            maxNameLength = nameLength;
-        }
+            uint32_t nameLength;
+            foeResultSet result = foeEcsNameMapFindName(nameMap, fullID, &nameLength, nullptr);
+            if (result.value == FOE_ECS_NO_MATCH) {
+                continue;
+            }
+            if (nameLength > maxNameLength) {
+                maxNameLength = nameLength;
+            }
 
-        // Write out the index
-        fwrite(&indexID, sizeof(foeIdIndex), 1, pWriteFile);
+            // Write out the index
+            fwrite(&indexID, sizeof(foeIdIndex), 1, pWriteFile);
 
-        // Write out the offset of the string in the data section
-        fwrite(&editorNameDataOffset, sizeof(uint32_t), 1, pWriteFile);
+            // Write out the offset of the string in the data section
+            fwrite(&editorNameDataOffset, sizeof(uint32_t), 1, pWriteFile);
 
-        editorNameDataOffset += sizeof(uint32_t) + nameLength;
-        ++numNames;
+            editorNameDataOffset += sizeof(uint32_t) + nameLength;
+            ++numNames;
+        }
     }
 
     *pNamesWritten = numNames;
@@ -397,24 +360,23 @@ void binary_write_EditorNames(foeIdGroup groupID,
 
     // Write out the actual editor names
     std::unique_ptr<char[]> nameBuffer(new char[maxNameLength]);
-    pUnused = pUnusedIndexes;
-    for (foeIdIndex indexID = foeIdIndexMinValue; indexID < maxIndexID; ++indexID) {
-        // Check if this particular index is unused, skip if it is
-        if (pUnused != pEndUnusedIndex && *pUnused == indexID) {
-            ++pUnused;
-            continue;
-        }
-
-        foeId fullID = foeIdCreate(groupID, indexID);
+    for (auto const &range : liveRanges) {
+        for (foeIdIndex indexID = range.first; indexID < range.first + range.count; ++indexID) {
+            foeId fullID = foeIdCreate(groupID, indexID);
+
+            uint32_t nameLength = maxNameLength;
+            foeResultSet result =
+                foeEcsNameMapFindName(nameMap, fullID, &nameLength, nameBuffer.get());
+            if (result.value == FOE_ECS_NO_MATCH) {
+                continue;
+            }
+            if (result.value != FOE_SUCCESS) {
+                std::abort();
+            }
 
-        uint32_t nameLength = maxNameLength;
-        foeResultSet result = foeEcsNameMapFindName(nameMap, fullID, &nameLength, nameBuffer.get());
-        if (result.value != FOE_SUCCESS) {
-            std::abort();
+            fwrite(&nameLength, sizeof(uint32_t), 1, pWriteFile);
+            fwrite(nameBuffer.get(), nameLength, 1, pWriteFile);
         }
-
-        fwrite(&nameLength, sizeof(uint32_t), 1, pWriteFile);
-        fwrite(nameBuffer.get(), nameLength, 1, pWriteFile);
     }
 
     *pWriteSize = (numNames * (sizeof(foeIdIndex) + sizeof(uint32_t))) + editorNameDataOffset;
@@ -526,27 +488,11 @@ EXPORT_FAILED:
         totalWrittenData += entityIndexDataSize;
 
         { // Write out Resource Editor Names
-            foeResultSet result;
-            foeIdIndex maxIndex;
-            std::vector<foeIdIndex> unusedIndices;
-
-            do {
-                uint32_t count;
-                foeEcsExportIndexes(
-                    foeSimulationPersistentResourceIndexes(foeSimulationGetGroupData(simulation)),
-                    nullptr, &count, nullptr);
-
-                unusedIndices.resize(count);
-                result = foeEcsExportIndexes(
-                    foeSimulationPersistentResourceIndexes(foeSimulationGetGroupData(simulation)),
-                    &maxIndex, &count, unusedIndices.data());
-                unusedIndices.resize(count);
-            } while (result.value != FOE_SUCCESS);
-            std::sort(unusedIndices.begin(), unusedIndices.end());
-
             uint32_t writtenBytes = 0;
             binary_write_EditorNames(
-                foeIdPersistentGroup, maxIndex, unusedIndices.data(), unusedIndices.size(),
+                foeIdPersistentGroup,
+                getLiveIndexRanges(
+                    foeSimulationPersistentResourceIndexes(foeSimulationGetGroupData(simulation))),
                 foeSimulationGetResourceNameMap(simulation),
                 &fileHeaderData.resourceEditorNamesOffset, &fileHeaderData.numResourceEditorNames,
                 &writtenBytes, pOutFile);
@@ -554,27 +500,11 @@ EXPORT_FAILED:
         }
 
         { // Write out Entity Editor Names
-            foeResultSet result;
-            foeIdIndex maxIndex;
-            std::vector<foeIdIndex> unusedIndices;
-
-            do {
-                uint32_t count;
-                foeEcsExportIndexes(
-                    foeSimulationPersistentEntityIndexes(foeSimulationGetGroupData(simulation)),
-                    nullptr, &count, nullptr);
-
-                unusedIndices.resize(count);
-                result = foeEcsExportIndexes(
-                    foeSimulationPersistentEntityIndexes(foeSimulationGetGroupData(simulation)),
-                    &maxIndex, &count, unusedIndices.data());
-                unusedIndices.resize(count);
-            } while (result.value != FOE_SUCCESS);
-            std::sort(unusedIndices.begin(), unusedIndices.end());
-
             uint32_t writtenBytes = 0;
             binary_write_EditorNames(
-                foeIdPersistentGroup, maxIndex, unusedIndices.data(), unusedIndices.size(),
+                foeIdPersistentGroup,
+                getLiveIndexRanges(
+                    foeSimulationPersistentEntityIndexes(foeSimulationGetGroupData(simulation))),
                 foeSimulationGetEntityNameMap(simulation), &fileHeaderData.entityEditorNamesOffset,
                 &fileHeaderData.numEntityEditorNames, &writtenBytes, pOutFile);
             totalWrittenData += writtenBytes;
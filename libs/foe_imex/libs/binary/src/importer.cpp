@@ -17,6 +17,7 @@
 #include <cassert>
 #include <filesystem>
 #include <string_view>
+#include <vector>
 
 namespace {
 
@@ -278,6 +279,10 @@ foeResultSet importStateData(foeImexImporter importer,
             foeEcsGetTranslatedGroup(pImporter->groupTranslator, foeIdPersistentGroup,
                                      &topLevelImportGroup);
 
+        std::vector<std::pair<foeIdIndex, size_t>> nameOffsets;
+        std::vector<char> nameBuffer;
+        nameOffsets.reserve(pImporter->fileHeader.numEntityEditorNames);
+
         for (uint32_t i = 0; i < pImporter->fileHeader.numEntityEditorNames; ++i) {
             pData = pImporter->pFileData + pImporter->fileHeader.entityEditorNamesOffset +
                     (i * (sizeof(foeIdIndex) + sizeof(uint32_t)));
@@ -296,13 +301,22 @@ foeResultSet importStateData(foeImexImporter importer,
             uint32_t strLen = *(uint32_t const *)pData;
             pData += sizeof(uint32_t);
 
-            std::unique_ptr<char[]> buffer(new char[strLen + 1]);
-            memcpy(buffer.get(), pData, strLen);
-            pData += strLen;
-            buffer[strLen] = '\0';
+            // Names in the file aren't null-terminated, so are copied out with terminators added
+            nameOffsets.emplace_back(indexID, nameBuffer.size());
+            nameBuffer.insert(nameBuffer.end(), (char const *)pData, (char const *)pData + strLen);
+            nameBuffer.push_back('\0');
+        }
 
-            foeEcsNameMapAdd(nameMap, foeIdCreate(topLevelImportGroup, indexID), buffer.get());
+        std::vector<foeEcsNameMapEntry> entries;
+        entries.reserve(nameOffsets.size());
+        for (auto const &[indexID, offset] : nameOffsets) {
+            entries.emplace_back(foeEcsNameMapEntry{
+                .id = foeIdCreate(topLevelImportGroup, indexID),
+                .pName = nameBuffer.data() + offset,
+            });
         }
+
+        foeEcsNameMapAddMany(nameMap, entries.size(), entries.data());
     }
 
     // Component Binary Key Index
@@ -202,64 +202,60 @@ foeResultSet exportGroupEntityIndexData(foeSimulation simulation, YAML::Node &da
     return to_foeResult(FOE_IMEX_YAML_ERROR_FAILED_TO_WRITE_COMPONENT_INDEX_DATA);
 }
 
-foeResultSet exportResources(foeIdGroup group, foeSimulation simulation, YAML::Node &data) {
-    // Get the valid set of resource indices
+/// Returns the runs of currently live indices, in ascending order
+std::vector<foeIdIndexRange> getLiveIndexRanges(foeEcsIndexes indexes) {
     foeResultSet result;
-    foeIdIndex maxIndices;
-    std::vector<foeIdIndex> unusedIndices;
+    std::vector<foeIdIndexRange> ranges;
 
     do {
         uint32_t count;
-        foeEcsExportIndexes(
-            foeSimulationResourceIndexes(foeSimulationGetGroupData(simulation), group), nullptr,
-            &count, nullptr);
-
-        unusedIndices.resize(count);
-        result = foeEcsExportIndexes(
-            foeSimulationResourceIndexes(foeSimulationGetGroupData(simulation), group), &maxIndices,
-            &count, unusedIndices.data());
-        unusedIndices.resize(count);
+        foeEcsExportLiveIndexRanges(indexes, &count, nullptr);
+
+        ranges.resize(count);
+        result = foeEcsExportLiveIndexRanges(indexes, &count, ranges.data());
+        ranges.resize(count);
     } while (result.value != FOE_SUCCESS);
-    std::sort(unusedIndices.begin(), unusedIndices.end());
+
+    return ranges;
+}
+
+foeResultSet exportResources(foeIdGroup group, foeSimulation simulation, YAML::Node &data) {
+    // Get the valid set of resource indices
+    std::vector<foeIdIndexRange> liveRanges = getLiveIndexRanges(
+        foeSimulationResourceIndexes(foeSimulationGetGroupData(simulation), group));
 
     foeResourceID resourceID;
-    auto unused = unusedIndices.begin();
 
     try {
-        for (foeIdIndex idx = foeIdIndexMinValue; idx < maxIndices; ++idx) {
-            // Check if unused, then skip if it is
-            if (unused != unusedIndices.end()) {
-                if (idx == *unused) {
-                    ++unused;
-                    continue;
+        for (auto const &range : liveRanges) {
+            for (foeIdIndex idx = range.first; idx < range.first + range.count; ++idx) {
+                resourceID = foeIdCreate(group, idx);
+
+                // Resource Name
+                foeEcsNameMap nameMap = foeSimulationGetResourceNameMap(simulation);
+                char *pResourceName = NULL;
+                if (nameMap != FOE_NULL_HANDLE) {
+                    uint32_t strLength = 0;
+                    foeResultSet result;
+                    do {
+                        result = foeEcsNameMapFindName(nameMap, resourceID, &strLength,
+                                                       pResourceName);
+                        if (result.value == FOE_ECS_SUCCESS && pResourceName != NULL) {
+                            break;
+                        } else if ((result.value == FOE_ECS_SUCCESS && pResourceName == NULL) ||
+                                   result.value == FOE_ECS_INCOMPLETE) {
+                            pResourceName = (char *)realloc(pResourceName, strLength);
+                            if (pResourceName == NULL)
+                                std::abort();
+                        }
+                    } while (result.value != FOE_ECS_NO_MATCH);
                 }
-            }
-
-            resourceID = foeIdCreate(group, idx);
-
-            // Resource Name
-            foeEcsNameMap nameMap = foeSimulationGetResourceNameMap(simulation);
-            char *pResourceName = NULL;
-            if (nameMap != FOE_NULL_HANDLE) {
-                uint32_t strLength = 0;
-                foeResultSet result;
-                do {
-                    result = foeEcsNameMapFindName(nameMap, resourceID, &strLength, pResourceName);
-                    if (result.value == FOE_ECS_SUCCESS && pResourceName != NULL) {
-                        break;
-                    } else if ((result.value == FOE_ECS_SUCCESS && pResourceName == NULL) ||
-                               result.value == FOE_ECS_INCOMPLETE) {
-                        pResourceName = (char *)realloc(pResourceName, strLength);
-                        if (pResourceName == NULL)
-                            std::abort();
-                    }
-                } while (result.value != FOE_ECS_NO_MATCH);
-            }
 
-            data.push_back(exportResource(resourceID, pResourceName, gResourceFns, simulation));
+                data.push_back(exportResource(resourceID, pResourceName, gResourceFns, simulation));
 
-            if (pResourceName)
-                free(pResourceName);
+                if (pResourceName)
+                    free(pResourceName);
+            }
         }
     } catch (foeYamlException const &e) {
         FOE_LOG(foeImexYaml, FOE_LOG_LEVEL_ERROR, "Failed to export resource: {} - {}",
@@ -272,62 +268,40 @@ foeResultSet exportResources(foeIdGroup group, foeSimulation simulation, YAML::N
 
 foeResultSet exportComponentData(foeIdGroup group, foeSimulation simulation, YAML::Node &data) {
     // Get the valid set of entity indices
-    foeResultSet result;
-    foeIdIndex maxIndices;
-    std::vector<foeIdIndex> unusedIndices;
-
-    do {
-        uint32_t count;
-        foeEcsExportIndexes(
-            foeSimulationEntityIndexes(foeSimulationGetGroupData(simulation), group), nullptr,
-            &count, nullptr);
-
-        unusedIndices.resize(count);
-        result = foeEcsExportIndexes(
-            foeSimulationEntityIndexes(foeSimulationGetGroupData(simulation), group), &maxIndices,
-            &count, unusedIndices.data());
-        unusedIndices.resize(count);
-    } while (result.value != FOE_SUCCESS);
-    std::sort(unusedIndices.begin(), unusedIndices.end());
+    std::vector<foeIdIndexRange> liveRanges = getLiveIndexRanges(
+        foeSimulationEntityIndexes(foeSimulationGetGroupData(simulation), group));
 
     foeEntityID entity;
-    auto unused = unusedIndices.begin();
 
     try {
-        for (foeIdIndex idx = foeIdIndexMinValue; idx < maxIndices; ++idx) {
-            // Check if unused, then skip if it is
-            if (unused != unusedIndices.end()) {
-                if (idx == *unused) {
-                    ++unused;
-                    continue;
+        for (auto const &range : liveRanges) {
+            for (foeIdIndex idx = range.first; idx < range.first + range.count; ++idx) {
+                entity = foeIdCreate(group, idx);
+
+                // Entity Name
+                foeEcsNameMap nameMap = foeSimulationGetEntityNameMap(simulation);
+                char *pName = NULL;
+                if (nameMap != FOE_NULL_HANDLE) {
+                    uint32_t strLength = 0;
+                    foeResultSet result;
+                    do {
+                        result = foeEcsNameMapFindName(nameMap, entity, &strLength, pName);
+                        if (result.value == FOE_ECS_SUCCESS && pName != NULL) {
+                            break;
+                        } else if ((result.value == FOE_ECS_SUCCESS && pName == NULL) ||
+                                   result.value == FOE_ECS_INCOMPLETE) {
+                            pName = (char *)realloc(pName, strLength);
+                            if (pName == NULL)
+                                std::abort();
+                        }
+                    } while (result.value != FOE_ECS_NO_MATCH);
                 }
-            }
 
-            entity = foeIdCreate(group, idx);
-
-            // Entity Name
-            foeEcsNameMap nameMap = foeSimulationGetEntityNameMap(simulation);
-            char *pName = NULL;
-            if (nameMap != FOE_NULL_HANDLE) {
-                uint32_t strLength = 0;
-                foeResultSet result;
-                do {
-                    result = foeEcsNameMapFindName(nameMap, entity, &strLength, pName);
-                    if (result.value == FOE_ECS_SUCCESS && pName != NULL) {
-                        break;
-                    } else if ((result.value == FOE_ECS_SUCCESS && pName == NULL) ||
-                               result.value == FOE_ECS_INCOMPLETE) {
-                        pName = (char *)realloc(pName, strLength);
-                        if (pName == NULL)
-                            std::abort();
-                    }
-                } while (result.value != FOE_ECS_NO_MATCH);
-            }
+                data.push_back(exportComponents(entity, pName, gComponentFns, simulation));
 
-            data.push_back(exportComponents(entity, pName, gComponentFns, simulation));
-
-            if (pName)
-                free(pName);
+                if (pName)
+                    free(pName);
+            }
         }
     } catch (foeYamlException const &e) {
         FOE_LOG(foeImexYaml, FOE_LOG_LEVEL_ERROR, "Failed to export entity: {} - {}",
@@ -183,7 +183,7 @@ TEST_CASE("foeYamlImporter - Function Tests") {
         REQUIRE(count == 2);
 
         CHECK(nextFreshIndex == 3);
-        CHECK(recycled[0] == 0);
+        CHECK(recycled[0] == 1);
         CHECK(recycled[1] == 2);
 
         foeEcsDestroyIndexes(indexes);
@@ -22,6 +22,22 @@
 
 namespace {
 
+foeResourceCreateInfoType const cCollisionShapeCreateInfoTypes[] = {
+    FOE_PHYSICS_STRUCTURE_TYPE_COLLISION_SHAPE_CREATE_INFO,
+};
+
+foeSimulationStructureType const cPhysicsSystemReadPools[] = {
+    FOE_PHYSICS_STRUCTURE_TYPE_RIGID_BODY_POOL,
+};
+
+foeSimulationStructureType const cPhysicsSystemWritePools[] = {
+    FOE_POSITION_STRUCTURE_TYPE_POSITION_3D_POOL,
+};
+
+foeResultSet processPhysicsSystem(void *pSystem, float timeElapsed) {
+    return foePhysicsProcessSystem((foePhysicsSystem)pSystem, timeElapsed);
+}
+
 struct TypeSelection {
     // Loaders
     bool collisionShapeLoader;
@@ -140,6 +156,8 @@ foeResultSet create(foeSimulation simulation) {
             .sType = FOE_PHYSICS_STRUCTURE_TYPE_COLLISION_SHAPE_LOADER,
             .pLoader = new (std::nothrow) foeCollisionShapeLoader,
             .pCanProcessCreateInfoFn = foeCollisionShapeLoader::canProcessCreateInfo,
+            .createInfoTypeCount = 1,
+            .pCreateInfoTypes = cCollisionShapeCreateInfoTypes,
             .pLoadFn = foeCollisionShapeLoader::load,
             .pMaintenanceFn = [](void *pLoader) {
                 reinterpret_cast<foeCollisionShapeLoader *>(pLoader)->maintenance();
@@ -182,6 +200,14 @@ foeResultSet create(foeSimulation simulation) {
             goto CREATE_FAILED;
         }
 
+        // The physics system looks up rigid bodies by entity
+        result =
+            foeEcsComponentPoolEnableOffsetIndex((foeEcsComponentPool)createInfo.pComponentPool);
+        if (result.value != FOE_SUCCESS) {
+            foeEcsDestroyComponentPool((foeEcsComponentPool)createInfo.pComponentPool);
+            goto CREATE_FAILED;
+        }
+
         result = foeSimulationInsertComponentPool(simulation, &createInfo);
         if (result.value != FOE_SUCCESS) {
             delete (foeRigidBodyPool *)createInfo.pComponentPool;
@@ -205,6 +231,11 @@ foeResultSet create(foeSimulation simulation) {
     if (result.value != FOE_SUCCESS) {
         foeSimulationSystemData createInfo{
             .sType = FOE_PHYSICS_STRUCTURE_TYPE_PHYSICS_SYSTEM,
+            .pProcessFn = processPhysicsSystem,
+            .readPoolCount = 1,
+            .pReadPools = cPhysicsSystemReadPools,
+            .writePoolCount = 1,
+            .pWritePools = cPhysicsSystemWritePools,
         };
 
         result = foePhysicsCreateSystem((foePhysicsSystem *)&createInfo.pSystem);
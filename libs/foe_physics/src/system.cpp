@@ -1,4 +1,4 @@
-// Copyright (C) 2021-2024 George Cave.
+// Copyright (C) 2021-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
@@ -7,6 +7,8 @@
 #include <btBulletDynamicsCommon.h>
 #include <foe/ecs/id.h>
 #include <foe/ecs/id_to_string.hpp>
+#include <foe/ecs/join.h>
+#include <foe/ecs/result.h>
 #include <foe/physics/component/rigid_body.h>
 #include <foe/physics/component/rigid_body_pool.h>
 #include <foe/physics/resource/collision_shape.hpp>
@@ -15,9 +17,6 @@
 #include <foe/position/component/3d_pool.h>
 #include <foe/resource/resource.h>
 
-#define GLM_ENABLE_EXPERIMENTAL
-#include <glm/gtx/matrix_decompose.hpp>
-
 #include "bt_glm_conversion.hpp"
 #include "log.hpp"
 #include "result.h"
@@ -40,8 +39,9 @@ struct PhysicsSystem {
     foeRigidBodyPool rigidBodyPool;
     foePosition3dPool positionPool;
 
-    // Entity Lists
-    foeEcsEntityList positionModifiedEntityList;
+    // Change version of the position pool that modifications have been processed up to, which
+    // includes the positions written back by this system
+    uint32_t positionChangeVersion;
 
     // Physics World Instance Items
     btBroadphaseInterface *pBroadphase;
@@ -59,90 +59,96 @@ struct PhysicsSystem {
 
 FOE_DEFINE_HANDLE_CASTS(physics_system, PhysicsSystem, foePhysicsSystem)
 
-[[nodiscard]]
-foeResultSet addWorldObject(PhysicsSystem *pPhysicsSystem,
-                            foeEntityID entity,
-                            foeRigidBody *pRigidBody,
-                            foePosition3d *pPosition,
-                            foeResource collisionShape) {
+/// An entity to be added to the world, with its components if they are already known
+struct WorldObjectRequest {
+    foeEntityID entity;
+    foeRigidBody *pRigidBody;
+    foePosition3d *pPosition;
+};
+
+bool isWorldObject(PhysicsSystem const *pPhysicsSystem, foeEntityID entity) {
     auto searchIt = std::lower_bound(pPhysicsSystem->activeWorldObjects.begin(),
                                      pPhysicsSystem->activeWorldObjects.end(), entity,
                                      [](ActiveWorldObject const &obj, foeEntityID const entity) {
                                          return obj.entity < entity;
                                      });
 
-    // If already added, don't re-add it
-    if (searchIt != pPhysicsSystem->activeWorldObjects.end() && searchIt->entity == entity)
-        return to_foeResult(FOE_PHYSICS_SUCCESS);
+    return searchIt != pPhysicsSystem->activeWorldObjects.end() && searchIt->entity == entity;
+}
 
+/// Finds any of the request's components not already known, returning false if any are missing
+bool findWorldObjectComponents(PhysicsSystem *pPhysicsSystem, WorldObjectRequest &request) {
     // RigidBody
-    if (pRigidBody == nullptr) {
-        foeEntityID const *const pStartID = foeEcsComponentPoolIdPtr(pPhysicsSystem->rigidBodyPool);
-        foeEntityID const *const pEndID =
-            pStartID + foeEcsComponentPoolSize(pPhysicsSystem->rigidBodyPool);
+    if (request.pRigidBody == nullptr) {
+        size_t offset;
+        if (!foeEcsComponentPoolFindOffset(pPhysicsSystem->rigidBodyPool, request.entity, &offset))
+            return false;
 
-        foeEntityID const *pID = std::lower_bound(pStartID, pEndID, entity);
-
-        if (pID != pEndID && *pID == entity) {
-            size_t offset = pID - pStartID;
-            pRigidBody =
-                (foeRigidBody *)foeEcsComponentPoolDataPtr(pPhysicsSystem->rigidBodyPool) + offset;
-        } else {
-            return to_foeResult(FOE_PHYSICS_SUCCESS);
-        }
+        request.pRigidBody =
+            (foeRigidBody *)foeEcsComponentPoolDataPtr(pPhysicsSystem->rigidBodyPool) + offset;
     }
 
     // foePosition3d
-    if (pPosition == nullptr) {
-        foeEntityID const *const pStartID = foeEcsComponentPoolIdPtr(pPhysicsSystem->positionPool);
-        foeEntityID const *const pEndID =
-            pStartID + foeEcsComponentPoolSize(pPhysicsSystem->positionPool);
-
-        foeEntityID const *pID = std::lower_bound(pStartID, pEndID, entity);
+    if (request.pPosition == nullptr) {
+        size_t offset;
+        if (!foeEcsComponentPoolFindOffset(pPhysicsSystem->positionPool, request.entity, &offset))
+            return false;
 
-        if (pID != pEndID && *pID == entity) {
-            size_t offset = pID - pStartID;
-            pPosition =
-                *((foePosition3d **)foeEcsComponentPoolDataPtr(pPhysicsSystem->positionPool) +
-                  offset);
-        } else {
-            return to_foeResult(FOE_PHYSICS_SUCCESS);
-        }
+        request.pPosition =
+            (foePosition3d *)foeEcsComponentPoolDataPtr(pPhysicsSystem->positionPool) + offset;
     }
 
-    // CollisionShape
-    while (collisionShape == FOE_NULL_HANDLE) {
-        collisionShape =
-            foeResourcePoolFind(pPhysicsSystem->resourcePool, pRigidBody->collisionShape);
+    return true;
+}
+
+/// Advances a held resource reference to the latest replacement, if it has been replaced
+foeResource getCurrentResource(foeResource resource) {
+    if (foeResourceGetType(resource) != FOE_RESOURCE_RESOURCE_TYPE_REPLACED)
+        return resource;
+
+    foeResource replacementResource = foeResourceGetCurrent(resource);
+
+    foeResourceDecrementRefCount(resource);
+
+    return replacementResource;
+}
+
+/** @brief Adds the world object for a request with all of its components found
+ * @param collisionShape Collision shape resource of the rigid body, with the acquired reference
+ * being handed over.
+ */
+[[nodiscard]]
+foeResultSet addAcquiredWorldObject(PhysicsSystem *pPhysicsSystem,
+                                    WorldObjectRequest const &request,
+                                    foeResource collisionShape) {
+    auto searchIt = std::lower_bound(pPhysicsSystem->activeWorldObjects.begin(),
+                                     pPhysicsSystem->activeWorldObjects.end(), request.entity,
+                                     [](ActiveWorldObject const &obj, foeEntityID const entity) {
+                                         return obj.entity < entity;
+                                     });
 
-        if (collisionShape == FOE_NULL_HANDLE)
-            collisionShape =
-                foeResourcePoolAdd(pPhysicsSystem->resourcePool, pRigidBody->collisionShape);
+    // If already added, don't re-add it
+    if (searchIt != pPhysicsSystem->activeWorldObjects.end() &&
+        searchIt->entity == request.entity) {
+        foeResourceDecrementRefCount(collisionShape);
+        return to_foeResult(FOE_PHYSICS_SUCCESS);
     }
 
-CHECK_COLLISION_SHAPE_LOADED:
+    // CollisionShape
+    collisionShape = getCurrentResource(collisionShape);
+
     if (auto resourceState = foeResourceGetState(collisionShape);
         (resourceState & FOE_RESOURCE_STATE_LOADED_BIT) == 0) {
         if ((resourceState & FOE_RESOURCE_STATE_LOADING_BIT) == 0) {
             foeResourceLoadData(collisionShape);
         }
-        pPhysicsSystem->awaitingLoadingResources.emplace_back(entity);
+        pPhysicsSystem->awaitingLoadingResources.emplace_back(request.entity);
 
         // No longer holding on to this resource reference
         foeResourceDecrementRefCount(collisionShape);
 
         return to_foeResult(FOE_PHYSICS_SUCCESS);
     }
-    if (foeResourceGetType(collisionShape) == FOE_RESOURCE_RESOURCE_TYPE_REPLACED) {
-        // Resource has been replaced, advance to it instead
-        foeResource replacementResource = foeResourceGetReplacement(collisionShape);
-
-        foeResourceDecrementRefCount(collisionShape);
-
-        collisionShape = replacementResource;
-
-        goto CHECK_COLLISION_SHAPE_LOADED;
-    }
 
     // Get CollisionShape data, if it exists in the acquired resource
     auto const *pCollisionShape = (foeCollisionShape const *)foeResourceGetTypeData(
@@ -152,7 +158,7 @@ CHECK_COLLISION_SHAPE_LOADED:
         FOE_LOG(foePhysics, FOE_LOG_LEVEL_ERROR,
                 "foePhysicsSystem - Failed to load {} rigid body because the given "
                 "resource {} is not a collision shape resource.",
-                foeIdToString(entity), foeIdToString(pRigidBody->collisionShape))
+                foeIdToString(request.entity), foeIdToString(request.pRigidBody->collisionShape))
 
         // No longer holding on to this resource reference
         foeResourceDecrementRefCount(collisionShape);
@@ -161,19 +167,21 @@ CHECK_COLLISION_SHAPE_LOADED:
     }
 
     // We have everything we need now
-    btRigidBody::btRigidBodyConstructionInfo rigidBodyCI{pRigidBody->mass, nullptr,
+    btRigidBody::btRigidBodyConstructionInfo rigidBodyCI{request.pRigidBody->mass, nullptr,
                                                          pCollisionShape->collisionShape.get()};
     rigidBodyCI.m_startWorldTransform =
-        glmToBtTransform(pPosition->position, pPosition->orientation);
+        glmToBtTransform(request.pPosition->position, request.pPosition->orientation);
 
     ActiveWorldObject newObject = {
-        .entity = entity,
+        .entity = request.entity,
         .collisionShape = collisionShape,
-        .mass = pRigidBody->mass,
+        .mass = request.pRigidBody->mass,
         .pRigidBody = (btRigidBody *)malloc(sizeof(btRigidBody)),
     };
-    if (newObject.pRigidBody == nullptr)
+    if (newObject.pRigidBody == nullptr) {
+        foeResourceDecrementRefCount(collisionShape);
         return to_foeResult(FOE_PHYSICS_ERROR_OUT_OF_MEMORY);
+    }
     new (newObject.pRigidBody) btRigidBody{rigidBodyCI};
 
     foeResourceIncrementUseCount(collisionShape);
@@ -185,6 +193,63 @@ CHECK_COLLISION_SHAPE_LOADED:
     return to_foeResult(FOE_PHYSICS_SUCCESS);
 }
 
+/** @brief Adds world objects for a set of entities that have all they need and aren't yet added
+ * @param requests Entities to add, which is modified during processing.
+ *
+ * The collision shapes of the whole set are acquired together, and those that need loading are
+ * started together, rather than going to the resource pool separately for each entity.
+ */
+[[nodiscard]]
+foeResultSet addWorldObjects(PhysicsSystem *pPhysicsSystem,
+                             std::vector<WorldObjectRequest> &requests) {
+    requests.erase(std::remove_if(requests.begin(), requests.end(),
+                                  [&](WorldObjectRequest &request) {
+                                      return isWorldObject(pPhysicsSystem, request.entity) ||
+                                             !findWorldObjectComponents(pPhysicsSystem, request);
+                                  }),
+                   requests.end());
+    if (requests.empty())
+        return to_foeResult(FOE_PHYSICS_SUCCESS);
+
+    uint32_t const count = (uint32_t)requests.size();
+    std::vector<foeResourceID> collisionShapeIDs(count);
+    std::vector<foeResource> collisionShapes(count);
+
+    for (uint32_t i = 0; i < count; ++i)
+        collisionShapeIDs[i] = requests[i].pRigidBody->collisionShape;
+
+    foeResultSet result = foeResourcePoolAcquireMany(
+        pPhysicsSystem->resourcePool, count, collisionShapeIDs.data(), collisionShapes.data());
+    if (result.value != FOE_SUCCESS) {
+        for (foeResource collisionShape : collisionShapes) {
+            if (collisionShape != FOE_NULL_HANDLE)
+                foeResourceDecrementRefCount(collisionShape);
+        }
+        return to_foeResult(FOE_PHYSICS_ERROR_OUT_OF_MEMORY);
+    }
+
+    std::vector<foeResource> collisionShapesToLoad;
+    for (foeResource &collisionShape : collisionShapes) {
+        collisionShape = getCurrentResource(collisionShape);
+
+        if ((foeResourceGetState(collisionShape) &
+             (FOE_RESOURCE_STATE_LOADING_BIT | FOE_RESOURCE_STATE_LOADED_BIT)) == 0)
+            collisionShapesToLoad.emplace_back(collisionShape);
+    }
+    foeResourceLoadDataMany((uint32_t)collisionShapesToLoad.size(), collisionShapesToLoad.data());
+
+    for (uint32_t i = 0; i < count; ++i) {
+        result = addAcquiredWorldObject(pPhysicsSystem, requests[i], collisionShapes[i]);
+        if (result.value != FOE_SUCCESS) {
+            for (++i; i < count; ++i)
+                foeResourceDecrementRefCount(collisionShapes[i]);
+            return result;
+        }
+    }
+
+    return to_foeResult(FOE_PHYSICS_SUCCESS);
+}
+
 void removeWorldObject(PhysicsSystem *pPhysicsSystem, foeEntityID entity) {
     auto searchIt = std::lower_bound(pPhysicsSystem->activeWorldObjects.begin(),
                                      pPhysicsSystem->activeWorldObjects.end(), entity,
@@ -244,14 +309,8 @@ extern "C" foeResultSet foePhysicsInitializeSystem(foePhysicsSystem physicsSyste
     // Setup internal data
     foeResultSet result = to_foeResult(FOE_PHYSICS_SUCCESS);
 
-    // Entity List
-    result = foeEcsCreateEntityList(&pPhysicsSystem->positionModifiedEntityList);
-    if (result.value != FOE_SUCCESS)
-        goto INITIALIZATION_FAILED;
-    result =
-        foeEcsComponentPoolAddEntityList(positionPool, pPhysicsSystem->positionModifiedEntityList);
-    if (result.value != FOE_SUCCESS)
-        goto INITIALIZATION_FAILED;
+    // Any positions already changed are picked up by initialization below
+    pPhysicsSystem->positionChangeVersion = foeEcsComponentPoolAdvanceChangeVersion(positionPool);
 
     // Physics World
     pPhysicsSystem->pBroadphase = new (std::nothrow) btDbvtBroadphase;
@@ -295,16 +354,39 @@ extern "C" foeResultSet foePhysicsInitializeSystem(foePhysicsSystem physicsSyste
     // As we're initializing, we need to go through and process any already
     // available data, so that per-tick processing can be streamlined to operate
     // more quickly using deltas
-    { // Iterate through active rigid bodies, the primary for this system
-        foeEntityID const *pID = foeEcsComponentPoolIdPtr(rigidBodyPool);
-        foeEntityID const *const pEndID = pID + foeEcsComponentPoolSize(rigidBodyPool);
-        foeRigidBody *pData = (foeRigidBody *)foeEcsComponentPoolDataPtr(rigidBodyPool);
+    { // Iterate through entities with both a rigid body and a position
+        foeEcsComponentPool const joinPools[2] = {rigidBodyPool, positionPool};
+        uint32_t const joinDriver = foeEcsJoinDriver(2, joinPools);
+        size_t joinOffset = 0;
+        foeResultSet joinResult;
+        std::vector<WorldObjectRequest> requests;
+
+        foeRigidBody *const pStartRigidBodyData =
+            (foeRigidBody *)foeEcsComponentPoolDataPtr(rigidBodyPool);
+        foePosition3d *const pStartPositionData =
+            (foePosition3d *)foeEcsComponentPoolDataPtr(positionPool);
+
+        do {
+            foeEntityID joinedEntities[256];
+            size_t joinedOffsets[256 * 2];
+            uint32_t joinedCount = 256;
+
+            joinResult = foeEcsJoin(2, joinPools, joinDriver, &joinOffset, SIZE_MAX, &joinedCount,
+                                    joinedEntities, joinedOffsets);
+
+            requests.clear();
+            for (uint32_t i = 0; i < joinedCount; ++i) {
+                requests.emplace_back(WorldObjectRequest{
+                    .entity = joinedEntities[i],
+                    .pRigidBody = pStartRigidBodyData + joinedOffsets[i * 2],
+                    .pPosition = pStartPositionData + joinedOffsets[i * 2 + 1],
+                });
+            }
 
-        for (; pID != pEndID; ++pID, ++pData) {
-            result = addWorldObject(pPhysicsSystem, *pID, pData, nullptr, nullptr);
+            result = addWorldObjects(pPhysicsSystem, requests);
             if (result.value != FOE_SUCCESS)
                 goto INITIALIZATION_FAILED;
-        }
+        } while (joinResult.value == FOE_ECS_INCOMPLETE);
     }
 
 INITIALIZATION_FAILED:
@@ -368,14 +450,6 @@ extern "C" void foePhysicsDeinitializeSystem(foePhysicsSystem physicsSystem) {
         delete pPhysicsSystem->pBroadphase;
     pPhysicsSystem->pBroadphase = nullptr;
 
-    // Entity List
-    if (pPhysicsSystem->positionModifiedEntityList != FOE_NULL_HANDLE) {
-        foeEcsComponentPoolRemoveEntityList(pPhysicsSystem->positionPool,
-                                            pPhysicsSystem->positionModifiedEntityList);
-        foeEcsDestroyEntityList(pPhysicsSystem->positionModifiedEntityList);
-        pPhysicsSystem->positionModifiedEntityList = FOE_NULL_HANDLE;
-    }
-
     // Clear external data
     pPhysicsSystem->positionPool = FOE_NULL_HANDLE;
     pPhysicsSystem->rigidBodyPool = FOE_NULL_HANDLE;
@@ -385,12 +459,14 @@ extern "C" void foePhysicsDeinitializeSystem(foePhysicsSystem physicsSystem) {
 extern "C" foeResultSet foePhysicsProcessSystem(foePhysicsSystem physicsSystem, float timeElapsed) {
     PhysicsSystem *pPhysicsSystem = physics_system_from_handle(physicsSystem);
     foeResultSet result = to_foeResult(FOE_PHYSICS_SUCCESS);
+    std::vector<WorldObjectRequest> requests;
+
+    { // Any previously attempted items that were waiting for external resources to be loaded
+        auto awaitingResources = std::move(pPhysicsSystem->awaitingLoadingResources);
+        for (auto const &it : awaitingResources)
+            requests.emplace_back(WorldObjectRequest{.entity = it});
 
-    // Any previously attempted items that were waiting for external resources to be
-    // loaded
-    auto awaitingResources = std::move(pPhysicsSystem->awaitingLoadingResources);
-    for (auto const &it : awaitingResources) {
-        result = addWorldObject(pPhysicsSystem, it, nullptr, nullptr, nullptr);
+        result = addWorldObjects(pPhysicsSystem, requests);
         if (result.value != FOE_SUCCESS)
             return result;
     }
@@ -428,41 +504,43 @@ extern "C" foeResultSet foePhysicsProcessSystem(foePhysicsSystem physicsSystem,
             foeEntityID const *const pEndModifiedID =
                 pModifiedID + foeEcsEntityListSize(entityList);
 
+            requests.clear();
             for (; pModifiedID != pEndModifiedID; ++pModifiedID) {
                 removeWorldObject(pPhysicsSystem, *pModifiedID);
-                result =
-                    addWorldObject(pPhysicsSystem, *pModifiedID, nullptr, nullptr, FOE_NULL_HANDLE);
-                if (result.value != FOE_SUCCESS)
-                    return result;
+                requests.emplace_back(WorldObjectRequest{.entity = *pModifiedID});
             }
+
+            result = addWorldObjects(pPhysicsSystem, requests);
+            if (result.value != FOE_SUCCESS)
+                return result;
         }
     }
 
     { // Modified Position
-        size_t const entityListCount =
-            foeEcsComponentPoolEntityListSize(pPhysicsSystem->rigidBodyPool);
-        foeEcsEntityList const *pLists =
-            foeEcsComponentPoolEntityLists(pPhysicsSystem->rigidBodyPool);
-
-        for (size_t i = 0; i < entityListCount; ++i) {
-            foeEcsEntityList entityList = pLists[i];
-
-            // Make sure not to process items modified by this same system
-            if (entityList == pPhysicsSystem->positionModifiedEntityList)
-                continue;
-
-            foeEntityID const *pModifiedID = foeEcsEntityListPtr(entityList);
-            foeEntityID const *const pEndModifiedID =
-                pModifiedID + foeEcsEntityListSize(entityList);
-
-            for (; pModifiedID != pEndModifiedID; ++pModifiedID) {
-                removeWorldObject(pPhysicsSystem, *pModifiedID);
-                result =
-                    addWorldObject(pPhysicsSystem, *pModifiedID, nullptr, nullptr, FOE_NULL_HANDLE);
-                if (result.value != FOE_SUCCESS)
-                    return result;
-            }
+        foeEntityID const *const pStartID = foeEcsComponentPoolIdPtr(pPhysicsSystem->positionPool);
+        foePosition3d *const pStartData =
+            (foePosition3d *)foeEcsComponentPoolDataPtr(pPhysicsSystem->positionPool);
+        size_t const count = foeEcsComponentPoolSize(pPhysicsSystem->positionPool);
+
+        // Not advanced until after positions are written back below, so that those writes aren't
+        // picked up here as changes next time
+        uint32_t const changeVersion = pPhysicsSystem->positionChangeVersion;
+
+        requests.clear();
+        for (size_t offset =
+                 foeEcsComponentPoolNextChanged(pPhysicsSystem->positionPool, changeVersion, 0);
+             offset < count; offset = foeEcsComponentPoolNextChanged(
+                                 pPhysicsSystem->positionPool, changeVersion, offset + 1)) {
+            removeWorldObject(pPhysicsSystem, pStartID[offset]);
+            requests.emplace_back(WorldObjectRequest{
+                .entity = pStartID[offset],
+                .pPosition = pStartData + offset,
+            });
         }
+
+        result = addWorldObjects(pPhysicsSystem, requests);
+        if (result.value != FOE_SUCCESS)
+            return result;
     }
 
     { // Inserted RigidBody
@@ -474,45 +552,52 @@ extern "C" foeResultSet foePhysicsProcessSystem(foePhysicsSystem physicsSystem,
         size_t const *const pEndOffset =
             pOffset + foeEcsComponentPoolInserted(pPhysicsSystem->rigidBodyPool);
 
+        requests.clear();
         for (; pOffset != pEndOffset; ++pOffset) {
-            result = addWorldObject(pPhysicsSystem, pStartID[*pOffset], pStartData + *pOffset,
-                                    nullptr, nullptr);
-            if (result.value != FOE_SUCCESS)
-                return result;
+            requests.emplace_back(WorldObjectRequest{
+                .entity = pStartID[*pOffset],
+                .pRigidBody = pStartData + *pOffset,
+            });
         }
+
+        result = addWorldObjects(pPhysicsSystem, requests);
+        if (result.value != FOE_SUCCESS)
+            return result;
     }
 
     { // Inserted Position
         foeEntityID const *const pStartID = foeEcsComponentPoolIdPtr(pPhysicsSystem->positionPool);
-        foePosition3d **const pStartData =
-            (foePosition3d **)foeEcsComponentPoolDataPtr(pPhysicsSystem->positionPool);
+        foePosition3d *const pStartData =
+            (foePosition3d *)foeEcsComponentPoolDataPtr(pPhysicsSystem->positionPool);
 
         size_t const *pOffset = foeEcsComponentPoolInsertedOffsetPtr(pPhysicsSystem->positionPool);
         size_t const *const pEndOffset =
             pOffset + foeEcsComponentPoolInserted(pPhysicsSystem->positionPool);
 
+        requests.clear();
         for (; pOffset != pEndOffset; ++pOffset) {
-            result = addWorldObject(pPhysicsSystem, pStartID[*pOffset], nullptr,
-                                    pStartData[*pOffset], nullptr);
-            if (result.value != FOE_SUCCESS)
-                return result;
+            requests.emplace_back(WorldObjectRequest{
+                .entity = pStartID[*pOffset],
+                .pPosition = pStartData + *pOffset,
+            });
         }
+
+        result = addWorldObjects(pPhysicsSystem, requests);
+        if (result.value != FOE_SUCCESS)
+            return result;
     }
 
     // Actual step the world forward by the amount of elapsed time
     pPhysicsSystem->pWorld->stepSimulation(timeElapsed);
 
     { // Copy position data to foePosition3d objects
-        std::vector<foeEntityID> modifiedIDs;
-        modifiedIDs.reserve(pPhysicsSystem->activeWorldObjects.size());
-
         foeEntityID const *pPositionID = foeEcsComponentPoolIdPtr(pPhysicsSystem->positionPool);
 
         foeEntityID const *const pStartPositionID = pPositionID;
         foeEntityID const *const pEndPositionID =
             pStartPositionID + foeEcsComponentPoolSize(pPhysicsSystem->positionPool);
-        foePosition3d **const pStartPositionData =
-            (foePosition3d **)foeEcsComponentPoolDataPtr(pPhysicsSystem->positionPool);
+        foePosition3d *const pStartPositionData =
+            (foePosition3d *)foeEcsComponentPoolDataPtr(pPhysicsSystem->positionPool);
 
         for (auto const &activeWorldObject : pPhysicsSystem->activeWorldObjects) {
             pPositionID = std::lower_bound(pPositionID, pEndPositionID, activeWorldObject.entity);
@@ -521,26 +606,22 @@ extern "C" foeResultSet foePhysicsProcessSystem(foePhysicsSystem physicsSystem,
             if (*pPositionID != activeWorldObject.entity)
                 continue;
 
-            foePosition3d *pPosition = pStartPositionData[pPositionID - pStartPositionID];
+            size_t const positionOffset = pPositionID - pStartPositionID;
+            foePosition3d *pPosition = pStartPositionData + positionOffset;
 
-            glm::mat4 transform = btToGlmMat4(activeWorldObject.pRigidBody->getWorldTransform());
-            glm::vec3 scale;
-            glm::quat rotation;
-            glm::vec3 translation;
-            glm::vec3 skew;
-            glm::vec4 perspective;
-            glm::decompose(transform, scale, rotation, translation, skew, perspective);
-            pPosition->position = translation;
-            pPosition->orientation = rotation;
+            // Rigid body transforms have no scale or skew, so can be read directly rather than
+            // decomposing a matrix
+            btTransform const &transform = activeWorldObject.pRigidBody->getWorldTransform();
+            pPosition->position = btToGlmVec3(transform.getOrigin());
+            pPosition->orientation = btToGlmQuat(transform.getRotation());
 
-            modifiedIDs.emplace_back(*pPositionID);
+            // Tell other systems about what positions were modified here
+            foeEcsComponentPoolMarkChanged(pPhysicsSystem->positionPool, positionOffset);
         }
 
-        // Tell other systems about what positions were modified here
-        uint32_t listCount = modifiedIDs.size();
-        foeEntityID *pEntityList = modifiedIDs.data();
-        foeEcsResetEntityList(pPhysicsSystem->positionModifiedEntityList, 1, &listCount,
-                              &pEntityList);
+        // Advancing past the positions just written means they aren't processed here next time
+        pPhysicsSystem->positionChangeVersion =
+            foeEcsComponentPoolAdvanceChangeVersion(pPhysicsSystem->positionPool);
     }
 
     return to_foeResult(FOE_PHYSICS_SUCCESS);
@@ -12,7 +12,7 @@
 
 #include "result.h"
 
-#include <memory>
+#include <algorithm>
 
 extern "C" foeResultSet export_foePosition3D(foeEntityID entity,
                                              foeSimulation simulation,
@@ -31,10 +31,10 @@ extern "C" foeResultSet export_foePosition3D(foeEntityID entity,
         if (pID != pEndID && *pID == entity) {
             size_t offset = pID - pStartID;
 
-            foePosition3d **ppPositionData =
-                (foePosition3d **)foeEcsComponentPoolDataPtr(componentPool) + offset;
+            foePosition3d const *pPositionData =
+                (foePosition3d const *)foeEcsComponentPoolDataPtr(componentPool) + offset;
 
-            result = binary_write_foePosition3d(*ppPositionData, &set.dataSize, nullptr);
+            result = binary_write_foePosition3d(pPositionData, &set.dataSize, nullptr);
             if (result.value != FOE_SUCCESS)
                 goto EXPORT_FAILED;
 
@@ -44,7 +44,7 @@ extern "C" foeResultSet export_foePosition3D(foeEntityID entity,
                 goto EXPORT_FAILED;
             }
 
-            result = binary_write_foePosition3d(*ppPositionData, &set.dataSize, set.pData);
+            result = binary_write_foePosition3d(pPositionData, &set.dataSize, set.pData);
             set.pKey = binary_key_foePosition3d();
         }
     }
@@ -68,14 +68,10 @@ extern "C" foeResultSet import_foePosition3D(void const *pReadBuffer,
     if (componentPool == FOE_NULL_HANDLE)
         return to_foeResult(FOE_POSITION_BINARY_ERROR_POSITION_3D_POOL_NOT_FOUND);
 
-    std::unique_ptr<foePosition3d> pComponentData(new foePosition3d);
-    foePosition3d *pData = pComponentData.get();
-    foeResultSet result = binary_read_foePosition3d(pReadBuffer, pReadSize, pComponentData.get());
+    foePosition3d componentData;
+    foeResultSet result = binary_read_foePosition3d(pReadBuffer, pReadSize, &componentData);
     if (result.value == FOE_SUCCESS)
-        result = foeEcsComponentPoolInsert(componentPool, entity, &pData);
-
-    if (result.value == FOE_SUCCESS)
-        pComponentData.release();
+        result = foeEcsComponentPoolInsert(componentPool, entity, &componentData);
 
     return result;
 }
\ No newline at end of file
@@ -26,10 +26,10 @@ void imgui_foePositionComponents(foeEntityID entity, foeSimulation simulation) {
     foeEntityID const *pID = std::lower_bound(pStartID, pEndID, entity);
 
     if (pID != pEndID && *pID == entity) {
-        foePosition3d **pComponentData =
-            (foePosition3d **)foeEcsComponentPoolDataPtr(componentPool) + (pID - pStartID);
+        foePosition3d *pComponentData =
+            (foePosition3d *)foeEcsComponentPoolDataPtr(componentPool) + (pID - pStartID);
 
-        imgui_foePosition3d(*pComponentData);
+        imgui_foePosition3d(pComponentData);
     }
 }
 
@@ -29,12 +29,12 @@ std::vector<foeKeyYamlPair> exportComponents(foeEntityID entity, foeSimulation s
         if (pID != pEndID && *pID == entity) {
             size_t offset = pID - pStartID;
 
-            foePosition3d **ppPositionData =
-                (foePosition3d **)foeEcsComponentPoolDataPtr(componentPool) + offset;
+            foePosition3d const *pPositionData =
+                (foePosition3d const *)foeEcsComponentPoolDataPtr(componentPool) + offset;
 
             keyDataPairs.emplace_back(foeKeyYamlPair{
                 .key = yaml_position3d_key(),
-                .data = yaml_write_position3d(**ppPositionData),
+                .data = yaml_write_position3d(*pPositionData),
             });
         }
     }
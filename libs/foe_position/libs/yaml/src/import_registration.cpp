@@ -27,18 +27,10 @@ bool importPosition3D(YAML::Node const &node,
             return false;
 
         try {
-            std::unique_ptr<foePosition3d> pData(new foePosition3d);
-            *pData = yaml_read_position3d(dataNode);
+            foePosition3d data = yaml_read_position3d(dataNode);
 
-            foePosition3d *ppData = pData.get();
-
-            foeResultSet result = foeEcsComponentPoolInsert(componentPool, entity, &ppData);
-            if (result.value == FOE_SUCCESS) {
-                pData.release();
-                return true;
-            } else {
-                return false;
-            }
+            foeResultSet result = foeEcsComponentPoolInsert(componentPool, entity, &data);
+            return result.value == FOE_SUCCESS;
         } catch (foeYamlException const &e) {
             throw foeYamlException{std::string{yaml_position3d_key()} + "::" + e.whatStr()};
         }
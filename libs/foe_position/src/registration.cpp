@@ -29,18 +29,25 @@ foeResultSet create(foeSimulation simulation) {
             },
         };
 
-        result = foeEcsCreateComponentPool(
-            0, 16, sizeof(foePosition3d *),
-            [](void *pData) {
-                foePosition3d **ppPosition = (foePosition3d **)pData;
-                delete *ppPosition;
-            },
-            (foeEcsComponentPool *)&createInfo.pComponentPool);
+        // Stored inline, so systems iterating positions walk contiguous memory
+        result = foeEcsCreateComponentPool(0, 16, sizeof(foePosition3d), nullptr,
+                                           (foeEcsComponentPool *)&createInfo.pComponentPool);
         if (result.value != FOE_SUCCESS) {
             result = to_foeResult(FOE_POSITION_ERROR_OUT_OF_MEMORY);
             goto CREATE_FAILED;
         }
 
+        // Physics and rendering look up positions by entity
+        result =
+            foeEcsComponentPoolEnableOffsetIndex((foeEcsComponentPool)createInfo.pComponentPool);
+        if (result.value != FOE_SUCCESS) {
+            foeEcsDestroyComponentPool((foeEcsComponentPool)createInfo.pComponentPool);
+            result = to_foeResult(FOE_POSITION_ERROR_OUT_OF_MEMORY);
+            goto CREATE_FAILED;
+        }
+        // They also pick up on the positions that were modified by others
+        foeEcsComponentPoolEnableChangeTracking((foeEcsComponentPool)createInfo.pComponentPool);
+
         result = foeSimulationInsertComponentPool(simulation, &createInfo);
         if (result.value != FOE_SUCCESS) {
             foeEcsDestroyComponentPool((foeEcsComponentPool)createInfo.pComponentPool);
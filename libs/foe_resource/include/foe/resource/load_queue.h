@@ -0,0 +1,112 @@
+// Copyright (C) 2026 George Cave.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef FOE_RESOURCE_LOAD_QUEUE_H
+#define FOE_RESOURCE_LOAD_QUEUE_H
+
+#include <foe/handle.h>
+#include <foe/resource/export.h>
+#include <foe/resource/resource.h>
+#include <foe/result.h>
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Holds requests to load resources until they are dispatched in order of priority
+ *
+ * Rather than each resource being scheduled to load as soon as it is wanted, requests are held
+ * until dispatched, where those with the lowest priority value are started first. This allows
+ * priorities such as the distance to the viewer to be used directly, and to be updated while the
+ * requests wait.
+ *
+ * A request made for a resource with a non-zero use count is cancelled instead of dispatched if
+ * its use count has dropped to zero by then, as nothing is waiting on it anymore.
+ *
+ * @note Thread-safe
+ */
+FOE_DEFINE_HANDLE(foeResourceLoadQueue)
+
+typedef struct foeResourceLoadQueueStatistics {
+    /// Number of requests waiting to be dispatched
+    uint32_t pendingCount;
+    /// Largest number of requests that have been waiting at once
+    uint32_t maxPendingCount;
+    /// Number of dispatched requests that haven't finished loading
+    uint32_t inFlightCount;
+    /// Number of new requests, not including those updating an already pending request
+    uint64_t requestCount;
+    /// Number of requests dispatched to be loaded
+    uint64_t dispatchCount;
+    /// Number of requests cancelled before being dispatched, explicitly or by use count
+    uint64_t cancelCount;
+    /// Number of dispatched requests that finished loaded
+    uint64_t loadedCount;
+    /// Number of dispatched requests that finished having failed to load
+    uint64_t failedCount;
+    /// Total time from the request to being seen as loaded, for all loaded requests
+    uint64_t totalTimeToLoadedNs;
+    /// Longest time from the request to being seen as loaded
+    uint64_t maxTimeToLoadedNs;
+} foeResourceLoadQueueStatistics;
+
+FOE_RES_EXPORT
+foeResultSet foeCreateResourceLoadQueue(foeResourceLoadQueue *pLoadQueue);
+
+/// Any pending requests are cancelled
+FOE_RES_EXPORT
+void foeDestroyResourceLoadQueue(foeResourceLoadQueue loadQueue);
+
+/** @brief Requests the resource be loaded
+ * @param resource Resource to load, which is referenced by the queue until the request is done.
+ * @param priority Requests with lower values are dispatched first, with ties dispatched in the
+ * order they were requested or last had their priority changed.
+ * @return FOE_RESOURCE_SUCCESS if the request is pending, FOE_RESOURCE_ALREADY_LOADING if the
+ * resource is already being loaded, or FOE_RESOURCE_ERROR_REPLACED_CANNOT_BE_LOADED if the
+ * resource has been replaced.
+ *
+ * If the resource already has a pending request, its priority is updated instead.
+ */
+FOE_RES_EXPORT
+foeResultSet foeResourceLoadQueueRequest(foeResourceLoadQueue loadQueue,
+                                         foeResource resource,
+                                         float priority);
+
+/** @brief Changes the priority of a pending request
+ * @return FOE_RESOURCE_SUCCESS on success, FOE_RESOURCE_ERROR_NOT_FOUND if the resource doesn't
+ * have a pending request.
+ */
+FOE_RES_EXPORT
+foeResultSet foeResourceLoadQueueSetPriority(foeResourceLoadQueue loadQueue,
+                                             foeResource resource,
+                                             float priority);
+
+/** @brief Cancels a pending request
+ * @return FOE_RESOURCE_SUCCESS on success, FOE_RESOURCE_ERROR_NOT_FOUND if the resource doesn't
+ * have a pending request.
+ */
+FOE_RES_EXPORT
+foeResultSet foeResourceLoadQueueCancel(foeResourceLoadQueue loadQueue, foeResource resource);
+
+/** @brief Starts loading the highest priority pending requests
+ * @param maxCount Most requests to start loading, where cancelled requests don't count.
+ * @return Number of requests dispatched.
+ *
+ * Dispatched requests are started together with foeResourceLoadDataMany. The state of previously
+ * dispatched requests is also checked, with those that have finished added to the statistics.
+ */
+FOE_RES_EXPORT
+uint32_t foeResourceLoadQueueDispatch(foeResourceLoadQueue loadQueue, uint32_t maxCount);
+
+FOE_RES_EXPORT
+void foeResourceLoadQueueGetStatistics(foeResourceLoadQueue loadQueue,
+                                       foeResourceLoadQueueStatistics *pStatistics);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FOE_RESOURCE_LOAD_QUEUE_H
@@ -1,4 +1,4 @@
-// Copyright (C) 2022-2023 George Cave.
+// Copyright (C) 2022-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
@@ -12,6 +12,8 @@
 #include <foe/result.h>
 #include <foe/split_thread_pool.h>
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -20,8 +22,30 @@ struct foeResourceFns;
 
 typedef int foeResourcePoolType;
 
+/** @brief Holds a set of resources, each with a unique ID
+ *
+ * Resources are split across shards by the low bits of their index, each with its own lock and
+ * hash table, so that threads working with different resources rarely contend with each other.
+ *
+ * @note Thread-safe
+ */
 FOE_DEFINE_HANDLE(foeResourcePool)
 
+typedef struct foeResourcePoolMemoryStatistics {
+    /// Host memory used by loaded resources, as of the last budget check
+    uint64_t residentCpuBytes;
+    /// Device memory used by loaded resources, as of the last budget check
+    uint64_t residentGpuBytes;
+    /// Number of resources unloaded to stay within the budget
+    uint64_t evictionCount;
+    /// Host memory freed by evictions
+    uint64_t evictedCpuBytes;
+    /// Device memory freed by evictions
+    uint64_t evictedGpuBytes;
+    /// Number of evicted resources that were later loaded again
+    uint64_t reloadMissCount;
+} foeResourcePoolMemoryStatistics;
+
 FOE_RES_EXPORT
 foeResultSet foeCreateResourcePool(foeResourceFns const *pResourceFns,
                                    foeResourcePool *pResourcePool);
@@ -33,6 +57,36 @@ void foeDestroyResourcePool(foeResourcePool resourcePool);
 FOE_RES_EXPORT
 foeResource foeResourcePoolAdd(foeResourcePool resourcePool, foeResourceID resourceID);
 
+/** @brief Finds the resource with the ID, adding a new undefined resource if it isn't in the pool
+ * @return The found or added resource, or FOE_NULL_HANDLE if a new resource couldn't be created.
+ *
+ * Unlike separate calls to find then add, this can't fail due to another thread adding the same
+ * resource in between.
+ *
+ * Returned resources have reference count pre-incremented.
+ */
+FOE_RES_EXPORT
+foeResource foeResourcePoolFindOrAdd(foeResourcePool resourcePool, foeResourceID resourceID);
+
+/** @brief Finds or adds the resources for a set of IDs at once
+ * @param count Number of IDs in pResourceIDs, and handles to be written to pResources.
+ * @param pResourceIDs IDs of the resources to acquire, which may contain duplicates.
+ * @param pResources Written with the resource for each ID in the same order, or FOE_NULL_HANDLE
+ * if a new resource couldn't be created for it.
+ * @return FOE_RESOURCE_SUCCESS if all resources were acquired, otherwise
+ * FOE_RESOURCE_ERROR_OUT_OF_MEMORY.
+ *
+ * Acts the same as calling foeResourcePoolFindOrAdd for each ID, except the IDs are grouped so that
+ * each shard of the pool is only locked once for the whole set.
+ *
+ * Returned resources have reference count pre-incremented, once for every time they are returned.
+ */
+FOE_RES_EXPORT
+foeResultSet foeResourcePoolAcquireMany(foeResourcePool resourcePool,
+                                        uint32_t count,
+                                        foeResourceID const *pResourceIDs,
+                                        foeResource *pResources);
+
 // Returned resources have reference count pre-incremented.
 FOE_RES_EXPORT
 foeResource foeResourcePoolLoadedReplace(
@@ -57,6 +111,35 @@ void foeResourcePoolSetAsyncTaskCallback(foeResourcePool resourcePool,
                                          void *pScheduleAsyncTaskContext,
                                          PFN_foeScheduleTask scheduleAsyncTask);
 
+/** @brief Sets the most memory loaded resources of the pool should take up
+ * @param cpuBytes Budget for host memory, UINT64_MAX for no limit.
+ * @param gpuBytes Budget for device memory, UINT64_MAX for no limit.
+ *
+ * The budget is only checked by foeResourcePoolEnforceMemoryBudget. There is no limit by default.
+ */
+FOE_RES_EXPORT
+void foeResourcePoolSetMemoryBudget(foeResourcePool resourcePool,
+                                    uint64_t cpuBytes,
+                                    uint64_t gpuBytes);
+
+/** @brief Unloads the least recently used resources while the pool is over its memory budget
+ * @return Number of resources evicted.
+ *
+ * Memory usage is as set by foeResourceSetMemoryUsage for each loaded resource. Only resources
+ * with a use count of zero that aren't already loading are evicted, in order of their last use
+ * time. They are unloaded with foeResourceUnloadDataIfUnused, so any that start being used during
+ * the call are left loaded.
+ *
+ * This goes through every resource in the pool, so is intended to be called periodically, such as
+ * once a frame, rather than after every load.
+ */
+FOE_RES_EXPORT
+uint32_t foeResourcePoolEnforceMemoryBudget(foeResourcePool resourcePool);
+
+FOE_RES_EXPORT
+void foeResourcePoolGetMemoryStatistics(foeResourcePool resourcePool,
+                                        foeResourcePoolMemoryStatistics *pStatistics);
+
 // Unloads called 'immediately'
 FOE_RES_EXPORT
 void foeResourcePoolUnloadAll(foeResourcePool resourcePool);
@@ -1,4 +1,4 @@
-// Copyright (C) 2022-2023 George Cave.
+// Copyright (C) 2022-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
@@ -87,6 +87,19 @@ foeResultSet foeResourceReplace(foeResource oldResource, foeResource newResource
 FOE_RES_EXPORT
 foeResource foeResourceGetReplacement(foeResource resource);
 
+/** @brief Returns the resource that has taken the place of the given one
+ * @return The final replacement after following any replacements, or the resource itself if it
+ * hasn't been replaced.
+ *
+ * Replacements are published atomically and never change once set, so this doesn't lock and
+ * consumers can move straight to the current resource rather than stepping through each
+ * replacement.
+ *
+ * Returned resource has it's reference already incremented.
+ */
+FOE_RES_EXPORT
+foeResource foeResourceGetCurrent(foeResource resource);
+
 FOE_RES_EXPORT
 foeResourceID foeResourceGetID(foeResource resource);
 
@@ -109,6 +122,27 @@ int foeResourceIncrementUseCount(foeResource resource);
 FOE_RES_EXPORT
 int foeResourceDecrementUseCount(foeResource resource);
 
+/** @brief Returns when the resource was last used
+ * @return Time in nanoseconds of a monotonic clock, from when the use count last dropped to zero or
+ * the resource last finished loading, whichever is later.
+ *
+ * Used to find the least recently used resources when evicting them to stay within a budget.
+ */
+FOE_RES_EXPORT
+uint64_t foeResourceGetLastUseTime(foeResource resource);
+
+/** @brief Sets the number of bytes the loaded data of the resource takes up
+ * @param cpuBytes Bytes of host memory used by the data, including any it points to.
+ * @param gpuBytes Bytes of device memory used by the data, such as for images or buffers.
+ *
+ * Loaders should set this before calling the post-load function, as it describes the data being
+ * loaded rather than any currently loaded data. It is only counted while the resource is loaded.
+ */
+FOE_RES_EXPORT
+void foeResourceSetMemoryUsage(foeResource resource, uint64_t cpuBytes, uint64_t gpuBytes);
+FOE_RES_EXPORT
+void foeResourceGetMemoryUsage(foeResource resource, uint64_t *pCpuBytes, uint64_t *pGpuBytes);
+
 FOE_RES_EXPORT
 foeResourceStateFlags foeResourceGetState(foeResource resource);
 
@@ -119,9 +153,32 @@ void const *foeResourceGetTypeData(foeResource resource, foeResourceType type);
 
 FOE_RES_EXPORT
 foeResultSet foeResourceLoadData(foeResource resource);
+
+/** @brief Starts loading a set of resources together
+ * @param count Number of resource handles in pResources.
+ * @param pResources Resources to load, which may contain duplicates or FOE_NULL_HANDLE entries.
+ * @return The number of resources that started loading.
+ *
+ * Duplicates, replaced resources and those already being loaded are skipped. Resources sharing
+ * the same asynchronous task scheduler are loaded in batches, with each batch scheduled as a single
+ * task, rather than scheduling a separate task for every resource. Resources from the same pool
+ * are started in the order given.
+ */
+FOE_RES_EXPORT
+uint32_t foeResourceLoadDataMany(uint32_t count, foeResource const *pResources);
 FOE_RES_EXPORT
 void foeResourceUnloadData(foeResource resource, bool immediate);
 
+/** @brief Unloads the resource only if it isn't in use or loading
+ * @return True if the resource was unloaded, false if it is in use, loading, or can't be unloaded.
+ *
+ * Unlike checking foeResourceGetUseCount before calling foeResourceUnloadData, the resource can't
+ * start being used in between. Once this returns it is no longer flagged as loaded, so anything
+ * that starts using it after won't use the data being unloaded, even when the unload is deferred.
+ */
+FOE_RES_EXPORT
+bool foeResourceUnloadDataIfUnused(foeResource resource, bool immediate);
+
 #ifdef __cplusplus
 }
 #endif
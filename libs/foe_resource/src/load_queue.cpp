@@ -0,0 +1,318 @@
+// Copyright (C) 2026 George Cave.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <foe/resource/load_queue.h>
+
+#include <foe/ecs/id_to_string.hpp>
+
+#include "log.hpp"
+#include "result.h"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct PendingRequest {
+    float priority;
+    /// Order of the latest request or priority change, to find the current entry in the heap
+    uint64_t sequence;
+    Clock::time_point requestTime;
+    /// Whether the resource was in use when requested, so should be cancelled if it no longer is
+    bool wasUsed;
+};
+
+/// Entry in the heap, which is stale if the sequence no longer matches the pending request
+struct HeapEntry {
+    float priority;
+    uint64_t sequence;
+    foeResource resource;
+};
+
+struct InFlightRequest {
+    foeResource resource;
+    Clock::time_point requestTime;
+};
+
+/// Orders the heap so that the front is the lowest priority value, then the earliest sequence
+bool heapCompare(HeapEntry const &lhs, HeapEntry const &rhs) {
+    if (lhs.priority != rhs.priority)
+        return lhs.priority > rhs.priority;
+    return lhs.sequence > rhs.sequence;
+}
+
+struct LoadQueue {
+    std::mutex sync;
+
+    uint64_t nextSequence{0};
+    std::unordered_map<foeResource, PendingRequest> pending;
+    std::vector<HeapEntry> heap;
+    std::vector<InFlightRequest> inFlight;
+
+    foeResourceLoadQueueStatistics statistics{};
+};
+
+FOE_DEFINE_HANDLE_CASTS(load_queue, LoadQueue, foeResourceLoadQueue)
+
+void pushHeapEntry(LoadQueue *pLoadQueue, foeResource resource, PendingRequest const &request) {
+    pLoadQueue->heap.emplace_back(HeapEntry{
+        .priority = request.priority,
+        .sequence = request.sequence,
+        .resource = resource,
+    });
+    std::push_heap(pLoadQueue->heap.begin(), pLoadQueue->heap.end(), heapCompare);
+
+    // Stale entries are only removed when reaching the front, so if they come to outnumber the
+    // current ones, rebuild the heap from the pending requests
+    if (pLoadQueue->heap.size() > 2 * pLoadQueue->pending.size() + 64) {
+        pLoadQueue->heap.clear();
+        for (auto const &it : pLoadQueue->pending) {
+            pLoadQueue->heap.emplace_back(HeapEntry{
+                .priority = it.second.priority,
+                .sequence = it.second.sequence,
+                .resource = it.first,
+            });
+        }
+        std::make_heap(pLoadQueue->heap.begin(), pLoadQueue->heap.end(), heapCompare);
+    }
+}
+
+/** @brief Checks on dispatched requests, recording and removing those that are no longer loading
+ * @param finished Appended with the resources of removed requests, which still hold the queue's
+ * reference, to be released by the caller once the queue is unlocked.
+ */
+void updateInFlight(LoadQueue *pLoadQueue,
+                    Clock::time_point now,
+                    std::vector<foeResource> &finished) {
+    auto &statistics = pLoadQueue->statistics;
+
+    auto newEnd = std::remove_if(
+        pLoadQueue->inFlight.begin(), pLoadQueue->inFlight.end(),
+        [&](InFlightRequest const &request) {
+            foeResourceStateFlags state = foeResourceGetState(request.resource);
+            if ((state & FOE_RESOURCE_STATE_LOADING_BIT) != 0)
+                return false;
+
+            if ((state & FOE_RESOURCE_STATE_LOADED_BIT) != 0) {
+                uint64_t timeToLoaded = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                            now - request.requestTime)
+                                            .count();
+
+                ++statistics.loadedCount;
+                statistics.totalTimeToLoadedNs += timeToLoaded;
+                statistics.maxTimeToLoadedNs = std::max(statistics.maxTimeToLoadedNs, timeToLoaded);
+            } else {
+                ++statistics.failedCount;
+            }
+
+            finished.emplace_back(request.resource);
+            return true;
+        });
+    pLoadQueue->inFlight.erase(newEnd, pLoadQueue->inFlight.end());
+}
+
+} // namespace
+
+extern "C" foeResultSet foeCreateResourceLoadQueue(foeResourceLoadQueue *pLoadQueue) {
+    LoadQueue *pNewLoadQueue = new (std::nothrow) LoadQueue;
+    if (pNewLoadQueue == nullptr)
+        return to_foeResult(FOE_RESOURCE_ERROR_OUT_OF_MEMORY);
+
+    *pLoadQueue = load_queue_to_handle(pNewLoadQueue);
+
+    return to_foeResult(FOE_RESOURCE_SUCCESS);
+}
+
+extern "C" void foeDestroyResourceLoadQueue(foeResourceLoadQueue loadQueue) {
+    LoadQueue *pLoadQueue = load_queue_from_handle(loadQueue);
+
+    for (auto const &it : pLoadQueue->pending)
+        foeResourceDecrementRefCount(it.first);
+    for (auto const &request : pLoadQueue->inFlight)
+        foeResourceDecrementRefCount(request.resource);
+
+    delete pLoadQueue;
+}
+
+extern "C" foeResultSet foeResourceLoadQueueRequest(foeResourceLoadQueue loadQueue,
+                                                    foeResource resource,
+                                                    float priority) {
+    LoadQueue *pLoadQueue = load_queue_from_handle(loadQueue);
+
+    if (foeResourceGetType(resource) == FOE_RESOURCE_RESOURCE_TYPE_REPLACED)
+        return to_foeResult(FOE_RESOURCE_ERROR_REPLACED_CANNOT_BE_LOADED);
+
+    std::scoped_lock lock{pLoadQueue->sync};
+
+    auto [it, added] = pLoadQueue->pending.try_emplace(resource);
+    PendingRequest &request = it->second;
+
+    if (added) {
+        if ((foeResourceGetState(resource) & FOE_RESOURCE_STATE_LOADING_BIT) != 0) {
+            pLoadQueue->pending.erase(it);
+            return to_foeResult(FOE_RESOURCE_ALREADY_LOADING);
+        }
+
+        foeResourceIncrementRefCount(resource);
+
+        request.requestTime = Clock::now();
+        request.wasUsed = foeResourceGetUseCount(resource) > 0;
+
+        auto &statistics = pLoadQueue->statistics;
+        ++statistics.requestCount;
+        statistics.pendingCount = (uint32_t)pLoadQueue->pending.size();
+        statistics.maxPendingCount = std::max(statistics.maxPendingCount, statistics.pendingCount);
+    } else {
+        request.wasUsed = request.wasUsed || foeResourceGetUseCount(resource) > 0;
+
+        if (request.priority == priority)
+            return to_foeResult(FOE_RESOURCE_SUCCESS);
+    }
+
+    request.priority = priority;
+    request.sequence = pLoadQueue->nextSequence++;
+    pushHeapEntry(pLoadQueue, resource, request);
+
+    return to_foeResult(FOE_RESOURCE_SUCCESS);
+}
+
+extern "C" foeResultSet foeResourceLoadQueueSetPriority(foeResourceLoadQueue loadQueue,
+                                                        foeResource resource,
+                                                        float priority) {
+    LoadQueue *pLoadQueue = load_queue_from_handle(loadQueue);
+
+    std::scoped_lock lock{pLoadQueue->sync};
+
+    auto it = pLoadQueue->pending.find(resource);
+    if (it == pLoadQueue->pending.end())
+        return to_foeResult(FOE_RESOURCE_ERROR_NOT_FOUND);
+
+    if (it->second.priority != priority) {
+        it->second.priority = priority;
+        it->second.sequence = pLoadQueue->nextSequence++;
+        pushHeapEntry(pLoadQueue, resource, it->second);
+    }
+
+    return to_foeResult(FOE_RESOURCE_SUCCESS);
+}
+
+extern "C" foeResultSet foeResourceLoadQueueCancel(foeResourceLoadQueue loadQueue,
+                                                   foeResource resource) {
+    LoadQueue *pLoadQueue = load_queue_from_handle(loadQueue);
+
+    std::unique_lock lock{pLoadQueue->sync};
+
+    auto it = pLoadQueue->pending.find(resource);
+    if (it == pLoadQueue->pending.end())
+        return to_foeResult(FOE_RESOURCE_ERROR_NOT_FOUND);
+
+    // The entry left in the heap is now stale, and skipped when it reaches the front
+    pLoadQueue->pending.erase(it);
+
+    ++pLoadQueue->statistics.cancelCount;
+    pLoadQueue->statistics.pendingCount = (uint32_t)pLoadQueue->pending.size();
+
+    lock.unlock();
+
+    foeResourceDecrementRefCount(resource);
+
+    return to_foeResult(FOE_RESOURCE_SUCCESS);
+}
+
+extern "C" uint32_t foeResourceLoadQueueDispatch(foeResourceLoadQueue loadQueue,
+                                                 uint32_t maxCount) {
+    LoadQueue *pLoadQueue = load_queue_from_handle(loadQueue);
+    std::vector<foeResource> dispatched;
+    std::vector<InFlightRequest> dispatchedRequests;
+    std::vector<foeResource> cancelled;
+    std::vector<foeResource> finished;
+
+    std::unique_lock lock{pLoadQueue->sync};
+
+    Clock::time_point const now = Clock::now();
+    updateInFlight(pLoadQueue, now, finished);
+
+    auto &heap = pLoadQueue->heap;
+    while (!heap.empty() && dispatched.size() < maxCount) {
+        std::pop_heap(heap.begin(), heap.end(), heapCompare);
+        HeapEntry entry = heap.back();
+        heap.pop_back();
+
+        auto it = pLoadQueue->pending.find(entry.resource);
+        if (it == pLoadQueue->pending.end() || it->second.sequence != entry.sequence)
+            // Stale entry, from a cancelled request or one with a changed priority
+            continue;
+
+        if (it->second.wasUsed && foeResourceGetUseCount(entry.resource) == 0) {
+            FOE_LOG(foeResource, FOE_LOG_LEVEL_VERBOSE,
+                    "[{}] foeResourceLoadQueue - Cancelling load of [{},{}], no longer in use",
+                    (void *)pLoadQueue, foeIdToString(foeResourceGetID(entry.resource)),
+                    foeResourceGetType(entry.resource))
+
+            cancelled.emplace_back(entry.resource);
+        } else {
+            dispatched.emplace_back(entry.resource);
+
+            // The queue's reference is carried over until the load is seen to have finished
+            dispatchedRequests.emplace_back(InFlightRequest{
+                .resource = entry.resource,
+                .requestTime = it->second.requestTime,
+            });
+        }
+
+        pLoadQueue->pending.erase(it);
+    }
+
+    auto &statistics = pLoadQueue->statistics;
+    statistics.pendingCount = (uint32_t)pLoadQueue->pending.size();
+    statistics.dispatchCount += dispatched.size();
+    statistics.cancelCount += cancelled.size();
+
+    lock.unlock();
+
+    // Loads can run synchronously, so start them outside of the lock
+    foeResourceLoadDataMany((uint32_t)dispatched.size(), dispatched.data());
+
+    // Only tracked once the loads have started, otherwise in the meantime they would be seen as not
+    // loading and released as finished
+    lock.lock();
+
+    pLoadQueue->inFlight.insert(pLoadQueue->inFlight.end(), dispatchedRequests.begin(),
+                                dispatchedRequests.end());
+    statistics.inFlightCount = (uint32_t)pLoadQueue->inFlight.size();
+
+    lock.unlock();
+
+    // Releasing the last reference destroys the resource, which must not be done under the lock
+    for (foeResource resource : cancelled)
+        foeResourceDecrementRefCount(resource);
+    for (foeResource resource : finished)
+        foeResourceDecrementRefCount(resource);
+
+    return (uint32_t)dispatched.size();
+}
+
+extern "C" void foeResourceLoadQueueGetStatistics(foeResourceLoadQueue loadQueue,
+                                                  foeResourceLoadQueueStatistics *pStatistics) {
+    LoadQueue *pLoadQueue = load_queue_from_handle(loadQueue);
+    std::vector<foeResource> finished;
+
+    std::unique_lock lock{pLoadQueue->sync};
+
+    updateInFlight(pLoadQueue, Clock::now(), finished);
+    pLoadQueue->statistics.inFlightCount = (uint32_t)pLoadQueue->inFlight.size();
+
+    *pStatistics = pLoadQueue->statistics;
+
+    lock.unlock();
+
+    for (foeResource resource : finished)
+        foeResourceDecrementRefCount(resource);
+}
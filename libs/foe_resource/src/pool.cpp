@@ -1,9 +1,10 @@
-// Copyright (C) 2022-2023 George Cave.
+// Copyright (C) 2022-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
 #include <foe/resource/pool.h>
 
+#include <foe/ecs/id_shards.hpp>
 #include <foe/ecs/id_to_string.hpp>
 #include <foe/resource/resource_fns.h>
 
@@ -11,30 +12,199 @@
 #include "result.h"
 
 #include <algorithm>
+#include <atomic>
 #include <mutex>
+#include <new>
 #include <shared_mutex>
 #include <vector>
 
 namespace {
 
-struct ResourcePool {
+constexpr uint32_t cShardBits = 6;
+constexpr uint32_t cShardCount = 1U << cShardBits;
+
+/// Open-addressed slot, empty if the resource is FOE_NULL_HANDLE
+struct Slot {
+    foeResourceID id;
+    foeResource resource;
+    /// Whether the resource was unloaded for the memory budget and hasn't been loaded since
+    bool evicted;
+};
+
+/// A subset of the pool's resources, by the low bits of their index, with a separate lock
+struct alignas(64) Shard {
     std::shared_mutex sync;
+    /// Linear-probed table of the resources, capacity is zero or a power of two
+    std::vector<Slot> slots;
+    uint32_t count = 0;
+};
+
+struct ResourcePool {
+    /// Given to the pool's resources, with loads going through the pool to track reloads
     foeResourceFns callbacks;
-    std::vector<foeResource> resources;
+    /// The originally provided load function, that loads are passed on to
+    void *pLoadContext;
+    PFN_foeLoadResourceData pLoadFn;
+
+    Shard shards[cShardCount];
+
+    std::mutex memorySync;
+    uint64_t cpuMemoryBudget{UINT64_MAX};
+    uint64_t gpuMemoryBudget{UINT64_MAX};
+    foeResourcePoolMemoryStatistics memoryStatistics{};
+    std::atomic_uint64_t reloadMissCount{0};
 };
 
 FOE_DEFINE_HANDLE_CASTS(resource_pool, ResourcePool, foeResourcePool)
 
+uint32_t getShardIndex(foeResourceID resourceID) {
+    return foeIdGetShardIndex<cShardCount>(resourceID);
+}
+
+Shard &getShard(ResourcePool *pResourcePool, foeResourceID resourceID) {
+    return pResourcePool->shards[getShardIndex(resourceID)];
+}
+
+/// Returns the home position of the ID, the shard bits having already been used to pick the shard
+size_t getHome(Shard const &shard, foeResourceID resourceID) {
+    uint32_t hash = (resourceID >> cShardBits) * 0x9E3779B1U;
+    return (hash ^ (hash >> 16)) & (shard.slots.size() - 1);
+}
+
+/// Returns the slot holding the ID, or nullptr if the shard doesn't have it
+Slot *findSlot(Shard &shard, foeResourceID resourceID) {
+    if (shard.count == 0)
+        return nullptr;
+
+    size_t const mask = shard.slots.size() - 1;
+    for (size_t i = getHome(shard, resourceID);; i = (i + 1) & mask) {
+        Slot &slot = shard.slots[i];
+
+        if (slot.resource == FOE_NULL_HANDLE)
+            return nullptr;
+        if (slot.id == resourceID)
+            return &slot;
+    }
+}
+
+/// Inserts into the shard, growing it if needed, where the ID must not already be in it
+void insertSlot(Shard &shard, Slot const &newSlot) {
+    if ((shard.count + 1) * 4 > shard.slots.size() * 3) {
+        std::vector<Slot> oldSlots(std::max<size_t>(shard.slots.size() * 2, 16));
+        oldSlots.swap(shard.slots);
+
+        shard.count = 0;
+        for (auto const &slot : oldSlots) {
+            if (slot.resource != FOE_NULL_HANDLE)
+                insertSlot(shard, slot);
+        }
+    }
+
+    size_t const mask = shard.slots.size() - 1;
+    size_t i = getHome(shard, newSlot.id);
+    while (shard.slots[i].resource != FOE_NULL_HANDLE)
+        i = (i + 1) & mask;
+
+    shard.slots[i] = newSlot;
+    ++shard.count;
+}
+
+/// Removes the slot, shifting back any following slots so no tombstones are needed
+void eraseSlot(Shard &shard, Slot *pSlot) {
+    size_t const mask = shard.slots.size() - 1;
+    size_t hole = pSlot - shard.slots.data();
+
+    for (size_t i = (hole + 1) & mask;; i = (i + 1) & mask) {
+        Slot &slot = shard.slots[i];
+        if (slot.resource == FOE_NULL_HANDLE)
+            break;
+
+        // Only move slots whose home position isn't between the hole and themselves
+        size_t const home = getHome(shard, slot.id);
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            shard.slots[hole] = slot;
+            hole = i;
+        }
+    }
+
+    shard.slots[hole].resource = FOE_NULL_HANDLE;
+    --shard.count;
+}
+
+/** @brief Creates a new undefined resource and adds it to the shard
+ * @return The new resource with an extra reference for the caller, or FOE_NULL_HANDLE on failure.
+ * @note The shard's lock must be held exclusively, and the ID must not already be in it.
+ */
+foeResource addUndefined(ResourcePool *pResourcePool, Shard &shard, foeResourceID resourceID) {
+    foeResource newResource;
+    foeResultSet result =
+        foeCreateUndefinedResource(resourceID, &pResourcePool->callbacks, &newResource);
+    if (result.value != FOE_RESOURCE_SUCCESS) {
+        char buffer[FOE_MAX_RESULT_STRING_SIZE];
+        result.toString(result.value, buffer);
+        FOE_LOG(foeResource, FOE_LOG_LEVEL_ERROR,
+                "[{}] foeResourcePool - Error while creating a new resource [{}]: {}",
+                (void *)pResourcePool, foeIdToString(resourceID), buffer)
+
+        return FOE_NULL_HANDLE;
+    }
+
+    // Since we're returning the resource, increment the count to account for that
+    foeResourceIncrementRefCount(newResource);
+
+    insertSlot(shard, Slot{.id = resourceID, .resource = newResource});
+    return newResource;
+}
+
+/// Load function given to the pool's resources, counting reloads of evicted ones
+void loadResource(void *pContext, foeResource resource, PFN_foeResourcePostLoad postLoadFn) {
+    ResourcePool *pResourcePool = (ResourcePool *)pContext;
+    foeResourceID resourceID = foeResourceGetID(resource);
+    Shard &shard = getShard(pResourcePool, resourceID);
+
+    bool evicted = false;
+    { // Most loads aren't of evicted resources, only needing the shared lock to check
+        std::shared_lock lock{shard.sync};
+
+        Slot *pSlot = findSlot(shard, resourceID);
+        evicted = pSlot != nullptr && pSlot->resource == resource && pSlot->evicted;
+    }
+
+    if (evicted) {
+        std::unique_lock lock{shard.sync};
+
+        Slot *pSlot = findSlot(shard, resourceID);
+        if (pSlot != nullptr && pSlot->resource == resource && pSlot->evicted) {
+            pSlot->evicted = false;
+            ++pResourcePool->reloadMissCount;
+        }
+    }
+
+    pResourcePool->pLoadFn(pResourcePool->pLoadContext, resource, postLoadFn);
+}
+
+struct EvictionCandidate {
+    foeResource resource;
+    uint64_t lastUseTime;
+    uint64_t cpuBytes;
+    uint64_t gpuBytes;
+};
+
 } // namespace
 
 extern "C" foeResultSet foeCreateResourcePool(foeResourceFns const *pResourceFns,
                                               foeResourcePool *pResourcePool) {
     ResourcePool *pNewResourcePool = new (std::nothrow) ResourcePool{
         .callbacks = *pResourceFns,
+        .pLoadContext = pResourceFns->pLoadContext,
+        .pLoadFn = pResourceFns->pLoadFn,
     };
     if (pNewResourcePool == NULL)
         return to_foeResult(FOE_RESOURCE_ERROR_OUT_OF_MEMORY);
 
+    pNewResourcePool->callbacks.pLoadContext = pNewResourcePool;
+    pNewResourcePool->callbacks.pLoadFn = loadResource;
+
     *pResourcePool = resource_pool_to_handle(pNewResourcePool);
 
     return to_foeResult(FOE_RESOURCE_SUCCESS);
@@ -43,15 +213,20 @@ extern "C" foeResultSet foeCreateResourcePool(foeResourceFns const *pResourceFns
 extern "C" void foeDestroyResourcePool(foeResourcePool resourcePool) {
     ResourcePool *pResourcePool = resource_pool_from_handle(resourcePool);
 
-    for (auto const resource : pResourcePool->resources) {
-        int refCount = foeResourceDecrementRefCount(resource);
+    for (auto &shard : pResourcePool->shards) {
+        for (auto const &slot : shard.slots) {
+            if (slot.resource == FOE_NULL_HANDLE)
+                continue;
+
+            int refCount = foeResourceDecrementRefCount(slot.resource);
 
-        if (refCount != 0) {
-            FOE_LOG(foeResource, FOE_LOG_LEVEL_WARNING,
-                    "[{}] foeResourcePool - While destroying, found foeResource [{},{}] that "
-                    "still has external references and thus skipped immediate destruction",
-                    (void *)pResourcePool, foeIdToString(foeResourceGetID(resource)),
-                    foeResourceGetType(resource));
+            if (refCount != 0) {
+                FOE_LOG(foeResource, FOE_LOG_LEVEL_WARNING,
+                        "[{}] foeResourcePool - While destroying, found foeResource [{},{}] that "
+                        "still has external references and thus skipped immediate destruction",
+                        (void *)pResourcePool, foeIdToString(slot.id),
+                        foeResourceGetType(slot.resource));
+            }
         }
     }
 
@@ -60,38 +235,104 @@ extern "C" void foeDestroyResourcePool(foeResourcePool resourcePool) {
 
 extern "C" foeResource foeResourcePoolAdd(foeResourcePool resourcePool, foeResourceID resourceID) {
     ResourcePool *pResourcePool = resource_pool_from_handle(resourcePool);
+    Shard &shard = getShard(pResourcePool, resourceID);
 
-    std::unique_lock lock{pResourcePool->sync};
+    std::unique_lock lock{shard.sync};
 
-    auto searchIt =
-        std::lower_bound(pResourcePool->resources.begin(), pResourcePool->resources.end(),
-                         resourceID, [](foeResource resource, foeResourceID id) {
-                             return foeResourceGetID(resource) < id;
-                         });
-
-    if (searchIt != pResourcePool->resources.end() && foeResourceGetID(*searchIt) == resourceID)
-        // Didn't find the resource we're supposed to be replacing
+    if (findSlot(shard, resourceID) != nullptr)
+        // Already have a resource with the ID
         return FOE_NULL_HANDLE;
 
     // Not found, add it
-    foeResource newResource;
-    foeResultSet result =
-        foeCreateUndefinedResource(resourceID, &pResourcePool->callbacks, &newResource);
-    if (result.value != FOE_RESOURCE_SUCCESS) {
-        char buffer[FOE_MAX_RESULT_STRING_SIZE];
-        result.toString(result.value, buffer);
-        FOE_LOG(foeResource, FOE_LOG_LEVEL_ERROR,
-                "[{}] foeResourcePool - Error while creating a new resource [{}]: {}",
-                (void *)pResourcePool, foeIdToString(resourceID), buffer)
+    return addUndefined(pResourcePool, shard, resourceID);
+}
 
-        return FOE_NULL_HANDLE;
+extern "C" foeResource foeResourcePoolFindOrAdd(foeResourcePool resourcePool,
+                                                foeResourceID resourceID) {
+    ResourcePool *pResourcePool = resource_pool_from_handle(resourcePool);
+    Shard &shard = getShard(pResourcePool, resourceID);
+
+    { // Most of the time the resource already exists, only needing the shared lock
+        std::shared_lock lock{shard.sync};
+
+        if (Slot *pSlot = findSlot(shard, resourceID); pSlot != nullptr) {
+            foeResourceIncrementRefCount(pSlot->resource);
+            return pSlot->resource;
+        }
     }
 
-    // Since we're returning the resource, increment the count to account for that
-    foeResourceIncrementRefCount(newResource);
+    std::unique_lock lock{shard.sync};
 
-    pResourcePool->resources.insert(searchIt, newResource);
-    return newResource;
+    // May have been added by another thread between the locks
+    if (Slot *pSlot = findSlot(shard, resourceID); pSlot != nullptr) {
+        foeResourceIncrementRefCount(pSlot->resource);
+        return pSlot->resource;
+    }
+
+    return addUndefined(pResourcePool, shard, resourceID);
+}
+
+extern "C" foeResultSet foeResourcePoolAcquireMany(foeResourcePool resourcePool,
+                                                   uint32_t count,
+                                                   foeResourceID const *pResourceIDs,
+                                                   foeResource *pResources) {
+    ResourcePool *pResourcePool = resource_pool_from_handle(resourcePool);
+    foeResultSet result = to_foeResult(FOE_RESOURCE_SUCCESS);
+
+    // Group the requests by shard, so that each shard is only locked once for the whole set
+    uint32_t shardOffsets[cShardCount + 1];
+    std::vector<uint32_t> requests;
+    foeIdGroupByShard<cShardCount>(count, pResourceIDs, shardOffsets, requests);
+
+    for (uint32_t shardIndex = 0; shardIndex < cShardCount; ++shardIndex) {
+        uint32_t const *pBegin = requests.data() + shardOffsets[shardIndex];
+        uint32_t const *const pEnd = requests.data() + shardOffsets[shardIndex + 1];
+        if (pBegin == pEnd)
+            continue;
+
+        Shard &shard = pResourcePool->shards[shardIndex];
+        bool missing = false;
+
+        { // Most of the time the resources already exist, only needing the shared lock
+            std::shared_lock lock{shard.sync};
+
+            for (uint32_t const *pRequest = pBegin; pRequest != pEnd; ++pRequest) {
+                Slot *pSlot = findSlot(shard, pResourceIDs[*pRequest]);
+
+                if (pSlot != nullptr) {
+                    foeResourceIncrementRefCount(pSlot->resource);
+                    pResources[*pRequest] = pSlot->resource;
+                } else {
+                    pResources[*pRequest] = FOE_NULL_HANDLE;
+                    missing = true;
+                }
+            }
+        }
+
+        if (!missing)
+            continue;
+
+        std::unique_lock lock{shard.sync};
+
+        // Duplicate IDs in the set find the resource added for the first of them
+        for (uint32_t const *pRequest = pBegin; pRequest != pEnd; ++pRequest) {
+            if (pResources[*pRequest] != FOE_NULL_HANDLE)
+                continue;
+
+            foeResourceID resourceID = pResourceIDs[*pRequest];
+
+            if (Slot *pSlot = findSlot(shard, resourceID); pSlot != nullptr) {
+                foeResourceIncrementRefCount(pSlot->resource);
+                pResources[*pRequest] = pSlot->resource;
+            } else {
+                pResources[*pRequest] = addUndefined(pResourcePool, shard, resourceID);
+                if (pResources[*pRequest] == FOE_NULL_HANDLE)
+                    result = to_foeResult(FOE_RESOURCE_ERROR_OUT_OF_MEMORY);
+            }
+        }
+    }
+
+    return result;
 }
 
 extern "C" foeResource foeResourcePoolLoadedReplace(
@@ -104,16 +345,12 @@ extern "C" foeResource foeResourcePoolLoadedReplace(
     void *pUnloadDataContext,
     void (*pUnloadDataFn)(void *, foeResource, uint32_t, PFN_foeResourceUnloadCall, bool)) {
     ResourcePool *pResourcePool = resource_pool_from_handle(resourcePool);
+    Shard &shard = getShard(pResourcePool, resourceID);
 
-    std::unique_lock lock{pResourcePool->sync};
-
-    auto searchIt =
-        std::lower_bound(pResourcePool->resources.begin(), pResourcePool->resources.end(),
-                         resourceID, [](foeResource resource, foeResourceID id) {
-                             return foeResourceGetID(resource) < id;
-                         });
+    std::unique_lock lock{shard.sync};
 
-    if (searchIt == pResourcePool->resources.end() || foeResourceGetID(*searchIt) != resourceID)
+    Slot *pSlot = findSlot(shard, resourceID);
+    if (pSlot == nullptr)
         // Didn't find the resource we're supposed to be replacing
         return FOE_NULL_HANDLE;
 
@@ -132,7 +369,7 @@ extern "C" foeResource foeResourcePoolLoadedReplace(
         return FOE_NULL_HANDLE;
     }
 
-    result = foeResourceReplace(*searchIt, newResource);
+    result = foeResourceReplace(pSlot->resource, newResource);
     if (result.value != FOE_RESOURCE_SUCCESS) {
         foeResourceDecrementRefCount(newResource);
         char buffer[FOE_MAX_RESULT_STRING_SIZE];
@@ -145,8 +382,9 @@ extern "C" foeResource foeResourcePoolLoadedReplace(
     }
 
     // Swap the resources
-    foeResource oldResource = *searchIt;
-    *searchIt = newResource;
+    foeResource oldResource = pSlot->resource;
+    pSlot->resource = newResource;
+    pSlot->evicted = false;
 
     lock.unlock();
 
@@ -164,18 +402,13 @@ extern "C" foeResource foeResourcePoolLoadedReplace(
 
 extern "C" foeResource foeResourcePoolFind(foeResourcePool resourcePool, foeResourceID resourceID) {
     ResourcePool *pResourcePool = resource_pool_from_handle(resourcePool);
+    Shard &shard = getShard(pResourcePool, resourceID);
 
-    std::shared_lock lock{pResourcePool->sync};
+    std::shared_lock lock{shard.sync};
 
-    auto searchIt =
-        std::lower_bound(pResourcePool->resources.begin(), pResourcePool->resources.end(),
-                         resourceID, [](foeResource resource, foeResourceID id) {
-                             return foeResourceGetID(resource) < id;
-                         });
-
-    if (searchIt != pResourcePool->resources.end() && foeResourceGetID(*searchIt) == resourceID) {
-        foeResourceIncrementRefCount(*searchIt);
-        return *searchIt;
+    if (Slot *pSlot = findSlot(shard, resourceID); pSlot != nullptr) {
+        foeResourceIncrementRefCount(pSlot->resource);
+        return pSlot->resource;
     }
 
     return FOE_NULL_HANDLE;
@@ -184,19 +417,14 @@ extern "C" foeResource foeResourcePoolFind(foeResourcePool resourcePool, foeReso
 extern "C" foeResultSet foeResourcePoolRemove(foeResourcePool resourcePool,
                                               foeResourceID resourceID) {
     ResourcePool *pResourcePool = resource_pool_from_handle(resourcePool);
+    Shard &shard = getShard(pResourcePool, resourceID);
     foeResource resource{FOE_NULL_HANDLE};
 
-    std::unique_lock lock{pResourcePool->sync};
-
-    auto searchIt =
-        std::lower_bound(pResourcePool->resources.begin(), pResourcePool->resources.end(),
-                         resourceID, [](foeResource resource, foeResourceID id) {
-                             return foeResourceGetID(resource) < id;
-                         });
+    std::unique_lock lock{shard.sync};
 
-    if (searchIt != pResourcePool->resources.end() && foeResourceGetID(*searchIt) == resourceID) {
-        resource = *searchIt;
-        pResourcePool->resources.erase(searchIt);
+    if (Slot *pSlot = findSlot(shard, resourceID); pSlot != nullptr) {
+        resource = pSlot->resource;
+        eraseSlot(shard, pSlot);
     }
     lock.unlock();
 
@@ -224,13 +452,166 @@ extern "C" void foeResourcePoolSetAsyncTaskCallback(foeResourcePool resourcePool
     pResourcePool->callbacks.pScheduleAsyncTaskContext = pScheduleAsyncTaskContext;
 }
 
+extern "C" void foeResourcePoolSetMemoryBudget(foeResourcePool resourcePool,
+                                               uint64_t cpuBytes,
+                                               uint64_t gpuBytes) {
+    ResourcePool *pResourcePool = resource_pool_from_handle(resourcePool);
+
+    std::scoped_lock lock{pResourcePool->memorySync};
+
+    pResourcePool->cpuMemoryBudget = cpuBytes;
+    pResourcePool->gpuMemoryBudget = gpuBytes;
+}
+
+extern "C" uint32_t foeResourcePoolEnforceMemoryBudget(foeResourcePool resourcePool) {
+    ResourcePool *pResourcePool = resource_pool_from_handle(resourcePool);
+    uint64_t residentCpuBytes = 0;
+    uint64_t residentGpuBytes = 0;
+
+    std::scoped_lock memoryLock{pResourcePool->memorySync};
+
+    // Usually within budget, so only total the resident memory first, and leave gathering and
+    // referencing eviction candidates to when something does need to be evicted
+    for (auto &shard : pResourcePool->shards) {
+        std::shared_lock lock{shard.sync};
+
+        for (auto const &slot : shard.slots) {
+            if (slot.resource == FOE_NULL_HANDLE ||
+                (foeResourceGetState(slot.resource) & FOE_RESOURCE_STATE_LOADED_BIT) == 0)
+                continue;
+
+            uint64_t cpuBytes;
+            uint64_t gpuBytes;
+            foeResourceGetMemoryUsage(slot.resource, &cpuBytes, &gpuBytes);
+
+            residentCpuBytes += cpuBytes;
+            residentGpuBytes += gpuBytes;
+        }
+    }
+
+    auto &statistics = pResourcePool->memoryStatistics;
+    uint64_t const cpuBudget = pResourcePool->cpuMemoryBudget;
+    uint64_t const gpuBudget = pResourcePool->gpuMemoryBudget;
+    uint32_t count = 0;
+
+    if (residentCpuBytes > cpuBudget || residentGpuBytes > gpuBudget) {
+        std::vector<EvictionCandidate> candidates;
+
+        // Totalled again alongside the candidates, so that evicting them can't take more off than
+        // was counted if anything has loaded or unloaded since
+        residentCpuBytes = 0;
+        residentGpuBytes = 0;
+
+        for (auto &shard : pResourcePool->shards) {
+            std::shared_lock lock{shard.sync};
+
+            for (auto const &slot : shard.slots) {
+                if (slot.resource == FOE_NULL_HANDLE)
+                    continue;
+
+                foeResourceStateFlags state = foeResourceGetState(slot.resource);
+                if ((state & FOE_RESOURCE_STATE_LOADED_BIT) == 0)
+                    continue;
+
+                EvictionCandidate candidate{
+                    .resource = slot.resource,
+                    .lastUseTime = foeResourceGetLastUseTime(slot.resource),
+                };
+                foeResourceGetMemoryUsage(slot.resource, &candidate.cpuBytes,
+                                          &candidate.gpuBytes);
+
+                residentCpuBytes += candidate.cpuBytes;
+                residentGpuBytes += candidate.gpuBytes;
+
+                if ((state & FOE_RESOURCE_STATE_LOADING_BIT) == 0 &&
+                    foeResourceGetUseCount(slot.resource) == 0) {
+                    foeResourceIncrementRefCount(slot.resource);
+                    candidates.emplace_back(candidate);
+                }
+            }
+        }
+
+        std::sort(candidates.begin(), candidates.end(),
+                  [](EvictionCandidate const &lhs, EvictionCandidate const &rhs) {
+                      return lhs.lastUseTime < rhs.lastUseTime;
+                  });
+
+        for (auto const &candidate : candidates) {
+            bool const overCpu = residentCpuBytes > cpuBudget;
+            bool const overGpu = residentGpuBytes > gpuBudget;
+            if (!overCpu && !overGpu)
+                break;
+
+            // Only evict resources that free up memory that is over budget
+            if (!(overCpu && candidate.cpuBytes != 0) && !(overGpu && candidate.gpuBytes != 0))
+                continue;
+
+            foeResourceID resourceID = foeResourceGetID(candidate.resource);
+            Shard &shard = getShard(pResourcePool, resourceID);
+            {
+                std::unique_lock lock{shard.sync};
+
+                // Could have been removed or replaced since being checked
+                Slot *pSlot = findSlot(shard, resourceID);
+                if (pSlot == nullptr || pSlot->resource != candidate.resource)
+                    continue;
+
+                pSlot->evicted = true;
+            }
+
+            // Could have started being used since being checked, which is only known for certain
+            // as part of unloading
+            if (!foeResourceUnloadDataIfUnused(candidate.resource, false)) {
+                std::unique_lock lock{shard.sync};
+
+                Slot *pSlot = findSlot(shard, resourceID);
+                if (pSlot != nullptr && pSlot->resource == candidate.resource)
+                    pSlot->evicted = false;
+                continue;
+            }
+
+            residentCpuBytes -= candidate.cpuBytes;
+            residentGpuBytes -= candidate.gpuBytes;
+            statistics.evictedCpuBytes += candidate.cpuBytes;
+            statistics.evictedGpuBytes += candidate.gpuBytes;
+            ++count;
+        }
+
+        FOE_LOG(foeResource, FOE_LOG_LEVEL_VERBOSE,
+                "[{}] foeResourcePool - Evicted {} resources to be within the memory budget",
+                (void *)pResourcePool, count)
+
+        for (auto const &candidate : candidates)
+            foeResourceDecrementRefCount(candidate.resource);
+    }
+
+    statistics.residentCpuBytes = residentCpuBytes;
+    statistics.residentGpuBytes = residentGpuBytes;
+    statistics.evictionCount += count;
+
+    return count;
+}
+
+extern "C" void foeResourcePoolGetMemoryStatistics(foeResourcePool resourcePool,
+                                                   foeResourcePoolMemoryStatistics *pStatistics) {
+    ResourcePool *pResourcePool = resource_pool_from_handle(resourcePool);
+
+    std::scoped_lock lock{pResourcePool->memorySync};
+
+    *pStatistics = pResourcePool->memoryStatistics;
+    pStatistics->reloadMissCount = pResourcePool->reloadMissCount;
+}
+
 extern "C" void foeResourcePoolUnloadAll(foeResourcePool resourcePool) {
     ResourcePool *pResourcePool = resource_pool_from_handle(resourcePool);
 
-    std::shared_lock lock{pResourcePool->sync};
+    for (auto &shard : pResourcePool->shards) {
+        std::shared_lock lock{shard.sync};
 
-    for (foeResource it : pResourcePool->resources) {
-        foeResourceUnloadData(it, false);
+        for (auto const &slot : shard.slots) {
+            if (slot.resource != FOE_NULL_HANDLE)
+                foeResourceUnloadData(slot.resource, false);
+        }
     }
 }
 
@@ -239,14 +620,17 @@ extern "C" uint32_t foeResourcePoolUnloadType(foeResourcePool resourcePool,
     uint32_t count = 0;
     ResourcePool *pResourcePool = resource_pool_from_handle(resourcePool);
 
-    std::shared_lock lock{pResourcePool->sync};
-
-    for (foeResource it : pResourcePool->resources) {
-        if (foeResourceGetType(it) == resourceType &&
-            (foeResourceGetState(it) &
-             (FOE_RESOURCE_STATE_LOADING_BIT | FOE_RESOURCE_STATE_LOADED_BIT)) != 0) {
-            foeResourceUnloadData(it, false);
-            ++count;
+    for (auto &shard : pResourcePool->shards) {
+        std::shared_lock lock{shard.sync};
+
+        for (auto const &slot : shard.slots) {
+            if (slot.resource != FOE_NULL_HANDLE &&
+                foeResourceGetType(slot.resource) == resourceType &&
+                (foeResourceGetState(slot.resource) &
+                 (FOE_RESOURCE_STATE_LOADING_BIT | FOE_RESOURCE_STATE_LOADED_BIT)) != 0) {
+                foeResourceUnloadData(slot.resource, false);
+                ++count;
+            }
         }
     }
 
@@ -7,9 +7,13 @@
 #include <foe/ecs/id_to_string.hpp>
 #include <foe/resource/resource_fns.h>
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <mutex>
+#include <new>
 #include <thread>
+#include <vector>
 
 #include "log.hpp"
 #include "result.h"
@@ -18,22 +22,26 @@ struct foeResourceFns;
 
 namespace {
 
-struct ReplacedResource {
-    foeResourceType rType;
-    void *pNext;
-    foeResource replacementResource;
-    bool incrementedUse;
-};
-
 struct Resource {
     foeResourceID id;
 
     foeResourceFns const *pResourceFns;
 
-    std::recursive_mutex sync;
+    /// Guards modification of the data and the unload context/fn, never held while calling out to
+    /// the unload function, which may call back in through resourceUnloadCall
+    std::mutex sync;
+
+    /// Published once when an undefined resource is replaced, before the type changes to REPLACED
+    std::atomic<Resource *> pReplacement{nullptr};
+    /// Whether the use count of the replacement was incremented on behalf of this resource
+    std::atomic_bool replacementUsed{false};
 
     std::atomic_int refCount{1};
     std::atomic_int useCount{0};
+    std::atomic_uint64_t lastUseTime{0};
+
+    std::atomic_uint64_t cpuMemoryUsage{0};
+    std::atomic_uint64_t gpuMemoryUsage{0};
 
     // Load State
     std::atomic_uint iteration{0};
@@ -52,6 +60,18 @@ struct Resource {
 
 FOE_DEFINE_HANDLE_CASTS(resource, Resource, foeResource)
 
+uint64_t getUseTime() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/// Type is read atomically, as it changes to REPLACED while other threads may be reading it
+std::atomic_ref<foeResourceType> resourceTypeRef(foeResource resource) {
+    foeResourceBase *pBaseData = (foeResourceBase *)foeResourceGetData(resource);
+    return std::atomic_ref<foeResourceType>{pBaseData->rType};
+}
+
 void postLoadFn(
     foeResource resource,
     foeResultSet loadResult,
@@ -78,11 +98,12 @@ void postLoadFn(
             desired &= ~(FOE_RESOURCE_STATE_LOADING_BIT);
         } while (!pResource->state.compare_exchange_weak(expected, desired));
     } else {
-        pResource->sync.lock();
-
-        // Unload any previous data
+        // Unload any previous data, outside of the lock as the unload calls back into the resource.
+        // Nothing else can be loading at the same time, being flagged as LOADING.
         foeResourceUnloadData(resource, true);
 
+        pResource->sync.lock();
+
         // Move the new data in
         loadDataFn(pLoadDataContext, (void *)foeResourceGetData(resource));
 
@@ -98,6 +119,8 @@ void postLoadFn(
             desired &= ~(FOE_RESOURCE_STATE_LOADING_BIT | FOE_RESOURCE_STATE_FAILED_BIT);
         } while (!pResource->state.compare_exchange_weak(expected, desired));
 
+        pResource->lastUseTime = getUseTime();
+
         pResource->sync.unlock();
     }
 
@@ -111,6 +134,44 @@ void loadResourceTask(Resource *pResource) {
                                      resource_to_handle(pResource), postLoadFn);
 }
 
+/// Number of resources loaded by each task scheduled from foeResourceLoadDataMany
+constexpr uint32_t cLoadBatchSize = 16;
+
+struct LoadBatch {
+    uint32_t count;
+    Resource *pResources[cLoadBatchSize];
+};
+
+void loadResourceBatchTask(LoadBatch *pLoadBatch) {
+    for (uint32_t i = 0; i < pLoadBatch->count; ++i)
+        loadResourceTask(pLoadBatch->pResources[i]);
+
+    delete pLoadBatch;
+}
+
+/** @brief Sets the resource as loading, taking a reference for the loading process
+ * @return True if now loading, false if it was already being loaded by something else.
+ */
+bool beginLoading(Resource *pResource) {
+    foeResourceIncrementRefCount(resource_to_handle(pResource));
+
+    // Only want to start loading if the data isn't already slated to be loaded
+    bool setLoadingFlag = false;
+    foeResourceStateFlags expected = pResource->state;
+    do {
+        if ((expected & FOE_RESOURCE_STATE_LOADING_BIT) != 0)
+            break;
+
+        setLoadingFlag = pResource->state.compare_exchange_weak(
+            expected, expected | FOE_RESOURCE_STATE_LOADING_BIT);
+    } while (!setLoadingFlag);
+
+    if (!setLoadingFlag)
+        foeResourceDecrementRefCount(resource_to_handle(pResource));
+
+    return setLoadingFlag;
+}
+
 } // namespace
 
 extern "C" char const *foeResourceStateFlagBitToString(foeResourceStateFlagBits flag) {
@@ -130,7 +191,7 @@ extern "C" foeResultSet foeCreateUndefinedResource(foeResourceID id,
                                                    foeResourceFns const *pResourceFns,
                                                    foeResource *pResource) {
     return foeCreateResource(id, FOE_RESOURCE_RESOURCE_TYPE_UNDEFINED, pResourceFns,
-                             sizeof(ReplacedResource), pResource);
+                             sizeof(foeResourceBase), pResource);
 }
 
 extern "C" foeResultSet foeCreateResource(foeResourceID id,
@@ -192,23 +253,22 @@ extern "C" foeResultSet foeResourceReplace(foeResource oldResource, foeResource
     Resource *pOldResource = resource_from_handle(oldResource);
     foeResultSet result = to_foeResult(FOE_RESOURCE_SUCCESS);
 
-    pOldResource->sync.lock();
+    std::unique_lock lock{pOldResource->sync};
 
     if (foeResourceGetType(oldResource) == FOE_RESOURCE_RESOURCE_TYPE_UNDEFINED) {
-        ReplacedResource *pOldData = (ReplacedResource *)foeResourceGetData(oldResource);
-        pOldData->replacementResource = newResource;
         foeResourceIncrementRefCount(newResource);
 
         if (foeResourceGetUseCount(oldResource) != 0) {
             foeResourceIncrementUseCount(newResource);
-            pOldData->incrementedUse = true;
+            pOldResource->replacementUsed = true;
         }
 
-        // @TODO - Not sure if this is guarantees therType to happen after the newResource is set,
-        // nor that the changes are all made visible to other threads correctly.
-        std::atomic_thread_fence(std::memory_order_relaxed);
-
-        pOldData->rType = FOE_RESOURCE_RESOURCE_TYPE_REPLACED;
+        // Publish the replacement before the type, so that anything seeing the REPLACED type will
+        // also see the replacement
+        pOldResource->pReplacement.store(resource_from_handle(newResource),
+                                         std::memory_order_release);
+        resourceTypeRef(oldResource)
+            .store(FOE_RESOURCE_RESOURCE_TYPE_REPLACED, std::memory_order_release);
 
         foeResourceStateFlags expected = pOldResource->state;
         foeResourceStateFlags desired;
@@ -227,29 +287,39 @@ extern "C" foeResultSet foeResourceReplace(foeResource oldResource, foeResource
         result = to_foeResult(FOE_RESOURCE_ERROR_RESOURCE_NOT_UNDEFINED);
     }
 
-    pOldResource->sync.unlock();
-
     return result;
 }
 
 extern "C" foeResource foeResourceGetReplacement(foeResource resource) {
-    if (foeResourceGetType(resource) == FOE_RESOURCE_RESOURCE_TYPE_REPLACED) {
-        ReplacedResource *pData = (ReplacedResource *)foeResourceGetData(resource);
+    Resource *pReplacement =
+        resource_from_handle(resource)->pReplacement.load(std::memory_order_acquire);
 
-        foeResourceIncrementRefCount(pData->replacementResource);
-        return pData->replacementResource;
+    if (pReplacement != nullptr) {
+        foeResourceIncrementRefCount(resource_to_handle(pReplacement));
+        return resource_to_handle(pReplacement);
     }
 
     return FOE_NULL_HANDLE;
 }
+
+extern "C" foeResource foeResourceGetCurrent(foeResource resource) {
+    Resource *pCurrent = resource_from_handle(resource);
+
+    // Replacements are only ever published once, so can be followed without locking
+    while (Resource *pReplacement = pCurrent->pReplacement.load(std::memory_order_acquire))
+        pCurrent = pReplacement;
+
+    foeResourceIncrementRefCount(resource_to_handle(pCurrent));
+    return resource_to_handle(pCurrent);
+}
+
 extern "C" foeResourceID foeResourceGetID(foeResource resource) {
     auto *pResource = resource_from_handle(resource);
     return pResource->id;
 }
 
 extern "C" foeResourceType foeResourceGetType(foeResource resource) {
-    foeResourceBase const *pBaseData = (foeResourceBase *)foeResourceGetData(resource);
-    return pBaseData->rType;
+    return resourceTypeRef(resource).load(std::memory_order_acquire);
 }
 
 extern "C" bool foeResourceHasType(foeResource resource, foeResourceType type) {
@@ -289,12 +359,10 @@ extern "C" int foeResourceDecrementRefCount(foeResource resource) {
         FOE_LOG(foeResource, FOE_LOG_LEVEL_VERBOSE, "[{},{}] foeResource - Destroyed",
                 foeIdToString(pResource->id), foeResourceGetType(resource))
 
-        if (foeResourceGetType(resource) == FOE_RESOURCE_RESOURCE_TYPE_REPLACED) {
-            ReplacedResource *pData = (ReplacedResource *)foeResourceGetData(resource);
-
-            if (pData->incrementedUse)
-                foeResourceDecrementUseCount(pData->replacementResource);
-            foeResourceDecrementRefCount(pData->replacementResource);
+        if (Resource *pReplacement = pResource->pReplacement; pReplacement != nullptr) {
+            if (pResource->replacementUsed)
+                foeResourceDecrementUseCount(resource_to_handle(pReplacement));
+            foeResourceDecrementRefCount(resource_to_handle(pReplacement));
         }
 
         pResource->~Resource();
@@ -312,6 +380,16 @@ extern "C" int foeResourceGetUseCount(foeResource resource) {
 
 extern "C" int foeResourceIncrementUseCount(foeResource resource) {
     auto *pResource = resource_from_handle(resource);
+
+    int expected = pResource->useCount.load(std::memory_order_relaxed);
+    while (expected > 0) {
+        if (pResource->useCount.compare_exchange_weak(expected, expected + 1))
+            return expected + 1;
+    }
+
+    // Going from unused to used is done under the lock, so that it can't happen while
+    // foeResourceUnloadDataIfUnused has seen the resource as unused and is unloading it
+    std::scoped_lock lock{pResource->sync};
     return ++pResource->useCount;
 }
 
@@ -319,17 +397,41 @@ extern "C" int foeResourceDecrementUseCount(foeResource resource) {
     auto *pResource = resource_from_handle(resource);
     int useCount = --pResource->useCount;
 
-    if (useCount == 0 && foeResourceGetType(resource) == FOE_RESOURCE_RESOURCE_TYPE_REPLACED) {
-        ReplacedResource *pData = (ReplacedResource *)foeResourceGetData(resource);
-        if (pData->incrementedUse) {
-            pData->incrementedUse = false;
-            foeResourceDecrementUseCount(pData->replacementResource);
+    if (useCount == 0) {
+        pResource->lastUseTime.store(getUseTime(), std::memory_order_relaxed);
+
+        if (pResource->replacementUsed.exchange(false)) {
+            foeResourceDecrementUseCount(
+                resource_to_handle(pResource->pReplacement.load(std::memory_order_acquire)));
         }
     }
 
     return useCount;
 }
 
+extern "C" uint64_t foeResourceGetLastUseTime(foeResource resource) {
+    auto *pResource = resource_from_handle(resource);
+    return pResource->lastUseTime.load(std::memory_order_relaxed);
+}
+
+extern "C" void foeResourceSetMemoryUsage(foeResource resource,
+                                          uint64_t cpuBytes,
+                                          uint64_t gpuBytes) {
+    auto *pResource = resource_from_handle(resource);
+
+    pResource->cpuMemoryUsage.store(cpuBytes, std::memory_order_relaxed);
+    pResource->gpuMemoryUsage.store(gpuBytes, std::memory_order_relaxed);
+}
+
+extern "C" void foeResourceGetMemoryUsage(foeResource resource,
+                                          uint64_t *pCpuBytes,
+                                          uint64_t *pGpuBytes) {
+    auto *pResource = resource_from_handle(resource);
+
+    *pCpuBytes = pResource->cpuMemoryUsage.load(std::memory_order_relaxed);
+    *pGpuBytes = pResource->gpuMemoryUsage.load(std::memory_order_relaxed);
+}
+
 extern "C" foeResourceStateFlags foeResourceGetState(foeResource resource) {
     auto *pResource = resource_from_handle(resource);
     return pResource->state;
@@ -360,24 +462,10 @@ extern "C" foeResultSet foeResourceLoadData(foeResource resource) {
     if (type == FOE_RESOURCE_RESOURCE_TYPE_REPLACED)
         return to_foeResult(FOE_RESOURCE_ERROR_REPLACED_CANNOT_BE_LOADED);
 
-    foeResourceIncrementRefCount(resource);
-
-    // Only want to start loading if the data isn't already slated to be loaded
-    bool setLoadingFlag = false;
-    foeResourceStateFlags expected = pResource->state;
-    do {
-        if ((expected & FOE_RESOURCE_STATE_LOADING_BIT) != 0)
-            break;
-
-        setLoadingFlag = pResource->state.compare_exchange_weak(
-            expected, expected | FOE_RESOURCE_STATE_LOADING_BIT);
-    } while (!setLoadingFlag);
-
-    if (!setLoadingFlag) {
+    if (!beginLoading(pResource)) {
         FOE_LOG(foeResource, FOE_LOG_LEVEL_WARNING,
                 "[{},{}] foeResource - Resource already loading", foeIdToString(pResource->id),
                 foeResourceGetType(resource))
-        foeResourceDecrementRefCount(resource);
         return to_foeResult(FOE_RESOURCE_ALREADY_LOADING);
     }
 
@@ -398,6 +486,65 @@ extern "C" foeResultSet foeResourceLoadData(foeResource resource) {
     return to_foeResult(FOE_RESOURCE_SUCCESS);
 }
 
+extern "C" uint32_t foeResourceLoadDataMany(uint32_t count, foeResource const *pResources) {
+    std::vector<Resource *> loading;
+    loading.reserve(count);
+
+    // Loads are started in the given order, with duplicates skipped by beginLoading as they are
+    // already flagged as loading by their first occurrence
+    for (foeResource const *pResource = pResources; pResource != pResources + count; ++pResource) {
+        if (*pResource == FOE_NULL_HANDLE ||
+            foeResourceGetType(*pResource) == FOE_RESOURCE_RESOURCE_TYPE_REPLACED)
+            continue;
+
+        if (beginLoading(resource_from_handle(*pResource)))
+            loading.emplace_back(resource_from_handle(*pResource));
+    }
+
+    // Resources from the same pool share the same functions, so can be batched together
+    std::stable_sort(loading.begin(), loading.end(), [](Resource *pLhs, Resource *pRhs) {
+        return pLhs->pResourceFns < pRhs->pResourceFns;
+    });
+
+    size_t offset = 0;
+    while (offset < loading.size()) {
+        Resource *pResource = loading[offset];
+        foeResourceFns const *pResourceFns = pResource->pResourceFns;
+
+        if (pResourceFns->scheduleAsyncTask == nullptr) {
+            loadResourceTask(pResource);
+            ++offset;
+            continue;
+        }
+
+        // Batch with the following resources from the same pool
+        LoadBatch *pLoadBatch = new (std::nothrow) LoadBatch;
+        if (pLoadBatch == nullptr) {
+            FOE_LOG(foeResource, FOE_LOG_LEVEL_WARNING,
+                    "[{},{}] foeResource - Failed to allocate a batch, loading synchronously",
+                    foeIdToString(pResource->id), foeResourceGetType(resource_to_handle(pResource)))
+
+            loadResourceTask(pResource);
+            ++offset;
+            continue;
+        }
+
+        pLoadBatch->count = 0;
+        while (offset < loading.size() && pLoadBatch->count < cLoadBatchSize &&
+               loading[offset]->pResourceFns == pResourceFns) {
+            pLoadBatch->pResources[pLoadBatch->count++] = loading[offset++];
+        }
+
+        pResourceFns->scheduleAsyncTask(pResourceFns->pScheduleAsyncTaskContext,
+                                        (PFN_foeTask)loadResourceBatchTask, pLoadBatch);
+    }
+
+    FOE_LOG(foeResource, FOE_LOG_LEVEL_VERBOSE,
+            "foeResource - Started loading {} of {} resources in a batch", loading.size(), count)
+
+    return (uint32_t)loading.size();
+}
+
 namespace {
 
 bool resourceUnloadCall(foeResource resource,
@@ -445,6 +592,44 @@ bool resourceUnloadCall(foeResource resource,
 
 } // namespace
 
+namespace {
+
+void callUnloadDataFn(foeResource resource,
+                      bool immediate,
+                      void *pUnloadDataContext,
+                      decltype(Resource::unloadDataFn) unloadDataFn,
+                      uint32_t iteration) {
+    auto *pResource = resource_from_handle(resource);
+
+    foeResourceIncrementRefCount(resource);
+
+    if (int uses = pResource->useCount; uses > 0) {
+        FOE_LOG(foeResource, FOE_LOG_LEVEL_WARNING,
+                "[{},{}] foeResource - Unloading while still actively used {} times",
+                foeIdToString(pResource->id), foeResourceGetType(resource), uses)
+    }
+
+    if (immediate) {
+        FOE_LOG(foeResource, FOE_LOG_LEVEL_VERBOSE, "[{},{}] foeResource - Unloading immediately",
+                foeIdToString(pResource->id), foeResourceGetType(resource))
+    } else {
+        FOE_LOG(foeResource, FOE_LOG_LEVEL_VERBOSE, "[{},{}] foeResource - Unloading normally",
+                foeIdToString(pResource->id), foeResourceGetType(resource))
+    }
+
+    unloadDataFn(pUnloadDataContext, resource, iteration, resourceUnloadCall, immediate);
+}
+
+void clearLoadedFlag(Resource *pResource) {
+    foeResourceStateFlags expected = pResource->state;
+    while ((expected & FOE_RESOURCE_STATE_LOADED_BIT) != 0 &&
+           !pResource->state.compare_exchange_weak(expected,
+                                                   expected & ~FOE_RESOURCE_STATE_LOADED_BIT))
+        ;
+}
+
+} // namespace
+
 extern "C" void foeResourceUnloadData(foeResource resource, bool immediate) {
     auto *pResource = resource_from_handle(resource);
 
@@ -455,35 +640,51 @@ extern "C" void foeResourceUnloadData(foeResource resource, bool immediate) {
 
     pResource->sync.lock();
 
-    if (pResource->unloadDataFn != nullptr) {
-        // If there is a provided unload function, then use it
-        foeResourceIncrementRefCount(resource);
+    // The unload function is called outside of the lock, as it calls back in through
+    // resourceUnloadCall, where the iteration makes sure the data is only unloaded once
+    auto *pUnloadDataContext = pResource->pUnloadDataContext;
+    auto *unloadDataFn = pResource->unloadDataFn;
+    uint32_t iteration = pResource->iteration;
 
-        if (int uses = pResource->useCount; uses > 0) {
-            FOE_LOG(foeResource, FOE_LOG_LEVEL_WARNING,
-                    "[{},{}] foeResource - Unloading while still actively used {} times",
-                    foeIdToString(pResource->id), foeResourceGetType(resource), uses)
-        }
+    if (unloadDataFn == nullptr) {
+        // No provided unload function, thus no heavy work but need to remove the LOADED flag
+        clearLoadedFlag(pResource);
+    }
 
-        if (immediate) {
-            FOE_LOG(foeResource, FOE_LOG_LEVEL_VERBOSE,
-                    "[{},{}] foeResource - Unloading immediately", foeIdToString(pResource->id),
-                    foeResourceGetType(resource))
-        } else {
-            FOE_LOG(foeResource, FOE_LOG_LEVEL_VERBOSE, "[{},{}] foeResource - Unloading normally",
-                    foeIdToString(pResource->id), foeResourceGetType(resource))
-        }
+    pResource->sync.unlock();
 
-        pResource->unloadDataFn(pResource->pUnloadDataContext, resource, pResource->iteration,
-                                resourceUnloadCall, immediate);
-    } else {
-        // No provided unload function, thus no heavy work but need to remove the LOADED flag
-        foeResourceStateFlags expected = pResource->state;
-        while ((expected & FOE_RESOURCE_STATE_LOADED_BIT) != 0 &&
-               !pResource->state.compare_exchange_weak(expected,
-                                                       expected & ~FOE_RESOURCE_STATE_LOADED_BIT))
-            ;
+    // If there is a provided unload function, then use it
+    if (unloadDataFn != nullptr)
+        callUnloadDataFn(resource, immediate, pUnloadDataContext, unloadDataFn, iteration);
+}
+
+extern "C" bool foeResourceUnloadDataIfUnused(foeResource resource, bool immediate) {
+    auto *pResource = resource_from_handle(resource);
+
+    foeResourceType type = foeResourceGetType(resource);
+    if (type == FOE_RESOURCE_RESOURCE_TYPE_UNDEFINED || type == FOE_RESOURCE_RESOURCE_TYPE_REPLACED)
+        return false;
+
+    pResource->sync.lock();
+
+    // With the lock held the use count can't go up from zero, and anything that starts using it
+    // afterwards sees it as no longer loaded, even if the unload itself is deferred
+    if (pResource->useCount != 0 ||
+        (pResource->state & FOE_RESOURCE_STATE_LOADING_BIT) != 0) {
+        pResource->sync.unlock();
+        return false;
     }
 
+    auto *pUnloadDataContext = pResource->pUnloadDataContext;
+    auto *unloadDataFn = pResource->unloadDataFn;
+    uint32_t iteration = pResource->iteration;
+
+    clearLoadedFlag(pResource);
+
     pResource->sync.unlock();
-}
\ No newline at end of file
+
+    if (unloadDataFn != nullptr)
+        callUnloadDataFn(resource, immediate, pUnloadDataContext, unloadDataFn, iteration);
+
+    return true;
+}
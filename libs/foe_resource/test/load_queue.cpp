@@ -0,0 +1,279 @@
+// Copyright (C) 2026 George Cave.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <catch2/catch_test_macros.hpp>
+#include <foe/resource/load_queue.h>
+#include <foe/resource/resource.h>
+#include <foe/resource/resource_fns.h>
+#include <foe/resource/result.h>
+#include <foe/resource/type_defs.h>
+
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr foeResourceType cTestResourceType = 0xf0f0f0;
+
+struct TestResource {
+    foeResourceType rType;
+    void *pNext;
+    int value;
+};
+
+struct LoadRecord {
+    foeResource resource;
+    PFN_foeResourcePostLoad postLoadFn;
+};
+
+void errToString(int value, char buffer[FOE_MAX_RESULT_STRING_SIZE]) {
+    memcpy(buffer, "TestError", sizeof("TestError"));
+}
+
+void recordLoadCall(void *pContext, foeResource resource, PFN_foeResourcePostLoad postLoadFn) {
+    std::vector<LoadRecord> *pLoads = (std::vector<LoadRecord> *)pContext;
+
+    pLoads->emplace_back(LoadRecord{
+        .resource = resource,
+        .postLoadFn = postLoadFn,
+    });
+}
+
+TestResource testData = {
+    .rType = cTestResourceType,
+    .value = 42,
+};
+
+auto loadDataFn = [](void *pSrc, void *pDst) { memcpy(pDst, pSrc, sizeof(TestResource)); };
+
+/// Unloads by calling back into the load queue in the context, as a destroyed resource's owner may
+void queueStatisticsUnloadFn(void *pUnloadContext,
+                             foeResource resource,
+                             uint32_t resourceIteration,
+                             PFN_foeResourceUnloadCall unloadCall,
+                             bool immediate) {
+    foeResourceLoadQueueStatistics statistics;
+    foeResourceLoadQueueGetStatistics((foeResourceLoadQueue)pUnloadContext, &statistics);
+
+    unloadCall(resource, resourceIteration, nullptr, [](void *, void *) {});
+}
+
+} // namespace
+
+TEST_CASE("foeResourceLoadQueue") {
+    std::vector<LoadRecord> loads;
+    foeResourceFns resourceFns{
+        .pLoadContext = &loads,
+        .pLoadFn = recordLoadCall,
+    };
+
+    foeResourceLoadQueue loadQueue{FOE_NULL_HANDLE};
+    REQUIRE(foeCreateResourceLoadQueue(&loadQueue).value == FOE_RESOURCE_SUCCESS);
+
+    constexpr int resourceCount = 4;
+    foeResource resources[resourceCount];
+    for (int i = 0; i < resourceCount; ++i) {
+        REQUIRE(foeCreateResource(i, cTestResourceType, &resourceFns, sizeof(TestResource),
+                                  &resources[i])
+                    .value == FOE_RESOURCE_SUCCESS);
+    }
+
+    foeResourceLoadQueueStatistics statistics;
+
+    SECTION("Requests are dispatched lowest priority value first") {
+        CHECK(foeResourceLoadQueueRequest(loadQueue, resources[0], 3.f).value ==
+              FOE_RESOURCE_SUCCESS);
+        CHECK(foeResourceLoadQueueRequest(loadQueue, resources[1], 1.f).value ==
+              FOE_RESOURCE_SUCCESS);
+        CHECK(foeResourceLoadQueueRequest(loadQueue, resources[2], 2.f).value ==
+              FOE_RESOURCE_SUCCESS);
+        CHECK(foeResourceLoadQueueRequest(loadQueue, resources[3], 1.f).value ==
+              FOE_RESOURCE_SUCCESS);
+
+        // Requesting again doesn't add another
+        CHECK(foeResourceLoadQueueRequest(loadQueue, resources[3], 1.f).value ==
+              FOE_RESOURCE_SUCCESS);
+
+        // Not yet loading while pending
+        CHECK(foeResourceGetState(resources[0]) == (foeResourceStateFlags)0);
+        CHECK(foeResourceGetRefCount(resources[0]) == 2);
+
+        foeResourceLoadQueueGetStatistics(loadQueue, &statistics);
+        CHECK(statistics.pendingCount == 4);
+        CHECK(statistics.maxPendingCount == 4);
+        CHECK(statistics.requestCount == 4);
+
+        CHECK(foeResourceLoadQueueDispatch(loadQueue, 2) == 2);
+        REQUIRE(loads.size() == 2);
+        CHECK(foeResourceGetState(resources[1]) == FOE_RESOURCE_STATE_LOADING_BIT);
+        CHECK(foeResourceGetState(resources[3]) == FOE_RESOURCE_STATE_LOADING_BIT);
+        CHECK(foeResourceGetState(resources[0]) == (foeResourceStateFlags)0);
+
+        CHECK(foeResourceLoadQueueDispatch(loadQueue, 1) == 1);
+        REQUIRE(loads.size() == 3);
+        CHECK(loads[2].resource == resources[2]);
+
+        CHECK(foeResourceLoadQueueDispatch(loadQueue, 10) == 1);
+        REQUIRE(loads.size() == 4);
+        CHECK(loads[3].resource == resources[0]);
+
+        CHECK(foeResourceLoadQueueDispatch(loadQueue, 10) == 0);
+
+        foeResourceLoadQueueGetStatistics(loadQueue, &statistics);
+        CHECK(statistics.pendingCount == 0);
+        CHECK(statistics.inFlightCount == 4);
+        CHECK(statistics.dispatchCount == 4);
+
+        SECTION("Finished loads are tracked") {
+            loads[0].postLoadFn(loads[0].resource, foeResultSet{.value = FOE_SUCCESS}, &testData,
+                                loadDataFn, nullptr, nullptr);
+            loads[1].postLoadFn(loads[1].resource,
+                                foeResultSet{.value = -1, .toString = errToString}, nullptr,
+                                nullptr, nullptr, nullptr);
+
+            foeResourceLoadQueueGetStatistics(loadQueue, &statistics);
+            CHECK(statistics.inFlightCount == 2);
+            CHECK(statistics.loadedCount == 1);
+            CHECK(statistics.failedCount == 1);
+            CHECK(statistics.maxTimeToLoadedNs == statistics.totalTimeToLoadedNs);
+
+            // The queue has released its reference to the finished resources
+            CHECK(foeResourceGetRefCount(loads[0].resource) == 1);
+            CHECK(foeResourceGetRefCount(loads[1].resource) == 1);
+
+            loads.erase(loads.begin(), loads.begin() + 2);
+        }
+
+        for (auto const &load : loads) {
+            load.postLoadFn(load.resource, foeResultSet{.value = -1, .toString = errToString},
+                            nullptr, nullptr, nullptr, nullptr);
+        }
+    }
+
+    SECTION("Finished loads holding the last reference are released outside of the queue lock") {
+        CHECK(foeResourceLoadQueueRequest(loadQueue, resources[0], 1.f).value ==
+              FOE_RESOURCE_SUCCESS);
+        CHECK(foeResourceLoadQueueDispatch(loadQueue, 10) == 1);
+        REQUIRE(loads.size() == 1);
+
+        loads[0].postLoadFn(loads[0].resource, foeResultSet{.value = FOE_SUCCESS}, &testData,
+                            loadDataFn, loadQueue, queueStatisticsUnloadFn);
+
+        // Leave the queue with the only reference, so releasing it destroys the resource
+        CHECK(foeResourceDecrementRefCount(resources[0]) == 1);
+        resources[0] = FOE_NULL_HANDLE;
+
+        foeResourceLoadQueueGetStatistics(loadQueue, &statistics);
+        CHECK(statistics.inFlightCount == 0);
+        CHECK(statistics.loadedCount == 1);
+    }
+
+    SECTION("Pending requests can be re-prioritized") {
+        CHECK(foeResourceLoadQueueRequest(loadQueue, resources[0], 1.f).value ==
+              FOE_RESOURCE_SUCCESS);
+        CHECK(foeResourceLoadQueueRequest(loadQueue, resources[1], 2.f).value ==
+              FOE_RESOURCE_SUCCESS);
+        CHECK(foeResourceLoadQueueRequest(loadQueue, resources[2], 3.f).value ==
+              FOE_RESOURCE_SUCCESS);
+
+        CHECK(foeResourceLoadQueueSetPriority(loadQueue, resources[2], 0.f).value ==
+              FOE_RESOURCE_SUCCESS);
+        // Requesting again also updates the priority
+        CHECK(foeResourceLoadQueueRequest(loadQueue, resources[0], 5.f).value ==
+              FOE_RESOURCE_SUCCESS);
+
+        CHECK(foeResourceLoadQueueSetPriority(loadQueue, resources[3], 0.f).value ==
+              FOE_RESOURCE_ERROR_NOT_FOUND);
+
+        foeResourceLoadQueueGetStatistics(loadQueue, &statistics);
+        CHECK(statistics.pendingCount == 3);
+        CHECK(statistics.requestCount == 3);
+
+        CHECK(foeResourceLoadQueueDispatch(loadQueue, 10) == 3);
+        REQUIRE(loads.size() == 3);
+        CHECK(loads[0].resource == resources[2]);
+        CHECK(loads[1].resource == resources[1]);
+        CHECK(loads[2].resource == resources[0]);
+
+        for (auto const &load : loads) {
+            load.postLoadFn(load.resource, foeResultSet{.value = -1, .toString = errToString},
+                            nullptr, nullptr, nullptr, nullptr);
+        }
+    }
+
+    SECTION("Pending requests can be cancelled") {
+        CHECK(foeResourceLoadQueueRequest(loadQueue, resources[0], 1.f).value ==
+              FOE_RESOURCE_SUCCESS);
+        CHECK(foeResourceGetRefCount(resources[0]) == 2);
+
+        CHECK(foeResourceLoadQueueCancel(loadQueue, resources[0]).value == FOE_RESOURCE_SUCCESS);
+        CHECK(foeResourceGetRefCount(resources[0]) == 1);
+        CHECK(foeResourceLoadQueueCancel(loadQueue, resources[0]).value ==
+              FOE_RESOURCE_ERROR_NOT_FOUND);
+
+        CHECK(foeResourceLoadQueueDispatch(loadQueue, 10) == 0);
+        CHECK(loads.empty());
+
+        foeResourceLoadQueueGetStatistics(loadQueue, &statistics);
+        CHECK(statistics.cancelCount == 1);
+        CHECK(statistics.pendingCount == 0);
+    }
+
+    SECTION("Requests are cancelled if their use count drops to zero before dispatch") {
+        foeResourceIncrementUseCount(resources[0]);
+        foeResourceIncrementUseCount(resources[1]);
+
+        CHECK(foeResourceLoadQueueRequest(loadQueue, resources[0], 1.f).value ==
+              FOE_RESOURCE_SUCCESS);
+        CHECK(foeResourceLoadQueueRequest(loadQueue, resources[1], 1.f).value ==
+              FOE_RESOURCE_SUCCESS);
+
+        foeResourceDecrementUseCount(resources[0]);
+
+        CHECK(foeResourceLoadQueueDispatch(loadQueue, 10) == 1);
+        REQUIRE(loads.size() == 1);
+        CHECK(loads[0].resource == resources[1]);
+        CHECK(foeResourceGetRefCount(resources[0]) == 1);
+
+        foeResourceLoadQueueGetStatistics(loadQueue, &statistics);
+        CHECK(statistics.cancelCount == 1);
+        CHECK(statistics.dispatchCount == 1);
+
+        loads[0].postLoadFn(loads[0].resource, foeResultSet{.value = -1, .toString = errToString},
+                            nullptr, nullptr, nullptr, nullptr);
+        foeResourceDecrementUseCount(resources[1]);
+    }
+
+    SECTION("Resources already loading are not queued") {
+        REQUIRE(foeResourceLoadData(resources[0]).value == FOE_RESOURCE_SUCCESS);
+
+        CHECK(foeResourceLoadQueueRequest(loadQueue, resources[0], 1.f).value ==
+              FOE_RESOURCE_ALREADY_LOADING);
+
+        foeResourceLoadQueueGetStatistics(loadQueue, &statistics);
+        CHECK(statistics.pendingCount == 0);
+        CHECK(statistics.requestCount == 0);
+
+        loads[0].postLoadFn(loads[0].resource, foeResultSet{.value = -1, .toString = errToString},
+                            nullptr, nullptr, nullptr, nullptr);
+    }
+
+    SECTION("Destroying the queue releases pending requests") {
+        CHECK(foeResourceLoadQueueRequest(loadQueue, resources[0], 1.f).value ==
+              FOE_RESOURCE_SUCCESS);
+
+        foeDestroyResourceLoadQueue(loadQueue);
+        loadQueue = FOE_NULL_HANDLE;
+
+        CHECK(foeResourceGetRefCount(resources[0]) == 1);
+    }
+
+    if (loadQueue != FOE_NULL_HANDLE)
+        foeDestroyResourceLoadQueue(loadQueue);
+
+    for (auto resource : resources) {
+        if (resource != FOE_NULL_HANDLE)
+            CHECK(foeResourceDecrementRefCount(resource) == 0);
+    }
+}
@@ -1,13 +1,19 @@
-// Copyright (C) 2023-2025 George Cave.
+// Copyright (C) 2023-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <foe/resource/pool.h>
 #include <foe/resource/resource_fns.h>
 #include <foe/resource/result.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
 
 namespace {
 
@@ -162,6 +168,164 @@ TEST_CASE("foeResourcePool - Cannot add the same ID again until after it is firs
     foeDestroyResourcePool(pool);
 }
 
+TEST_CASE("foeResourcePool - Find or add") {
+    foeResourceFns resourceFns{};
+    foeResourcePool pool{FOE_NULL_HANDLE};
+
+    REQUIRE(foeCreateResourcePool(&resourceFns, &pool).value == FOE_SUCCESS);
+
+    SECTION("Adds an undefined resource if it isn't in the pool") {
+        foeResource resource = foeResourcePoolFindOrAdd(pool, 5);
+        REQUIRE(resource != FOE_NULL_HANDLE);
+
+        CHECK(foeResourceGetID(resource) == 5);
+        CHECK(foeResourceGetType(resource) == FOE_RESOURCE_RESOURCE_TYPE_UNDEFINED);
+        CHECK(foeResourceGetRefCount(resource) == 2);
+
+        SECTION("Then returns the same resource") {
+            CHECK(foeResourcePoolFindOrAdd(pool, 5) == resource);
+            CHECK(foeResourceGetRefCount(resource) == 3);
+            foeResourceDecrementRefCount(resource);
+        }
+
+        foeResourceDecrementRefCount(resource);
+    }
+
+    SECTION("Returns a resource already added to the pool") {
+        foeResource resource = foeResourcePoolAdd(pool, 5);
+        REQUIRE(resource != FOE_NULL_HANDLE);
+
+        CHECK(foeResourcePoolFindOrAdd(pool, 5) == resource);
+        CHECK(foeResourceGetRefCount(resource) == 3);
+
+        foeResourceDecrementRefCount(resource);
+        foeResourceDecrementRefCount(resource);
+    }
+
+    SECTION("Threads racing to add the same IDs all get the same resources") {
+        constexpr int threadCount = 8;
+        constexpr foeResourceID idCount = 1000;
+
+        std::vector<foeResource> threadResources[threadCount];
+        std::thread threads[threadCount];
+        for (int i = 0; i < threadCount; ++i) {
+            threads[i] = std::thread([&, i] {
+                for (foeResourceID id = 0; id < idCount; ++id)
+                    threadResources[i].emplace_back(foeResourcePoolFindOrAdd(pool, id));
+            });
+        }
+        for (auto &thread : threads)
+            thread.join();
+
+        for (foeResourceID id = 0; id < idCount; ++id) {
+            REQUIRE(threadResources[0][id] != FOE_NULL_HANDLE);
+            CHECK(foeResourceGetRefCount(threadResources[0][id]) == threadCount + 1);
+
+            for (int i = 1; i < threadCount; ++i)
+                CHECK(threadResources[i][id] == threadResources[0][id]);
+        }
+
+        for (auto const &resources : threadResources) {
+            for (auto resource : resources)
+                foeResourceDecrementRefCount(resource);
+        }
+    }
+
+    foeDestroyResourcePool(pool);
+}
+
+TEST_CASE("foeResourcePool - Acquiring many resources at once") {
+    foeResourceFns resourceFns{};
+    foeResourcePool pool{FOE_NULL_HANDLE};
+
+    REQUIRE(foeCreateResourcePool(&resourceFns, &pool).value == FOE_SUCCESS);
+
+    foeResource existing = foeResourcePoolAdd(pool, 70);
+    REQUIRE(existing != FOE_NULL_HANDLE);
+
+    // Spread across shards, with some duplicates and one already in the pool
+    std::vector<foeResourceID> ids;
+    for (foeResourceID id = 0; id < 200; id += 3)
+        ids.emplace_back(id);
+    ids.emplace_back(70);
+    ids.emplace_back(6);
+    ids.emplace_back(6);
+    ids.emplace_back(1000);
+
+    std::vector<foeResource> resources(ids.size(), FOE_NULL_HANDLE);
+    foeResultSet result = foeResourcePoolAcquireMany(pool, (uint32_t)ids.size(), ids.data(),
+                                                     resources.data());
+    CHECK(result.value == FOE_RESOURCE_SUCCESS);
+
+    for (size_t i = 0; i < ids.size(); ++i) {
+        REQUIRE(resources[i] != FOE_NULL_HANDLE);
+        CHECK(foeResourceGetID(resources[i]) == ids[i]);
+
+        // Same as what would be found individually
+        foeResource found = foeResourcePoolFind(pool, ids[i]);
+        CHECK(found == resources[i]);
+        foeResourceDecrementRefCount(found);
+    }
+
+    // One reference for the pool, plus one for each time it was returned
+    CHECK(foeResourceGetRefCount(resources[0]) == 2);
+    CHECK(foeResourceGetRefCount(existing) == 3);
+    CHECK(foeResourceGetRefCount(resources.back()) == 2);
+
+    foeResource six = foeResourcePoolFind(pool, 6);
+    CHECK(foeResourceGetRefCount(six) == 5);
+    foeResourceDecrementRefCount(six);
+
+    SECTION("Nothing is written for an empty set") {
+        CHECK(foeResourcePoolAcquireMany(pool, 0, nullptr, nullptr).value == FOE_RESOURCE_SUCCESS);
+    }
+
+    for (auto resource : resources)
+        foeResourceDecrementRefCount(resource);
+    foeResourceDecrementRefCount(existing);
+
+    foeDestroyResourcePool(pool);
+}
+
+TEST_CASE("foeResourcePool - Many resources added and removed in mixed order") {
+    foeResourceFns resourceFns{};
+    foeResourcePool pool{FOE_NULL_HANDLE};
+
+    REQUIRE(foeCreateResourcePool(&resourceFns, &pool).value == FOE_SUCCESS);
+
+    // IDs across several groups, so that both the shards and each shard's table are well used
+    std::vector<foeResourceID> ids;
+    for (foeIdGroup group = 0; group < 4; ++group) {
+        for (foeIdIndex index = 1; index <= 5000; ++index)
+            ids.emplace_back(foeIdCreate(foeIdValueToGroup(group), index));
+    }
+    std::shuffle(ids.begin(), ids.end(), std::mt19937{42});
+
+    for (auto id : ids) {
+        foeResource resource = foeResourcePoolAdd(pool, id);
+        REQUIRE(resource != FOE_NULL_HANDLE);
+        foeResourceDecrementRefCount(resource);
+    }
+
+    // Remove every third one
+    for (size_t i = 0; i < ids.size(); i += 3)
+        REQUIRE(foeResourcePoolRemove(pool, ids[i]).value == FOE_SUCCESS);
+
+    for (size_t i = 0; i < ids.size(); ++i) {
+        foeResource resource = foeResourcePoolFind(pool, ids[i]);
+
+        if (i % 3 == 0) {
+            CHECK(resource == FOE_NULL_HANDLE);
+        } else {
+            REQUIRE(resource != FOE_NULL_HANDLE);
+            CHECK(foeResourceGetID(resource) == ids[i]);
+            foeResourceDecrementRefCount(resource);
+        }
+    }
+
+    foeDestroyResourcePool(pool);
+}
+
 TEST_CASE("foeResourcePool - Replacing a resource in a pool") {
     UnloadedData unloadedData = {};
     foeResourceFns resourceFns{};
@@ -380,6 +544,116 @@ TEST_CASE("foeResourcePool - Unloading resources via pool") {
     foeDestroyResourcePool(pool);
 }
 
+TEST_CASE("foeResourcePool - Evicting least recently used resources over the memory budget") {
+    UnloadedData unloaded[3]{};
+    PFN_foeResourcePostLoad postLoadFn = nullptr;
+    foeResourceFns resourceFns{
+        .pLoadContext = &postLoadFn,
+        .pLoadFn = startLoadCall,
+    };
+    foeResourcePool pool{FOE_NULL_HANDLE};
+    foeResource resources[3]{};
+    foeResourcePoolMemoryStatistics statistics;
+
+    REQUIRE(foeCreateResourcePool(&resourceFns, &pool).value == FOE_SUCCESS);
+
+    for (int i = 0; i < 3; ++i) {
+        foeResource undefinedResource = foeResourcePoolAdd(pool, i);
+        REQUIRE(undefinedResource != FOE_NULL_HANDLE);
+        foeResourceDecrementRefCount(undefinedResource);
+
+        resources[i] = foeResourcePoolLoadedReplace(pool, i, cTestResourceType,
+                                                    sizeof(TestResource), &testData, loadDataFn,
+                                                    &unloaded[i], unloadFn);
+        REQUIRE(resources[i] != FOE_NULL_HANDLE);
+        foeResourceSetMemoryUsage(resources[i], 100, 10);
+    }
+
+    // Last used in the order of 1, 2 then 0
+    for (int i : {1, 2, 0}) {
+        foeResourceIncrementUseCount(resources[i]);
+        foeResourceDecrementUseCount(resources[i]);
+    }
+
+    SECTION("Nothing is evicted without a budget") {
+        CHECK(foeResourcePoolEnforceMemoryBudget(pool) == 0);
+
+        foeResourcePoolGetMemoryStatistics(pool, &statistics);
+        CHECK(statistics.residentCpuBytes == 300);
+        CHECK(statistics.residentGpuBytes == 30);
+        CHECK(statistics.evictionCount == 0);
+    }
+    SECTION("Least recently used are evicted until within the budget") {
+        foeResourcePoolSetMemoryBudget(pool, 250, UINT64_MAX);
+        CHECK(foeResourcePoolEnforceMemoryBudget(pool) == 1);
+
+        CHECK(unloaded[1].resource == resources[1]);
+        CHECK_FALSE(unloaded[1].immediate);
+        CHECK(foeResourceGetState(resources[1]) == (foeResourceStateFlags)0);
+        CHECK(foeResourceGetState(resources[2]) == FOE_RESOURCE_STATE_LOADED_BIT);
+        CHECK(foeResourceGetState(resources[0]) == FOE_RESOURCE_STATE_LOADED_BIT);
+
+        foeResourcePoolGetMemoryStatistics(pool, &statistics);
+        CHECK(statistics.residentCpuBytes == 200);
+        CHECK(statistics.residentGpuBytes == 20);
+        CHECK(statistics.evictionCount == 1);
+        CHECK(statistics.evictedCpuBytes == 100);
+        CHECK(statistics.evictedGpuBytes == 10);
+
+        // Within budget, nothing more to evict
+        CHECK(foeResourcePoolEnforceMemoryBudget(pool) == 0);
+
+        SECTION("Loading an evicted resource again is a reload miss") {
+            REQUIRE(foeResourceLoadData(resources[1]).value == FOE_SUCCESS);
+            REQUIRE(postLoadFn != nullptr);
+            postLoadFn(resources[1], foeResultSet{.value = -1, .toString = errToString}, nullptr,
+                       nullptr, nullptr, nullptr);
+
+            foeResourcePoolGetMemoryStatistics(pool, &statistics);
+            CHECK(statistics.reloadMissCount == 1);
+
+            // Only the first load after being evicted is a miss
+            REQUIRE(foeResourceLoadData(resources[1]).value == FOE_SUCCESS);
+            postLoadFn(resources[1], foeResultSet{.value = -1, .toString = errToString}, nullptr,
+                       nullptr, nullptr, nullptr);
+
+            foeResourcePoolGetMemoryStatistics(pool, &statistics);
+            CHECK(statistics.reloadMissCount == 1);
+        }
+    }
+    SECTION("Resources in use are not evicted") {
+        foeResourceIncrementUseCount(resources[1]);
+
+        foeResourcePoolSetMemoryBudget(pool, UINT64_MAX, 0);
+        CHECK(foeResourcePoolEnforceMemoryBudget(pool) == 2);
+
+        CHECK(foeResourceGetState(resources[1]) == FOE_RESOURCE_STATE_LOADED_BIT);
+        CHECK(foeResourceGetState(resources[2]) == (foeResourceStateFlags)0);
+        CHECK(foeResourceGetState(resources[0]) == (foeResourceStateFlags)0);
+
+        foeResourcePoolGetMemoryStatistics(pool, &statistics);
+        CHECK(statistics.residentGpuBytes == 10);
+        CHECK(statistics.evictionCount == 2);
+
+        foeResourceDecrementUseCount(resources[1]);
+    }
+    SECTION("Resources not using memory that is over budget are not evicted") {
+        foeResourceSetMemoryUsage(resources[1], 100, 0);
+
+        foeResourcePoolSetMemoryBudget(pool, UINT64_MAX, 15);
+        CHECK(foeResourcePoolEnforceMemoryBudget(pool) == 1);
+
+        CHECK(foeResourceGetState(resources[1]) == FOE_RESOURCE_STATE_LOADED_BIT);
+        CHECK(foeResourceGetState(resources[2]) == (foeResourceStateFlags)0);
+        CHECK(foeResourceGetState(resources[0]) == FOE_RESOURCE_STATE_LOADED_BIT);
+    }
+
+    // Cleanup
+    for (auto resource : resources)
+        foeResourceDecrementRefCount(resource);
+    foeDestroyResourcePool(pool);
+}
+
 TEST_CASE("foeResourcePool - Check adding async to pool propagates to resources") {
     bool asyncTaskCalled = false;
     auto asyncTaskFn = [](void *pAsyncContext, PFN_foeTask taskFn, void *pTaskContext)
@@ -431,4 +705,59 @@ TEST_CASE("foeResourcePool - Check adding async to pool propagates to resources"
     // Cleanup
     CHECK(foeResourceDecrementRefCount(resource) == 1);
     foeDestroyResourcePool(pool);
-}
\ No newline at end of file
+}
+
+TEST_CASE("foeResourcePool - Finding resources across threads", "[.][benchmark]") {
+    constexpr int threadCount = 16;
+    constexpr foeIdIndex resourceCount = 100000;
+
+    foeResourceFns resourceFns{};
+    foeResourcePool pool{FOE_NULL_HANDLE};
+    REQUIRE(foeCreateResourcePool(&resourceFns, &pool).value == FOE_SUCCESS);
+
+    std::vector<foeResourceID> ids;
+    for (foeIdIndex index = 1; index <= resourceCount; ++index)
+        ids.emplace_back(foeIdCreate(foeIdPersistentGroup, index));
+    std::shuffle(ids.begin(), ids.end(), std::mt19937{42});
+
+    BENCHMARK("Adding 100k resources in random order") {
+        foeResourcePool addPool{FOE_NULL_HANDLE};
+        foeCreateResourcePool(&resourceFns, &addPool);
+
+        for (auto id : ids)
+            foeResourceDecrementRefCount(foeResourcePoolAdd(addPool, id));
+
+        foeDestroyResourcePool(addPool);
+    };
+
+    for (auto id : ids)
+        foeResourceDecrementRefCount(foeResourcePoolAdd(pool, id));
+
+    auto runThreads = [&](auto &&threadFn) {
+        std::thread threads[threadCount];
+        for (int i = 0; i < threadCount; ++i)
+            threads[i] = std::thread(threadFn, i);
+        for (auto &thread : threads)
+            thread.join();
+    };
+
+    BENCHMARK("16 threads finding 100k resources each") {
+        runThreads([&](int threadIndex) {
+            for (foeIdIndex i = 0; i < resourceCount; ++i) {
+                foeResourceID id = ids[(i + threadIndex * 6247) % resourceCount];
+                foeResourceDecrementRefCount(foeResourcePoolFind(pool, id));
+            }
+        });
+    };
+
+    BENCHMARK("16 threads finding or adding 100k resources each") {
+        runThreads([&](int threadIndex) {
+            for (foeIdIndex i = 0; i < resourceCount; ++i) {
+                foeResourceID id = ids[(i + threadIndex * 6247) % resourceCount];
+                foeResourceDecrementRefCount(foeResourcePoolFindOrAdd(pool, id));
+            }
+        });
+    };
+
+    foeDestroyResourcePool(pool);
+}
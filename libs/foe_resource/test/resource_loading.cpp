@@ -1,4 +1,4 @@
-// Copyright (C) 2023-2025 George Cave.
+// Copyright (C) 2023-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
@@ -9,6 +9,7 @@
 #include <foe/resource/type_defs.h>
 
 #include <cstring>
+#include <vector>
 
 namespace {
 
@@ -221,4 +222,80 @@ TEST_CASE("foeResource - Loading via async task function") {
 
     // Cleanup
     REQUIRE(foeResourceDecrementRefCount(resource) == 0);
-}
\ No newline at end of file
+}
+
+TEST_CASE("foeResource - Loading many resources at once") {
+    struct LoadContext {
+        std::vector<PFN_foeResourcePostLoad> postLoadFns;
+        int scheduledTasks;
+    } context{};
+
+    auto asyncTaskFn = [](void *pAsyncContext, PFN_foeTask taskFn, void *pTaskContext)
+#if defined(__clang__) || defined(__GNUC__)
+                           __attribute__((no_sanitize("function"))) // different function signature
+#endif
+    {
+        ++((LoadContext *)pAsyncContext)->scheduledTasks;
+
+        taskFn(pTaskContext);
+    };
+    auto loadFn = [](void *pContext, foeResource resource, PFN_foeResourcePostLoad postLoadFn) {
+        ((LoadContext *)pContext)->postLoadFns.emplace_back(postLoadFn);
+    };
+
+    foeResourceFns resourceFns{
+        .pLoadContext = &context,
+        .pLoadFn = loadFn,
+    };
+
+    constexpr uint32_t resourceCount = 40;
+    std::vector<foeResource> resources;
+    for (uint32_t i = 0; i < resourceCount; ++i) {
+        foeResource resource{FOE_NULL_HANDLE};
+        REQUIRE(foeCreateResource(i, cTestResourceType, &resourceFns, sizeof(TestResource),
+                                  &resource)
+                    .value == FOE_SUCCESS);
+        resources.emplace_back(resource);
+    }
+
+    // Duplicates and null handles are skipped
+    std::vector<foeResource> toLoad = resources;
+    toLoad.emplace_back(resources[3]);
+    toLoad.push_back(FOE_NULL_HANDLE);
+    toLoad.emplace_back(resources[0]);
+
+    SECTION("Synchronously") {
+        CHECK(foeResourceLoadDataMany((uint32_t)toLoad.size(), toLoad.data()) == resourceCount);
+
+        CHECK(context.scheduledTasks == 0);
+    }
+    SECTION("Asynchronously, in batches") {
+        resourceFns.scheduleAsyncTask = asyncTaskFn;
+        resourceFns.pScheduleAsyncTaskContext = &context;
+
+        CHECK(foeResourceLoadDataMany((uint32_t)toLoad.size(), toLoad.data()) == resourceCount);
+
+        // Fewer tasks than resources
+        CHECK(context.scheduledTasks > 0);
+        CHECK(context.scheduledTasks < (int)resourceCount);
+    }
+
+    CHECK(context.postLoadFns.size() == resourceCount);
+    for (auto resource : resources) {
+        CHECK(foeResourceGetState(resource) == FOE_RESOURCE_STATE_LOADING_BIT);
+        CHECK(foeResourceGetRefCount(resource) == 2);
+    }
+
+    // Already loading, so none are started again
+    CHECK(foeResourceLoadDataMany((uint32_t)resources.size(), resources.data()) == 0);
+    CHECK(context.postLoadFns.size() == resourceCount);
+
+    for (auto resource : resources) {
+        context.postLoadFns.front()(resource, foeResultSet{.value = -1, .toString = errToString},
+                                    nullptr, nullptr, nullptr, nullptr);
+    }
+
+    // Cleanup
+    for (auto resource : resources)
+        CHECK(foeResourceDecrementRefCount(resource) == 0);
+}
@@ -1,4 +1,4 @@
-// Copyright (C) 2022-2023 George Cave.
+// Copyright (C) 2022-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
@@ -7,6 +7,10 @@
 #include <foe/resource/resource_fns.h>
 #include <foe/resource/result.h>
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 TEST_CASE("foeResource - Attempting to do a resource replacement with a defined type fails") {
     foeResource resource{FOE_NULL_HANDLE};
     foeResourceFns fns{};
@@ -123,4 +127,79 @@ TEST_CASE("foeResource - Replacement of undefined resource works as expected") {
     // Cleanup
     CHECK(foeResourceDecrementRefCount(replacementResource) == 1);
     CHECK(foeResourceDecrementRefCount(replacementResource) == 0);
-}
\ No newline at end of file
+}
+
+TEST_CASE("foeResource - Getting the current resource follows all replacements") {
+    foeResourceFns fns{};
+    foeResource resources[3];
+
+    for (auto &resource : resources)
+        REQUIRE(foeCreateUndefinedResource(0, &fns, &resource).value == FOE_SUCCESS);
+
+    // Not replaced, so is the current resource
+    foeResource current = foeResourceGetCurrent(resources[0]);
+    CHECK(current == resources[0]);
+    CHECK(foeResourceDecrementRefCount(current) == 1);
+
+    REQUIRE(foeResourceReplace(resources[0], resources[1]).value == FOE_SUCCESS);
+    REQUIRE(foeResourceReplace(resources[1], resources[2]).value == FOE_SUCCESS);
+
+    // Goes straight to the end, where the original only knows its direct replacement
+    current = foeResourceGetCurrent(resources[0]);
+    CHECK(current == resources[2]);
+    CHECK(foeResourceGetRefCount(resources[2]) == 3);
+    CHECK(foeResourceDecrementRefCount(current) == 2);
+
+    foeResource replacement = foeResourceGetReplacement(resources[0]);
+    CHECK(replacement == resources[1]);
+    foeResourceDecrementRefCount(replacement);
+
+    // Cleanup
+    for (auto resource : resources)
+        foeResourceDecrementRefCount(resource);
+}
+
+TEST_CASE("foeResource - Replacement while other threads are following the resource") {
+    constexpr int threadCount = 4;
+    foeResourceFns fns{};
+    foeResource resource{FOE_NULL_HANDLE};
+    foeResource replacementResource{FOE_NULL_HANDLE};
+
+    REQUIRE(foeCreateUndefinedResource(0, &fns, &resource).value == FOE_SUCCESS);
+    REQUIRE(foeCreateResource(0, 1, &fns, sizeof(foeResourceBase), &replacementResource).value ==
+            FOE_SUCCESS);
+
+    std::atomic_bool start{false};
+    std::vector<std::thread> threads;
+    std::atomic_int sawReplacement{0};
+
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back([&] {
+            while (!start)
+                std::this_thread::yield();
+
+            // Whenever the type is seen as replaced, the replacement must be available
+            while (true) {
+                if (foeResourceGetType(resource) == FOE_RESOURCE_RESOURCE_TYPE_REPLACED) {
+                    foeResource current = foeResourceGetCurrent(resource);
+                    if (current == replacementResource)
+                        ++sawReplacement;
+                    foeResourceDecrementRefCount(current);
+                    break;
+                }
+            }
+        });
+    }
+
+    start = true;
+    REQUIRE(foeResourceReplace(resource, replacementResource).value == FOE_SUCCESS);
+
+    for (auto &thread : threads)
+        thread.join();
+
+    CHECK(sawReplacement == threadCount);
+
+    // Cleanup
+    CHECK(foeResourceDecrementRefCount(resource) == 0);
+    CHECK(foeResourceDecrementRefCount(replacementResource) == 0);
+}
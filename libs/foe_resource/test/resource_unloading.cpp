@@ -1,4 +1,4 @@
-// Copyright (C) 2023 George Cave.
+// Copyright (C) 2023-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
@@ -263,4 +263,61 @@ TEST_CASE("foeResource - Unloading a regular resource") {
     }
 
     CHECK(foeResourceDecrementRefCount(resource) == 0);
-}
\ No newline at end of file
+}
+
+TEST_CASE("foeResource - Unloading a resource only if it is unused") {
+    PFN_foeResourcePostLoad postLoadFn = nullptr;
+    foeResourceFns resourceFns{
+        .pLoadContext = &postLoadFn,
+        .pLoadFn = startLoadCall,
+    };
+    DelayedUnloadingData delayedUnloadingData = {};
+    foeResource resource{FOE_NULL_HANDLE};
+    foeResultSet result;
+
+    result = foeCreateResource(0, cTestResourceType, &resourceFns, sizeof(TestResource), &resource);
+    REQUIRE(result.value == FOE_SUCCESS);
+    REQUIRE(resource != FOE_NULL_HANDLE);
+
+    result = foeResourceLoadData(resource);
+    REQUIRE(result.value == FOE_SUCCESS);
+
+    SECTION("Fails while loading") {
+        CHECK_FALSE(foeResourceUnloadDataIfUnused(resource, false));
+        CHECK(foeResourceGetState(resource) == FOE_RESOURCE_STATE_LOADING_BIT);
+
+        postLoadFn(resource, foeResultSet{.value = FOE_SUCCESS}, &testData, loadDataFn,
+                   &delayedUnloadingData, unloadFn);
+        CHECK(foeResourceGetState(resource) == FOE_RESOURCE_STATE_LOADED_BIT);
+    }
+
+    SECTION("When loaded") {
+        postLoadFn(resource, foeResultSet{.value = FOE_SUCCESS}, &testData, loadDataFn,
+                   &delayedUnloadingData, unloadFn);
+        REQUIRE(foeResourceGetState(resource) == FOE_RESOURCE_STATE_LOADED_BIT);
+
+        SECTION("Fails when use count is non-zero, leaving it loaded") {
+            foeResourceIncrementUseCount(resource);
+
+            CHECK_FALSE(foeResourceUnloadDataIfUnused(resource, false));
+            CHECK(foeResourceGetState(resource) == FOE_RESOURCE_STATE_LOADED_BIT);
+            CHECK(foeResourceGetRefCount(resource) == 1);
+
+            foeResourceDecrementUseCount(resource);
+        }
+        SECTION("Succeeds when use count is zero, no longer loaded before a delayed unload") {
+            CHECK(foeResourceUnloadDataIfUnused(resource, false));
+
+            // Anything starting to use it from now on sees it as not loaded
+            CHECK(foeResourceGetState(resource) == (foeResourceStateFlags)0);
+            CHECK(foeResourceGetRefCount(resource) == 2);
+
+            CHECK(processDelayedUnloading(&delayedUnloadingData));
+
+            CHECK(foeResourceGetState(resource) == (foeResourceStateFlags)0);
+            CHECK(foeResourceGetRefCount(resource) == 1);
+        }
+    }
+
+    CHECK(foeResourceDecrementRefCount(resource) == 0);
+}
@@ -1,4 +1,4 @@
-// Copyright (C) 2023 George Cave.
+// Copyright (C) 2023-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
@@ -15,6 +15,13 @@
 extern "C" {
 #endif
 
+/** @brief Holds the create info for each resource ID
+ *
+ * Entries are hashed across shards by the low bits of their index, each with its own lock, so
+ * that lookups from many loading threads at once rarely contend with each other.
+ *
+ * @note Thread-safe
+ */
 FOE_DEFINE_HANDLE(foeResourceCreateInfoPool)
 
 FOE_SIM_EXPORT
@@ -28,6 +35,22 @@ foeResultSet foeResourceCreateInfoPoolAdd(foeResourceCreateInfoPool resourceCrea
                                           foeResourceID resourceID,
                                           foeResourceCreateInfo resourceCreateInfo);
 
+/** @brief Adds a set of create infos at once, such as when importing
+ * @param count Number of elements in pResourceIDs and pResourceCreateInfos.
+ * @param pResourceIDs IDs to add the create info for.
+ * @param pResourceCreateInfos Create info to add for the ID at the same position.
+ * @return FOE_SIMULATION_SUCCESS if all were added, otherwise
+ * FOE_SIMULATION_ERROR_RESOURCE_CREATE_INFO_ALREADY_ADDED if any ID already had a create info, in
+ * which case all the others are still added.
+ *
+ * Each shard of the pool is only locked once for the whole set.
+ */
+FOE_SIM_EXPORT
+foeResultSet foeResourceCreateInfoPoolAddMany(foeResourceCreateInfoPool resourceCreateInfoPool,
+                                              uint32_t count,
+                                              foeResourceID const *pResourceIDs,
+                                              foeResourceCreateInfo const *pResourceCreateInfos);
+
 FOE_SIM_EXPORT
 foeResultSet foeResourceCreateInfoPoolRemove(foeResourceCreateInfoPool resourceCreateInfoPool,
                                              foeResourceID resourceID);
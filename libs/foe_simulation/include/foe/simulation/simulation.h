@@ -14,6 +14,7 @@
 #include <foe/simulation/group_data.h>
 #include <foe/simulation/resource_create_info_history.h>
 #include <foe/simulation/resource_create_info_pool.h>
+#include <foe/split_thread_pool.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -61,8 +62,14 @@ typedef struct foeSimulationLoaderData {
     size_t gfxInitCount;
     /// The loader itself
     void *pLoader;
-    /// Function that returns whether the loader can process a given ResourceCreateInfo type
+    /// Function that returns whether the loader can process a given ResourceCreateInfo type, only
+    /// used for types that no loader has registered in pCreateInfoTypes
     bool (*pCanProcessCreateInfoFn)(foeResourceCreateInfo);
+    /// Number of ResourceCreateInfo types handled by the loader
+    uint32_t createInfoTypeCount;
+    /// ResourceCreateInfo types handled by the loader, which are dispatched directly to it, must
+    /// remain valid while the loader is present
+    foeResourceCreateInfoType const *pCreateInfoTypes;
     /// Function to be called to load a resource with a compatible ResourceCreateInfo
     void (*pLoadFn)(void *, foeResource, foeResourceCreateInfo, PFN_foeResourcePostLoad);
     /// Maintenance to be performed as part of the regular simulation loop
@@ -84,6 +91,17 @@ typedef struct foeSimulationSystemData {
     size_t initCount;
     size_t gfxInitCount;
     void *pSystem;
+    /// Processing to be performed as part of the regular simulation loop, optional
+    foeResultSet (*pProcessFn)(void *, float);
+    /// Number of component pool types read during processing
+    uint32_t readPoolCount;
+    /// Component pool types read during processing, must remain valid while the system is present
+    foeSimulationStructureType const *pReadPools;
+    /// Number of component pool types written to during processing
+    uint32_t writePoolCount;
+    /// Component pool types written to during processing, must remain valid while the system is
+    /// present
+    foeSimulationStructureType const *pWritePools;
 } foeSimulationSystemData;
 
 /// Return if a simulation has been successfully initialized
@@ -242,6 +260,43 @@ foeResultSet foeSimulationReleaseSystem(foeSimulation simulation,
                                         foeSimulationStructureType sType,
                                         void **ppSystem);
 
+/**
+ * @brief Runs the processing of all systems for a single simulation tick
+ * @param simulation Simulation whose systems are to be processed
+ * @param threadPool Thread pool the systems are processed on
+ * @param timeElapsed Time, in seconds, since the last tick
+ * @return FOE_SIMULATION_SUCCESS if all systems processed successfully, otherwise the first
+ * failure result returned by a system.
+ *
+ * Systems are processed in the order they were inserted, except that any systems whose declared
+ * read/write component pools don't conflict are processed concurrently. Two systems conflict if
+ * either writes to a pool that the other reads or writes.
+ *
+ * Blocks until all systems have been processed.
+ */
+FOE_SIM_EXPORT
+foeResultSet foeSimulationProcessSystems(foeSimulation simulation,
+                                         foeSplitThreadPool threadPool,
+                                         float timeElapsed);
+
+/**
+ * @brief Runs the maintenance of all component pools, in parallel
+ * @param simulation Simulation whose component pools are to be maintained
+ * @param threadPool Thread pool the maintenance is spread across
+ * @param pMaintenanceTimes Optional, if not NULL, must point to an array with an entry for each
+ * component pool as returned by foeSimulationGetComponentPools, which is filled with the time each
+ * pool's maintenance took, in nanoseconds. Pools without a maintenance function get zero.
+ * @return FOE_SIMULATION_SUCCESS once all maintenance has completed, an appropriate error code
+ * otherwise.
+ *
+ * Component pools are independent of each other, so are maintained concurrently, with the calling
+ * thread also taking part. Blocks until all maintenance has completed.
+ */
+FOE_SIM_EXPORT
+foeResultSet foeSimulationMaintainComponentPools(foeSimulation simulation,
+                                                 foeSplitThreadPool threadPool,
+                                                 uint64_t *pMaintenanceTimes);
+
 FOE_SIM_EXPORT
 foeResultSet foeSimulationGetResourceCreateInfo(foeSimulation simulation,
                                                 foeResourceID resourceID,
@@ -1,27 +1,27 @@
-// Copyright (C) 2023 George Cave.
+// Copyright (C) 2023-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
 #include <foe/simulation/resource_create_info_history.h>
 
 #include "result.h"
+#include "sharded_resource_map.hpp"
 
-#include <algorithm>
 #include <mutex>
-#include <shared_mutex>
+#include <new>
 #include <vector>
 
 namespace {
 
 struct Entry {
-    foeResourceID id;
     std::vector<foeResourceCreateInfo> history;
     size_t current;
 };
 
+using HistoryMap = ShardedResourceMap<Entry>;
+
 struct ResourceCreateInfoHistory {
-    std::shared_mutex sync;
-    std::vector<Entry> entries;
+    HistoryMap map;
 };
 
 FOE_DEFINE_HANDLE_CASTS(create_info_history,
@@ -46,10 +46,12 @@ extern "C" void foeDestroyResourceCreateInfoHistory(
     ResourceCreateInfoHistory *pCreateInfoHistory =
         create_info_history_from_handle(resourceCreateInfoHistory);
 
-    for (Entry const &entry : pCreateInfoHistory->entries) {
-        for (foeResourceCreateInfo resourceCI : entry.history) {
-            foeResourceCreateInfoDecrementRefCount(resourceCI);
-            // @TODO - Log non-zero counts
+    for (auto const &shard : pCreateInfoHistory->map.shards) {
+        for (auto const &it : shard.entries) {
+            for (foeResourceCreateInfo resourceCI : it.second.history) {
+                foeResourceCreateInfoDecrementRefCount(resourceCI);
+                // @TODO - Log non-zero counts
+            }
         }
     }
 
@@ -62,23 +64,18 @@ extern "C" foeResultSet foeResourceCreateInfoHistoryAdd(
     foeResourceCreateInfo resourceCreateInfo) {
     ResourceCreateInfoHistory *pCreateInfoHistory =
         create_info_history_from_handle(resourceCreateInfoHistory);
+    auto &shard = pCreateInfoHistory->map.getShard(resourceID);
 
-    std::unique_lock lock{pCreateInfoHistory->sync};
-
-    auto searchIt =
-        std::lower_bound(pCreateInfoHistory->entries.begin(), pCreateInfoHistory->entries.end(),
-                         resourceID, [](Entry const &entry, foeResourceID resourceID) {
-                             return entry.id < resourceID;
-                         });
+    std::unique_lock lock{shard.sync};
 
-    if (searchIt != pCreateInfoHistory->entries.end() && searchIt->id == resourceID)
+    auto [it, added] = shard.entries.try_emplace(resourceID);
+    if (!added)
         return to_foeResult(FOE_SIMULATION_ERROR_RESOURCE_CREATE_INFO_ALREADY_ADDED);
 
-    pCreateInfoHistory->entries.emplace(searchIt, Entry{
-                                                      .id = resourceID,
-                                                      .history = {resourceCreateInfo},
-                                                      .current = 0,
-                                                  });
+    it->second = Entry{
+        .history = {resourceCreateInfo},
+        .current = 0,
+    };
 
     lock.unlock();
 
@@ -87,24 +84,62 @@ extern "C" foeResultSet foeResourceCreateInfoHistoryAdd(
     return to_foeResult(FOE_SIMULATION_SUCCESS);
 }
 
+extern "C" foeResultSet foeResourceCreateInfoHistoryAddMany(
+    foeResourceCreateInfoHistory resourceCreateInfoHistory,
+    uint32_t count,
+    foeResourceID const *pResourceIDs,
+    foeResourceCreateInfo const *pResourceCreateInfos) {
+    ResourceCreateInfoHistory *pCreateInfoHistory =
+        create_info_history_from_handle(resourceCreateInfoHistory);
+    foeResultSet result = to_foeResult(FOE_SIMULATION_SUCCESS);
+
+    uint32_t shardOffsets[HistoryMap::cShardCount + 1];
+    std::vector<uint32_t> requests;
+    HistoryMap::groupByShard(count, pResourceIDs, shardOffsets, requests);
+
+    for (uint32_t shardIndex = 0; shardIndex < HistoryMap::cShardCount; ++shardIndex) {
+        uint32_t const *pBegin = requests.data() + shardOffsets[shardIndex];
+        uint32_t const *const pEnd = requests.data() + shardOffsets[shardIndex + 1];
+        if (pBegin == pEnd)
+            continue;
+
+        auto &shard = pCreateInfoHistory->map.shards[shardIndex];
+        std::unique_lock lock{shard.sync};
+
+        shard.entries.reserve(shard.entries.size() + (pEnd - pBegin));
+
+        for (uint32_t const *pRequest = pBegin; pRequest != pEnd; ++pRequest) {
+            auto [it, added] = shard.entries.try_emplace(pResourceIDs[*pRequest]);
+            if (!added) {
+                result = to_foeResult(FOE_SIMULATION_ERROR_RESOURCE_CREATE_INFO_ALREADY_ADDED);
+                continue;
+            }
+
+            it->second = Entry{
+                .history = {pResourceCreateInfos[*pRequest]},
+                .current = 0,
+            };
+            foeResourceCreateInfoIncrementRefCount(pResourceCreateInfos[*pRequest]);
+        }
+    }
+
+    return result;
+}
+
 extern "C" foeResultSet foeResourceCreateInfoHistoryRemove(
     foeResourceCreateInfoHistory resourceCreateInfoHistory, foeResourceID resourceID) {
     ResourceCreateInfoHistory *pCreateInfoHistory =
         create_info_history_from_handle(resourceCreateInfoHistory);
+    auto &shard = pCreateInfoHistory->map.getShard(resourceID);
 
-    std::unique_lock lock{pCreateInfoHistory->sync};
-
-    auto searchIt =
-        std::lower_bound(pCreateInfoHistory->entries.begin(), pCreateInfoHistory->entries.end(),
-                         resourceID, [](Entry const &entry, foeResourceID resourceID) {
-                             return entry.id < resourceID;
-                         });
+    std::unique_lock lock{shard.sync};
 
-    if (searchIt == pCreateInfoHistory->entries.end() || searchIt->id != resourceID)
+    auto searchIt = shard.entries.find(resourceID);
+    if (searchIt == shard.entries.end())
         return to_foeResult(FOE_SIMULATION_ERROR_RESOURCE_CREATE_INFO_NOT_FOUND);
 
-    Entry entry = std::move(*searchIt);
-    pCreateInfoHistory->entries.erase(searchIt);
+    Entry entry = std::move(searchIt->second);
+    shard.entries.erase(searchIt);
 
     lock.unlock();
 
@@ -120,22 +155,17 @@ extern "C" foeResourceCreateInfo foeResourceCreateInfoHistoryCurrent(
     foeResourceCreateInfoHistory resourceCreateInfoHistory, foeResourceID resourceID) {
     ResourceCreateInfoHistory *pCreateInfoHistory =
         create_info_history_from_handle(resourceCreateInfoHistory);
+    auto &shard = pCreateInfoHistory->map.getShard(resourceID);
 
-    std::shared_lock lock{pCreateInfoHistory->sync};
+    std::shared_lock lock{shard.sync};
 
-    auto searchIt =
-        std::lower_bound(pCreateInfoHistory->entries.begin(), pCreateInfoHistory->entries.end(),
-                         resourceID, [](Entry const &entry, foeResourceID resourceID) {
-                             return entry.id < resourceID;
-                         });
-
-    if (searchIt == pCreateInfoHistory->entries.end() || searchIt->id != resourceID)
+    auto searchIt = shard.entries.find(resourceID);
+    if (searchIt == shard.entries.end())
         return FOE_NULL_HANDLE;
 
-    foeResourceCreateInfo createInfo = searchIt->history[searchIt->current];
-
-    lock.unlock();
+    foeResourceCreateInfo createInfo = searchIt->second.history[searchIt->second.current];
 
+    // Incremented while still locked, so it can't be removed and destroyed in between
     foeResourceCreateInfoIncrementRefCount(createInfo);
 
     return createInfo;
@@ -145,23 +175,19 @@ foeResultSet foeResourceCreateInfoHistoryUndo(
     foeResourceCreateInfoHistory resourceCreateInfoHistory, foeResourceID resourceID) {
     ResourceCreateInfoHistory *pCreateInfoHistory =
         create_info_history_from_handle(resourceCreateInfoHistory);
+    auto &shard = pCreateInfoHistory->map.getShard(resourceID);
 
-    std::unique_lock lock{pCreateInfoHistory->sync};
-
-    auto searchIt =
-        std::lower_bound(pCreateInfoHistory->entries.begin(), pCreateInfoHistory->entries.end(),
-                         resourceID, [](Entry const &entry, foeResourceID resourceID) {
-                             return entry.id < resourceID;
-                         });
+    std::unique_lock lock{shard.sync};
 
-    if (searchIt == pCreateInfoHistory->entries.end() || searchIt->id != resourceID)
+    auto searchIt = shard.entries.find(resourceID);
+    if (searchIt == shard.entries.end())
         return to_foeResult(FOE_SIMULATION_ERROR_RESOURCE_CREATE_INFO_NOT_FOUND);
 
-    if (searchIt->current == 0) {
+    if (searchIt->second.current == 0) {
         return to_foeResult(FOE_SIMULATION_CANNOT_UNDO);
     }
 
-    --searchIt->current;
+    --searchIt->second.current;
 
     return to_foeResult(FOE_SIMULATION_SUCCESS);
 }
@@ -170,23 +196,19 @@ foeResultSet foeResourceCreateInfoHistoryRedo(
     foeResourceCreateInfoHistory resourceCreateInfoHistory, foeResourceID resourceID) {
     ResourceCreateInfoHistory *pCreateInfoHistory =
         create_info_history_from_handle(resourceCreateInfoHistory);
+    auto &shard = pCreateInfoHistory->map.getShard(resourceID);
 
-    std::unique_lock lock{pCreateInfoHistory->sync};
+    std::unique_lock lock{shard.sync};
 
-    auto searchIt =
-        std::lower_bound(pCreateInfoHistory->entries.begin(), pCreateInfoHistory->entries.end(),
-                         resourceID, [](Entry const &entry, foeResourceID resourceID) {
-                             return entry.id < resourceID;
-                         });
-
-    if (searchIt == pCreateInfoHistory->entries.end() || searchIt->id != resourceID)
+    auto searchIt = shard.entries.find(resourceID);
+    if (searchIt == shard.entries.end())
         return to_foeResult(FOE_SIMULATION_ERROR_RESOURCE_CREATE_INFO_NOT_FOUND);
 
-    if (searchIt->current == searchIt->history.size() - 1) {
+    if (searchIt->second.current == searchIt->second.history.size() - 1) {
         return to_foeResult(FOE_SIMULATION_CANNOT_REDO);
     }
 
-    ++searchIt->current;
+    ++searchIt->second.current;
 
     return to_foeResult(FOE_SIMULATION_SUCCESS);
-}
\ No newline at end of file
+}
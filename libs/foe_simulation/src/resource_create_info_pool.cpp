@@ -1,26 +1,21 @@
-// Copyright (C) 2023 George Cave.
+// Copyright (C) 2023-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
 #include <foe/simulation/resource_create_info_pool.h>
 
 #include "result.h"
+#include "sharded_resource_map.hpp"
 
-#include <algorithm>
 #include <mutex>
-#include <shared_mutex>
-#include <vector>
+#include <new>
 
 namespace {
 
-struct Entry {
-    foeResourceID id;
-    foeResourceCreateInfo createInfo;
-};
+using CreateInfoMap = ShardedResourceMap<foeResourceCreateInfo>;
 
 struct ResourceCreateInfoPool {
-    std::shared_mutex sync;
-    std::vector<Entry> entries;
+    CreateInfoMap map;
 };
 
 FOE_DEFINE_HANDLE_CASTS(create_info_pool, ResourceCreateInfoPool, foeResourceCreateInfoPool)
@@ -41,9 +36,11 @@ extern "C" foeResultSet foeCreateResourceCreateInfoPool(
 extern "C" void foeDestroyResourceCreateInfoPool(foeResourceCreateInfoPool resourceCreateInfoPool) {
     ResourceCreateInfoPool *pCreateInfoPool = create_info_pool_from_handle(resourceCreateInfoPool);
 
-    for (Entry const &it : pCreateInfoPool->entries) {
-        foeResourceCreateInfoDecrementRefCount(it.createInfo);
-        // @TODO - Log non-zero counts
+    for (auto const &shard : pCreateInfoPool->map.shards) {
+        for (auto const &it : shard.entries) {
+            foeResourceCreateInfoDecrementRefCount(it.second);
+            // @TODO - Log non-zero counts
+        }
     }
 
     delete pCreateInfoPool;
@@ -54,23 +51,13 @@ extern "C" foeResultSet foeResourceCreateInfoPoolAdd(
     foeResourceID resourceID,
     foeResourceCreateInfo resourceCreateInfo) {
     ResourceCreateInfoPool *pCreateInfoPool = create_info_pool_from_handle(resourceCreateInfoPool);
+    auto &shard = pCreateInfoPool->map.getShard(resourceID);
 
-    std::unique_lock lock{pCreateInfoPool->sync};
-
-    auto searchIt =
-        std::lower_bound(pCreateInfoPool->entries.begin(), pCreateInfoPool->entries.end(),
-                         resourceID, [](Entry const &entry, foeResourceID resourceID) {
-                             return entry.id < resourceID;
-                         });
+    std::unique_lock lock{shard.sync};
 
-    if (searchIt != pCreateInfoPool->entries.end() && searchIt->id == resourceID)
+    if (!shard.entries.try_emplace(resourceID, resourceCreateInfo).second)
         return to_foeResult(FOE_SIMULATION_ERROR_RESOURCE_CREATE_INFO_ALREADY_ADDED);
 
-    pCreateInfoPool->entries.emplace(searchIt, Entry{
-                                                   .id = resourceID,
-                                                   .createInfo = resourceCreateInfo,
-                                               });
-
     lock.unlock();
 
     foeResourceCreateInfoIncrementRefCount(resourceCreateInfo);
@@ -78,23 +65,55 @@ extern "C" foeResultSet foeResourceCreateInfoPoolAdd(
     return to_foeResult(FOE_SIMULATION_SUCCESS);
 }
 
+extern "C" foeResultSet foeResourceCreateInfoPoolAddMany(
+    foeResourceCreateInfoPool resourceCreateInfoPool,
+    uint32_t count,
+    foeResourceID const *pResourceIDs,
+    foeResourceCreateInfo const *pResourceCreateInfos) {
+    ResourceCreateInfoPool *pCreateInfoPool = create_info_pool_from_handle(resourceCreateInfoPool);
+    foeResultSet result = to_foeResult(FOE_SIMULATION_SUCCESS);
+
+    uint32_t shardOffsets[CreateInfoMap::cShardCount + 1];
+    std::vector<uint32_t> requests;
+    CreateInfoMap::groupByShard(count, pResourceIDs, shardOffsets, requests);
+
+    for (uint32_t shardIndex = 0; shardIndex < CreateInfoMap::cShardCount; ++shardIndex) {
+        uint32_t const *pBegin = requests.data() + shardOffsets[shardIndex];
+        uint32_t const *const pEnd = requests.data() + shardOffsets[shardIndex + 1];
+        if (pBegin == pEnd)
+            continue;
+
+        auto &shard = pCreateInfoPool->map.shards[shardIndex];
+        std::unique_lock lock{shard.sync};
+
+        shard.entries.reserve(shard.entries.size() + (pEnd - pBegin));
+
+        for (uint32_t const *pRequest = pBegin; pRequest != pEnd; ++pRequest) {
+            if (shard.entries.try_emplace(pResourceIDs[*pRequest], pResourceCreateInfos[*pRequest])
+                    .second) {
+                foeResourceCreateInfoIncrementRefCount(pResourceCreateInfos[*pRequest]);
+            } else {
+                result = to_foeResult(FOE_SIMULATION_ERROR_RESOURCE_CREATE_INFO_ALREADY_ADDED);
+            }
+        }
+    }
+
+    return result;
+}
+
 extern "C" foeResultSet foeResourceCreateInfoPoolRemove(
     foeResourceCreateInfoPool resourceCreateInfoPool, foeResourceID resourceID) {
     ResourceCreateInfoPool *pCreateInfoPool = create_info_pool_from_handle(resourceCreateInfoPool);
+    auto &shard = pCreateInfoPool->map.getShard(resourceID);
 
-    std::unique_lock lock{pCreateInfoPool->sync};
+    std::unique_lock lock{shard.sync};
 
-    auto searchIt =
-        std::lower_bound(pCreateInfoPool->entries.begin(), pCreateInfoPool->entries.end(),
-                         resourceID, [](Entry const &entry, foeResourceID resourceID) {
-                             return entry.id < resourceID;
-                         });
-
-    if (searchIt == pCreateInfoPool->entries.end() || searchIt->id != resourceID)
+    auto searchIt = shard.entries.find(resourceID);
+    if (searchIt == shard.entries.end())
         return to_foeResult(FOE_SIMULATION_ERROR_RESOURCE_CREATE_INFO_NOT_FOUND);
 
-    foeResourceCreateInfo createInfo = searchIt->createInfo;
-    pCreateInfoPool->entries.erase(searchIt);
+    foeResourceCreateInfo createInfo = searchIt->second;
+    shard.entries.erase(searchIt);
 
     lock.unlock();
 
@@ -107,23 +126,18 @@ extern "C" foeResultSet foeResourceCreateInfoPoolRemove(
 extern "C" foeResourceCreateInfo foeResourceCreateInfoPoolGet(
     foeResourceCreateInfoPool resourceCreateInfoPool, foeResourceID resourceID) {
     ResourceCreateInfoPool *pCreateInfoPool = create_info_pool_from_handle(resourceCreateInfoPool);
+    auto &shard = pCreateInfoPool->map.getShard(resourceID);
 
-    std::shared_lock lock{pCreateInfoPool->sync};
-
-    auto searchIt =
-        std::lower_bound(pCreateInfoPool->entries.begin(), pCreateInfoPool->entries.end(),
-                         resourceID, [](Entry const &entry, foeResourceID resourceID) {
-                             return entry.id < resourceID;
-                         });
+    std::shared_lock lock{shard.sync};
 
-    if (searchIt == pCreateInfoPool->entries.end() || searchIt->id != resourceID)
+    auto searchIt = shard.entries.find(resourceID);
+    if (searchIt == shard.entries.end())
         return FOE_NULL_HANDLE;
 
-    foeResourceCreateInfo createInfo = searchIt->createInfo;
-
-    lock.unlock();
+    foeResourceCreateInfo createInfo = searchIt->second;
 
+    // Incremented while still locked, so it can't be removed and destroyed in between
     foeResourceCreateInfoIncrementRefCount(createInfo);
 
     return createInfo;
-}
\ No newline at end of file
+}
@@ -0,0 +1,46 @@
+// Copyright (C) 2026 George Cave.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SHARDED_RESOURCE_MAP_HPP
+#define SHARDED_RESOURCE_MAP_HPP
+
+#include <foe/ecs/id.h>
+#include <foe/ecs/id_shards.hpp>
+
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+/** @brief Maps resource IDs to values, split across shards that are each locked separately
+ *
+ * IDs are assigned to shards by the low bits of their index, so that sequentially assigned IDs are
+ * spread evenly and threads looking up different IDs rarely contend on the same lock.
+ */
+template <typename Value>
+struct ShardedResourceMap {
+    static constexpr uint32_t cShardCount = 64;
+
+    struct alignas(64) Shard {
+        std::shared_mutex sync;
+        std::unordered_map<foeResourceID, Value> entries;
+    };
+
+    Shard shards[cShardCount];
+
+    static uint32_t getShardIndex(foeResourceID resourceID) {
+        return foeIdGetShardIndex<cShardCount>(resourceID);
+    }
+
+    Shard &getShard(foeResourceID resourceID) { return shards[getShardIndex(resourceID)]; }
+
+    /// Groups a set of IDs by their shard, so each shard only needs to be locked once
+    static void groupByShard(uint32_t count,
+                             foeResourceID const *pResourceIDs,
+                             uint32_t shardOffsets[cShardCount + 1],
+                             std::vector<uint32_t> &requests) {
+        foeIdGroupByShard<cShardCount>(count, pResourceIDs, shardOffsets, requests);
+    }
+};
+
+#endif // SHARDED_RESOURCE_MAP_HPP
@@ -7,17 +7,27 @@
 
 #include <foe/chrono/easy_clock.hpp>
 #include <foe/ecs/name_map.h>
+#include <foe/parallel_for.h>
 #include <foe/resource/resource_fns.h>
+#include <foe/task_group.h>
 
 #include "log.hpp"
 #include "result.h"
 
+#include <algorithm>
 #include <mutex>
 #include <shared_mutex>
+#include <unordered_map>
 #include <vector>
 
 namespace {
 
+struct LoaderDispatch {
+    foeSimulationStructureType sType;
+    void *pLoader;
+    void (*pLoadFn)(void *, foeResource, foeResourceCreateInfo, PFN_foeResourcePostLoad);
+};
+
 struct Simulation {
     /**
      * @brief Used to synchronize core access to the SimulationState
@@ -49,6 +59,8 @@ struct Simulation {
     foeResourceCreateInfoHistory resourceCreateInfoSessionPersistentData;
     foeResourcePool resourcePool;
     std::vector<foeSimulationLoaderData> resourceLoaders;
+    /// Loader for each registered ResourceCreateInfo type, where the earliest inserted loader wins
+    std::unordered_map<foeResourceCreateInfoType, LoaderDispatch> resourceLoaderDispatch;
 
     // Entity / Component Data
     foeEcsNameMap entityNameMap = FOE_NULL_HANDLE;
@@ -148,6 +160,28 @@ foeResourceCreateInfo getResourceCreateInfo(void *pContext, foeResourceID resour
     return FOE_NULL_HANDLE;
 }
 
+/// Adds the loader for each of its ResourceCreateInfo types that don't already have a loader
+void addResourceLoaderDispatch(Simulation *pSimulation,
+                               foeSimulationLoaderData const &loader,
+                               bool warnOnConflict) {
+    for (uint32_t i = 0; i < loader.createInfoTypeCount; ++i) {
+        auto [it, added] = pSimulation->resourceLoaderDispatch.try_emplace(
+            loader.pCreateInfoTypes[i], LoaderDispatch{
+                                            .sType = loader.sType,
+                                            .pLoader = loader.pLoader,
+                                            .pLoadFn = loader.pLoadFn,
+                                        });
+
+        if (!added && warnOnConflict && it->second.sType != loader.sType) {
+            FOE_LOG(foeSimulation, FOE_LOG_LEVEL_WARNING,
+                    "[{}] foeSimulation - Resource loader {} registered for ResourceCreateInfo "
+                    "type {}, which is already loaded by resource loader {}",
+                    (void *)pSimulation, loader.sType, loader.pCreateInfoTypes[i],
+                    it->second.sType);
+        }
+    }
+}
+
 void loadResource(void *pContext, foeResource resource, PFN_foeResourcePostLoad postLoadFn) {
     auto *pSimulation = reinterpret_cast<Simulation *>(pContext);
 
@@ -160,8 +194,18 @@ void loadResource(void *pContext, foeResource resource, PFN_foeResourcePostLoad
         return;
     }
 
+    auto searchIt =
+        pSimulation->resourceLoaderDispatch.find(foeResourceCreateInfoGetType(resourceCreateInfo));
+    if (searchIt != pSimulation->resourceLoaderDispatch.end()) {
+        searchIt->second.pLoadFn(searchIt->second.pLoader, resource, resourceCreateInfo,
+                                 postLoadFn);
+        return;
+    }
+
+    // Not a registered type, ask any loaders that can check for themselves
     for (auto const &it : pSimulation->resourceLoaders) {
-        if (it.pCanProcessCreateInfoFn(resourceCreateInfo)) {
+        if (it.pCanProcessCreateInfoFn != nullptr &&
+            it.pCanProcessCreateInfoFn(resourceCreateInfo)) {
             it.pLoadFn(it.pLoader, resource, resourceCreateInfo, postLoadFn);
             return;
         }
@@ -173,6 +217,72 @@ void loadResource(void *pContext, foeResource resource, PFN_foeResourcePostLoad
     foeResourceCreateInfoDecrementRefCount(resourceCreateInfo);
 }
 
+bool containsType(uint32_t count,
+                  foeSimulationStructureType const *pTypes,
+                  foeSimulationStructureType sType) {
+    for (uint32_t i = 0; i < count; ++i) {
+        if (pTypes[i] == sType)
+            return true;
+    }
+
+    return false;
+}
+
+/// Systems conflict if either one writes to a component pool the other one reads or writes
+bool systemsConflict(foeSimulationSystemData const &first, foeSimulationSystemData const &second) {
+    for (uint32_t i = 0; i < first.writePoolCount; ++i) {
+        if (containsType(second.readPoolCount, second.pReadPools, first.pWritePools[i]) ||
+            containsType(second.writePoolCount, second.pWritePools, first.pWritePools[i]))
+            return true;
+    }
+
+    for (uint32_t i = 0; i < second.writePoolCount; ++i) {
+        if (containsType(first.readPoolCount, first.pReadPools, second.pWritePools[i]))
+            return true;
+    }
+
+    return false;
+}
+
+struct SystemProcessData {
+    foeSimulationSystemData const *pSystemData;
+    float timeElapsed;
+    foeResultSet result;
+};
+
+void processSystemTask(void *pContext) {
+    auto *pProcessData = reinterpret_cast<SystemProcessData *>(pContext);
+
+    pProcessData->result =
+        pProcessData->pSystemData->pProcessFn(pProcessData->pSystemData->pSystem,
+                                              pProcessData->timeElapsed);
+}
+
+struct PoolMaintenanceData {
+    foeSimulationComponentPoolData const *pComponentPools;
+    uint64_t *pMaintenanceTimes;
+};
+
+void maintainComponentPools(void *pContext, size_t begin, size_t end) {
+    auto *pMaintenanceData = reinterpret_cast<PoolMaintenanceData *>(pContext);
+
+    for (size_t i = begin; i < end; ++i) {
+        auto const *pComponentPool = pMaintenanceData->pComponentPools + i;
+        uint64_t elapsed = 0;
+
+        if (pComponentPool->pMaintenanceFn) {
+            foeEasyHighResClock maintenanceTime;
+            pComponentPool->pMaintenanceFn(pComponentPool->pComponentPool);
+            maintenanceTime.update();
+
+            elapsed = maintenanceTime.elapsed<std::chrono::nanoseconds>().count();
+        }
+
+        if (pMaintenanceData->pMaintenanceTimes != nullptr)
+            pMaintenanceData->pMaintenanceTimes[i] = elapsed;
+    }
+}
+
 } // namespace
 
 extern "C" foeResultSet foeRegisterFunctionality(foeSimulationFunctionalty const *pFunctionality) {
@@ -1023,6 +1133,7 @@ extern "C" foeResultSet foeSimulationInsertResourceLoader(
     }
 
     pSimulation->resourceLoaders.emplace_back(*pCreateInfo);
+    addResourceLoaderDispatch(pSimulation, *pCreateInfo, true);
 
     return to_foeResult(FOE_SIMULATION_SUCCESS);
 }
@@ -1038,6 +1149,11 @@ extern "C" foeResultSet foeSimulationReleaseResourceLoader(foeSimulation simulat
             *ppLoader = it->pLoader;
             pSimulation->resourceLoaders.erase(it);
 
+            // Any types it had are taken over by the next loader to have registered them
+            pSimulation->resourceLoaderDispatch.clear();
+            for (auto const &loader : pSimulation->resourceLoaders)
+                addResourceLoaderDispatch(pSimulation, loader, false);
+
             return to_foeResult(FOE_SIMULATION_SUCCESS);
         }
     }
@@ -1113,6 +1229,84 @@ extern "C" foeResultSet foeSimulationReleaseSystem(foeSimulation simulation,
     return to_foeResult(FOE_SIMULATION_ERROR_TYPE_NOT_FOUND);
 }
 
+extern "C" foeResultSet foeSimulationProcessSystems(foeSimulation simulation,
+                                                    foeSplitThreadPool threadPool,
+                                                    float timeElapsed) {
+    Simulation *pSimulation = simulation_from_handle(simulation);
+    std::shared_lock lock{pSimulation->simSync};
+
+    size_t const systemCount = pSimulation->systems.size();
+    std::vector<SystemProcessData> processData(systemCount);
+    std::vector<foeTaskGroup> taskGroups(systemCount, FOE_NULL_HANDLE);
+    foeResultSet result = to_foeResult(FOE_SIMULATION_SUCCESS);
+
+    // Each system is its own task group, depending on any earlier conflicting systems
+    for (size_t i = 0; i < systemCount; ++i) {
+        foeSimulationSystemData const &system = pSimulation->systems[i];
+        if (system.pProcessFn == nullptr)
+            continue;
+
+        processData[i] = SystemProcessData{
+            .pSystemData = &system,
+            .timeElapsed = timeElapsed,
+            .result = to_foeResult(FOE_SIMULATION_SUCCESS),
+        };
+
+        result = foeCreateTaskGroup(threadPool, &taskGroups[i]);
+        if (result.value != FOE_SUCCESS)
+            break;
+
+        for (size_t j = 0; j < i; ++j) {
+            if (taskGroups[j] != FOE_NULL_HANDLE &&
+                systemsConflict(pSimulation->systems[j], system)) {
+                result = foeTaskGroupAddDependency(taskGroups[i], taskGroups[j]);
+                if (result.value != FOE_SUCCESS)
+                    break;
+            }
+        }
+        if (result.value != FOE_SUCCESS)
+            break;
+
+        result = foeTaskGroupScheduleSyncTask(taskGroups[i], processSystemTask, &processData[i]);
+        if (result.value != FOE_SUCCESS)
+            break;
+
+        foeTaskGroupClose(taskGroups[i]);
+    }
+
+    // Destroying waits for completion
+    for (auto taskGroup : taskGroups) {
+        if (taskGroup != FOE_NULL_HANDLE)
+            foeDestroyTaskGroup(taskGroup);
+    }
+
+    if (result.value != FOE_SUCCESS)
+        return result;
+
+    for (auto const &it : processData) {
+        if (it.pSystemData != nullptr && it.result.value != FOE_SUCCESS)
+            return it.result;
+    }
+
+    return to_foeResult(FOE_SIMULATION_SUCCESS);
+}
+
+extern "C" foeResultSet foeSimulationMaintainComponentPools(foeSimulation simulation,
+                                                            foeSplitThreadPool threadPool,
+                                                            uint64_t *pMaintenanceTimes) {
+    Simulation *pSimulation = simulation_from_handle(simulation);
+    std::shared_lock lock{pSimulation->simSync};
+
+    PoolMaintenanceData maintenanceData{
+        .pComponentPools = pSimulation->componentPools.data(),
+        .pMaintenanceTimes = pMaintenanceTimes,
+    };
+
+    // Each pool is a single item, with maintenance costs varying too widely to batch them
+    return foeParallelFor(threadPool, 0, pSimulation->componentPools.size(), 1,
+                          maintainComponentPools, &maintenanceData);
+}
+
 extern "C" foeResultSet foeSimulationGetResourceCreateInfo(foeSimulation simulation,
                                                            foeResourceID resourceID,
                                                            foeResourceCreateInfo *pResourceCI) {
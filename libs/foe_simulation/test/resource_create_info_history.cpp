@@ -0,0 +1,95 @@
+// Copyright (C) 2026 George Cave.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <catch2/catch_test_macros.hpp>
+#include <foe/simulation/resource_create_info_history.h>
+#include <foe/simulation/result.h>
+
+#include <vector>
+
+namespace {
+
+foeResourceCreateInfo createTestCreateInfo() {
+    int data = 0;
+    foeResourceCreateInfo createInfo{FOE_NULL_HANDLE};
+    foeCreateResourceCreateInfo(
+        0, nullptr, sizeof(int), &data, [](void *pSrc, void *pDst) { *(int *)pDst = *(int *)pSrc; },
+        &createInfo);
+
+    return createInfo;
+}
+
+} // namespace
+
+TEST_CASE("foeResourceCreateInfoHistory - Adding, getting and removing") {
+    foeResourceCreateInfoHistory history{FOE_NULL_HANDLE};
+    REQUIRE(foeCreateResourceCreateInfoHistory(&history).value == FOE_SIMULATION_SUCCESS);
+
+    foeResourceCreateInfo createInfo = createTestCreateInfo();
+    REQUIRE(createInfo != FOE_NULL_HANDLE);
+
+    foeResourceID resourceID = foeIdCreate(foeIdPersistentGroup, 1);
+
+    CHECK(foeResourceCreateInfoHistoryCurrent(history, resourceID) == FOE_NULL_HANDLE);
+    CHECK(foeResourceCreateInfoHistoryRemove(history, resourceID).value ==
+          FOE_SIMULATION_ERROR_RESOURCE_CREATE_INFO_NOT_FOUND);
+    CHECK(foeResourceCreateInfoHistoryUndo(history, resourceID).value ==
+          FOE_SIMULATION_ERROR_RESOURCE_CREATE_INFO_NOT_FOUND);
+
+    CHECK(foeResourceCreateInfoHistoryAdd(history, resourceID, createInfo).value ==
+          FOE_SIMULATION_SUCCESS);
+    CHECK(foeResourceCreateInfoHistoryAdd(history, resourceID, createInfo).value ==
+          FOE_SIMULATION_ERROR_RESOURCE_CREATE_INFO_ALREADY_ADDED);
+    CHECK(foeResourceCreateInfoGetRefCount(createInfo) == 2);
+
+    foeResourceCreateInfo currentCreateInfo =
+        foeResourceCreateInfoHistoryCurrent(history, resourceID);
+    CHECK(currentCreateInfo == createInfo);
+    CHECK(foeResourceCreateInfoDecrementRefCount(currentCreateInfo) == 2);
+
+    // Only one entry in the history, nowhere to go
+    CHECK(foeResourceCreateInfoHistoryUndo(history, resourceID).value ==
+          FOE_SIMULATION_CANNOT_UNDO);
+    CHECK(foeResourceCreateInfoHistoryRedo(history, resourceID).value ==
+          FOE_SIMULATION_CANNOT_REDO);
+
+    SECTION("Removing") {
+        CHECK(foeResourceCreateInfoHistoryRemove(history, resourceID).value ==
+              FOE_SIMULATION_SUCCESS);
+        CHECK(foeResourceCreateInfoGetRefCount(createInfo) == 1);
+        CHECK(foeResourceCreateInfoHistoryCurrent(history, resourceID) == FOE_NULL_HANDLE);
+    }
+
+    foeDestroyResourceCreateInfoHistory(history);
+    CHECK(foeResourceCreateInfoDecrementRefCount(createInfo) == 0);
+}
+
+TEST_CASE("foeResourceCreateInfoHistory - Adding many at once") {
+    foeResourceCreateInfoHistory history{FOE_NULL_HANDLE};
+    REQUIRE(foeCreateResourceCreateInfoHistory(&history).value == FOE_SIMULATION_SUCCESS);
+
+    foeResourceCreateInfo createInfo = createTestCreateInfo();
+    REQUIRE(createInfo != FOE_NULL_HANDLE);
+
+    std::vector<foeResourceID> ids;
+    for (foeIdIndex index = 1; index <= 300; ++index)
+        ids.emplace_back(foeIdCreate(foeIdPersistentGroup, index));
+    // Duplicates within the set are only added once
+    ids.emplace_back(ids[20]);
+    std::vector<foeResourceCreateInfo> createInfos(ids.size(), createInfo);
+
+    CHECK(foeResourceCreateInfoHistoryAddMany(history, (uint32_t)ids.size(), ids.data(),
+                                              createInfos.data())
+              .value == FOE_SIMULATION_ERROR_RESOURCE_CREATE_INFO_ALREADY_ADDED);
+    CHECK(foeResourceCreateInfoGetRefCount(createInfo) == 301);
+
+    for (auto id : ids) {
+        foeResourceCreateInfo currentCreateInfo = foeResourceCreateInfoHistoryCurrent(history, id);
+        CHECK(currentCreateInfo == createInfo);
+        foeResourceCreateInfoDecrementRefCount(currentCreateInfo);
+    }
+
+    foeDestroyResourceCreateInfoHistory(history);
+    CHECK(foeResourceCreateInfoDecrementRefCount(createInfo) == 0);
+}
@@ -0,0 +1,148 @@
+// Copyright (C) 2026 George Cave.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <foe/simulation/resource_create_info_pool.h>
+#include <foe/simulation/result.h>
+
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+foeResourceCreateInfo createTestCreateInfo() {
+    int data = 0;
+    foeResourceCreateInfo createInfo{FOE_NULL_HANDLE};
+    foeCreateResourceCreateInfo(
+        0, nullptr, sizeof(int), &data, [](void *pSrc, void *pDst) { *(int *)pDst = *(int *)pSrc; },
+        &createInfo);
+
+    return createInfo;
+}
+
+} // namespace
+
+TEST_CASE("foeResourceCreateInfoPool - Adding, getting and removing") {
+    foeResourceCreateInfoPool pool{FOE_NULL_HANDLE};
+    REQUIRE(foeCreateResourceCreateInfoPool(&pool).value == FOE_SIMULATION_SUCCESS);
+
+    foeResourceCreateInfo createInfo = createTestCreateInfo();
+    REQUIRE(createInfo != FOE_NULL_HANDLE);
+
+    foeResourceID resourceID = foeIdCreate(foeIdPersistentGroup, 1);
+
+    CHECK(foeResourceCreateInfoPoolGet(pool, resourceID) == FOE_NULL_HANDLE);
+    CHECK(foeResourceCreateInfoPoolRemove(pool, resourceID).value ==
+          FOE_SIMULATION_ERROR_RESOURCE_CREATE_INFO_NOT_FOUND);
+
+    CHECK(foeResourceCreateInfoPoolAdd(pool, resourceID, createInfo).value ==
+          FOE_SIMULATION_SUCCESS);
+    CHECK(foeResourceCreateInfoGetRefCount(createInfo) == 2);
+    CHECK(foeResourceCreateInfoPoolAdd(pool, resourceID, createInfo).value ==
+          FOE_SIMULATION_ERROR_RESOURCE_CREATE_INFO_ALREADY_ADDED);
+    CHECK(foeResourceCreateInfoGetRefCount(createInfo) == 2);
+
+    foeResourceCreateInfo foundCreateInfo = foeResourceCreateInfoPoolGet(pool, resourceID);
+    CHECK(foundCreateInfo == createInfo);
+    CHECK(foeResourceCreateInfoDecrementRefCount(foundCreateInfo) == 2);
+
+    SECTION("Removing") {
+        CHECK(foeResourceCreateInfoPoolRemove(pool, resourceID).value == FOE_SIMULATION_SUCCESS);
+        CHECK(foeResourceCreateInfoGetRefCount(createInfo) == 1);
+        CHECK(foeResourceCreateInfoPoolGet(pool, resourceID) == FOE_NULL_HANDLE);
+    }
+
+    foeDestroyResourceCreateInfoPool(pool);
+    CHECK(foeResourceCreateInfoDecrementRefCount(createInfo) == 0);
+}
+
+TEST_CASE("foeResourceCreateInfoPool - Adding many at once") {
+    foeResourceCreateInfoPool pool{FOE_NULL_HANDLE};
+    REQUIRE(foeCreateResourceCreateInfoPool(&pool).value == FOE_SIMULATION_SUCCESS);
+
+    foeResourceCreateInfo createInfo = createTestCreateInfo();
+    REQUIRE(createInfo != FOE_NULL_HANDLE);
+
+    std::vector<foeResourceID> ids;
+    for (foeIdIndex index = 1; index <= 300; ++index)
+        ids.emplace_back(foeIdCreate(foeIdPersistentGroup, index));
+    std::vector<foeResourceCreateInfo> createInfos(ids.size(), createInfo);
+
+    CHECK(foeResourceCreateInfoPoolAdd(pool, ids[10], createInfo).value == FOE_SIMULATION_SUCCESS);
+
+    // One is already in the pool, but the rest are still added
+    CHECK(foeResourceCreateInfoPoolAddMany(pool, (uint32_t)ids.size(), ids.data(),
+                                           createInfos.data())
+              .value == FOE_SIMULATION_ERROR_RESOURCE_CREATE_INFO_ALREADY_ADDED);
+    CHECK(foeResourceCreateInfoGetRefCount(createInfo) == 301);
+
+    for (auto id : ids) {
+        foeResourceCreateInfo foundCreateInfo = foeResourceCreateInfoPoolGet(pool, id);
+        CHECK(foundCreateInfo == createInfo);
+        foeResourceCreateInfoDecrementRefCount(foundCreateInfo);
+    }
+
+    foeDestroyResourceCreateInfoPool(pool);
+    CHECK(foeResourceCreateInfoDecrementRefCount(createInfo) == 0);
+}
+
+TEST_CASE("foeResourceCreateInfoPool - Getting create infos across threads", "[.][benchmark]") {
+    constexpr int threadCount = 16;
+    constexpr foeIdIndex createInfoCount = 500000;
+
+    foeResourceCreateInfo createInfo = createTestCreateInfo();
+    REQUIRE(createInfo != FOE_NULL_HANDLE);
+
+    std::vector<foeResourceID> ids;
+    for (foeIdIndex index = 1; index <= createInfoCount; ++index)
+        ids.emplace_back(foeIdCreate(foeIdPersistentGroup, index));
+    std::shuffle(ids.begin(), ids.end(), std::mt19937{42});
+    std::vector<foeResourceCreateInfo> createInfos(ids.size(), createInfo);
+
+    BENCHMARK("Adding 500k create infos one at a time") {
+        foeResourceCreateInfoPool addPool{FOE_NULL_HANDLE};
+        foeCreateResourceCreateInfoPool(&addPool);
+
+        for (auto id : ids)
+            foeResourceCreateInfoPoolAdd(addPool, id, createInfo);
+
+        foeDestroyResourceCreateInfoPool(addPool);
+    };
+
+    BENCHMARK("Adding 500k create infos at once") {
+        foeResourceCreateInfoPool addPool{FOE_NULL_HANDLE};
+        foeCreateResourceCreateInfoPool(&addPool);
+
+        foeResourceCreateInfoPoolAddMany(addPool, (uint32_t)ids.size(), ids.data(),
+                                         createInfos.data());
+
+        foeDestroyResourceCreateInfoPool(addPool);
+    };
+
+    foeResourceCreateInfoPool pool{FOE_NULL_HANDLE};
+    REQUIRE(foeCreateResourceCreateInfoPool(&pool).value == FOE_SIMULATION_SUCCESS);
+    REQUIRE(foeResourceCreateInfoPoolAddMany(pool, (uint32_t)ids.size(), ids.data(),
+                                             createInfos.data())
+                .value == FOE_SIMULATION_SUCCESS);
+
+    BENCHMARK("16 threads getting 500k create infos each") {
+        std::thread threads[threadCount];
+        for (int i = 0; i < threadCount; ++i) {
+            threads[i] = std::thread([&, i] {
+                for (foeIdIndex j = 0; j < createInfoCount; ++j) {
+                    foeResourceID id = ids[(j + i * 31247) % createInfoCount];
+                    foeResourceCreateInfoDecrementRefCount(foeResourceCreateInfoPoolGet(pool, id));
+                }
+            });
+        }
+        for (auto &thread : threads)
+            thread.join();
+    };
+
+    foeDestroyResourceCreateInfoPool(pool);
+    CHECK(foeResourceCreateInfoDecrementRefCount(createInfo) == 0);
+}
@@ -2,15 +2,96 @@
 //
 // SPDX-License-Identifier: Apache-2.0
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <foe/resource/create_info.h>
+#include <foe/resource/pool.h>
+#include <foe/resource/resource.h>
 #include <foe/simulation/registration.h>
 #include <foe/simulation/result.h>
 #include <foe/simulation/simulation.h>
+#include <foe/split_thread_pool.h>
 #include <foe/type_defs.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+
 namespace {
 foeResultSet pCreateFn(foeSimulation) { return {}; }
 size_t pDestroyFn(foeSimulation) { return 0; }
+
+struct TestSystem {
+    std::atomic_int *pSequence;
+    int processedAt;
+    foeResultSet result;
+};
+
+foeResultSet processTestSystem(void *pSystem, float) {
+    TestSystem *pTestSystem = (TestSystem *)pSystem;
+    pTestSystem->processedAt = (*pTestSystem->pSequence)++;
+
+    return pTestSystem->result;
+}
+
+struct EntityWorkSystem {
+    std::vector<float> const *pInput;
+    std::vector<float> *pOutput;
+};
+
+foeResultSet processEntityWorkSystem(void *pSystem, float timeElapsed) {
+    EntityWorkSystem *pWorkSystem = (EntityWorkSystem *)pSystem;
+
+    size_t const count = pWorkSystem->pOutput->size();
+    for (size_t i = 0; i < count; ++i) {
+        float value = (*pWorkSystem->pInput)[i];
+        for (int j = 0; j < 16; ++j)
+            value = std::sin(value + timeElapsed);
+        (*pWorkSystem->pOutput)[i] = value;
+    }
+
+    return {};
+}
+
+void maintainTestPool(void *pComponentPool) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    ++(*(std::atomic_int *)pComponentPool);
+}
+
+struct TestLoader {
+    std::vector<foeResourceCreateInfoType> loadedTypes;
+};
+
+bool canProcessTestCreateInfo(foeResourceCreateInfo createInfo) {
+    return foeResourceCreateInfoGetType(createInfo) == 13;
+}
+
+void loadTestResource(void *pLoader,
+                      foeResource resource,
+                      foeResourceCreateInfo createInfo,
+                      PFN_foeResourcePostLoad postLoadFn) {
+    TestLoader *pTestLoader = (TestLoader *)pLoader;
+    pTestLoader->loadedTypes.emplace_back(foeResourceCreateInfoGetType(createInfo));
+
+    // Only which loader was used matters, so every load fails
+    foeResultSet result{
+        .value = FOE_SIMULATION_ERROR_NO_LOADER_FOUND,
+        .toString = (PFN_foeResultToString)foeSimulationResultToString,
+    };
+    postLoadFn(resource, result, nullptr, nullptr, nullptr, nullptr);
+    foeResourceCreateInfoDecrementRefCount(createInfo);
+}
+
+foeSimulationStructureType const cPoolA = 1;
+foeSimulationStructureType const cPoolB = 2;
+foeSimulationStructureType const cPoolC = 3;
+foeSimulationStructureType const cPoolD = 4;
+
 } // namespace
 
 constexpr foeSimulationUUID cTestFunctionalityID = FOE_PLUGIN_ID(0);
@@ -92,3 +173,301 @@ TEST_CASE("SimState - EditorNameMap created when addNameMaps set to true", "[foe
 
     REQUIRE(foeDestroySimulation(testSimulation).value == FOE_SUCCESS);
 }
+
+TEST_CASE("SimState - Processing systems with declared pool access", "[foe][simulation]") {
+    foeSimulation testSimulation{FOE_NULL_HANDLE};
+    foeSplitThreadPool threadPool{FOE_NULL_HANDLE};
+
+    REQUIRE(foeCreateSimulation(false, &testSimulation).value == FOE_SUCCESS);
+    REQUIRE(foeCreateThreadPool(2, 1, &threadPool).value == FOE_SUCCESS);
+
+    std::atomic_int sequence = 0;
+    TestSystem writeA{.pSequence = &sequence, .processedAt = -1, .result = {}};
+    TestSystem writeB{.pSequence = &sequence, .processedAt = -1, .result = {}};
+    TestSystem readAB{.pSequence = &sequence, .processedAt = -1, .result = {}};
+
+    // A and B are independent, the last reads what both write so must be after both
+    foeSimulationSystemData systems[] = {
+        {
+            .sType = 100,
+            .pSystem = &writeA,
+            .pProcessFn = processTestSystem,
+            .writePoolCount = 1,
+            .pWritePools = &cPoolA,
+        },
+        {
+            .sType = 101,
+            .pSystem = &writeB,
+            .pProcessFn = processTestSystem,
+            .writePoolCount = 1,
+            .pWritePools = &cPoolB,
+        },
+        {
+            .sType = 102,
+            .pSystem = &readAB,
+            .pProcessFn = processTestSystem,
+            .readPoolCount = 1,
+            .pReadPools = &cPoolA,
+            .writePoolCount = 1,
+            .pWritePools = &cPoolB,
+        },
+    };
+
+    for (auto const &it : systems)
+        REQUIRE(foeSimulationInsertSystem(testSimulation, &it).value == FOE_SUCCESS);
+
+    SECTION("Conflicting systems are processed after the earlier ones") {
+        REQUIRE(foeSimulationProcessSystems(testSimulation, threadPool, 0.f).value ==
+                FOE_SUCCESS);
+
+        CHECK(writeA.processedAt >= 0);
+        CHECK(writeB.processedAt >= 0);
+        CHECK(readAB.processedAt == 2);
+    }
+
+    SECTION("A failing system's result is returned, with the others still processed") {
+        writeB.result = foeResultSet{
+            .value = FOE_SIMULATION_ERROR_OUT_OF_MEMORY,
+            .toString = (PFN_foeResultToString)foeSimulationResultToString,
+        };
+
+        CHECK(foeSimulationProcessSystems(testSimulation, threadPool, 0.f).value ==
+              FOE_SIMULATION_ERROR_OUT_OF_MEMORY);
+
+        CHECK(writeA.processedAt >= 0);
+        CHECK(readAB.processedAt == 2);
+    }
+
+    for (auto const &it : systems) {
+        void *pSystem;
+        REQUIRE(foeSimulationReleaseSystem(testSimulation, it.sType, &pSystem).value ==
+                FOE_SUCCESS);
+    }
+
+    foeDestroyThreadPool(threadPool);
+    REQUIRE(foeDestroySimulation(testSimulation).value == FOE_SUCCESS);
+}
+
+TEST_CASE("SimState - Frame time of processing systems", "[.][benchmark]") {
+    constexpr size_t cEntityCount = 100000;
+
+    foeSimulation testSimulation{FOE_NULL_HANDLE};
+    foeSplitThreadPool threadPool{FOE_NULL_HANDLE};
+
+    REQUIRE(foeCreateSimulation(false, &testSimulation).value == FOE_SUCCESS);
+    REQUIRE(foeCreateThreadPool(std::max(std::thread::hardware_concurrency(), 2U) - 1, 1,
+                                &threadPool)
+                .value == FOE_SUCCESS);
+
+    // Three independent 'simulation' systems, and a fourth 'render' reading all of their output
+    std::vector<float> input(cEntityCount, 1.f);
+    std::vector<float> outputs[4] = {
+        std::vector<float>(cEntityCount),
+        std::vector<float>(cEntityCount),
+        std::vector<float>(cEntityCount),
+        std::vector<float>(cEntityCount),
+    };
+    EntityWorkSystem workSystems[4] = {
+        {.pInput = &input, .pOutput = &outputs[0]},
+        {.pInput = &input, .pOutput = &outputs[1]},
+        {.pInput = &input, .pOutput = &outputs[2]},
+        {.pInput = &outputs[0], .pOutput = &outputs[3]},
+    };
+    foeSimulationStructureType const renderReadPools[] = {cPoolA, cPoolB, cPoolC};
+
+    foeSimulationSystemData systems[] = {
+        {
+            .sType = 100,
+            .pSystem = &workSystems[0],
+            .pProcessFn = processEntityWorkSystem,
+            .writePoolCount = 1,
+            .pWritePools = &cPoolA,
+        },
+        {
+            .sType = 101,
+            .pSystem = &workSystems[1],
+            .pProcessFn = processEntityWorkSystem,
+            .writePoolCount = 1,
+            .pWritePools = &cPoolB,
+        },
+        {
+            .sType = 102,
+            .pSystem = &workSystems[2],
+            .pProcessFn = processEntityWorkSystem,
+            .writePoolCount = 1,
+            .pWritePools = &cPoolC,
+        },
+        {
+            .sType = 103,
+            .pSystem = &workSystems[3],
+            .pProcessFn = processEntityWorkSystem,
+            .readPoolCount = 3,
+            .pReadPools = renderReadPools,
+            .writePoolCount = 1,
+            .pWritePools = &cPoolD,
+        },
+    };
+
+    for (auto const &it : systems)
+        REQUIRE(foeSimulationInsertSystem(testSimulation, &it).value == FOE_SUCCESS);
+
+    std::string const entityStr = std::to_string(cEntityCount) + " entities";
+
+    BENCHMARK("Serial - " + entityStr) {
+        for (auto const &it : systems)
+            it.pProcessFn(it.pSystem, 0.016f);
+    };
+
+    BENCHMARK("Scheduled - " + entityStr) {
+        return foeSimulationProcessSystems(testSimulation, threadPool, 0.016f);
+    };
+
+    for (auto const &it : systems) {
+        void *pSystem;
+        REQUIRE(foeSimulationReleaseSystem(testSimulation, it.sType, &pSystem).value ==
+                FOE_SUCCESS);
+    }
+
+    foeDestroyThreadPool(threadPool);
+    REQUIRE(foeDestroySimulation(testSimulation).value == FOE_SUCCESS);
+}
+
+TEST_CASE("SimState - Maintaining component pools", "[foe][simulation]") {
+    foeSimulation testSimulation{FOE_NULL_HANDLE};
+    foeSplitThreadPool threadPool{FOE_NULL_HANDLE};
+
+    REQUIRE(foeCreateSimulation(false, &testSimulation).value == FOE_SUCCESS);
+    REQUIRE(foeCreateThreadPool(2, 1, &threadPool).value == FOE_SUCCESS);
+
+    std::atomic_int maintenanceCounts[8] = {};
+    for (int i = 0; i < 8; ++i) {
+        foeSimulationComponentPoolData componentPoolData{
+            .sType = 100 + i,
+            .pComponentPool = &maintenanceCounts[i],
+            // The last pool has no maintenance
+            .pMaintenanceFn = (i != 7) ? maintainTestPool : nullptr,
+        };
+
+        REQUIRE(foeSimulationInsertComponentPool(testSimulation, &componentPoolData).value ==
+                FOE_SUCCESS);
+    }
+
+    SECTION("Without timing") {
+        REQUIRE(foeSimulationMaintainComponentPools(testSimulation, threadPool, nullptr).value ==
+                FOE_SUCCESS);
+    }
+
+    SECTION("With timing") {
+        uint64_t maintenanceTimes[8];
+        std::fill_n(maintenanceTimes, 8, UINT64_MAX);
+
+        REQUIRE(foeSimulationMaintainComponentPools(testSimulation, threadPool, maintenanceTimes)
+                    .value == FOE_SUCCESS);
+
+        for (int i = 0; i < 7; ++i)
+            CHECK(maintenanceTimes[i] >= 1000000);
+        CHECK(maintenanceTimes[7] == 0);
+    }
+
+    for (int i = 0; i < 7; ++i)
+        CHECK(maintenanceCounts[i] == 1);
+    CHECK(maintenanceCounts[7] == 0);
+
+    for (int i = 0; i < 8; ++i) {
+        void *pComponentPool;
+        REQUIRE(foeSimulationReleaseComponentPool(testSimulation, 100 + i, &pComponentPool).value ==
+                FOE_SUCCESS);
+    }
+
+    foeDestroyThreadPool(threadPool);
+    REQUIRE(foeDestroySimulation(testSimulation).value == FOE_SUCCESS);
+}
+
+TEST_CASE("SimState - Resources are loaded by the loader registered for their create info type",
+          "[foe][simulation]") {
+    foeSimulation testSimulation{FOE_NULL_HANDLE};
+
+    REQUIRE(foeCreateSimulation(false, &testSimulation).value == FOE_SUCCESS);
+
+    // Types 10 and 11 go to the first loader, 12 to the second as its registration of 11 conflicts,
+    // and 13 to the third which has no registered types and checks for itself
+    foeResourceCreateInfoType const cFirstTypes[] = {10, 11};
+    foeResourceCreateInfoType const cSecondTypes[] = {11, 12};
+    TestLoader loaders[3];
+
+    foeSimulationLoaderData loaderData[3] = {
+        {
+            .sType = 200,
+            .pLoader = &loaders[0],
+            .createInfoTypeCount = 2,
+            .pCreateInfoTypes = cFirstTypes,
+            .pLoadFn = loadTestResource,
+        },
+        {
+            .sType = 201,
+            .pLoader = &loaders[1],
+            .createInfoTypeCount = 2,
+            .pCreateInfoTypes = cSecondTypes,
+            .pLoadFn = loadTestResource,
+        },
+        {
+            .sType = 202,
+            .pLoader = &loaders[2],
+            .pCanProcessCreateInfoFn = canProcessTestCreateInfo,
+            .pLoadFn = loadTestResource,
+        },
+    };
+
+    for (auto const &it : loaderData)
+        REQUIRE(foeSimulationInsertResourceLoader(testSimulation, &it).value == FOE_SUCCESS);
+
+    foeResource resources[4];
+    for (uint32_t i = 0; i < 4; ++i) {
+        foeResourceID resourceID = foeIdCreate(foeIdValueToGroup(1), i + 1);
+        foeResourceCreateInfo createInfo{FOE_NULL_HANDLE};
+
+        REQUIRE(foeCreateResourceCreateInfo(10 + i, nullptr, 0, nullptr, [](void *, void *) {},
+                                            &createInfo)
+                    .value == FOE_SUCCESS);
+        REQUIRE(foeResourceCreateInfoPoolAdd(
+                    foeSimulationGetSavedBaseDataResourceCreateInfoPool(testSimulation),
+                    resourceID, createInfo)
+                    .value == FOE_SUCCESS);
+        foeResourceCreateInfoDecrementRefCount(createInfo);
+
+        resources[i] = foeResourcePoolFindOrAdd(foeSimulationGetResourcePool(testSimulation),
+                                                resourceID);
+        REQUIRE(resources[i] != FOE_NULL_HANDLE);
+    }
+
+    for (foeResource resource : resources)
+        foeResourceLoadData(resource);
+
+    CHECK(loaders[0].loadedTypes == std::vector<foeResourceCreateInfoType>{10, 11});
+    CHECK(loaders[1].loadedTypes == std::vector<foeResourceCreateInfoType>{12});
+    CHECK(loaders[2].loadedTypes == std::vector<foeResourceCreateInfoType>{13});
+
+    SECTION("Releasing a loader passes its conflicting types to the other loader") {
+        void *pLoader;
+        REQUIRE(foeSimulationReleaseResourceLoader(testSimulation, 200, &pLoader).value ==
+                FOE_SUCCESS);
+        CHECK(pLoader == &loaders[0]);
+
+        foeResourceLoadData(resources[0]);
+        foeResourceLoadData(resources[1]);
+
+        CHECK(loaders[0].loadedTypes.size() == 2);
+        CHECK(loaders[1].loadedTypes == std::vector<foeResourceCreateInfoType>{12, 11});
+        CHECK((foeResourceGetState(resources[0]) & FOE_RESOURCE_STATE_FAILED_BIT) != 0);
+    }
+
+    for (foeResource resource : resources)
+        foeResourceDecrementRefCount(resource);
+
+    for (auto const &it : loaderData) {
+        void *pLoader;
+        foeSimulationReleaseResourceLoader(testSimulation, it.sType, &pLoader);
+    }
+
+    REQUIRE(foeDestroySimulation(testSimulation).value == FOE_SUCCESS);
+}
@@ -6,6 +6,7 @@
 
 #include <MagickCore/MagickCore.h>
 #include <foe/chrono/dilated_long_clock.hpp>
+#include <foe/chrono/easy_clock.hpp>
 #include <foe/chrono/program_clock.hpp>
 #include <foe/graphics/vk/render_graph.hpp>
 #include <foe/graphics/vk/render_graph/job/blit_image.hpp>
@@ -22,8 +23,6 @@
 #include <foe/graphics/vk/sample_count.h>
 #include <foe/graphics/vk/session.h>
 #include <foe/imex/exporters.h>
-#include <foe/physics/system.h>
-#include <foe/physics/type_defs.h>
 #include <foe/quaternion_math.hpp>
 
 #include "graphics.hpp"
@@ -32,7 +31,6 @@
 #include "register_basic_functionality.h"
 #include "render_graph/render_scene.hpp"
 #include "render_to_file.hpp"
-#include "simulation/animated_bone_system.h"
 #include "simulation/armature_state.h"
 #include "simulation/render_system.hpp"
 #include "simulation/type_defs.h"
@@ -145,11 +143,27 @@ int Application::initialize(int argc, char **argv) {
         return retVal;
     }
 
-    result = foeCreateThreadPool(1, 1, &threadPool);
+    // Unless set, the sync threads take up whatever hardware threads the async ones don't, so that
+    // work spread over them, such as importing state, scales with the number of cores
+    uint32_t syncThreads = settings.general.syncThreads;
+    if (syncThreads == 0) {
+        uint32_t const hardwareThreads = std::thread::hardware_concurrency();
+        syncThreads = (hardwareThreads > settings.general.asyncThreads)
+                          ? hardwareThreads - settings.general.asyncThreads
+                          : 1;
+    }
+
+    result = foeCreateThreadPool(syncThreads, settings.general.asyncThreads, &threadPool);
     if (result.value != FOE_SUCCESS)
         ERRC_END_PROGRAM
 
-    result = importState("persistent", &searchPaths, &simulation);
+    FOE_LOG(foeSkunkworks, FOE_LOG_LEVEL_INFO,
+            "Created thread pool with {} sync and {} async threads", syncThreads,
+            settings.general.asyncThreads)
+
+    foeEasySteadyClock importClock;
+    result = importState("persistent", &searchPaths, threadPool, &simulation);
+    importClock.update();
     if (result.value != FOE_SUCCESS) {
         char buffer[FOE_MAX_RESULT_STRING_SIZE];
         result.toString(result.value, buffer);
@@ -159,6 +173,9 @@ int Application::initialize(int argc, char **argv) {
         return result.value;
     }
 
+    FOE_LOG(foeSkunkworks, FOE_LOG_LEVEL_INFO, "Imported '{}' state in {}ms", "persistent",
+            importClock.elapsed<std::chrono::milliseconds>().count())
+
 #ifdef EDITOR_MODE
     auto *pImGuiContext = ImGui::CreateContext();
 
@@ -556,6 +573,14 @@ int Application::initialize(int argc, char **argv) {
 
         foeResourcePoolSetAsyncTaskCallback(foeSimulationGetResourcePool(simulation),
                                             (void *)threadPool, asyncTaskFunc);
+
+        auto toBytes = [](uint64_t megabytes) -> uint64_t {
+            return (megabytes == UINT64_MAX) ? UINT64_MAX : megabytes * 1024 * 1024;
+        };
+
+        foeResourcePoolSetMemoryBudget(foeSimulationGetResourcePool(simulation),
+                                       toBytes(settings.resources.cpuMemoryBudget),
+                                       toBytes(settings.resources.gpuMemoryBudget));
     }
 
 #ifdef FOE_SUPPORT_XR
@@ -732,7 +757,7 @@ int Application::mainloop() {
             // if constexpr (false) {
             //     // Import the desired content
             //     foeSimulation *tempSimulation = nullptr;
-            //     result = importState("theDataA", &searchPaths, &tempSimulation);
+            //     result = importState("theDataA", &searchPaths, threadPool, &tempSimulation);
             //     if (result.value != FOE_SUCCESS)
             //         std::abort();
 
@@ -782,15 +807,7 @@ int Application::mainloop() {
         }
 
         // Component Pool Maintenance
-        size_t componentPoolCount;
-        foeSimulationComponentPoolData *pComponentPools;
-        foeSimulationGetComponentPools(simulation, &componentPoolCount, &pComponentPools);
-        for (size_t i = 0; i < componentPoolCount; ++i) {
-            foeSimulationComponentPoolData *pComponentPool = pComponentPools + i;
-            if (pComponentPool->pMaintenanceFn) {
-                pComponentPool->pMaintenanceFn(pComponentPool->pComponentPool);
-            }
-        }
+        foeSimulationMaintainComponentPools(simulation, threadPool, nullptr);
 
         // Resource Loader Maintenance
         size_t resourceLoaderCount;
@@ -803,18 +820,13 @@ int Application::mainloop() {
             }
         }
 
-        // Process systems
-        foeProcessAnimatedBoneSystem(
-            (foeAnimatedBoneSystem)foeSimulationGetSystem(
-                simulation, FOE_SKUNKWORKS_STRUCTURE_TYPE_ANIMATED_BONE_SYSTEM),
-            timeElapsedInSec);
-
-        foePhysicsProcessSystem((foePhysicsSystem)foeSimulationGetSystem(
-                                    simulation, FOE_PHYSICS_STRUCTURE_TYPE_PHYSICS_SYSTEM),
-                                timeElapsedInSec);
+        // Unload the least recently used resources while over the memory budget, if there is one
+        if (settings.resources.cpuMemoryBudget != UINT64_MAX ||
+            settings.resources.gpuMemoryBudget != UINT64_MAX)
+            foeResourcePoolEnforceMemoryBudget(foeSimulationGetResourcePool(simulation));
 
-        foeProcessRenderSystem((foeRenderSystem)foeSimulationGetSystem(
-            simulation, FOE_SKUNKWORKS_STRUCTURE_TYPE_RENDER_SYSTEM));
+        // Process systems, non-conflicting ones run concurrently
+        foeSimulationProcessSystems(simulation, threadPool, timeElapsedInSec);
 
         // Process Window Events
 #ifdef FOE_SKUNKWORKS_GLFW
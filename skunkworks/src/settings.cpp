@@ -38,6 +38,8 @@ bool parseEngineConfigFile(Settings *pOptions,
         if (auto generalNode = config["general"]; generalNode) {
             try {
                 yaml_read_bool("enableWindows", generalNode, pOptions->general.enableWindows);
+                yaml_read_uint32_t("syncThreads", generalNode, pOptions->general.syncThreads);
+                yaml_read_uint32_t("asyncThreads", generalNode, pOptions->general.asyncThreads);
             } catch (foeYamlException const &e) {
                 throw foeYamlException{"general::" + e.whatStr()};
             }
@@ -94,6 +96,18 @@ bool parseEngineConfigFile(Settings *pOptions,
             }
         }
 
+        // Resources
+        if (auto resourcesNode = config["resources"]; resourcesNode) {
+            try {
+                yaml_read_uint64_t("cpu_memory_budget_mb", resourcesNode,
+                                   pOptions->resources.cpuMemoryBudget);
+                yaml_read_uint64_t("gpu_memory_budget_mb", resourcesNode,
+                                   pOptions->resources.gpuMemoryBudget);
+            } catch (foeYamlException const &e) {
+                throw foeYamlException{"resources::" + e.whatStr()};
+            }
+        }
+
         // Xr
         if (auto xrNode = config["xr"]; xrNode) {
             try {
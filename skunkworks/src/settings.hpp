@@ -14,6 +14,10 @@ class foeSearchPaths;
 struct Settings {
     struct General {
         bool enableWindows = true;
+        /// Number of sync threads in the thread pool, 0 to size it from the hardware's thread count
+        uint32_t syncThreads = 0;
+        /// Number of async threads in the thread pool
+        uint32_t asyncThreads = 1;
     } general;
 
     struct Window {
@@ -39,6 +43,13 @@ struct Settings {
         bool debugLogging = false;
     } graphics;
 
+    struct Resources {
+        /// Most host memory loaded resources can take up, in MiB, UINT64_MAX for no limit
+        uint64_t cpuMemoryBudget = UINT64_MAX;
+        /// Most device memory loaded resources can take up, in MiB, UINT64_MAX for no limit
+        uint64_t gpuMemoryBudget = UINT64_MAX;
+    } resources;
+
     struct Xr {
         bool enableXr = true;
         bool forceXr = false;
@@ -1,4 +1,4 @@
-// Copyright (C) 2021-2023 George Cave.
+// Copyright (C) 2021-2026 George Cave.
 //
 // SPDX-License-Identifier: Apache-2.0
 
@@ -128,24 +128,21 @@ extern "C" void foeDestroyAnimatedBoneSystem(foeAnimatedBoneSystem animatedBoneS
 namespace {
 
 bool processResourceReplacement(foeResource *pResource) {
-    bool replaced = false;
-
-    if (*pResource == FOE_NULL_HANDLE)
+    if (*pResource == FOE_NULL_HANDLE ||
+        foeResourceGetType(*pResource) != FOE_RESOURCE_RESOURCE_TYPE_REPLACED)
         return false;
 
-    while (foeResourceGetType(*pResource) == FOE_RESOURCE_RESOURCE_TYPE_REPLACED) {
-        foeResource replacement = foeResourceGetReplacement(*pResource);
+    // Move straight to the latest replacement
+    foeResource replacement = foeResourceGetCurrent(*pResource);
 
-        foeResourceIncrementUseCount(replacement);
+    foeResourceIncrementUseCount(replacement);
 
-        foeResourceDecrementUseCount(*pResource);
-        foeResourceDecrementRefCount(*pResource);
+    foeResourceDecrementUseCount(*pResource);
+    foeResourceDecrementRefCount(*pResource);
 
-        *pResource = replacement;
-        replaced = true;
-    }
+    *pResource = replacement;
 
-    return replaced;
+    return true;
 }
 
 foeResourceStateFlags processResourceLoadState(foeResource *pResource,
@@ -185,6 +182,16 @@ foeResourceStateFlags processResourceLoadState(foeResource *pResource,
     return overallState;
 }
 
+/// Returns whether the resource is or could become an armature
+bool isArmatureCompatible(foeResource resource) {
+    foeResourceType type = foeResourceGetType(resource);
+
+    return type == FOE_SKUNKWORKS_STRUCTURE_TYPE_ARMATURE ||
+           type == FOE_RESOURCE_RESOURCE_TYPE_UNDEFINED ||
+           type == FOE_RESOURCE_RESOURCE_TYPE_REPLACED ||
+           foeResourceHasType(resource, FOE_SKUNKWORKS_STRUCTURE_TYPE_ARMATURE);
+}
+
 } // namespace
 
 extern "C" foeResultSet foeInitializeAnimatedBoneSystem(
@@ -215,22 +222,38 @@ extern "C" foeResultSet foeInitializeAnimatedBoneSystem(
         foeArmatureState const *pArmatureStateData =
             (foeArmatureState const *)foeEcsComponentPoolDataPtr(armatureStatePool);
 
-        for (; pArmatureStateID != pEndArmatureStateID; ++pArmatureStateID, ++pArmatureStateData) {
-            foeResource armature = FOE_NULL_HANDLE;
-            do {
-                armature = foeResourcePoolFind(resourcePool, pArmatureStateData->armatureID);
+        // Many entities share the same armatures, so acquire them and start loading together
+        size_t const armatureStateCount = pEndArmatureStateID - pArmatureStateID;
+        std::vector<foeResourceID> armatureIDs(armatureStateCount);
+        std::vector<foeResource> armatures(armatureStateCount);
+        for (size_t i = 0; i < armatureStateCount; ++i)
+            armatureIDs[i] = pArmatureStateData[i].armatureID;
+
+        result = foeResourcePoolAcquireMany(resourcePool, (uint32_t)armatureStateCount,
+                                            armatureIDs.data(), armatures.data());
+        if (result.value != FOE_SUCCESS) {
+            for (foeResource armature : armatures) {
+                if (armature != FOE_NULL_HANDLE)
+                    foeResourceDecrementRefCount(armature);
+            }
+            goto INITIALIZATION_FAILED;
+        }
 
-                if (armature == FOE_NULL_HANDLE) {
-                    armature = foeResourcePoolAdd(resourcePool, pArmatureStateData->armatureID);
-                }
-            } while (armature == FOE_NULL_HANDLE);
+        std::vector<foeResource> armaturesToLoad;
+        for (foeResource armature : armatures) {
+            if (isArmatureCompatible(armature) &&
+                (foeResourceGetState(armature) &
+                 (FOE_RESOURCE_STATE_LOADING_BIT | FOE_RESOURCE_STATE_LOADED_BIT)) == 0)
+                armaturesToLoad.emplace_back(armature);
+        }
+        foeResourceLoadDataMany((uint32_t)armaturesToLoad.size(), armaturesToLoad.data());
+
+        size_t i = 0;
+        for (; i < armatureStateCount; ++i, ++pArmatureStateID, ++pArmatureStateData) {
+            foeResource armature = armatures[i];
 
             // Resource ID provided does not match with an Armature type, don't use it
-            if (foeResourceType type = foeResourceGetType(armature);
-                type != FOE_SKUNKWORKS_STRUCTURE_TYPE_ARMATURE &&
-                type != FOE_RESOURCE_RESOURCE_TYPE_UNDEFINED &&
-                type != FOE_RESOURCE_RESOURCE_TYPE_REPLACED &&
-                !foeResourceHasType(armature, FOE_SKUNKWORKS_STRUCTURE_TYPE_ARMATURE)) {
+            if (!isArmatureCompatible(armature)) {
                 foeResourceDecrementRefCount(armature);
                 continue;
             }
@@ -256,7 +279,9 @@ extern "C" foeResultSet foeInitializeAnimatedBoneSystem(
                 };
                 if (newData.pBones == nullptr) {
                     result = to_foeResult(FOE_SKUNKWORKS_ERROR_OUT_OF_MEMORY);
-                    return result;
+                    foeResourceDecrementUseCount(armature);
+                    foeResourceDecrementRefCount(armature);
+                    break;
                 }
 
                 animateArmature(pArmature, pArmatureStateData->animationID,
@@ -266,7 +291,9 @@ extern "C" foeResultSet foeInitializeAnimatedBoneSystem(
                     foeEcsComponentPoolInsert(animatedBoneStatePool, *pArmatureStateID, &newData);
                 if (result.value != FOE_SUCCESS) {
                     free(newData.pBones);
-                    return result;
+                    foeResourceDecrementUseCount(armature);
+                    foeResourceDecrementRefCount(armature);
+                    break;
                 }
             } else if (resourceState & FOE_RESOURCE_STATE_LOADING_BIT) {
                 // Not yet loaded
@@ -276,6 +303,10 @@ extern "C" foeResultSet foeInitializeAnimatedBoneSystem(
                 });
             }
         }
+
+        // Release the armatures not reached because of an error
+        for (++i; i < armatureStateCount; ++i)
+            foeResourceDecrementRefCount(armatures[i]);
     }
 
 INITIALIZATION_FAILED:
@@ -467,16 +498,10 @@ extern "C" foeResultSet foeProcessAnimatedBoneSystem(foeAnimatedBoneSystem anima
                 if (pAnimatedBoneStateID == pEndAnimatedBoneStateID ||
                     *pAnimatedBoneStateID != *pModifiedID) {
                     // There is no associated AnimatedBoneState, check if we should add it
-                    foeResource armature = FOE_NULL_HANDLE;
-                    do {
-                        armature = foeResourcePoolFind(pAnimatedBoneSystem->mResourcePool,
-                                                       pArmatureStateData->armatureID);
-
-                        if (armature == FOE_NULL_HANDLE) {
-                            armature = foeResourcePoolAdd(pAnimatedBoneSystem->mResourcePool,
-                                                          pArmatureStateData->armatureID);
-                        }
-                    } while (armature == FOE_NULL_HANDLE);
+                    foeResource armature = foeResourcePoolFindOrAdd(
+                        pAnimatedBoneSystem->mResourcePool, pArmatureStateData->armatureID);
+                    if (armature == FOE_NULL_HANDLE)
+                        return to_foeResult(FOE_SKUNKWORKS_ERROR_OUT_OF_MEMORY);
 
                     // Resource ID provided does not match with an Armature type, don't use it
                     if (foeResourceType type = foeResourceGetType(armature);
@@ -557,15 +582,10 @@ extern "C" foeResultSet foeProcessAnimatedBoneSystem(foeAnimatedBoneSystem anima
                         foeResource newArmature = FOE_NULL_HANDLE;
 
                         // Acquire new armature resource
-                        do {
-                            newArmature = foeResourcePoolFind(pAnimatedBoneSystem->mResourcePool,
-                                                              pArmatureStateData->armatureID);
-
-                            if (newArmature == FOE_NULL_HANDLE) {
-                                newArmature = foeResourcePoolAdd(pAnimatedBoneSystem->mResourcePool,
-                                                                 pArmatureStateData->armatureID);
-                            }
-                        } while (newArmature == FOE_NULL_HANDLE);
+                        newArmature = foeResourcePoolFindOrAdd(pAnimatedBoneSystem->mResourcePool,
+                                                               pArmatureStateData->armatureID);
+                        if (newArmature == FOE_NULL_HANDLE)
+                            return to_foeResult(FOE_SKUNKWORKS_ERROR_OUT_OF_MEMORY);
 
                         if (foeResourceType type = foeResourceGetType(newArmature);
                             type != FOE_SKUNKWORKS_STRUCTURE_TYPE_ARMATURE &&
@@ -652,16 +672,10 @@ extern "C" foeResultSet foeProcessAnimatedBoneSystem(foeAnimatedBoneSystem anima
             foeEntityID entity = pStartArmatureStateID[*pOffset];
             foeArmatureState const *const pArmatureStateData = pStartArmatureStateData + *pOffset;
 
-            foeResource armature = FOE_NULL_HANDLE;
-            do {
-                armature = foeResourcePoolFind(pAnimatedBoneSystem->mResourcePool,
-                                               pArmatureStateData->armatureID);
-
-                if (armature == FOE_NULL_HANDLE) {
-                    armature = foeResourcePoolAdd(pAnimatedBoneSystem->mResourcePool,
-                                                  pArmatureStateData->armatureID);
-                }
-            } while (armature == FOE_NULL_HANDLE);
+            foeResource armature = foeResourcePoolFindOrAdd(pAnimatedBoneSystem->mResourcePool,
+                                                            pArmatureStateData->armatureID);
+            if (armature == FOE_NULL_HANDLE)
+                return to_foeResult(FOE_SKUNKWORKS_ERROR_OUT_OF_MEMORY);
 
             if (foeResourceType type = foeResourceGetType(armature);
                 type != FOE_SKUNKWORKS_STRUCTURE_TYPE_ARMATURE &&
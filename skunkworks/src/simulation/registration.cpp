@@ -26,6 +26,32 @@
 
 namespace {
 
+foeResourceCreateInfoType const cArmatureCreateInfoTypes[] = {
+    FOE_SKUNKWORKS_STRUCTURE_TYPE_ARMATURE_CREATE_INFO,
+};
+
+foeSimulationStructureType const cAnimatedBoneSystemReadPools[] = {
+    FOE_SKUNKWORKS_STRUCTURE_TYPE_ARMATURE_STATE_POOL,
+};
+
+foeSimulationStructureType const cAnimatedBoneSystemWritePools[] = {
+    FOE_SKUNKWORKS_STRUCTURE_TYPE_ANIMATED_BONE_STATE_POOL,
+};
+
+foeSimulationStructureType const cRenderSystemReadPools[] = {
+    FOE_SKUNKWORKS_STRUCTURE_TYPE_RENDER_STATE_POOL,
+    FOE_POSITION_STRUCTURE_TYPE_POSITION_3D_POOL,
+    FOE_SKUNKWORKS_STRUCTURE_TYPE_ANIMATED_BONE_STATE_POOL,
+};
+
+foeResultSet processAnimatedBoneSystem(void *pSystem, float timeElapsed) {
+    return foeProcessAnimatedBoneSystem((foeAnimatedBoneSystem)pSystem, timeElapsed);
+}
+
+foeResultSet processRenderSystem(void *pSystem, float) {
+    return foeProcessRenderSystem((foeRenderSystem)pSystem);
+}
+
 struct TypeSelection {
     // Loaders
     bool armatureLoader;
@@ -234,6 +260,8 @@ foeResultSet create(foeSimulation simulation) {
             .sType = FOE_SKUNKWORKS_STRUCTURE_TYPE_ARMATURE_LOADER,
             .pLoader = new (std::nothrow) foeArmatureLoader,
             .pCanProcessCreateInfoFn = foeArmatureLoader::canProcessCreateInfo,
+            .createInfoTypeCount = 1,
+            .pCreateInfoTypes = cArmatureCreateInfoTypes,
             .pLoadFn = foeArmatureLoader::load,
             .pMaintenanceFn = [](void *pLoader) {
                 reinterpret_cast<foeArmatureLoader *>(pLoader)->maintenance();
@@ -369,6 +397,11 @@ foeResultSet create(foeSimulation simulation) {
     if (result.value != FOE_SUCCESS) {
         foeSimulationSystemData createInfo{
             .sType = FOE_SKUNKWORKS_STRUCTURE_TYPE_ANIMATED_BONE_SYSTEM,
+            .pProcessFn = processAnimatedBoneSystem,
+            .readPoolCount = 1,
+            .pReadPools = cAnimatedBoneSystemReadPools,
+            .writePoolCount = 1,
+            .pWritePools = cAnimatedBoneSystemWritePools,
         };
 
         result = foeCreateAnimatedBoneSystem((foeAnimatedBoneSystem *)&createInfo.pSystem);
@@ -398,6 +431,9 @@ foeResultSet create(foeSimulation simulation) {
     if (result.value != FOE_SUCCESS) {
         foeSimulationSystemData createInfo{
             .sType = FOE_SKUNKWORKS_STRUCTURE_TYPE_RENDER_SYSTEM,
+            .pProcessFn = processRenderSystem,
+            .readPoolCount = 3,
+            .pReadPools = cRenderSystemReadPools,
         };
 
         result = foeCreateRenderSystem((foeRenderSystem *)&createInfo.pSystem);
@@ -5,11 +5,14 @@
 #include "render_system.hpp"
 
 #include <foe/ecs/id_to_string.hpp>
+#include <foe/ecs/join.h>
+#include <foe/ecs/result.h>
 #include <foe/graphics/resource/material.hpp>
 #include <foe/graphics/resource/mesh.hpp>
 #include <foe/graphics/resource/type_defs.h>
 #include <foe/graphics/resource/vertex_descriptor.h>
 #include <foe/position/component/3d.hpp>
+#include <foe/resource/load_queue.h>
 
 #include "../log.hpp"
 #include "../result.h"
@@ -23,6 +26,10 @@
 
 namespace {
 
+/// Most queued resource loads to start each time the render system is processed, so that a burst
+/// of new entities has its loads spread over several frames rather than all started in one
+constexpr uint32_t cMaxLoadsPerProcess = 64;
+
 struct RenderSystem {
     // Non Graphics
     foeResourcePool resourcePool;
@@ -30,7 +37,12 @@ struct RenderSystem {
     foePosition3dPool positionPool;
     foeAnimatedBoneStatePool animatedBoneStatePool;
 
+    // Change version of the position pool that modifications have been processed up to
+    uint32_t positionChangeVersion;
+
     std::vector<RenderDataSet> awaitingLoading;
+    /// Loads of the resources awaited on, prioritized by how many entities are waiting on each
+    foeResourceLoadQueue loadQueue;
 
     std::vector<RenderDataSet> renderData;
 
@@ -45,6 +57,88 @@ struct RenderSystem {
 
 FOE_DEFINE_HANDLE_CASTS(render_system, RenderSystem, foeRenderSystem)
 
+/** @brief Resources acquired and loaded together while processing a set of render states
+ *
+ * Rather than going to the resource pool separately for every resource of every entity, the
+ * resources of a set of render states can be acquired at once, then taken from here as each entity
+ * is processed. Resources found to need loading are gathered up and requested from the load queue
+ * when the batch is destroyed.
+ */
+struct ResourceBatch {
+    ResourceBatch(foeResourceLoadQueue loadQueue) : loadQueue{loadQueue} {}
+    ResourceBatch(ResourceBatch const &) = delete;
+    ResourceBatch &operator=(ResourceBatch const &) = delete;
+    ~ResourceBatch();
+
+    /// Queue that the loads are requested from
+    foeResourceLoadQueue loadQueue;
+    /// IDs of the acquired resources, sorted once acquired
+    std::vector<foeResourceID> resourceIDs;
+    /// Acquired resources matching each ID, each holding a reference for the batch
+    std::vector<foeResource> resources;
+    /// Resources to start loading, each holding a reference for the batch
+    std::vector<foeResource> toLoad;
+};
+
+ResourceBatch::~ResourceBatch() {
+    // Each entity needing a resource adds it again, so resources wanted by more entities are
+    // requested with a lower priority value, to be dispatched first
+    std::sort(toLoad.begin(), toLoad.end());
+    for (auto it = toLoad.begin(); it != toLoad.end();) {
+        auto endIt = std::upper_bound(it, toLoad.end(), *it);
+
+        // Already loading or replaced resources are left to be picked up on the next check
+        foeResourceLoadQueueRequest(loadQueue, *it, -(float)(endIt - it));
+
+        it = endIt;
+    }
+
+    for (foeResource resource : toLoad)
+        foeResourceDecrementRefCount(resource);
+
+    for (foeResource resource : resources) {
+        if (resource != FOE_NULL_HANDLE)
+            foeResourceDecrementRefCount(resource);
+    }
+}
+
+void addBatchResourceIDs(ResourceBatch *pBatch, foeRenderState const *pRenderState) {
+    for (foeResourceID resourceID :
+         {pRenderState->vertexDescriptor, pRenderState->bonedVertexDescriptor,
+          pRenderState->material, pRenderState->mesh}) {
+        if (resourceID != FOE_INVALID_ID)
+            pBatch->resourceIDs.emplace_back(resourceID);
+    }
+}
+
+/// Acquires all of the resources with IDs added to the batch at once
+void acquireBatchResources(foeResourcePool resourcePool, ResourceBatch *pBatch) {
+    std::sort(pBatch->resourceIDs.begin(), pBatch->resourceIDs.end());
+    pBatch->resourceIDs.erase(std::unique(pBatch->resourceIDs.begin(), pBatch->resourceIDs.end()),
+                              pBatch->resourceIDs.end());
+
+    pBatch->resources.resize(pBatch->resourceIDs.size());
+
+    // Any that couldn't be acquired are left as FOE_NULL_HANDLE, to be tried again when taken
+    foeResourcePoolAcquireMany(resourcePool, (uint32_t)pBatch->resourceIDs.size(),
+                               pBatch->resourceIDs.data(), pBatch->resources.data());
+}
+
+/// Returns the batch's resource with the ID with an added reference, or FOE_NULL_HANDLE if it
+/// wasn't acquired by the batch
+foeResource takeBatchResource(ResourceBatch const *pBatch, foeResourceID resourceID) {
+    auto searchIt =
+        std::lower_bound(pBatch->resourceIDs.begin(), pBatch->resourceIDs.end(), resourceID);
+    if (searchIt == pBatch->resourceIDs.end() || *searchIt != resourceID)
+        return FOE_NULL_HANDLE;
+
+    foeResource resource = pBatch->resources[searchIt - pBatch->resourceIDs.begin()];
+    if (resource != FOE_NULL_HANDLE)
+        foeResourceIncrementRefCount(resource);
+
+    return resource;
+}
+
 void clearRenderData(RenderResources const *pRenderData) {
     if (pRenderData->mesh != FOE_NULL_HANDLE) {
         foeResourceDecrementUseCount(pRenderData->mesh);
@@ -68,6 +162,7 @@ void clearRenderData(RenderResources const *pRenderData) {
 }
 
 bool getResourceData(foeResourcePool resourcePool,
+                     ResourceBatch const *pBatch,
                      foeResourceID resourceID,
                      foeResourceType resourceType,
                      size_t resourceTypeSize,
@@ -95,12 +190,12 @@ bool getResourceData(foeResourcePool resourcePool,
         return true;
 
     // If here, need to try to acquire the resource
-    do {
-        newResource = foeResourcePoolFind(resourcePool, resourceID);
-
-        if (newResource == FOE_NULL_HANDLE)
-            newResource = foeResourcePoolAdd(resourcePool, resourceID);
-    } while (newResource == FOE_NULL_HANDLE);
+    newResource = takeBatchResource(pBatch, resourceID);
+    if (newResource == FOE_NULL_HANDLE)
+        newResource = foeResourcePoolFindOrAdd(resourcePool, resourceID);
+    if (newResource == FOE_NULL_HANDLE)
+        // Couldn't be added to the pool, so can't be used
+        return false;
 
     // Make sure retrieved resource is the correct type, or could become the desired type
     if (foeResourceType type = foeResourceGetType(newResource);
@@ -113,27 +208,25 @@ bool getResourceData(foeResourcePool resourcePool,
 }
 
 bool processResourceReplacement(foeResource *pResource) {
-    bool replaced = false;
-
-    if (*pResource == FOE_NULL_HANDLE)
+    if (*pResource == FOE_NULL_HANDLE ||
+        foeResourceGetType(*pResource) != FOE_RESOURCE_RESOURCE_TYPE_REPLACED)
         return false;
 
-    while (foeResourceGetType(*pResource) == FOE_RESOURCE_RESOURCE_TYPE_REPLACED) {
-        foeResource replacement = foeResourceGetReplacement(*pResource);
+    // Move straight to the latest replacement
+    foeResource replacement = foeResourceGetCurrent(*pResource);
 
-        foeResourceIncrementUseCount(replacement);
+    foeResourceIncrementUseCount(replacement);
 
-        foeResourceDecrementUseCount(*pResource);
-        foeResourceDecrementRefCount(*pResource);
+    foeResourceDecrementUseCount(*pResource);
+    foeResourceDecrementRefCount(*pResource);
 
-        *pResource = replacement;
-        replaced = true;
-    }
+    *pResource = replacement;
 
-    return replaced;
+    return true;
 }
 
-foeResourceStateFlags processResourceLoadState(foeResource *pResource,
+foeResourceStateFlags processResourceLoadState(ResourceBatch *pBatch,
+                                               foeResource *pResource,
                                                foeResourceType resourceType,
                                                foeResourceStateFlags overallState) {
     if (*pResource == FOE_NULL_HANDLE)
@@ -159,8 +252,9 @@ foeResourceStateFlags processResourceLoadState(foeResource *pResource,
         overallState &= ~FOE_RESOURCE_STATE_LOADED_BIT;
 
         if ((resourceState & FOE_RESOURCE_STATE_LOADING_BIT) == 0) {
-            // Resource is not LOADED and not LOADING, request load
-            foeResourceLoadData(*pResource);
+            // Resource is not LOADED and not LOADING, request load with the rest of the batch
+            foeResourceIncrementRefCount(*pResource);
+            pBatch->toLoad.emplace_back(*pResource);
             overallState |= FOE_RESOURCE_STATE_LOADING_BIT;
         }
     }
@@ -170,7 +264,8 @@ foeResourceStateFlags processResourceLoadState(foeResource *pResource,
     return overallState;
 }
 
-foeResourceStateFlags loadResourceData(foeResource oldResource,
+foeResourceStateFlags loadResourceData(ResourceBatch *pBatch,
+                                       foeResource oldResource,
                                        foeResource &newResource,
                                        foeResourceType resourceType,
                                        foeResourceStateFlags overallState) {
@@ -185,7 +280,7 @@ foeResourceStateFlags loadResourceData(foeResource oldResource,
         foeResourceIncrementUseCount(newResource);
     }
 
-    return processResourceLoadState(&newResource, resourceType, overallState);
+    return processResourceLoadState(pBatch, &newResource, resourceType, overallState);
 }
 
 void getResourceCleanup(foeResource oldResource, foeResource newResource) {
@@ -204,28 +299,29 @@ void getResourceCleanup(foeResource oldResource, foeResource newResource) {
 
 [[nodiscard]]
 foeResourceStateFlags getRenderData(foeResourcePool resourcePool,
+                                    ResourceBatch *pBatch,
                                     foeRenderState const *pRenderState,
                                     RenderResources *pRenderData) {
     RenderResources newResourceData = {};
     bool good = true;
     foeResourceStateFlags overallResourceState = FOE_RESOURCE_STATE_FAILED_BIT;
 
-    good = good && getResourceData(resourcePool, pRenderState->vertexDescriptor,
+    good = good && getResourceData(resourcePool, pBatch, pRenderState->vertexDescriptor,
                                    FOE_GRAPHICS_RESOURCE_STRUCTURE_TYPE_VERTEX_DESCRIPTOR,
                                    sizeof(foeVertexDescriptor), pRenderData->vertexDescriptor,
                                    newResourceData.vertexDescriptor);
 
-    good = good && getResourceData(resourcePool, pRenderState->bonedVertexDescriptor,
+    good = good && getResourceData(resourcePool, pBatch, pRenderState->bonedVertexDescriptor,
                                    FOE_GRAPHICS_RESOURCE_STRUCTURE_TYPE_VERTEX_DESCRIPTOR,
                                    sizeof(foeVertexDescriptor), pRenderData->bonedVertexDescriptor,
                                    newResourceData.bonedVertexDescriptor);
 
     good =
-        good && getResourceData(resourcePool, pRenderState->material,
+        good && getResourceData(resourcePool, pBatch, pRenderState->material,
                                 FOE_GRAPHICS_RESOURCE_STRUCTURE_TYPE_MATERIAL, sizeof(foeMaterial),
                                 pRenderData->material, newResourceData.material);
 
-    good = good && getResourceData(resourcePool, pRenderState->mesh,
+    good = good && getResourceData(resourcePool, pBatch, pRenderState->mesh,
                                    FOE_GRAPHICS_RESOURCE_STRUCTURE_TYPE_MESH, sizeof(foeMesh),
                                    pRenderData->mesh, newResourceData.mesh);
 
@@ -241,16 +337,16 @@ foeResourceStateFlags getRenderData(foeResourcePool resourcePool,
         overallResourceState = FOE_RESOURCE_STATE_LOADED_BIT;
 
         overallResourceState = loadResourceData(
-            pRenderData->vertexDescriptor, newResourceData.vertexDescriptor,
+            pBatch, pRenderData->vertexDescriptor, newResourceData.vertexDescriptor,
             FOE_GRAPHICS_RESOURCE_STRUCTURE_TYPE_VERTEX_DESCRIPTOR, overallResourceState);
         overallResourceState = loadResourceData(
-            pRenderData->bonedVertexDescriptor, newResourceData.bonedVertexDescriptor,
+            pBatch, pRenderData->bonedVertexDescriptor, newResourceData.bonedVertexDescriptor,
             FOE_GRAPHICS_RESOURCE_STRUCTURE_TYPE_VERTEX_DESCRIPTOR, overallResourceState);
         overallResourceState =
-            loadResourceData(pRenderData->material, newResourceData.material,
+            loadResourceData(pBatch, pRenderData->material, newResourceData.material,
                              FOE_GRAPHICS_RESOURCE_STRUCTURE_TYPE_MATERIAL, overallResourceState);
         overallResourceState =
-            loadResourceData(pRenderData->mesh, newResourceData.mesh,
+            loadResourceData(pBatch, pRenderData->mesh, newResourceData.mesh,
                              FOE_GRAPHICS_RESOURCE_STRUCTURE_TYPE_MESH, overallResourceState);
     }
 
@@ -318,21 +414,19 @@ extern "C" foeResultSet foeInitializeRenderSystemGraphics(
     if (result.value != FOE_SUCCESS)
         goto GRAPHICS_INITIALIZATION_FAILED;
 
+    result = foeCreateResourceLoadQueue(&pRenderSystem->loadQueue);
+    if (result.value != FOE_SUCCESS)
+        goto GRAPHICS_INITIALIZATION_FAILED;
+
     { // Compile initial data sets
         pRenderSystem->renderData.reserve(foeEcsComponentPoolSize(renderStatePool));
+        pRenderSystem->positionChangeVersion =
+            foeEcsComponentPoolAdvanceChangeVersion(positionPool);
 
-        foeEntityID const *pRenderStateID = foeEcsComponentPoolIdPtr(renderStatePool);
-        foeEntityID const *const pEndRenderStateID =
-            pRenderStateID + foeEcsComponentPoolSize(renderStatePool);
-        foeRenderState const *pRenderStateData =
+        foeRenderState const *const pStartRenderStateData =
             (foeRenderState const *)foeEcsComponentPoolDataPtr(renderStatePool);
-
-        foeEntityID const *pPositionID = foeEcsComponentPoolIdPtr(positionPool);
-        foeEntityID const *const pStartPositionID = pPositionID;
-        foeEntityID const *const pEndPositionID =
-            pStartPositionID + foeEcsComponentPoolSize(positionPool);
-        foePosition3d const *const *const ppStartPositionData =
-            (foePosition3d const *const *const)foeEcsComponentPoolDataPtr(positionPool);
+        foePosition3d const *const pStartPositionData =
+            (foePosition3d const *)foeEcsComponentPoolDataPtr(positionPool);
 
         foeEntityID const *pAnimatedBoneStateID = foeEcsComponentPoolIdPtr(animatedBoneStatePool);
         foeEntityID const *const pStartAnimatedBoneStateID = pAnimatedBoneStateID;
@@ -341,53 +435,71 @@ extern "C" foeResultSet foeInitializeRenderSystemGraphics(
         foeAnimatedBoneState const *const pStartAnimatedBoneStateData =
             (foeAnimatedBoneState const *const)foeEcsComponentPoolDataPtr(animatedBoneStatePool);
 
-        for (; pRenderStateID != pEndRenderStateID; ++pRenderStateID, ++pRenderStateData) {
-            // Check if associated position component exists
-            pPositionID = std::lower_bound(pPositionID, pEndPositionID, *pRenderStateID);
-            if (pPositionID == pEndPositionID)
-                // No more possible positions, leave
-                break;
-            if (*pPositionID != *pRenderStateID)
-                // There is no associated position component, continue
-                continue;
+        // Only entities with both a render state and a position can be rendered
+        foeEcsComponentPool const joinPools[2] = {renderStatePool, positionPool};
+        uint32_t const joinDriver = foeEcsJoinDriver(2, joinPools);
+        size_t joinOffset = 0;
+        foeResultSet joinResult;
+
+        do {
+            foeEntityID joinedEntities[256];
+            size_t joinedOffsets[256 * 2];
+            uint32_t joinedCount = 256;
+
+            joinResult = foeEcsJoin(2, joinPools, joinDriver, &joinOffset, SIZE_MAX, &joinedCount,
+                                    joinedEntities, joinedOffsets);
+
+            ResourceBatch batch{pRenderSystem->loadQueue};
+            for (uint32_t i = 0; i < joinedCount; ++i)
+                addBatchResourceIDs(&batch, pStartRenderStateData + joinedOffsets[i * 2]);
+            acquireBatchResources(resourcePool, &batch);
+
+            for (uint32_t i = 0; i < joinedCount; ++i) {
+                foeEntityID const entity = joinedEntities[i];
+                foeRenderState const *const pRenderStateData =
+                    pStartRenderStateData + joinedOffsets[i * 2];
+                foePosition3d const *const pPositionData =
+                    pStartPositionData + joinedOffsets[i * 2 + 1];
 
-            RenderDataSet newDataSet{.entity = *pRenderStateID, .armatureIndex = UINT32_MAX};
+                RenderDataSet newDataSet{.entity = entity, .armatureIndex = UINT32_MAX};
 
-            foeResourceStateFlags resourceState =
-                getRenderData(resourcePool, pRenderStateData, &newDataSet.resources);
+                foeResourceStateFlags resourceState =
+                    getRenderData(resourcePool, &batch, pRenderStateData, &newDataSet.resources);
 
-            assert(resourceState & (FOE_RESOURCE_STATE_LOADING_BIT | FOE_RESOURCE_STATE_FAILED_BIT |
-                                    FOE_RESOURCE_STATE_LOADED_BIT));
+                assert(resourceState & (FOE_RESOURCE_STATE_LOADING_BIT |
+                                        FOE_RESOURCE_STATE_FAILED_BIT |
+                                        FOE_RESOURCE_STATE_LOADED_BIT));
 
-            if (resourceState & FOE_RESOURCE_STATE_FAILED_BIT) {
-                // Some required resource failed to load
-                clearArmatureData(pRenderSystem->armatureData, newDataSet.armatureIndex);
-            } else if (resourceState & FOE_RESOURCE_STATE_LOADED_BIT) {
-                // Data is loaded, can add right away
-                pAnimatedBoneStateID = std::lower_bound(pAnimatedBoneStateID,
-                                                        pEndAnimatedBoneStateID, *pRenderStateID);
-                if (pAnimatedBoneStateID != pEndAnimatedBoneStateID &&
-                    *pAnimatedBoneStateID == *pRenderStateID) {
-                    result = getArmatureData(pRenderSystem->armatureData,
-                                             pStartAnimatedBoneStateData +
-                                                 (pAnimatedBoneStateID - pStartAnimatedBoneStateID),
-                                             newDataSet.resources.mesh, newDataSet.armatureIndex);
+                if (resourceState & FOE_RESOURCE_STATE_FAILED_BIT) {
+                    // Some required resource failed to load
+                    clearArmatureData(pRenderSystem->armatureData, newDataSet.armatureIndex);
+                } else if (resourceState & FOE_RESOURCE_STATE_LOADED_BIT) {
+                    // Data is loaded, can add right away
+                    pAnimatedBoneStateID = std::lower_bound(pAnimatedBoneStateID,
+                                                            pEndAnimatedBoneStateID, entity);
+                    if (pAnimatedBoneStateID != pEndAnimatedBoneStateID &&
+                        *pAnimatedBoneStateID == entity) {
+                        result = getArmatureData(
+                            pRenderSystem->armatureData,
+                            pStartAnimatedBoneStateData +
+                                (pAnimatedBoneStateID - pStartAnimatedBoneStateID),
+                            newDataSet.resources.mesh, newDataSet.armatureIndex);
+                        if (result.value != FOE_SUCCESS)
+                            goto GRAPHICS_INITIALIZATION_FAILED;
+                    }
+
+                    result = insertPositionData(pRenderSystem->positionData,
+                                                pRenderSystem->renderData.size(), pPositionData);
                     if (result.value != FOE_SUCCESS)
                         goto GRAPHICS_INITIALIZATION_FAILED;
-                }
-
-                result = insertPositionData(
-                    pRenderSystem->positionData, pRenderSystem->renderData.size(),
-                    *(ppStartPositionData + (pPositionID - pStartPositionID)));
-                if (result.value != FOE_SUCCESS)
-                    goto GRAPHICS_INITIALIZATION_FAILED;
 
-                pRenderSystem->renderData.emplace_back(newDataSet);
-            } else if (resourceState & FOE_RESOURCE_STATE_LOADING_BIT) {
-                // Something is loading
-                pRenderSystem->awaitingLoading.emplace_back(newDataSet);
+                    pRenderSystem->renderData.emplace_back(newDataSet);
+                } else if (resourceState & FOE_RESOURCE_STATE_LOADING_BIT) {
+                    // Something is loading
+                    pRenderSystem->awaitingLoading.emplace_back(newDataSet);
+                }
             }
-        }
+        } while (joinResult.value == FOE_ECS_INCOMPLETE);
     }
 
 GRAPHICS_INITIALIZATION_FAILED:
@@ -415,6 +527,11 @@ extern "C" void foeDeinitializeRenderSystemGraphics(foeRenderSystem renderSystem
         clearRenderData(&dataSet.resources);
     }
 
+    // Any loads still pending are no longer wanted
+    if (pRenderSystem->loadQueue != FOE_NULL_HANDLE)
+        foeDestroyResourceLoadQueue(pRenderSystem->loadQueue);
+    pRenderSystem->loadQueue = FOE_NULL_HANDLE;
+
     // Clear external data
     pRenderSystem->gfxSession = FOE_NULL_HANDLE;
     pRenderSystem->animatedBoneStatePool = FOE_NULL_HANDLE;
@@ -428,6 +545,8 @@ extern "C" foeResultSet foeProcessRenderSystem(foeRenderSystem renderSystem) {
     foeResultSet result = to_foeResult(FOE_SKUNKWORKS_SUCCESS);
 
     { // Check items waiting on loading resources
+        // Mostly holding on to the resources already, so only the loads are batched
+        ResourceBatch batch{pRenderSystem->loadQueue};
         std::vector<RenderDataSet> dataSets = std::move(pRenderSystem->awaitingLoading);
         std::sort(dataSets.begin(), dataSets.end(),
                   [](RenderDataSet const &a, RenderDataSet const &b) {
@@ -441,13 +560,8 @@ extern "C" foeResultSet foeProcessRenderSystem(foeRenderSystem renderSystem) {
         foeRenderState const *pRenderStateData =
             (foeRenderState const *)foeEcsComponentPoolDataPtr(pRenderSystem->renderStatePool);
 
-        foeEntityID const *pPositionID = foeEcsComponentPoolIdPtr(pRenderSystem->positionPool);
-        foeEntityID const *const pStartPositionID = pPositionID;
-        foeEntityID const *const pEndPositionID =
-            pStartPositionID + foeEcsComponentPoolSize(pRenderSystem->positionPool);
-        foePosition3d const *const *const ppStartPositionData =
-            (foePosition3d const *const *const)foeEcsComponentPoolDataPtr(
-                pRenderSystem->positionPool);
+        foePosition3d const *const pStartPositionData =
+            (foePosition3d const *)foeEcsComponentPoolDataPtr(pRenderSystem->positionPool);
 
         foeEntityID const *pAnimatedBoneStateID =
             foeEcsComponentPoolIdPtr(pRenderSystem->animatedBoneStatePool);
@@ -479,10 +593,9 @@ extern "C" foeResultSet foeProcessRenderSystem(foeRenderSystem renderSystem) {
                 continue;
             }
 
-            pPositionID = std::lower_bound(pPositionID, pEndPositionID, awaitingIt->entity);
-            if (pPositionID == pEndPositionID)
-                goto END_AWAITING_RESOURCE_PROCESSING;
-            if (*pPositionID != awaitingIt->entity) {
+            size_t positionOffset;
+            if (!foeEcsComponentPoolFindOffset(pRenderSystem->positionPool, awaitingIt->entity,
+                                               &positionOffset)) {
                 // Whatever we were loading is no longer in the Position component pool, clear
                 // the data and continue
                 clearArmatureData(pRenderSystem->armatureData, awaitingIt->armatureIndex);
@@ -491,7 +604,7 @@ extern "C" foeResultSet foeProcessRenderSystem(foeRenderSystem renderSystem) {
             }
 
             foeResourceStateFlags resourceState = getRenderData(
-                pRenderSystem->resourcePool, pRenderStateData, &awaitingIt->resources);
+                pRenderSystem->resourcePool, &batch, pRenderStateData, &awaitingIt->resources);
 
             assert(resourceState & (FOE_RESOURCE_STATE_LOADING_BIT | FOE_RESOURCE_STATE_FAILED_BIT |
                                     FOE_RESOURCE_STATE_LOADED_BIT));
@@ -527,8 +640,7 @@ extern "C" foeResultSet foeProcessRenderSystem(foeRenderSystem renderSystem) {
                 }
 
                 size_t const posIndex = renderDataIt - pRenderSystem->renderData.begin();
-                foePosition3d const *const pPositionData =
-                    *(ppStartPositionData + (pPositionID - pStartPositionID));
+                foePosition3d const *const pPositionData = pStartPositionData + positionOffset;
                 result = insertPositionData(pRenderSystem->positionData, posIndex, pPositionData);
                 if (result.value != FOE_SUCCESS)
                     return result;
@@ -664,6 +776,14 @@ extern "C" foeResultSet foeProcessRenderSystem(foeRenderSystem renderSystem) {
                 (foeAnimatedBoneState const *const)foeEcsComponentPoolDataPtr(
                     pRenderSystem->animatedBoneStatePool);
 
+            ResourceBatch batch{pRenderSystem->loadQueue};
+            for (foeEntityID const *pID = pModifiedID; pID != pEndModifiedID; ++pID) {
+                size_t offset;
+                if (foeEcsComponentPoolFindOffset(pRenderSystem->renderStatePool, *pID, &offset))
+                    addBatchResourceIDs(&batch, pStartRenderStateData + offset);
+            }
+            acquireBatchResources(pRenderSystem->resourcePool, &batch);
+
             auto renderDataIt = pRenderSystem->renderData.begin();
 
             for (; pModifiedID != pEndModifiedID; ++pModifiedID) {
@@ -693,7 +813,7 @@ extern "C" foeResultSet foeProcessRenderSystem(foeRenderSystem renderSystem) {
                     pStartRenderStateData + (pRenderStateID - pStartRenderStateID);
 
                 foeResourceStateFlags resourceState = getRenderData(
-                    pRenderSystem->resourcePool, pRenderState, &renderDataIt->resources);
+                    pRenderSystem->resourcePool, &batch, pRenderState, &renderDataIt->resources);
 
                 assert(resourceState &
                        (FOE_RESOURCE_STATE_LOADING_BIT | FOE_RESOURCE_STATE_FAILED_BIT |
@@ -738,68 +858,53 @@ extern "C" foeResultSet foeProcessRenderSystem(foeRenderSystem renderSystem) {
     }
 
     { // Position3D modified
-        size_t const entityListCount =
-            foeEcsComponentPoolEntityListSize(pRenderSystem->positionPool);
-        foeEcsEntityList const *pLists =
-            foeEcsComponentPoolEntityLists(pRenderSystem->positionPool);
+        foeEntityID const *const pStartPositionID =
+            foeEcsComponentPoolIdPtr(pRenderSystem->positionPool);
+        foePosition3d const *const pStartPositionData =
+            (foePosition3d const *)foeEcsComponentPoolDataPtr(pRenderSystem->positionPool);
+        size_t const positionCount = foeEcsComponentPoolSize(pRenderSystem->positionPool);
 
-        for (size_t i = 0; i < entityListCount; ++i) {
-            foeEcsEntityList entityList = pLists[i];
+        uint32_t const changeVersion = pRenderSystem->positionChangeVersion;
+        pRenderSystem->positionChangeVersion =
+            foeEcsComponentPoolAdvanceChangeVersion(pRenderSystem->positionPool);
 
-            foeEntityID const *pModifiedID = foeEcsEntityListPtr(entityList);
-            foeEntityID const *const pEndModifiedID =
-                pModifiedID + foeEcsEntityListSize(entityList);
-
-            foeEntityID const *pPositionID = foeEcsComponentPoolIdPtr(pRenderSystem->positionPool);
-            foeEntityID const *const pStartPositionID = pPositionID;
-            foeEntityID const *const pEndPosititonID =
-                pStartPositionID + foeEcsComponentPoolSize(pRenderSystem->positionPool);
-            foePosition3d *const *const ppStartPositionData =
-                (foePosition3d *const *const)foeEcsComponentPoolDataPtr(
-                    pRenderSystem->positionPool);
+        auto renderDataIt = pRenderSystem->renderData.begin();
+        auto const endRenderDataIt = pRenderSystem->renderData.end();
 
-            auto renderDataIt = pRenderSystem->renderData.begin();
-            auto const endRenderDataIt = pRenderSystem->renderData.end();
+        for (size_t positionOffset =
+                 foeEcsComponentPoolNextChanged(pRenderSystem->positionPool, changeVersion, 0);
+             positionOffset < positionCount;
+             positionOffset = foeEcsComponentPoolNextChanged(pRenderSystem->positionPool,
+                                                             changeVersion, positionOffset + 1)) {
+            foeEntityID const entity = pStartPositionID[positionOffset];
 
-            for (; pModifiedID != pEndModifiedID; ++pModifiedID) {
-                // Check if the position component still exists
-                pPositionID = std::lower_bound(pPositionID, pEndPosititonID, *pModifiedID);
-                if (pPositionID == pEndPosititonID)
-                    break;
-                if (*pModifiedID != *pPositionID)
-                    continue;
-
-                // Check if there is associated render data
-                renderDataIt =
-                    std::lower_bound(renderDataIt, pRenderSystem->renderData.end(), *pModifiedID,
-                                     [](RenderDataSet const &obj, foeEntityID const entity) {
-                                         return obj.entity < entity;
-                                     });
-                if (renderDataIt == endRenderDataIt)
-                    break;
-                if (*pModifiedID != renderDataIt->entity)
-                    continue;
+            // Check if there is associated render data
+            renderDataIt = std::lower_bound(renderDataIt, endRenderDataIt, entity,
+                                            [](RenderDataSet const &obj, foeEntityID const entity) {
+                                                return obj.entity < entity;
+                                            });
+            if (renderDataIt == endRenderDataIt)
+                break;
+            if (entity != renderDataIt->entity)
+                continue;
 
-                size_t const index = renderDataIt - pRenderSystem->renderData.begin();
+            size_t const index = renderDataIt - pRenderSystem->renderData.begin();
 
-                uint8_t *pData = (uint8_t *)pRenderSystem->positionData.pCpuBuffer;
-                pData += index * pRenderSystem->positionData.alignment;
+            uint8_t *pData = (uint8_t *)pRenderSystem->positionData.pCpuBuffer;
+            pData += index * pRenderSystem->positionData.alignment;
 
-                glm::mat4 *pMatrix = (glm::mat4 *)pData;
-                foePosition3d const *pPositionData =
-                    *(ppStartPositionData + (pPositionID - pStartPositionID));
+            glm::mat4 *pMatrix = (glm::mat4 *)pData;
+            foePosition3d const *pPositionData = pStartPositionData + positionOffset;
 
-                *pMatrix = glm::mat4_cast(pPositionData->orientation) *
-                           glm::translate(glm::mat4(1.f), pPositionData->position);
-            }
+            *pMatrix = glm::mat4_cast(pPositionData->orientation) *
+                       glm::translate(glm::mat4(1.f), pPositionData->position);
         }
     }
 
     { // Position insertions
         foeEntityID const *pStartPositionID = foeEcsComponentPoolIdPtr(pRenderSystem->positionPool);
-        foePosition3d const *const *const ppStartPositionData =
-            (foePosition3d const *const *const)foeEcsComponentPoolDataPtr(
-                pRenderSystem->positionPool);
+        foePosition3d const *const pStartPositionData =
+            (foePosition3d const *)foeEcsComponentPoolDataPtr(pRenderSystem->positionPool);
 
         size_t const *pPositionOffset =
             foeEcsComponentPoolInsertedOffsetPtr(pRenderSystem->positionPool);
@@ -824,6 +929,15 @@ extern "C" foeResultSet foeProcessRenderSystem(foeRenderSystem renderSystem) {
             (foeAnimatedBoneState const *const)foeEcsComponentPoolDataPtr(
                 pRenderSystem->animatedBoneStatePool);
 
+        ResourceBatch batch{pRenderSystem->loadQueue};
+        for (size_t const *pOffset = pPositionOffset; pOffset != pEndPositionOffset; ++pOffset) {
+            size_t renderStateOffset;
+            if (foeEcsComponentPoolFindOffset(pRenderSystem->renderStatePool,
+                                              pStartPositionID[*pOffset], &renderStateOffset))
+                addBatchResourceIDs(&batch, pStartRenderStateData + renderStateOffset);
+        }
+        acquireBatchResources(pRenderSystem->resourcePool, &batch);
+
         auto renderDataIt = pRenderSystem->renderData.begin();
 
         for (; pPositionOffset != pEndPositionOffset; ++pPositionOffset) {
@@ -850,8 +964,8 @@ extern "C" foeResultSet foeProcessRenderSystem(foeRenderSystem renderSystem) {
 
             RenderDataSet newDataSet{.entity = entity, .armatureIndex = UINT32_MAX};
 
-            foeResourceStateFlags resourceState =
-                getRenderData(pRenderSystem->resourcePool, pRenderStateData, &newDataSet.resources);
+            foeResourceStateFlags resourceState = getRenderData(
+                pRenderSystem->resourcePool, &batch, pRenderStateData, &newDataSet.resources);
 
             assert(resourceState & (FOE_RESOURCE_STATE_LOADING_BIT | FOE_RESOURCE_STATE_FAILED_BIT |
                                     FOE_RESOURCE_STATE_LOADED_BIT));
@@ -874,8 +988,7 @@ extern "C" foeResultSet foeProcessRenderSystem(foeRenderSystem renderSystem) {
                 }
 
                 size_t const posIndex = renderDataIt - pRenderSystem->renderData.begin();
-                foePosition3d const *const pPositionData =
-                    *(ppStartPositionData + *pPositionOffset);
+                foePosition3d const *const pPositionData = pStartPositionData + *pPositionOffset;
                 result = insertPositionData(pRenderSystem->positionData, posIndex, pPositionData);
                 if (result.value != FOE_SUCCESS)
                     return result;
@@ -899,13 +1012,8 @@ extern "C" foeResultSet foeProcessRenderSystem(foeRenderSystem renderSystem) {
         size_t const *const pEndRenderStateOffset =
             pRenderStateOffset + foeEcsComponentPoolInserted(pRenderSystem->renderStatePool);
 
-        foeEntityID const *pPositionID = foeEcsComponentPoolIdPtr(pRenderSystem->positionPool);
-        foeEntityID const *pStartPositionID = pPositionID;
-        foeEntityID const *const pEndPositionID =
-            pStartPositionID + foeEcsComponentPoolSize(pRenderSystem->positionPool);
-        foePosition3d const *const *const ppStartPositionData =
-            (foePosition3d const *const *const)foeEcsComponentPoolDataPtr(
-                pRenderSystem->positionPool);
+        foePosition3d const *const pStartPositionData =
+            (foePosition3d const *)foeEcsComponentPoolDataPtr(pRenderSystem->positionPool);
 
         foeEntityID const *pAnimatedBoneStateID =
             foeEcsComponentPoolIdPtr(pRenderSystem->animatedBoneStatePool);
@@ -917,6 +1025,13 @@ extern "C" foeResultSet foeProcessRenderSystem(foeRenderSystem renderSystem) {
             (foeAnimatedBoneState const *const)foeEcsComponentPoolDataPtr(
                 pRenderSystem->animatedBoneStatePool);
 
+        ResourceBatch batch{pRenderSystem->loadQueue};
+        for (size_t const *pOffset = pRenderStateOffset; pOffset != pEndRenderStateOffset;
+             ++pOffset) {
+            addBatchResourceIDs(&batch, pStartRenderStateData + *pOffset);
+        }
+        acquireBatchResources(pRenderSystem->resourcePool, &batch);
+
         auto renderDataIt = pRenderSystem->renderData.begin();
 
         for (; pRenderStateOffset != pEndRenderStateOffset; ++pRenderStateOffset) {
@@ -924,10 +1039,9 @@ extern "C" foeResultSet foeProcessRenderSystem(foeRenderSystem renderSystem) {
             foeRenderState const *pRenderStateData = pStartRenderStateData + *pRenderStateOffset;
 
             // Make sure the associated position component exists
-            pPositionID = std::lower_bound(pPositionID, pEndPositionID, entity);
-            if (pPositionID == pEndPositionID)
-                break;
-            if (*pPositionID != entity)
+            size_t positionOffset;
+            if (!foeEcsComponentPoolFindOffset(pRenderSystem->positionPool, entity,
+                                               &positionOffset))
                 continue;
 
             // Check to see if the render data already exists for it
@@ -941,8 +1055,8 @@ extern "C" foeResultSet foeProcessRenderSystem(foeRenderSystem renderSystem) {
 
             RenderDataSet newDataSet{.entity = entity, .armatureIndex = UINT32_MAX};
 
-            foeResourceStateFlags resourceState =
-                getRenderData(pRenderSystem->resourcePool, pRenderStateData, &newDataSet.resources);
+            foeResourceStateFlags resourceState = getRenderData(
+                pRenderSystem->resourcePool, &batch, pRenderStateData, &newDataSet.resources);
 
             assert(resourceState & (FOE_RESOURCE_STATE_LOADING_BIT | FOE_RESOURCE_STATE_FAILED_BIT |
                                     FOE_RESOURCE_STATE_LOADED_BIT));
@@ -965,8 +1079,7 @@ extern "C" foeResultSet foeProcessRenderSystem(foeRenderSystem renderSystem) {
                 }
 
                 size_t const posIndex = renderDataIt - pRenderSystem->renderData.begin();
-                foePosition3d const *const pPositionData =
-                    *(ppStartPositionData + (pPositionID - pStartPositionID));
+                foePosition3d const *const pPositionData = pStartPositionData + positionOffset;
                 result = insertPositionData(pRenderSystem->positionData, posIndex, pPositionData);
                 if (result.value != FOE_SUCCESS)
                     return result;
@@ -1082,6 +1195,9 @@ extern "C" foeResultSet foeProcessRenderSystem(foeRenderSystem renderSystem) {
         }
     }
 
+    // Start the loads requested while processing, most waited on first
+    foeResourceLoadQueueDispatch(pRenderSystem->loadQueue, cMaxLoadsPerProcess);
+
     return to_foeResult(FOE_SKUNKWORKS_SUCCESS);
 }
 
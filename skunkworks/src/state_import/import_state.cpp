@@ -8,12 +8,17 @@
 #include <foe/ecs/group_translator.h>
 #include <foe/ecs/name_map.h>
 #include <foe/imex/importer.h>
+#include <foe/parallel_for.h>
 #include <foe/search_paths.hpp>
 #include <foe/simulation/simulation.h>
 
 #include "../log.hpp"
 #include "result.h"
 
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace {
 
 foeImexImporter searchAndCreateImporter(std::string_view dataSetName,
@@ -72,10 +77,211 @@ bool generateDependencyImporters(uint32_t dependencyCount,
     return true;
 }
 
+using EditorNames = std::vector<std::pair<foeId, std::string>>;
+
+/// Reads the editor names of all of the group's resources
+EditorNames readResourceEditorNames(foeImexImporter importer, foeEcsIndexes indexes) {
+    struct CallContext {
+        foeImexImporter importer;
+        EditorNames names;
+    };
+    CallContext callContext = {
+        .importer = importer,
+    };
+
+    foeEcsForEachID(
+        indexes,
+        [](void *pContext, foeId id) {
+            CallContext *pCallContext = (CallContext *)pContext;
+
+            uint32_t nameLength;
+            foeResultSet result = foeImexImporterGetResourceEditorName(
+                pCallContext->importer, foeIdGetIndex(id), &nameLength, NULL);
+            if (result.value == FOE_SUCCESS && nameLength > 0) {
+                std::string editorName;
+                do {
+                    editorName.resize(nameLength);
+                    result = foeImexImporterGetResourceEditorName(
+                        pCallContext->importer, foeIdGetIndex(id), &nameLength, editorName.data());
+                } while (result.value != FOE_SUCCESS);
+
+                pCallContext->names.emplace_back(id, std::move(editorName));
+            }
+        },
+        &callContext);
+
+    return std::move(callContext.names);
+}
+
+/// Reads the names that were given to any of the IDs in the indexes out of a name map
+EditorNames readNameMapNames(foeEcsNameMap nameMap, foeEcsIndexes indexes) {
+    struct CallContext {
+        foeEcsNameMap nameMap;
+        EditorNames names;
+    };
+    CallContext callContext = {
+        .nameMap = nameMap,
+    };
+
+    foeEcsForEachID(
+        indexes,
+        [](void *pContext, foeId id) {
+            CallContext *pCallContext = (CallContext *)pContext;
+
+            uint32_t nameLength;
+            foeResultSet result =
+                foeEcsNameMapFindName(pCallContext->nameMap, id, &nameLength, nullptr);
+            if (result.value != FOE_SUCCESS)
+                return;
+
+            std::string name;
+            name.resize(nameLength);
+            foeEcsNameMapFindName(pCallContext->nameMap, id, &nameLength, name.data());
+            // The returned length includes the null terminator
+            name.resize(nameLength - 1);
+
+            pCallContext->names.emplace_back(id, std::move(name));
+        },
+        &callContext);
+
+    return std::move(callContext.names);
+}
+
+/// Adds all of the given names to the map together, logging any that collide with existing ones
+void addEditorNames(foeEcsNameMap nameMap, EditorNames const &names, char const *pNameType) {
+    std::vector<foeEcsNameMapEntry> entries;
+    entries.reserve(names.size());
+    for (auto const &[id, editorName] : names) {
+        entries.emplace_back(foeEcsNameMapEntry{
+            .id = id,
+            .pName = editorName.c_str(),
+        });
+    }
+
+    foeResultSet result = foeEcsNameMapAddMany(nameMap, entries.size(), entries.data());
+    if (result.value != FOE_SUCCESS) {
+        char buffer[FOE_MAX_RESULT_STRING_SIZE];
+        result.toString(result.value, buffer);
+        FOE_LOG(foeSkunkworks, FOE_LOG_LEVEL_WARNING, "Not all {} editor names were added: {}",
+                pNameType, buffer)
+    }
+}
+
+/// Reads the create infos of all of the group's resources, then adds them to the pool together
+void importResourceCreateInfos(foeImexImporter importer,
+                               foeIdGroup group,
+                               foeEcsIndexes indexes,
+                               foeResourceCreateInfoPool createInfoPool) {
+    struct CallContext {
+        foeImexImporter importer;
+        foeIdGroup group;
+        std::vector<foeResourceID> resourceIDs;
+        std::vector<foeResourceCreateInfo> resourceCreateInfos;
+    };
+    CallContext callContext = {
+        .importer = importer,
+        .group = group,
+    };
+
+    foeEcsForEachID(
+        indexes,
+        [](void *pContext, foeId id) {
+            CallContext *pCallContext = (CallContext *)pContext;
+
+            foeResourceCreateInfo resourceCI = FOE_NULL_HANDLE;
+            foeResultSet result =
+                foeImexImporterGetResourceCreateInfo(pCallContext->importer, id, &resourceCI);
+            if (result.value != FOE_SUCCESS)
+                return;
+
+            if (resourceCI != FOE_NULL_HANDLE) {
+                pCallContext->resourceIDs.emplace_back(foeIdCreate(pCallContext->group, id));
+                pCallContext->resourceCreateInfos.emplace_back(resourceCI);
+            }
+        },
+        &callContext);
+
+    foeResourceCreateInfoPoolAddMany(createInfoPool, (uint32_t)callContext.resourceIDs.size(),
+                                     callContext.resourceIDs.data(),
+                                     callContext.resourceCreateInfos.data());
+
+    for (foeResourceCreateInfo resourceCI : callContext.resourceCreateInfos)
+        foeResourceCreateInfoDecrementRefCount(resourceCI);
+}
+
+struct DependencyImportData {
+    foeSimulation simulation;
+    bool importResourceNames;
+    bool importEntityNames;
+    /// Values of the groups with an importer
+    std::vector<foeIdGroupValue> groupValues;
+    /// Result of importing the state data of each group
+    std::vector<foeResultSet> results;
+    /// Resource editor names read for each group
+    std::vector<EditorNames> resourceNames;
+    /// Entity editor names read for each group
+    std::vector<EditorNames> entityNames;
+};
+
+/** @brief Imports everything for a range of dependency groups
+ *
+ * Each group only writes to its own indexes, with the rest going to the create info pool and
+ * component pools, which can be added to from multiple threads. Component data is staged
+ * per-thread by the component pools, and only merged on their next maintenance.
+ *
+ * Editor names are kept per-group rather than added to the simulation's name maps here, so that
+ * they can be added in group order afterwards. Otherwise which group gets a name that is used by
+ * more than one would depend on which thread got there first.
+ */
+void importDependencyGroups(void *pContext, size_t begin, size_t end) {
+    auto *pImportData = reinterpret_cast<DependencyImportData *>(pContext);
+    foeGroupData groupData = foeSimulationGetGroupData(pImportData->simulation);
+
+    for (size_t i = begin; i < end; ++i) {
+        foeIdGroup group = foeIdValueToGroup(pImportData->groupValues[i]);
+        foeImexImporter importer = foeSimulationImporter(groupData, group);
+        foeEcsIndexes resourceIndexes = foeSimulationResourceIndexes(groupData, group);
+
+        // Indice Data
+        foeImexImporterGetGroupResourceIndexData(importer, resourceIndexes);
+        foeImexImporterGetGroupEntityIndexData(importer,
+                                               foeSimulationEntityIndexes(groupData, group));
+
+        // Resource Editor Names
+        if (pImportData->importResourceNames)
+            pImportData->resourceNames[i] = readResourceEditorNames(importer, resourceIndexes);
+
+        // Resource Records
+        importResourceCreateInfos(
+            importer, group, resourceIndexes,
+            foeSimulationGetSavedBaseDataResourceCreateInfoPool(pImportData->simulation));
+
+        // State Data, with entity names going to a map of just this group's
+        foeEcsNameMap groupEntityNameMap = FOE_NULL_HANDLE;
+        if (pImportData->importEntityNames) {
+            foeResultSet result = foeEcsCreateNameMap(&groupEntityNameMap);
+            if (result.value != FOE_SUCCESS) {
+                pImportData->results[i] = result;
+                continue;
+            }
+        }
+
+        pImportData->results[i] = foeImexImporterGetStateData(importer, groupEntityNameMap,
+                                                               pImportData->simulation);
+
+        if (groupEntityNameMap != FOE_NULL_HANDLE) {
+            pImportData->entityNames[i] = readNameMapNames(
+                groupEntityNameMap, foeSimulationEntityIndexes(groupData, group));
+            foeEcsDestroyNameMap(groupEntityNameMap);
+        }
+    }
+}
+
 } // namespace
 
 foeResultSet importState(std::string_view topLevelDataSet,
                          foeSearchPaths *pSearchPaths,
+                         foeSplitThreadPool threadPool,
                          foeSimulation *pSimulation) {
     foeSimulation newSimulation = FOE_NULL_HANDLE;
     foeResultSet result = foeCreateSimulation(true, &newSimulation);
@@ -282,246 +488,78 @@ foeResultSet importState(std::string_view topLevelDataSet,
                                            persistentImporter);
     }
 
-    // Dependency Indice Data
-    for (foeIdGroup groupValue = 0; groupValue < foeIdNumDynamicGroups; ++groupValue) {
-        foeImexImporter groupImporter = foeSimulationImporter(
-            foeSimulationGetGroupData(newSimulation), foeIdValueToGroup(groupValue));
-        if (groupImporter == FOE_NULL_HANDLE)
-            continue;
+    foeGroupData groupData = foeSimulationGetGroupData(newSimulation);
+    foeEcsNameMap resourceNameMap = foeSimulationGetResourceNameMap(newSimulation);
+    foeEcsNameMap entityNameMap = foeSimulationGetEntityNameMap(newSimulation);
+
+    // Dependency Groups, which are independent of each other, so are imported in parallel
+    DependencyImportData dependencyImportData{
+        .simulation = newSimulation,
+        .importResourceNames = resourceNameMap != FOE_NULL_HANDLE,
+        .importEntityNames = entityNameMap != FOE_NULL_HANDLE,
+    };
+    for (foeIdGroupValue groupValue = 0; groupValue < foeIdNumDynamicGroups; ++groupValue) {
+        if (foeSimulationImporter(groupData, foeIdValueToGroup(groupValue)) != FOE_NULL_HANDLE)
+            dependencyImportData.groupValues.emplace_back(groupValue);
+    }
+    dependencyImportData.results.resize(dependencyImportData.groupValues.size());
+    dependencyImportData.resourceNames.resize(dependencyImportData.groupValues.size());
+    dependencyImportData.entityNames.resize(dependencyImportData.groupValues.size());
+
+    // Each group is a single item, as the amount of data in each varies too widely to batch them
+    result = foeParallelFor(threadPool, 0, dependencyImportData.groupValues.size(), 1,
+                            importDependencyGroups, &dependencyImportData);
+    if (result.value != FOE_SUCCESS)
+        return result;
 
-        foeImexImporterGetGroupResourceIndexData(
-            groupImporter, foeSimulationResourceIndexes(foeSimulationGetGroupData(newSimulation),
-                                                        foeIdValueToGroup(groupValue)));
+    for (foeResultSet groupResult : dependencyImportData.results) {
+        if (groupResult.value != FOE_SUCCESS)
+            return groupResult;
+    }
 
-        foeImexImporterGetGroupEntityIndexData(
-            groupImporter, foeSimulationEntityIndexes(foeSimulationGetGroupData(newSimulation),
-                                                      foeIdValueToGroup(groupValue)));
+    // Dependency Editor Names, in group order so earlier groups keep any names in contention
+    for (size_t i = 0; i < dependencyImportData.groupValues.size(); ++i) {
+        if (resourceNameMap != FOE_NULL_HANDLE)
+            addEditorNames(resourceNameMap, dependencyImportData.resourceNames[i], "resource");
+        if (entityNameMap != FOE_NULL_HANDLE)
+            addEditorNames(entityNameMap, dependencyImportData.entityNames[i], "entity");
     }
 
     // Persistent Indice Data
+    foeImexImporter persistentGroupImporter = foeSimulationPersistentImporter(groupData);
+
     result = foeImexImporterGetGroupEntityIndexData(
-        foeSimulationPersistentImporter(foeSimulationGetGroupData(newSimulation)),
-        foeSimulationPersistentEntityIndexes(foeSimulationGetGroupData(newSimulation)));
+        persistentGroupImporter, foeSimulationPersistentEntityIndexes(groupData));
     if (result.value != FOE_SUCCESS)
         return to_foeResult(FOE_STATE_IMPORT_ERROR_IMPORTING_INDEX_DATA);
 
     result = foeImexImporterGetGroupResourceIndexData(
-        foeSimulationPersistentImporter(foeSimulationGetGroupData(newSimulation)),
-        foeSimulationPersistentResourceIndexes(foeSimulationGetGroupData(newSimulation)));
+        persistentGroupImporter, foeSimulationPersistentResourceIndexes(groupData));
     if (result.value != FOE_SUCCESS)
         return to_foeResult(FOE_STATE_IMPORT_ERROR_IMPORTING_INDEX_DATA);
 
-    // Read the Resource Editor Names
-    foeEcsNameMap resourceNameMap = foeSimulationGetResourceNameMap(newSimulation);
-    if (resourceNameMap != FOE_NULL_HANDLE) {
-        // Dependent Groups
-        for (foeIdGroup groupValue = 0; groupValue < foeIdNumDynamicGroups; ++groupValue) {
-            foeImexImporter groupImporter = foeSimulationImporter(
-                foeSimulationGetGroupData(newSimulation), foeIdValueToGroup(groupValue));
-            if (groupImporter == FOE_NULL_HANDLE)
-                continue;
-
-            struct CallContext {
-                foeImexImporter importer;
-                foeEcsNameMap nameMap;
-            };
-            CallContext callContext = {
-                .importer = groupImporter,
-                .nameMap = resourceNameMap,
-            };
-
-            // Go through all the indexes for the group, set any available editor names
-            foeEcsForEachID(
-                foeSimulationResourceIndexes(foeSimulationGetGroupData(newSimulation),
-                                             foeIdValueToGroup(groupValue)),
-                [](void *pContext, foeId id) {
-                    CallContext *pCallContext = (CallContext *)pContext;
-
-                    uint32_t nameLength;
-                    foeResultSet result = foeImexImporterGetResourceEditorName(
-                        pCallContext->importer, foeIdGetIndex(id), &nameLength, NULL);
-                    if (result.value == FOE_SUCCESS && nameLength > 0) {
-                        std::string editorName;
-                        do {
-                            editorName.resize(nameLength);
-                            result = foeImexImporterGetResourceEditorName(
-                                pCallContext->importer, foeIdGetIndex(id), &nameLength,
-                                editorName.data());
-                        } while (result.value != FOE_SUCCESS);
-
-                        foeEcsNameMapAdd(pCallContext->nameMap, id, editorName.c_str());
-                    }
-                },
-                &callContext);
-        }
-
-        // Persistent Group
-        foeImexImporter groupImporter =
-            foeSimulationPersistentImporter(foeSimulationGetGroupData(newSimulation));
-
-        // Go through all the indexes for the group, set any available editor names
-        std::vector<foeIdIndex> recycledIndexes;
-
-        struct CallContext {
-            foeImexImporter importer;
-            foeEcsNameMap nameMap;
-        };
-        CallContext callContext = {
-            .importer = groupImporter,
-            .nameMap = resourceNameMap,
-        };
-
-        foeEcsForEachID(
-            foeSimulationPersistentResourceIndexes(foeSimulationGetGroupData(newSimulation)),
-            [](void *pContext, foeId id) {
-                CallContext *pCallContext = (CallContext *)pContext;
-
-                uint32_t nameLength;
-                foeResultSet result = foeImexImporterGetResourceEditorName(
-                    pCallContext->importer, foeIdGetIndex(id), &nameLength, NULL);
-                if (result.value == FOE_SUCCESS && nameLength > 0) {
-                    std::string editorName;
-                    do {
-                        editorName.resize(nameLength);
-                        result = foeImexImporterGetResourceEditorName(
-                            pCallContext->importer, foeIdGetIndex(id), &nameLength,
-                            editorName.data());
-                    } while (result.value != FOE_SUCCESS);
-
-                    foeEcsNameMapAdd(pCallContext->nameMap, id, editorName.c_str());
-                }
-            },
-            &callContext);
-    }
-
-    // Import Resource History/Records
-    {
-        // Dynamic Groups
-        for (foeIdGroup groupValue = 0; groupValue < foeIdNumDynamicGroups; ++groupValue) {
-            foeImexImporter groupImporter = foeSimulationImporter(
-                foeSimulationGetGroupData(newSimulation), foeIdValueToGroup(groupValue));
-            if (groupImporter == FOE_NULL_HANDLE)
-                continue;
-
-            // Go through all GroupIDs upto this group, and import any resource data for all of it
-            for (foeIdGroupValue resourceGroupValue = 0; resourceGroupValue <= groupValue;
-                 ++resourceGroupValue) {
-                auto *pGroupIndexes =
-                    foeSimulationResourceIndexes(foeSimulationGetGroupData(newSimulation),
-                                                 foeIdValueToGroup(resourceGroupValue));
-                if (pGroupIndexes == nullptr)
-                    continue;
-
-                struct CallContext {
-                    foeImexImporter importer;
-                    foeResourceCreateInfoPool pool;
-                    foeIdGroupValue groupValue;
-                };
-                CallContext callContext = {
-                    .importer = groupImporter,
-                    .pool = foeSimulationGetSavedBaseDataResourceCreateInfoPool(newSimulation),
-                    .groupValue = groupValue,
-                };
-
-                // Go through all the indexes for the group, set any available editor names
-                foeEcsForEachID(
-                    foeSimulationResourceIndexes(foeSimulationGetGroupData(newSimulation),
-                                                 foeIdValueToGroup(groupValue)),
-                    [](void *pContext, foeId id) {
-                        CallContext *pCallContext = (CallContext *)pContext;
-
-                        foeResourceCreateInfo resourceCI = FOE_NULL_HANDLE;
-                        foeResultSet result = foeImexImporterGetResourceCreateInfo(
-                            pCallContext->importer, id, &resourceCI);
-                        if (result.value != FOE_SUCCESS)
-                            return;
-
-                        if (resourceCI != FOE_NULL_HANDLE) {
-                            foeResourceID fullID =
-                                foeIdCreate(foeIdValueToGroup(pCallContext->groupValue), id);
-                            foeResourceCreateInfoPoolAdd(pCallContext->pool, fullID, resourceCI);
-
-                            foeResourceCreateInfoDecrementRefCount(resourceCI);
-                        }
-                    },
-                    &callContext);
-            }
-        }
-
-        // Persistent Group
-        foeImexImporter persistentImporter =
-            foeSimulationPersistentImporter(foeSimulationGetGroupData(newSimulation));
-
-        // Go through all GroupIDs upto this group, and import any resource data for all of it
-        for (foeIdGroupValue resourceGroupValue = 0;
-             resourceGroupValue <= foeIdPersistentGroupValue; ++resourceGroupValue) {
-            auto *pGroupIndexes = foeSimulationResourceIndexes(
-                foeSimulationGetGroupData(newSimulation), foeIdValueToGroup(resourceGroupValue));
-            if (pGroupIndexes == nullptr)
-                continue;
-
-            struct CallContext {
-                foeImexImporter importer;
-                foeResourceCreateInfoPool pool;
-            };
-            CallContext callContext = {
-                .importer = persistentImporter,
-                .pool = foeSimulationGetSavedPersistentDataResourceCreateInfoPool(newSimulation),
-            };
-
-            // Go through all the indexes for the group, set any available editor names
-            foeEcsForEachID(
-                foeSimulationResourceIndexes(foeSimulationGetGroupData(newSimulation),
-                                             foeIdValueToGroup(foeIdPersistentGroupValue)),
-                [](void *pContext, foeId id) {
-                    CallContext *pCallContext = (CallContext *)pContext;
-
-                    foeResourceCreateInfo resourceCI = FOE_NULL_HANDLE;
-                    foeResultSet result = foeImexImporterGetResourceCreateInfo(
-                        pCallContext->importer, id, &resourceCI);
-                    if (result.value != FOE_SUCCESS)
-                        return;
-
-                    if (resourceCI != FOE_NULL_HANDLE) {
-                        foeResourceID fullID = foeIdCreate(foeIdPersistentGroup, id);
-                        foeResourceCreateInfoPoolAdd(pCallContext->pool, fullID, resourceCI);
-
-                        foeResourceCreateInfoDecrementRefCount(resourceCI);
-                    }
-                },
-                &callContext);
-        }
-    }
-
-    // Importing Dependency State Data
-    foeEcsNameMap entityNameMap = foeSimulationGetEntityNameMap(newSimulation);
-    for (foeIdGroup groupValue = 0; groupValue < foeIdNumDynamicGroups; ++groupValue) {
-        foeImexImporter groupImporter = foeSimulationImporter(
-            foeSimulationGetGroupData(newSimulation), foeIdValueToGroup(groupValue));
-        if (groupImporter == FOE_NULL_HANDLE)
-            continue;
-
-        result = foeImexImporterGetStateData(groupImporter, entityNameMap, newSimulation);
-        if (result.value != FOE_SUCCESS)
-            return result;
-    }
-
-    // Importing Persistent State Data
-    result = foeImexImporterGetStateData(
-        foeSimulationPersistentImporter(foeSimulationGetGroupData(newSimulation)), entityNameMap,
-        newSimulation);
+    // Persistent Resource Editor Names
+    if (resourceNameMap != FOE_NULL_HANDLE)
+        addEditorNames(resourceNameMap,
+                       readResourceEditorNames(persistentGroupImporter,
+                                               foeSimulationPersistentResourceIndexes(groupData)),
+                       "resource");
+
+    // Persistent Resource Records
+    importResourceCreateInfos(
+        persistentGroupImporter, foeIdPersistentGroup,
+        foeSimulationPersistentResourceIndexes(groupData),
+        foeSimulationGetSavedPersistentDataResourceCreateInfoPool(newSimulation));
+
+    // Persistent State Data
+    result = foeImexImporterGetStateData(persistentGroupImporter, entityNameMap, newSimulation);
     if (result.value != FOE_SUCCESS)
         return result;
 
-    size_t componentPoolCount;
-    foeSimulationComponentPoolData *pComponentPools;
-    foeSimulationGetComponentPools(newSimulation, &componentPoolCount, &pComponentPools);
-    for (size_t i = 0; i < componentPoolCount; ++i) {
-        foeSimulationComponentPoolData *pComponentPool = pComponentPools + i;
-        if (pComponentPool->pMaintenanceFn) {
-            pComponentPool->pMaintenanceFn(pComponentPool->pComponentPool);
-        }
-    }
+    // Merge the component data staged by all of the importing threads into the pools
+    result = foeSimulationMaintainComponentPools(newSimulation, threadPool, nullptr);
+    if (result.value != FOE_SUCCESS)
+        return result;
 
     // Successfully returning
     *pSimulation = newSimulation;
@@ -7,6 +7,7 @@
 
 #include <foe/handle.h>
 #include <foe/result.h>
+#include <foe/split_thread_pool.h>
 
 #include <string_view>
 
@@ -14,9 +15,12 @@ FOE_DEFINE_HANDLE(foeSimulation)
 
 class foeSearchPaths;
 
-/// Imports data set and its dependencies
+/** @brief Imports data set and its dependencies
+ * @param threadPool Pool whose sync threads import the dependency groups in parallel
+ */
 foeResultSet importState(std::string_view topLevelDataSet,
                          foeSearchPaths *pSearchPaths,
+                         foeSplitThreadPool threadPool,
                          foeSimulation *pSimulation);
 
 #endif // IMPORT_STATE_HPP
\ No newline at end of file